@@ -176,6 +176,22 @@ FUNCTION_LINKAGE void JOIN(ARENA_NAME, deallocate_all)(ARENA_TYPE *self);
  */
 FUNCTION_LINKAGE void *JOIN(ARENA_NAME, allocate_aligned)(ARENA_TYPE *self, const size_t alignment, const size_t size);
 
+/**
+ * @brief Get the pointer to a chunk of the arena. With specific alignment.
+ *        Without zeroing the memory.
+ *
+ * Prefer this when the memory is overwritten before it is read anyway.
+ *
+ * @param[in] self              arena pointer.
+ * @param[in] alignment         alignment size
+ * @param[in] size              chunk size
+ *
+ * @return                      A pointer to an uninitialized memory chunk.
+ * @retval NULL                 If the arena doesn't have enough memory for the allocation.
+ */
+FUNCTION_LINKAGE void *JOIN(ARENA_NAME, allocate_aligned_uninitialized)(ARENA_TYPE *self, const size_t alignment,
+                                                                        const size_t size);
+
 /**
  * @brief Get the pointer to a chunk of the arena.
  *
@@ -270,6 +286,18 @@ FUNCTION_LINKAGE void JOIN(ARENA_NAME, deallocate_all)(ARENA_TYPE *self)
 }
 
 FUNCTION_LINKAGE void *JOIN(ARENA_NAME, allocate_aligned)(ARENA_TYPE *self, const size_t alignment, const size_t size)
+{
+    void *ptr = JOIN(ARENA_NAME, allocate_aligned_uninitialized)(self, alignment, size);
+
+    if (ptr) {
+        memset(ptr, 0, size);
+    }
+
+    return ptr;
+}
+
+FUNCTION_LINKAGE void *JOIN(ARENA_NAME, allocate_aligned_uninitialized)(ARENA_TYPE *self, const size_t alignment,
+                                                                        const size_t size)
 {
     assert(self);
 
@@ -287,8 +315,6 @@ FUNCTION_LINKAGE void *JOIN(ARENA_NAME, allocate_aligned)(ARENA_TYPE *self, cons
     self->prev_offset = relative_offset;
     self->curr_offset = relative_offset + size;
 
-    memset(ptr, 0, size);
-
     return ptr;
 }
 
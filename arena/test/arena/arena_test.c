@@ -6,12 +6,16 @@
     - init
     - deallocate_all
     - allocate_aligned / allocate
+    - allocate_aligned_uninitialized
     - reallocate_aligned / reallocate
 
     Branches:
     - allocate_aligned()
         | !has_space_left -> NULL
         | otherwise -> (non-NULL pointer to chunk of initialized memory with correct alignment)
+    - allocate_aligned_uninitialized()
+        | !has_space_left -> NULL
+        | otherwise -> (non-NULL pointer to chunk of memory with correct alignment, left as is)
     - reallocate_aligned()
         | new_size == 0 || old_ptr == NULL || new_size || !inside_arena_buf -> NULL
         | has_optimized_w_prev_buf -> (same pointer, but interally shrinks/grows the memory chunk)
@@ -169,4 +173,26 @@ int main(void)
 
         assert(!arena_allocate_aligned(&a, 1, 1));
     }
+    // uninitialized allocation leaves the memory as is:
+    {
+        struct arena a;
+        unsigned char buf[sizeof(int) * 4];
+        memset(buf, 0xab, sizeof(buf));
+
+        arena_init(&a, sizeof(buf), buf);
+
+        unsigned char *p = arena_allocate_aligned_uninitialized(&a, alignof(int), sizeof(int) * 2);
+        assert(p && (uintptr_t)p % alignof(int) == 0);
+        for (size_t i = 0; i < sizeof(int) * 2; i++) {
+            assert(p[i] == 0xab);
+        }
+
+        unsigned char *q = arena_allocate_aligned(&a, alignof(int), sizeof(int) * 2);
+        assert(q && q != p);
+        for (size_t i = 0; i < sizeof(int) * 2; i++) {
+            assert(q[i] == 0);
+        }
+
+        assert(!arena_allocate_aligned_uninitialized(&a, 1, 1));
+    }
 }
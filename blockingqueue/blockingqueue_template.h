@@ -0,0 +1,535 @@
+/*  blockingqueue_template.h
+ *
+ *  Copyright (C) 2025 abxh
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *  See the file LICENSE included with this distribution for more
+ *  information. */
+
+/**
+ * @file blockingqueue_template.h
+ * @brief Blocking wrapper around a lock-free queue, waiting on futexes
+ *
+ * Wraps a queue defined with `spscqueue_template.h` or `mpmcqueue_template.h`
+ * (with the same thread rules), and adds `enqueue` and `dequeue` operations
+ * which wait while the queue is full or empty:
+ *      @li The operation is first retried in a spin loop. The number of
+ *          retries adapts: it is doubled when spinning succeeded last time,
+ *          and halved when it did not, between `BLOCKINGQUEUE_MIN_SPIN` and
+ *          `BLOCKINGQUEUE_MAX_SPIN`. The processor is yielded every
+ *          `BLOCKINGQUEUE_YIELD_INTERVAL` retries.
+ *      @li Then the thread registers as sleeping, and sleeps on a futex word
+ *          (see `futex.h`) until the other side makes room or adds a value.
+ *
+ * The other side only issues a wake-up system call when a thread is
+ * registered as sleeping, such that the fast path stays lock-free and without
+ * system calls. Idle threads use no CPU time.
+ *
+ * Source(s) used:
+ *  @li https://www.akkadia.org/drepper/futex.pdf
+ */
+
+/**
+ * @example blockingqueue_example.c
+ * Example of how `blockingqueue_template.h` header file is used in practice.
+ */
+
+#ifdef __cplusplus
+#ifdef __GNUC__
+#define restrict __restrict__
+#else
+#define restrict
+#endif
+extern "C" {
+#endif
+
+#include <assert.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+// macro definitions: {{{
+
+/**
+ * @def PASTE(a,b)
+ * @brief Paste two tokens together.
+ */
+#ifndef PASTE
+#define PASTE(a, b) a##b
+#endif
+
+/**
+ * @def XPASTE(a,b)
+ * @brief First expand tokens, then paste them together.
+ */
+#ifndef XPASTE
+#define XPASTE(a, b) PASTE(a, b)
+#endif
+
+/**
+ * @def JOIN(a,b)
+ * @brief First expand tokens, then paste them together with a _ in between.
+ */
+#ifndef JOIN
+#define JOIN(a, b) XPASTE(a, XPASTE(_, b))
+#endif
+
+/**
+ * @def BLOCKINGQUEUE_MIN_SPIN
+ * @brief Minimum number of retries before sleeping.
+ */
+#ifndef BLOCKINGQUEUE_MIN_SPIN
+#define BLOCKINGQUEUE_MIN_SPIN (16)
+#endif
+
+/**
+ * @def BLOCKINGQUEUE_MAX_SPIN
+ * @brief Maximum number of retries before sleeping. Each retry is in the order
+ *        of tens of nanoseconds.
+ */
+#ifndef BLOCKINGQUEUE_MAX_SPIN
+#define BLOCKINGQUEUE_MAX_SPIN (4096)
+#endif
+
+/**
+ * @def BLOCKINGQUEUE_YIELD_INTERVAL
+ * @brief Number of retries between yielding the processor while spinning.
+ */
+#ifndef BLOCKINGQUEUE_YIELD_INTERVAL
+#define BLOCKINGQUEUE_YIELD_INTERVAL (64)
+#endif
+
+/**
+ * @def BLOCKINGQUEUE_CACHE_LINE_SIZE
+ * @brief Alignment used to keep the producer and consumer fields apart.
+ *        Equal to a typical cache line size.
+ */
+#ifndef BLOCKINGQUEUE_CACHE_LINE_SIZE
+#define BLOCKINGQUEUE_CACHE_LINE_SIZE (64)
+#endif
+
+/// @cond DO_NOT_DOCUMENT
+#ifndef BLOCKINGQUEUE_ALIGNAS
+#ifdef __cplusplus
+#define BLOCKINGQUEUE_ALIGNAS(x) alignas(x)
+#else
+#define BLOCKINGQUEUE_ALIGNAS(x) _Alignas(x)
+#endif
+#endif
+/// @endcond
+
+/**
+ * @def NAME
+ * @brief Prefix to blocking queue type and operations. This must be manually
+ *        defined before including this header file.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef NAME
+#define NAME blockingqueue
+#error "Must define NAME."
+#else
+#define BLOCKINGQUEUE_NAME NAME
+#endif
+
+/**
+ * @def QUEUE
+ * @brief The `NAME` of the wrapped queue defined with `spscqueue_template.h` or
+ *        `mpmcqueue_template.h`. This must be manually defined before
+ *        including this header file.
+ *
+ * The queue type and functions must be declared before including this header
+ * file.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef QUEUE
+#define QUEUE queue
+#error "Must define QUEUE."
+#endif
+
+/**
+ * @def VALUE_TYPE
+ * @brief The value type of the wrapped queue. This must be manually defined
+ *        before including this header file.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef VALUE_TYPE
+#define VALUE_TYPE int
+#define FUNCTION_DEFINITIONS
+#define TYPE_DEFINITIONS
+#error "Must define VALUE_TYPE."
+#endif
+
+/**
+ * @def FUNCTION_LINKAGE
+ * @brief Specify function linkage e.g. static inline
+ */
+#ifndef FUNCTION_LINKAGE
+#define FUNCTION_LINKAGE
+#endif
+
+/// @cond DO_NOT_DOCUMENT
+#define BLOCKINGQUEUE_TYPE       struct BLOCKINGQUEUE_NAME
+#define BLOCKINGQUEUE_QUEUE_TYPE struct QUEUE
+#define BLOCKINGQUEUE_NOTIFY     JOIN(internal, JOIN(BLOCKINGQUEUE_NAME, notify))
+#define BLOCKINGQUEUE_ADAPT_SPIN JOIN(internal, JOIN(BLOCKINGQUEUE_NAME, adapt_spin))
+#define BLOCKINGQUEUE_DEQUEUE    JOIN(internal, JOIN(BLOCKINGQUEUE_NAME, dequeue))
+#define BLOCKINGQUEUE_BACKOFF    JOIN(internal, JOIN(BLOCKINGQUEUE_NAME, backoff))
+/// @endcond
+
+// }}}
+
+// type definitions: {{{
+
+/**
+ * @def TYPE_DEFINITIONS
+ * @brief Define the types
+ */
+#ifdef TYPE_DEFINITIONS
+
+/**
+ * @brief Generated blocking queue struct type for a `QUEUE`.
+ */
+struct BLOCKINGQUEUE_NAME {
+    BLOCKINGQUEUE_QUEUE_TYPE *queue; ///< The wrapped queue.
+
+    BLOCKINGQUEUE_ALIGNAS(BLOCKINGQUEUE_CACHE_LINE_SIZE)
+    _Atomic(uint32_t) not_empty_word;           ///< Futex word consumers sleep on. Changed to wake them.
+    _Atomic(uint32_t) sleeping_consumer_count;  ///< Number of consumers registered as sleeping.
+    _Atomic(uint32_t) consumer_spin_limit;      ///< Current number of retries of consumers before sleeping.
+
+    BLOCKINGQUEUE_ALIGNAS(BLOCKINGQUEUE_CACHE_LINE_SIZE)
+    _Atomic(uint32_t) not_full_word;            ///< Futex word producers sleep on. Changed to wake them.
+    _Atomic(uint32_t) sleeping_producer_count;  ///< Number of producers registered as sleeping.
+    _Atomic(uint32_t) producer_spin_limit;      ///< Current number of retries of producers before sleeping.
+};
+
+#endif
+
+// }}}
+
+// function declarations: {{{
+
+/**
+ * @brief Initialize a blocking queue struct, given the queue to wrap.
+ *
+ * @param[in] self              Blocking queue pointer.
+ * @param[in] queue_ptr         The queue to wrap. Not owned.
+ *
+ * @return                      The blocking queue pointer.
+ */
+FUNCTION_LINKAGE BLOCKINGQUEUE_TYPE *JOIN(BLOCKINGQUEUE_NAME, init)(BLOCKINGQUEUE_TYPE *self,
+                                                                    BLOCKINGQUEUE_QUEUE_TYPE *queue_ptr);
+
+/**
+ * @brief Enqueue a value at the back of the queue, if it is not full, and wake
+ *        a sleeping consumer.
+ *
+ * @param[in] self              The blocking queue pointer.
+ * @param[in] value             The value to enqueue.
+ *
+ * @return                      Whether the value was enqueued.
+ */
+FUNCTION_LINKAGE bool JOIN(BLOCKINGQUEUE_NAME, try_enqueue)(BLOCKINGQUEUE_TYPE *self, const VALUE_TYPE value);
+
+/**
+ * @brief Dequeue a value from the front of the queue, if it is not empty, and
+ *        wake a sleeping producer.
+ *
+ * @param[in] self              The blocking queue pointer.
+ * @param[out] value_ptr        Set to the front value, if any.
+ *
+ * @return                      Whether a value was dequeued.
+ */
+FUNCTION_LINKAGE bool JOIN(BLOCKINGQUEUE_NAME, try_dequeue)(BLOCKINGQUEUE_TYPE *restrict self,
+                                                            VALUE_TYPE *restrict value_ptr);
+
+/**
+ * @brief Enqueue a value at the back of the queue, waiting while it is full.
+ *
+ * @param[in] self              The blocking queue pointer.
+ * @param[in] value             The value to enqueue.
+ */
+FUNCTION_LINKAGE void JOIN(BLOCKINGQUEUE_NAME, enqueue)(BLOCKINGQUEUE_TYPE *self, const VALUE_TYPE value);
+
+/**
+ * @brief Dequeue a value from the front of the queue, waiting while it is
+ *        empty.
+ *
+ * @param[in] self              The blocking queue pointer.
+ *
+ * @return                      The front value.
+ */
+FUNCTION_LINKAGE VALUE_TYPE JOIN(BLOCKINGQUEUE_NAME, dequeue)(BLOCKINGQUEUE_TYPE *self);
+
+/**
+ * @brief Dequeue a value from the front of the queue, waiting while it is
+ *        empty, for at most a given time.
+ *
+ * @param[in] self              The blocking queue pointer.
+ * @param[out] value_ptr        Set to the front value, if any.
+ * @param[in] timeout_ns        The maximum time to wait in nanoseconds.
+ *
+ * @return                      Whether a value was dequeued before the timeout.
+ */
+FUNCTION_LINKAGE bool JOIN(BLOCKINGQUEUE_NAME, dequeue_timed)(BLOCKINGQUEUE_TYPE *restrict self,
+                                                              VALUE_TYPE *restrict value_ptr,
+                                                              const uint64_t timeout_ns);
+
+// }}}
+
+// function definitions: {{{
+
+/**
+ * @def FUNCTION_DEFINITIONS
+ * @brief Define the functions
+ */
+#ifdef FUNCTION_DEFINITIONS
+
+#include "futex.h" // futex_wait, futex_wake, futex_cpu_relax
+
+/// @cond DO_NOT_DOCUMENT
+static inline void JOIN(internal, JOIN(BLOCKINGQUEUE_NAME, notify))(_Atomic(uint32_t) *word_ptr,
+                                                                    _Atomic(uint32_t) *sleeping_count_ptr)
+{
+    /* pairs with the fence of the sleeping side: either it sees the change of the queue before sleeping, or the
+     * sleeping count is seen here */
+    atomic_thread_fence(memory_order_seq_cst);
+
+    if (atomic_load_explicit(sleeping_count_ptr, memory_order_relaxed) != 0) {
+        atomic_fetch_add_explicit(word_ptr, 1, memory_order_release);
+        futex_wake(word_ptr, 1);
+    }
+}
+
+static inline void JOIN(internal, JOIN(BLOCKINGQUEUE_NAME, adapt_spin))(_Atomic(uint32_t) *spin_limit_ptr,
+                                                                        const bool spinning_succeeded)
+{
+    const uint32_t spin_limit = atomic_load_explicit(spin_limit_ptr, memory_order_relaxed);
+
+    if (spinning_succeeded && spin_limit < BLOCKINGQUEUE_MAX_SPIN) {
+        atomic_store_explicit(spin_limit_ptr, spin_limit * 2, memory_order_relaxed);
+    }
+    else if (!spinning_succeeded && spin_limit > BLOCKINGQUEUE_MIN_SPIN) {
+        atomic_store_explicit(spin_limit_ptr, spin_limit / 2, memory_order_relaxed);
+    }
+}
+
+/* yield now and then, such that the other side can run when the cores are oversubscribed */
+static inline void JOIN(internal, JOIN(BLOCKINGQUEUE_NAME, backoff))(const uint32_t retry_index)
+{
+    if ((retry_index + 1) % BLOCKINGQUEUE_YIELD_INTERVAL == 0) {
+        sched_yield();
+    }
+    else {
+        futex_cpu_relax();
+    }
+}
+
+static inline int64_t JOIN(internal, JOIN(BLOCKINGQUEUE_NAME, now_ns))(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* waits until the deadline, or forever if the deadline is negative */
+static inline bool JOIN(internal, JOIN(BLOCKINGQUEUE_NAME, dequeue))(BLOCKINGQUEUE_TYPE *restrict self,
+                                                                     VALUE_TYPE *restrict value_ptr,
+                                                                     const int64_t deadline_ns)
+{
+    const uint32_t spin_limit = atomic_load_explicit(&self->consumer_spin_limit, memory_order_relaxed);
+
+    for (uint32_t i = 0; i < spin_limit; i++) {
+        if (JOIN(QUEUE, try_dequeue)(self->queue, value_ptr)) {
+            BLOCKINGQUEUE_ADAPT_SPIN(&self->consumer_spin_limit, true);
+            BLOCKINGQUEUE_NOTIFY(&self->not_full_word, &self->sleeping_producer_count);
+            return true;
+        }
+        BLOCKINGQUEUE_BACKOFF(i);
+    }
+    BLOCKINGQUEUE_ADAPT_SPIN(&self->consumer_spin_limit, false);
+
+    for (;;) {
+        /* read before re-checking the queue, such that a wake-up in between is not missed */
+        const uint32_t word = atomic_load_explicit(&self->not_empty_word, memory_order_acquire);
+
+        atomic_fetch_add_explicit(&self->sleeping_consumer_count, 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+
+        if (JOIN(QUEUE, try_dequeue)(self->queue, value_ptr)) {
+            atomic_fetch_sub_explicit(&self->sleeping_consumer_count, 1, memory_order_relaxed);
+            BLOCKINGQUEUE_NOTIFY(&self->not_full_word, &self->sleeping_producer_count);
+            return true;
+        }
+
+        if (deadline_ns < 0) {
+            futex_wait(&self->not_empty_word, word, NULL);
+        }
+        else {
+            const int64_t remaining_ns = deadline_ns - JOIN(internal, JOIN(BLOCKINGQUEUE_NAME, now_ns))();
+
+            if (remaining_ns <= 0) {
+                atomic_fetch_sub_explicit(&self->sleeping_consumer_count, 1, memory_order_relaxed);
+                return false;
+            }
+
+            const struct timespec timeout = {(time_t)(remaining_ns / 1000000000), (long)(remaining_ns % 1000000000)};
+            futex_wait(&self->not_empty_word, word, &timeout);
+        }
+
+        atomic_fetch_sub_explicit(&self->sleeping_consumer_count, 1, memory_order_relaxed);
+
+        if (JOIN(QUEUE, try_dequeue)(self->queue, value_ptr)) {
+            BLOCKINGQUEUE_NOTIFY(&self->not_full_word, &self->sleeping_producer_count);
+            return true;
+        }
+    }
+}
+/// @endcond
+
+FUNCTION_LINKAGE BLOCKINGQUEUE_TYPE *JOIN(BLOCKINGQUEUE_NAME, init)(BLOCKINGQUEUE_TYPE *self,
+                                                                    BLOCKINGQUEUE_QUEUE_TYPE *queue_ptr)
+{
+    assert(self != NULL);
+    assert(queue_ptr != NULL);
+
+    self->queue = queue_ptr;
+
+    atomic_init(&self->not_empty_word, 0);
+    atomic_init(&self->sleeping_consumer_count, 0);
+    atomic_init(&self->consumer_spin_limit, BLOCKINGQUEUE_MIN_SPIN);
+
+    atomic_init(&self->not_full_word, 0);
+    atomic_init(&self->sleeping_producer_count, 0);
+    atomic_init(&self->producer_spin_limit, BLOCKINGQUEUE_MIN_SPIN);
+
+    return self;
+}
+
+FUNCTION_LINKAGE bool JOIN(BLOCKINGQUEUE_NAME, try_enqueue)(BLOCKINGQUEUE_TYPE *self, const VALUE_TYPE value)
+{
+    assert(self != NULL);
+
+    if (!JOIN(QUEUE, try_enqueue)(self->queue, value)) {
+        return false;
+    }
+    BLOCKINGQUEUE_NOTIFY(&self->not_empty_word, &self->sleeping_consumer_count);
+
+    return true;
+}
+
+FUNCTION_LINKAGE bool JOIN(BLOCKINGQUEUE_NAME, try_dequeue)(BLOCKINGQUEUE_TYPE *restrict self,
+                                                            VALUE_TYPE *restrict value_ptr)
+{
+    assert(self != NULL);
+    assert(value_ptr != NULL);
+
+    if (!JOIN(QUEUE, try_dequeue)(self->queue, value_ptr)) {
+        return false;
+    }
+    BLOCKINGQUEUE_NOTIFY(&self->not_full_word, &self->sleeping_producer_count);
+
+    return true;
+}
+
+FUNCTION_LINKAGE void JOIN(BLOCKINGQUEUE_NAME, enqueue)(BLOCKINGQUEUE_TYPE *self, const VALUE_TYPE value)
+{
+    assert(self != NULL);
+
+    const uint32_t spin_limit = atomic_load_explicit(&self->producer_spin_limit, memory_order_relaxed);
+
+    for (uint32_t i = 0; i < spin_limit; i++) {
+        if (JOIN(QUEUE, try_enqueue)(self->queue, value)) {
+            BLOCKINGQUEUE_ADAPT_SPIN(&self->producer_spin_limit, true);
+            BLOCKINGQUEUE_NOTIFY(&self->not_empty_word, &self->sleeping_consumer_count);
+            return;
+        }
+        BLOCKINGQUEUE_BACKOFF(i);
+    }
+    BLOCKINGQUEUE_ADAPT_SPIN(&self->producer_spin_limit, false);
+
+    for (;;) {
+        /* read before re-checking the queue, such that a wake-up in between is not missed */
+        const uint32_t word = atomic_load_explicit(&self->not_full_word, memory_order_acquire);
+
+        atomic_fetch_add_explicit(&self->sleeping_producer_count, 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+
+        if (JOIN(QUEUE, try_enqueue)(self->queue, value)) {
+            atomic_fetch_sub_explicit(&self->sleeping_producer_count, 1, memory_order_relaxed);
+            BLOCKINGQUEUE_NOTIFY(&self->not_empty_word, &self->sleeping_consumer_count);
+            return;
+        }
+
+        futex_wait(&self->not_full_word, word, NULL);
+
+        atomic_fetch_sub_explicit(&self->sleeping_producer_count, 1, memory_order_relaxed);
+
+        if (JOIN(QUEUE, try_enqueue)(self->queue, value)) {
+            BLOCKINGQUEUE_NOTIFY(&self->not_empty_word, &self->sleeping_consumer_count);
+            return;
+        }
+    }
+}
+
+FUNCTION_LINKAGE VALUE_TYPE JOIN(BLOCKINGQUEUE_NAME, dequeue)(BLOCKINGQUEUE_TYPE *self)
+{
+    assert(self != NULL);
+
+    VALUE_TYPE value;
+    BLOCKINGQUEUE_DEQUEUE(self, &value, -1);
+
+    return value;
+}
+
+FUNCTION_LINKAGE bool JOIN(BLOCKINGQUEUE_NAME, dequeue_timed)(BLOCKINGQUEUE_TYPE *restrict self,
+                                                              VALUE_TYPE *restrict value_ptr,
+                                                              const uint64_t timeout_ns)
+{
+    assert(self != NULL);
+    assert(value_ptr != NULL);
+
+    const uint64_t max_timeout_ns = (uint64_t)INT64_MAX / 2;
+    const uint64_t clamped_timeout_ns = timeout_ns < max_timeout_ns ? timeout_ns : max_timeout_ns;
+
+    return BLOCKINGQUEUE_DEQUEUE(self, value_ptr,
+                                 JOIN(internal, JOIN(BLOCKINGQUEUE_NAME, now_ns))() + (int64_t)clamped_timeout_ns);
+}
+
+#endif
+
+// }}}
+
+// macro undefs: {{{
+
+#undef NAME
+#undef QUEUE
+#undef VALUE_TYPE
+#undef FUNCTION_LINKAGE
+#undef FUNCTION_DEFINITIONS
+#undef TYPE_DEFINITIONS
+
+#undef BLOCKINGQUEUE_NAME
+#undef BLOCKINGQUEUE_TYPE
+#undef BLOCKINGQUEUE_QUEUE_TYPE
+#undef BLOCKINGQUEUE_NOTIFY
+#undef BLOCKINGQUEUE_ADAPT_SPIN
+#undef BLOCKINGQUEUE_DEQUEUE
+#undef BLOCKINGQUEUE_BACKOFF
+
+// }}}
+
+#ifdef __cplusplus
+}
+#endif
+
+// vim: ft=c fdm=marker
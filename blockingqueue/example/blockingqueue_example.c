@@ -0,0 +1,68 @@
+#include <assert.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#define NAME       int_spsc
+#define VALUE_TYPE int
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "spscqueue_template.h"
+
+#define NAME       int_bq
+#define QUEUE      int_spsc
+#define VALUE_TYPE int
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "blockingqueue_template.h"
+
+#define MESSAGE_COUNT (1000)
+#define STOP          (-1)
+
+static struct int_bq bq;
+
+static void *consumer(void *arg)
+{
+    long *sum = arg;
+    for (;;) {
+        const int value = int_bq_dequeue(&bq); // sleeps while empty
+        if (value == STOP) {
+            break;
+        }
+        *sum += value;
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    struct int_spsc *q = int_spsc_create(16);
+    if (!q) {
+        assert(false);
+    }
+    int_bq_init(&bq, q);
+
+    long sum = 0;
+    pthread_t thread;
+    pthread_create(&thread, NULL, consumer, &sum);
+
+    for (int i = 1; i <= MESSAGE_COUNT; i++) {
+        int_bq_enqueue(&bq, i); // sleeps while full
+    }
+    int_bq_enqueue(&bq, STOP);
+
+    pthread_join(thread, NULL);
+
+    assert(sum == (long)MESSAGE_COUNT * (MESSAGE_COUNT + 1) / 2);
+    printf("sum: %ld\n", sum);
+
+    /* nothing to wait for: gives up after 1 ms */
+    int value;
+    if (!int_bq_dequeue_timed(&bq, &value, 1000000)) {
+        printf("timed out\n");
+    }
+
+    int_spsc_destroy(q);
+}
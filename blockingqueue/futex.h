@@ -0,0 +1,112 @@
+/*  futex.h
+ *
+ *  Copyright (C) 2025 abxh
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *  See the file LICENSE included with this distribution for more
+ *  information. */
+
+/**
+ * @file futex.h
+ * @brief Wait on and wake threads waiting on a 32-bit word
+ *
+ * Linux futexes are used, which put the waiting thread to sleep in the kernel
+ * until the word is woken (or changes).
+ *
+ * @note On other platforms than Linux, waiting falls back to yielding, such
+ *       that waiters poll.
+ *
+ * Source(s) used:
+ *  @li https://man7.org/linux/man-pages/man2/futex.2.html
+ *  @li https://www.akkadia.org/drepper/futex.pdf
+ */
+
+#pragma once
+
+#ifndef FUTEX_H
+#define FUTEX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <sched.h>
+#endif
+
+/**
+ * @brief Hint to the processor that the caller is spinning.
+ */
+static inline void futex_cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * @brief Sleep as long as the word is equal to the expected value, until
+ *        woken by `futex_wake` or the timeout passes.
+ *
+ * @note May return spuriously. The caller is expected to re-check its
+ *       condition.
+ *
+ * @param[in] word_ptr          Pointer to the word.
+ * @param[in] expected          The value of the word to sleep on.
+ * @param[in] timeout_ptr       The relative timeout, or NULL to sleep without
+ *                              a timeout.
+ */
+static inline void futex_wait(_Atomic(uint32_t) *word_ptr, const uint32_t expected, const struct timespec *timeout_ptr)
+{
+    assert(word_ptr != NULL);
+
+#ifdef __linux__
+    /* the return value is of no interest: the word changed, it was woken, interrupted or timed out */
+    (void)syscall(SYS_futex, (uint32_t *)word_ptr, FUTEX_WAIT_PRIVATE, expected, timeout_ptr, NULL, 0);
+#else
+    (void)(expected);
+    (void)(timeout_ptr);
+    sched_yield();
+#endif
+}
+
+/**
+ * @brief Wake up to `count` threads sleeping on the word.
+ *
+ * @param[in] word_ptr          Pointer to the word.
+ * @param[in] count             The maximum number of threads to wake.
+ */
+static inline void futex_wake(_Atomic(uint32_t) *word_ptr, const int count)
+{
+    assert(word_ptr != NULL);
+
+#ifdef __linux__
+    (void)syscall(SYS_futex, (uint32_t *)word_ptr, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+#else
+    (void)(word_ptr);
+    (void)(count);
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FUTEX_H
+
+// vim: ft=c
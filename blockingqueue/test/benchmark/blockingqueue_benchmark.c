@@ -0,0 +1,248 @@
+// Measures the latency and the CPU time of consumers under a bursty load:
+// producers enqueue bursts of timestamped values, and sleep in between. The
+// consumers wait for values by:
+//  - blocking: the blocking queue, sleeping on a futex.
+//  - spin-poll: retrying try_dequeue, yielding now and then.
+//  - sleep-poll: retrying try_dequeue, sleeping 50 us when empty.
+// Run with `make bench`.
+//
+// usage: ./a.out [number of bursts]
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define NAME       u64_spsc
+#define VALUE_TYPE uint64_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "spscqueue_template.h"
+
+#define NAME       u64_mpmc
+#define VALUE_TYPE uint64_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "mpmcqueue_template.h"
+
+#define NAME       u64_bspsc
+#define QUEUE      u64_spsc
+#define VALUE_TYPE uint64_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "blockingqueue_template.h"
+
+#define NAME       u64_bmpmc
+#define QUEUE      u64_mpmc
+#define VALUE_TYPE uint64_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "blockingqueue_template.h"
+
+#define CAPACITY          (1024)
+#define BURST_SIZE        (64)
+#define BURST_GAP_NS      (200000)
+#define POLL_SLEEP_NS     (50000)
+#define MPMC_THREAD_COUNT (2) // producers, and consumers
+#define STOP              (UINT64_MAX)
+
+/* spin for a while before giving up the core, such that oversubscribed cores still make progress */
+#define SPIN_LIMIT (1024)
+
+enum wait_mode { BLOCKING, SPIN_POLL, SLEEP_POLL };
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t thread_cpu_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static void sleep_ns(const long ns)
+{
+    const struct timespec ts = {ns / 1000000000, ns % 1000000000};
+    nanosleep(&ts, NULL);
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+    const uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static struct u64_bspsc bspsc;
+static struct u64_bmpmc bmpmc;
+static bool use_mpmc;
+static enum wait_mode mode;
+static uint64_t burst_count;
+
+static bool try_enqueue(const uint64_t value)
+{
+    return use_mpmc ? u64_bmpmc_try_enqueue(&bmpmc, value) : u64_bspsc_try_enqueue(&bspsc, value);
+}
+
+static bool try_dequeue(uint64_t *value_ptr)
+{
+    return use_mpmc ? u64_bmpmc_try_dequeue(&bmpmc, value_ptr) : u64_bspsc_try_dequeue(&bspsc, value_ptr);
+}
+
+static uint64_t dequeue(void)
+{
+    uint64_t value;
+    uint32_t spins = 0;
+
+    switch (mode) {
+    case BLOCKING:
+        return use_mpmc ? u64_bmpmc_dequeue(&bmpmc) : u64_bspsc_dequeue(&bspsc);
+    case SPIN_POLL:
+        while (!try_dequeue(&value)) {
+            if (++spins == SPIN_LIMIT) {
+                spins = 0;
+                sched_yield();
+            }
+        }
+        return value;
+    case SLEEP_POLL:
+        while (!try_dequeue(&value)) {
+            sleep_ns(POLL_SLEEP_NS);
+        }
+        return value;
+    }
+    return STOP;
+}
+
+struct consumer_args {
+    uint64_t *latencies;
+    uint64_t latency_count;
+    uint64_t cpu_ns;
+};
+
+static void *producer(void *arg)
+{
+    (void)arg;
+    for (uint64_t i = 0; i < burst_count; i++) {
+        for (uint32_t j = 0; j < BURST_SIZE; j++) {
+            while (!try_enqueue(now_ns())) {
+                sched_yield();
+            }
+        }
+        sleep_ns(BURST_GAP_NS);
+    }
+    return NULL;
+}
+
+static void *consumer(void *arg)
+{
+    struct consumer_args *args = arg;
+    const uint64_t cpu_start = thread_cpu_ns();
+
+    for (;;) {
+        const uint64_t value = dequeue();
+        if (value == STOP) {
+            break;
+        }
+        args->latencies[args->latency_count++] = now_ns() - value;
+    }
+
+    args->cpu_ns = thread_cpu_ns() - cpu_start;
+    return NULL;
+}
+
+static void run(const char *label, const bool mpmc, const enum wait_mode wait_mode)
+{
+    const uint32_t thread_count = mpmc ? MPMC_THREAD_COUNT : 1;
+    const uint64_t total = burst_count * BURST_SIZE * thread_count;
+
+    use_mpmc = mpmc;
+    mode = wait_mode;
+
+    pthread_t producers[MPMC_THREAD_COUNT], consumers[MPMC_THREAD_COUNT];
+    struct consumer_args args[MPMC_THREAD_COUNT];
+
+    for (uint32_t i = 0; i < thread_count; i++) {
+        args[i].latencies = malloc(total * sizeof(uint64_t));
+        args[i].latency_count = 0;
+        if (!args[i].latencies) {
+            fprintf(stderr, "allocation failed\n");
+            exit(1);
+        }
+        pthread_create(&consumers[i], NULL, consumer, &args[i]);
+    }
+    for (uint32_t i = 0; i < thread_count; i++) {
+        pthread_create(&producers[i], NULL, producer, NULL);
+    }
+
+    for (uint32_t i = 0; i < thread_count; i++) {
+        pthread_join(producers[i], NULL);
+    }
+    for (uint32_t i = 0; i < thread_count; i++) {
+        while (!try_enqueue(STOP)) {
+            sched_yield();
+        }
+    }
+
+    uint64_t *latencies = malloc(total * sizeof(uint64_t));
+    uint64_t count = 0, cpu_ns = 0;
+    if (!latencies) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+    for (uint32_t i = 0; i < thread_count; i++) {
+        pthread_join(consumers[i], NULL);
+        for (uint64_t j = 0; j < args[i].latency_count; j++) {
+            latencies[count++] = args[i].latencies[j];
+        }
+        cpu_ns += args[i].cpu_ns;
+        free(args[i].latencies);
+    }
+    qsort(latencies, count, sizeof(uint64_t), compare_u64);
+
+    printf("%-22s %12.2f %12.2f %18.2f\n", label, (double)latencies[count / 2] * 1e-3,
+           (double)latencies[count * 99 / 100] * 1e-3, (double)cpu_ns * 1e-6);
+
+    free(latencies);
+}
+
+int main(int argc, char **argv)
+{
+    burst_count = argc > 1 ? strtoull(argv[1], NULL, 10) : 1000;
+
+    struct u64_spsc *spsc = u64_spsc_create(CAPACITY);
+    struct u64_mpmc *mpmc = u64_mpmc_create(CAPACITY);
+    if (!spsc || !mpmc || burst_count == 0) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+    u64_bspsc_init(&bspsc, spsc);
+    u64_bmpmc_init(&bmpmc, mpmc);
+
+    printf("%llu bursts of %d values, %d us apart\n", (unsigned long long)burst_count, BURST_SIZE,
+           BURST_GAP_NS / 1000);
+    printf("%-22s %12s %12s %18s\n", "queue", "median (us)", "p99 (us)", "consumer CPU (ms)");
+
+    run("spsc blocking", false, BLOCKING);
+    run("spsc spin-poll", false, SPIN_POLL);
+    run("spsc sleep-poll", false, SLEEP_POLL);
+    run("mpmc 2x2 blocking", true, BLOCKING);
+    run("mpmc 2x2 spin-poll", true, SPIN_POLL);
+    run("mpmc 2x2 sleep-poll", true, SLEEP_POLL);
+
+    u64_mpmc_destroy(mpmc);
+    u64_spsc_destroy(spsc);
+
+    return 0;
+}
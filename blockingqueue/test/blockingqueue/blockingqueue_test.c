@@ -0,0 +1,277 @@
+/*
+    Test cases:
+    - Init:
+      - Consumer and producer fields are on separate cache lines
+    - Single thread:
+      - try_enqueue / try_dequeue pass through to the wrapped queue
+      - dequeue returns at once when not empty
+      - dequeue_timed times out when empty, and returns at once when not empty
+      - The spin limit adapts, and stays within its bounds
+    - Sleeping:
+      - A consumer sleeping in dequeue is woken by try_enqueue
+      - A producer sleeping in enqueue is woken by try_dequeue
+    - Multiple threads, with a small capacity such that both sides sleep:
+      - SPSC: values are received in order
+      - MPMC (4 producers, 4 consumers): every value is received exactly once, with
+        the smallest capacity (1, rounded up to 2)
+*/
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define NAME       u32_spsc
+#define VALUE_TYPE uint32_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "spscqueue_template.h"
+
+#define NAME       u32_mpmc
+#define VALUE_TYPE uint32_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "mpmcqueue_template.h"
+
+#define NAME       u32_bspsc
+#define QUEUE      u32_spsc
+#define VALUE_TYPE uint32_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "blockingqueue_template.h"
+
+#define NAME       u32_bmpmc
+#define QUEUE      u32_mpmc
+#define VALUE_TYPE uint32_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "blockingqueue_template.h"
+
+#define THREAD_COUNT      (4)
+#define VALUES_PER_THREAD (20000)
+#define PRODUCER_SHIFT    (24)
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void sleep_ms(const long ms)
+{
+    const struct timespec ts = {0, ms * 1000000};
+    nanosleep(&ts, NULL);
+}
+
+static void init_test(void)
+{
+    assert(offsetof(struct u32_bspsc, not_full_word) - offsetof(struct u32_bspsc, not_empty_word)
+           >= BLOCKINGQUEUE_CACHE_LINE_SIZE);
+    assert(offsetof(struct u32_bspsc, not_empty_word) % BLOCKINGQUEUE_CACHE_LINE_SIZE == 0);
+    assert(offsetof(struct u32_bspsc, not_full_word) % BLOCKINGQUEUE_CACHE_LINE_SIZE == 0);
+
+    struct u32_spsc *q = u32_spsc_create(4);
+    assert(q != NULL);
+
+    struct u32_bspsc bq;
+    assert(u32_bspsc_init(&bq, q) == &bq);
+    assert(bq.queue == q);
+    assert(atomic_load(&bq.sleeping_consumer_count) == 0);
+    assert(atomic_load(&bq.sleeping_producer_count) == 0);
+
+    u32_spsc_destroy(q);
+}
+
+static void single_thread_test(void)
+{
+    struct u32_spsc *q = u32_spsc_create(4);
+    assert(q != NULL);
+
+    struct u32_bspsc bq;
+    u32_bspsc_init(&bq, q);
+
+    uint32_t value = 0;
+    assert(!u32_bspsc_try_dequeue(&bq, &value));
+    for (uint32_t i = 0; i < 4; i++) {
+        assert(u32_bspsc_try_enqueue(&bq, i));
+    }
+    assert(!u32_bspsc_try_enqueue(&bq, 4));
+    assert(u32_spsc_count(q) == 4);
+
+    assert(u32_bspsc_dequeue(&bq) == 0);
+    assert(u32_bspsc_dequeue_timed(&bq, &value, 0) && value == 1);
+    assert(u32_bspsc_try_dequeue(&bq, &value) && value == 2);
+    u32_bspsc_enqueue(&bq, 5);
+    assert(u32_bspsc_dequeue(&bq) == 3);
+    assert(u32_bspsc_dequeue(&bq) == 5);
+
+    /* empty: gives up after the timeout */
+    const double start = now_s();
+    assert(!u32_bspsc_dequeue_timed(&bq, &value, 20 * 1000000));
+    assert(now_s() - start >= 0.019);
+    assert(atomic_load(&bq.sleeping_consumer_count) == 0);
+    assert(!u32_bspsc_dequeue_timed(&bq, &value, 0));
+
+    /* spinning without success shrinks the spin limit down to its minimum */
+    for (uint32_t i = 0; i < 16; i++) {
+        assert(!u32_bspsc_dequeue_timed(&bq, &value, 0));
+    }
+    assert(atomic_load(&bq.consumer_spin_limit) == BLOCKINGQUEUE_MIN_SPIN);
+
+    /* succeeding while spinning grows it up to its maximum */
+    for (uint32_t i = 0; i < 16; i++) {
+        assert(u32_bspsc_try_enqueue(&bq, i));
+        assert(u32_bspsc_dequeue(&bq) == i);
+    }
+    assert(atomic_load(&bq.consumer_spin_limit) == BLOCKINGQUEUE_MAX_SPIN);
+
+    u32_spsc_destroy(q);
+}
+
+static void *sleeping_consumer(void *arg)
+{
+    struct u32_bspsc *bq = arg;
+    assert(u32_bspsc_dequeue(bq) == 42);
+    return NULL;
+}
+
+static void *sleeping_producer(void *arg)
+{
+    struct u32_bspsc *bq = arg;
+    u32_bspsc_enqueue(bq, 43);
+    return NULL;
+}
+
+static void sleeping_test(void)
+{
+    struct u32_spsc *q = u32_spsc_create(2);
+    assert(q != NULL);
+
+    struct u32_bspsc bq;
+    u32_bspsc_init(&bq, q);
+
+    pthread_t thread;
+    assert(pthread_create(&thread, NULL, sleeping_consumer, &bq) == 0);
+    while (atomic_load(&bq.sleeping_consumer_count) == 0) {
+        sleep_ms(1);
+    }
+    sleep_ms(10); // most likely inside futex_wait by now
+    assert(u32_bspsc_try_enqueue(&bq, 42));
+    assert(pthread_join(thread, NULL) == 0);
+    assert(atomic_load(&bq.sleeping_consumer_count) == 0);
+
+    assert(u32_bspsc_try_enqueue(&bq, 0));
+    assert(u32_bspsc_try_enqueue(&bq, 1));
+    assert(pthread_create(&thread, NULL, sleeping_producer, &bq) == 0);
+    while (atomic_load(&bq.sleeping_producer_count) == 0) {
+        sleep_ms(1);
+    }
+    sleep_ms(10);
+    uint32_t value;
+    assert(u32_bspsc_try_dequeue(&bq, &value) && value == 0);
+    assert(pthread_join(thread, NULL) == 0);
+    assert(atomic_load(&bq.sleeping_producer_count) == 0);
+
+    assert(u32_bspsc_dequeue(&bq) == 1);
+    assert(u32_bspsc_dequeue(&bq) == 43);
+
+    u32_spsc_destroy(q);
+}
+
+static struct u32_bspsc shared_spsc;
+static struct u32_bmpmc shared_mpmc;
+static uint8_t *seen;
+
+static void *spsc_producer(void *arg)
+{
+    (void)arg;
+    for (uint32_t i = 0; i < VALUES_PER_THREAD; i++) {
+        u32_bspsc_enqueue(&shared_spsc, i);
+    }
+    return NULL;
+}
+
+static void spsc_threads_test(void)
+{
+    struct u32_spsc *q = u32_spsc_create(2);
+    assert(q != NULL);
+    u32_bspsc_init(&shared_spsc, q);
+
+    pthread_t thread;
+    assert(pthread_create(&thread, NULL, spsc_producer, NULL) == 0);
+    for (uint32_t i = 0; i < VALUES_PER_THREAD; i++) {
+        assert(u32_bspsc_dequeue(&shared_spsc) == i);
+    }
+    assert(pthread_join(thread, NULL) == 0);
+    assert(u32_spsc_is_empty(q));
+
+    u32_spsc_destroy(q);
+}
+
+static void *mpmc_producer(void *arg)
+{
+    const uint32_t id = (uint32_t)(uintptr_t)arg;
+
+    for (uint32_t i = 0; i < VALUES_PER_THREAD; i++) {
+        u32_bmpmc_enqueue(&shared_mpmc, id << PRODUCER_SHIFT | i);
+    }
+    return NULL;
+}
+
+static void *mpmc_consumer(void *arg)
+{
+    (void)arg;
+    for (uint32_t i = 0; i < VALUES_PER_THREAD; i++) {
+        const uint32_t value = u32_bmpmc_dequeue(&shared_mpmc);
+
+        const uint32_t id = value >> PRODUCER_SHIFT;
+        const uint32_t index = value & ((1U << PRODUCER_SHIFT) - 1);
+        assert(id < THREAD_COUNT && index < VALUES_PER_THREAD);
+
+        seen[id * VALUES_PER_THREAD + index]++;
+    }
+    return NULL;
+}
+
+static void mpmc_threads_test(void)
+{
+    struct u32_mpmc *q = u32_mpmc_create(1);
+    seen = calloc(THREAD_COUNT * VALUES_PER_THREAD, sizeof(uint8_t));
+    assert(q != NULL && seen != NULL);
+    u32_bmpmc_init(&shared_mpmc, q);
+
+    pthread_t producers[THREAD_COUNT], consumers[THREAD_COUNT];
+    for (uint32_t i = 0; i < THREAD_COUNT; i++) {
+        assert(pthread_create(&producers[i], NULL, mpmc_producer, (void *)(uintptr_t)i) == 0);
+        assert(pthread_create(&consumers[i], NULL, mpmc_consumer, NULL) == 0);
+    }
+    for (uint32_t i = 0; i < THREAD_COUNT; i++) {
+        assert(pthread_join(producers[i], NULL) == 0);
+        assert(pthread_join(consumers[i], NULL) == 0);
+    }
+
+    for (uint32_t i = 0; i < THREAD_COUNT * VALUES_PER_THREAD; i++) {
+        assert(seen[i] == 1);
+    }
+    assert(u32_mpmc_count(q) == 0);
+
+    free(seen);
+    u32_mpmc_destroy(q);
+}
+
+int main(void)
+{
+    init_test();
+    single_thread_test();
+    sleeping_test();
+    spsc_threads_test();
+    mpmc_threads_test();
+}
@@ -0,0 +1,771 @@
+/*  bloomfilter_template.h
+ *
+ *  Copyright (C) 2025 abxh
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *  See the file LICENSE included with this distribution for more
+ *  information. */
+
+/**
+ * @file bloomfilter_template.h
+ * @brief Fixed-size cache-line-blocked Bloom filter
+ *
+ * The filter is an array of 64-byte blocks, each made of 8 64-bit words. A key
+ * is mapped to a single block, and sets (or tests) one bit in every word of
+ * that block. A query thereby touches exactly one cache line. The word loops
+ * are written such that the compiler can turn them into SIMD instructions.
+ *
+ * A query answers either "definitely not contained" or "possibly contained".
+ * Keys cannot be removed.
+ *
+ * With 8 bits set per key, 8 bits per key gives a false positive rate of
+ * roughly 3%, 12 bits per key roughly 0.5% and 16 bits per key roughly 0.1%.
+ *
+ * The following macros must be defined:
+ *      @li `NAME`
+ *      @li `KEY_TYPE`
+ *      @li `HASH_FUNCTION(key)`
+ *
+ * Source(s) used:
+ *  @li https://github.com/apache/parquet-format/blob/master/BloomFilter.md
+ *  @li https://save-buffer.github.io/bloom_filter.html
+ */
+
+/**
+ * @example bloomfilter_example.c
+ * Example of how `bloomfilter_template.h` header file is used in practice.
+ */
+
+#ifdef __cplusplus
+#ifdef __GNUC__
+#define restrict __restrict__
+#else
+#define restrict
+#endif
+extern "C" {
+#endif
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// macro definitions: {{{
+
+/**
+ * @def PASTE(a,b)
+ * @brief Paste two tokens together.
+ */
+#ifndef PASTE
+#define PASTE(a, b) a##b
+#endif
+
+/**
+ * @def XPASTE(a,b)
+ * @brief First expand tokens, then paste them together.
+ */
+#ifndef XPASTE
+#define XPASTE(a, b) PASTE(a, b)
+#endif
+
+/**
+ * @def JOIN(a,b)
+ * @brief First expand tokens, then paste them together with a _ in between.
+ */
+#ifndef JOIN
+#define JOIN(a, b) XPASTE(a, XPASTE(_, b))
+#endif
+
+/**
+ * @def BLOOMFILTER_BLOCK_WORDS
+ * @brief Number of 64-bit words per block. One bit is set per word.
+ */
+#ifndef BLOOMFILTER_BLOCK_WORDS
+#define BLOOMFILTER_BLOCK_WORDS (8)
+#endif
+
+/**
+ * @def BLOOMFILTER_BLOCK_SIZE
+ * @brief Size of a block in bytes. Equal to a typical cache line size.
+ */
+#ifndef BLOOMFILTER_BLOCK_SIZE
+#define BLOOMFILTER_BLOCK_SIZE (64)
+#endif
+
+/**
+ * @def BLOOMFILTER_BATCH_SIZE
+ * @brief Number of keys hashed and prefetched ahead by `insert_n` and
+ *        `contains_n`.
+ */
+#ifndef BLOOMFILTER_BATCH_SIZE
+#define BLOOMFILTER_BATCH_SIZE (16)
+#endif
+
+/**
+ * @def BLOOMFILTER_MAGIC
+ * @brief Magic number at the start of a serialized filter ("BLMF" in ASCII,
+ *        when written in little-endian).
+ */
+#ifndef BLOOMFILTER_MAGIC
+#define BLOOMFILTER_MAGIC (UINT32_C(0x464d4c42))
+#endif
+
+/**
+ * @def BLOOMFILTER_VERSION
+ * @brief Version of the serialization format.
+ */
+#ifndef BLOOMFILTER_VERSION
+#define BLOOMFILTER_VERSION (UINT32_C(1))
+#endif
+
+/**
+ * @def BLOOMFILTER_HEADER_SIZE
+ * @brief Size of the header of a serialized filter in bytes.
+ *
+ * The header consists of the following little-endian `uint32_t` fields:
+ *      @li magic number (`BLOOMFILTER_MAGIC`)
+ *      @li version (`BLOOMFILTER_VERSION`)
+ *      @li number of blocks
+ *      @li reserved (0)
+ *
+ * It is followed by the words of every block, each written as a little-endian
+ * `uint64_t`.
+ */
+#ifndef BLOOMFILTER_HEADER_SIZE
+#define BLOOMFILTER_HEADER_SIZE (16)
+#endif
+
+/**
+ * @def BLOOMFILTER_CALC_SIZEOF(bloomfilter_name, block_count)
+ *
+ * @brief Calculate the size of the Bloom filter struct. No overflow checks.
+ *
+ * @param[in] bloomfilter_name  Defined Bloom filter NAME.
+ * @param[in] block_count       Number of blocks.
+ *
+ * @return                      The equivalent size.
+ */
+#ifndef BLOOMFILTER_CALC_SIZEOF
+#define BLOOMFILTER_CALC_SIZEOF(bloomfilter_name, block_count) \
+    (offsetof(struct bloomfilter_name, blocks) + (size_t)(block_count) * BLOOMFILTER_BLOCK_SIZE)
+#endif
+
+/**
+ * @def BLOOMFILTER_CALC_SIZEOF_OVERFLOWS(bloomfilter_name, block_count)
+ *
+ * @brief Check for a given number of blocks, if the equivalent size of the
+ *        Bloom filter struct overflows.
+ *
+ * @param[in] bloomfilter_name  Defined Bloom filter NAME.
+ * @param[in] block_count       Number of blocks.
+ *
+ * @return                      Whether the equivalent size overflows.
+ */
+#ifndef BLOOMFILTER_CALC_SIZEOF_OVERFLOWS
+#define BLOOMFILTER_CALC_SIZEOF_OVERFLOWS(bloomfilter_name, block_count) \
+    ((size_t)(block_count) > (SIZE_MAX - offsetof(struct bloomfilter_name, blocks)) / BLOOMFILTER_BLOCK_SIZE)
+#endif
+
+/**
+ * @def BLOOMFILTER_SERIALIZED_SIZE(block_count)
+ *
+ * @brief Calculate the size of a serialized Bloom filter. No overflow checks.
+ *
+ * @param[in] block_count       Number of blocks.
+ *
+ * @return                      The equivalent size.
+ */
+#ifndef BLOOMFILTER_SERIALIZED_SIZE
+#define BLOOMFILTER_SERIALIZED_SIZE(block_count) \
+    (BLOOMFILTER_HEADER_SIZE + (size_t)(block_count) * BLOOMFILTER_BLOCK_SIZE)
+#endif
+
+/// @cond DO_NOT_DOCUMENT
+#ifndef BLOOMFILTER_ALIGNAS
+#ifdef __cplusplus
+#define BLOOMFILTER_ALIGNAS(x) alignas(x)
+#else
+#define BLOOMFILTER_ALIGNAS(x) _Alignas(x)
+#endif
+#endif
+
+#ifndef BLOOMFILTER_PREFETCH
+#if defined(__GNUC__) || defined(__clang__)
+#define BLOOMFILTER_PREFETCH(addr, rw) __builtin_prefetch((addr), (rw))
+#else
+#define BLOOMFILTER_PREFETCH(addr, rw) ((void)(addr))
+#endif
+#endif
+/// @endcond
+
+/**
+ * @def NAME
+ * @brief Prefix to Bloom filter types and operations. This must be manually
+ *        defined before including this header file.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef NAME
+#error "Must define NAME."
+#else
+#define BLOOMFILTER_NAME NAME
+#endif
+
+/**
+ * @def KEY_TYPE
+ * @brief The key type. This must be manually defined before including this
+ *        header file.
+ *
+ * Is undefined once header is included.
+ */
+#ifndef KEY_TYPE
+#define KEY_TYPE int
+#define FUNCTION_DEFINITIONS
+#define TYPE_DEFINITIONS
+#error "Must define KEY_TYPE."
+#endif
+
+/**
+ * @def HASH_FUNCTION(key)
+ * @brief Used to compute the block and bits of keys. This must be manually
+ *        defined before including this header file.
+ *
+ * Is undefined once header is included.
+ *
+ * @warning A serialized filter may only be deserialized by a Bloom filter
+ *          using the same hash function.
+ *
+ * @param key The key.
+ * @return The hash of the key as `uint32_t`.
+ */
+#ifndef HASH_FUNCTION
+#error "Must define HASH_FUNCTION."
+#define HASH_FUNCTION(key) (0)
+#endif
+
+/**
+ * @def FUNCTION_LINKAGE
+ * @brief Specify function linkage e.g. static inline
+ */
+#ifndef FUNCTION_LINKAGE
+#define FUNCTION_LINKAGE
+#endif
+
+/// @cond DO_NOT_DOCUMENT
+#define BLOOMFILTER_TYPE          struct BLOOMFILTER_NAME
+#define BLOOMFILTER_BLOCK_TYPE    struct JOIN(BLOOMFILTER_NAME, block)
+#define BLOOMFILTER_CLEAR         JOIN(BLOOMFILTER_NAME, clear)
+#define BLOOMFILTER_BLOCK_INDEX   JOIN(internal, JOIN(BLOOMFILTER_NAME, block_index))
+#define BLOOMFILTER_MAKE_MASK     JOIN(internal, JOIN(BLOOMFILTER_NAME, make_mask))
+#define BLOOMFILTER_BLOCK_SET     JOIN(internal, JOIN(BLOOMFILTER_NAME, block_set))
+#define BLOOMFILTER_BLOCK_TEST    JOIN(internal, JOIN(BLOOMFILTER_NAME, block_test))
+#define BLOOMFILTER_ALLOCATE      JOIN(internal, JOIN(BLOOMFILTER_NAME, allocate))
+/// @endcond
+
+// }}}
+
+// type definitions: {{{
+
+/**
+ * @def TYPE_DEFINITIONS
+ * @brief Define the types
+ */
+#ifdef TYPE_DEFINITIONS
+
+/**
+ * @brief Generated Bloom filter block struct type. The size of a cache line.
+ */
+struct JOIN(BLOOMFILTER_NAME, block) {
+    uint64_t words[BLOOMFILTER_BLOCK_WORDS]; ///< The words of the block.
+};
+
+/**
+ * @brief Generated Bloom filter struct type for a given `KEY_TYPE`.
+ */
+struct BLOOMFILTER_NAME {
+    uint32_t block_count; ///< Number of blocks.
+    BLOOMFILTER_ALIGNAS(BLOOMFILTER_BLOCK_SIZE)
+    BLOOMFILTER_BLOCK_TYPE blocks[]; ///< Array of blocks. Aligned to the size of a cache line.
+};
+
+#endif
+
+// }}}
+
+// function declarations: {{{
+
+/**
+ * @brief Initialize a Bloom filter struct, given a number of blocks.
+ *
+ * @param[in] self              Bloom filter pointer.
+ * @param[in] block_count       Number of blocks. Must be non-zero.
+ *
+ * @return                      The Bloom filter pointer.
+ */
+FUNCTION_LINKAGE BLOOMFILTER_TYPE *JOIN(BLOOMFILTER_NAME, init)(BLOOMFILTER_TYPE *self, const uint32_t block_count);
+
+/**
+ * @brief Create a Bloom filter with aligned_alloc(), sized for a given number
+ *        of keys.
+ *
+ * @param[in] expected_count    Number of keys expected to be inserted.
+ * @param[in] bits_per_key      Number of bits to reserve per key.
+ *
+ * @return                      A pointer to the Bloom filter.
+ * @retval NULL
+ *   @li                        If aligned_alloc fails.
+ *   @li                        If expected_count or bits_per_key is equal to 0.
+ *   @li                        If the number of blocks is larger than
+ *                              UINT32_MAX or the equivalent size overflows.
+ */
+FUNCTION_LINKAGE BLOOMFILTER_TYPE *JOIN(BLOOMFILTER_NAME, create)(const uint32_t expected_count,
+                                                                  const uint32_t bits_per_key);
+
+/**
+ * @brief Destroy a Bloom filter struct and free the underlying memory with
+ *        free().
+ *
+ * @warning May not be called twice in a row on the same object.
+ *
+ * @param[in] self              The Bloom filter pointer.
+ */
+FUNCTION_LINKAGE void JOIN(BLOOMFILTER_NAME, destroy)(BLOOMFILTER_TYPE *self);
+
+/**
+ * @brief Clear the Bloom filter.
+ *
+ * @param[in] self              The Bloom filter pointer.
+ */
+FUNCTION_LINKAGE void JOIN(BLOOMFILTER_NAME, clear)(BLOOMFILTER_TYPE *self);
+
+/**
+ * @brief Insert a key into the Bloom filter.
+ *
+ * @param[in] self              The Bloom filter pointer.
+ * @param[in] key               The key.
+ */
+FUNCTION_LINKAGE void JOIN(BLOOMFILTER_NAME, insert)(BLOOMFILTER_TYPE *self, KEY_TYPE key);
+
+/**
+ * @brief Check whether a key is possibly contained in the Bloom filter.
+ *
+ * @param[in] self              The Bloom filter pointer.
+ * @param[in] key               The key.
+ *
+ * @retval false                If the key is definitely not contained.
+ * @retval true                 If the key is possibly contained.
+ */
+FUNCTION_LINKAGE bool JOIN(BLOOMFILTER_NAME, contains)(const BLOOMFILTER_TYPE *self, KEY_TYPE key);
+
+/**
+ * @brief Insert an array of keys into the Bloom filter.
+ *
+ * Keys are hashed `BLOOMFILTER_BATCH_SIZE` at a time, and their blocks are
+ * prefetched before any of them is modified, such that the cache misses
+ * overlap.
+ *
+ * @param[in] self              The Bloom filter pointer.
+ * @param[in] n                 Number of keys.
+ * @param[in] keys              Array of `n` keys.
+ */
+FUNCTION_LINKAGE void JOIN(BLOOMFILTER_NAME, insert_n)(BLOOMFILTER_TYPE *self, const size_t n,
+                                                       const KEY_TYPE *keys);
+
+/**
+ * @brief Check for an array of keys whether they are possibly contained in the
+ *        Bloom filter.
+ *
+ * Keys are hashed `BLOOMFILTER_BATCH_SIZE` at a time, and their blocks are
+ * prefetched before any of them is tested, such that the cache misses overlap.
+ *
+ * @param[in] self              The Bloom filter pointer.
+ * @param[in] n                 Number of keys.
+ * @param[in] keys              Array of `n` keys.
+ * @param[out] out              Array of `n` results (or NULL if only the
+ *                              number is of interest).
+ *
+ * @return                      The number of keys possibly contained.
+ */
+FUNCTION_LINKAGE size_t JOIN(BLOOMFILTER_NAME, contains_n)(const BLOOMFILTER_TYPE *self, const size_t n,
+                                                           const KEY_TYPE *keys, bool *out);
+
+/**
+ * @brief Insert all keys of a source Bloom filter into a destination Bloom
+ *        filter, by taking the union of their bits.
+ *
+ * @param[in,out] dest_ptr      The destination Bloom filter.
+ * @param[in] src_ptr           The source Bloom filter. Must have the same
+ *                              number of blocks.
+ */
+FUNCTION_LINKAGE void JOIN(BLOOMFILTER_NAME, union_with)(BLOOMFILTER_TYPE *restrict dest_ptr,
+                                                         const BLOOMFILTER_TYPE *restrict src_ptr);
+
+/**
+ * @brief Serialize the Bloom filter into a buffer.
+ *
+ * The format is independent of the endianness of the machine. See
+ * `BLOOMFILTER_HEADER_SIZE`.
+ *
+ * @param[in] self              The Bloom filter pointer.
+ * @param[out] buf              Buffer of at least
+ *                              `BLOOMFILTER_SERIALIZED_SIZE(self->block_count)`
+ *                              bytes.
+ *
+ * @return                      The number of bytes written.
+ */
+FUNCTION_LINKAGE size_t JOIN(BLOOMFILTER_NAME, serialize)(const BLOOMFILTER_TYPE *self, uint8_t *buf);
+
+/**
+ * @brief Create a Bloom filter with aligned_alloc() from a buffer written by
+ *        `serialize`.
+ *
+ * @param[in] buf               The buffer.
+ * @param[in] len               Number of bytes in the buffer.
+ *
+ * @return                      A pointer to the Bloom filter.
+ * @retval NULL
+ *   @li                        If aligned_alloc fails.
+ *   @li                        If the magic number or version does not match.
+ *   @li                        If the number of bytes does not match the
+ *                              number of blocks.
+ */
+FUNCTION_LINKAGE BLOOMFILTER_TYPE *JOIN(BLOOMFILTER_NAME, deserialize)(const uint8_t *buf, const size_t len);
+
+// }}}
+
+// function definitions: {{{
+
+/**
+ * @def FUNCTION_DEFINITIONS
+ * @brief Define the functions
+ */
+#ifdef FUNCTION_DEFINITIONS
+
+/// @cond DO_NOT_DOCUMENT
+
+/* remix the hash, such that the block index is independent of the bits set within the block */
+static inline uint32_t JOIN(internal, JOIN(BLOOMFILTER_NAME, block_index))(const BLOOMFILTER_TYPE *self,
+                                                                           uint32_t hash)
+{
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35;
+    hash ^= hash >> 16;
+
+    /* map to [0, block_count) without a modulo */
+    return (uint32_t)(((uint64_t)hash * self->block_count) >> 32);
+}
+
+static inline void JOIN(internal, JOIN(BLOOMFILTER_NAME, make_mask))(const uint32_t hash,
+                                                                     uint64_t mask[BLOOMFILTER_BLOCK_WORDS])
+{
+    static const uint32_t salts[BLOOMFILTER_BLOCK_WORDS] = {
+        0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+    };
+
+    /* the top 6 bits of each salted product select a bit within the word. kept as two loops, as
+       the compiler vectorizes them separately, but not when fused. */
+    uint64_t shifts[BLOOMFILTER_BLOCK_WORDS];
+    for (uint32_t i = 0; i < BLOOMFILTER_BLOCK_WORDS; i++) {
+        shifts[i] = (hash * salts[i]) >> 26;
+    }
+    for (uint32_t i = 0; i < BLOOMFILTER_BLOCK_WORDS; i++) {
+        mask[i] = UINT64_C(1) << shifts[i];
+    }
+}
+
+static inline void JOIN(internal, JOIN(BLOOMFILTER_NAME, block_set))(BLOOMFILTER_BLOCK_TYPE *block,
+                                                                     const uint32_t hash)
+{
+    uint64_t mask[BLOOMFILTER_BLOCK_WORDS];
+    BLOOMFILTER_MAKE_MASK(hash, mask);
+
+    for (uint32_t i = 0; i < BLOOMFILTER_BLOCK_WORDS; i++) {
+        block->words[i] |= mask[i];
+    }
+}
+
+static inline bool JOIN(internal, JOIN(BLOOMFILTER_NAME, block_test))(const BLOOMFILTER_BLOCK_TYPE *block,
+                                                                      const uint32_t hash)
+{
+    uint64_t mask[BLOOMFILTER_BLOCK_WORDS];
+    BLOOMFILTER_MAKE_MASK(hash, mask);
+
+    /* accumulate without branching, such that all words are tested at once */
+    uint64_t missing = 0;
+    for (uint32_t i = 0; i < BLOOMFILTER_BLOCK_WORDS; i++) {
+        missing |= mask[i] & ~block->words[i];
+    }
+    return missing == 0;
+}
+
+static inline BLOOMFILTER_TYPE *JOIN(internal, JOIN(BLOOMFILTER_NAME, allocate))(const uint64_t block_count)
+{
+    if (block_count == 0 || block_count > UINT32_MAX
+        || BLOOMFILTER_CALC_SIZEOF_OVERFLOWS(BLOOMFILTER_NAME, block_count)) {
+        return NULL;
+    }
+
+    /* the size is a multiple of the alignment, as the blocks are aligned */
+    const size_t size = BLOOMFILTER_CALC_SIZEOF(BLOOMFILTER_NAME, block_count);
+
+    BLOOMFILTER_TYPE *self = (BLOOMFILTER_TYPE *)aligned_alloc(BLOOMFILTER_BLOCK_SIZE, size);
+
+    if (!self) {
+        return NULL;
+    }
+
+    self->block_count = (uint32_t)block_count;
+
+    return self;
+}
+
+/// @endcond
+
+FUNCTION_LINKAGE BLOOMFILTER_TYPE *JOIN(BLOOMFILTER_NAME, init)(BLOOMFILTER_TYPE *self, const uint32_t block_count)
+{
+    assert(self);
+    assert(block_count != 0);
+
+    self->block_count = block_count;
+
+    BLOOMFILTER_CLEAR(self);
+
+    return self;
+}
+
+FUNCTION_LINKAGE BLOOMFILTER_TYPE *JOIN(BLOOMFILTER_NAME, create)(const uint32_t expected_count,
+                                                                  const uint32_t bits_per_key)
+{
+    const uint64_t block_bits = BLOOMFILTER_BLOCK_SIZE * 8;
+    const uint64_t block_count = ((uint64_t)expected_count * bits_per_key + block_bits - 1) / block_bits;
+
+    BLOOMFILTER_TYPE *self = BLOOMFILTER_ALLOCATE(block_count);
+
+    if (!self) {
+        return NULL;
+    }
+
+    BLOOMFILTER_CLEAR(self);
+
+    return self;
+}
+
+FUNCTION_LINKAGE void JOIN(BLOOMFILTER_NAME, destroy)(BLOOMFILTER_TYPE *self)
+{
+    assert(self);
+
+    free(self);
+}
+
+FUNCTION_LINKAGE void JOIN(BLOOMFILTER_NAME, clear)(BLOOMFILTER_TYPE *self)
+{
+    assert(self);
+
+    memset(self->blocks, 0, (size_t)self->block_count * BLOOMFILTER_BLOCK_SIZE);
+}
+
+FUNCTION_LINKAGE void JOIN(BLOOMFILTER_NAME, insert)(BLOOMFILTER_TYPE *self, KEY_TYPE key)
+{
+    assert(self != NULL);
+
+    const uint32_t hash = HASH_FUNCTION(key);
+
+    BLOOMFILTER_BLOCK_SET(&self->blocks[BLOOMFILTER_BLOCK_INDEX(self, hash)], hash);
+}
+
+FUNCTION_LINKAGE bool JOIN(BLOOMFILTER_NAME, contains)(const BLOOMFILTER_TYPE *self, KEY_TYPE key)
+{
+    assert(self != NULL);
+
+    const uint32_t hash = HASH_FUNCTION(key);
+
+    return BLOOMFILTER_BLOCK_TEST(&self->blocks[BLOOMFILTER_BLOCK_INDEX(self, hash)], hash);
+}
+
+FUNCTION_LINKAGE void JOIN(BLOOMFILTER_NAME, insert_n)(BLOOMFILTER_TYPE *self, const size_t n,
+                                                       const KEY_TYPE *keys)
+{
+    assert(self != NULL);
+    assert(n == 0 || keys != NULL);
+
+    uint32_t hashes[BLOOMFILTER_BATCH_SIZE];
+    uint32_t indices[BLOOMFILTER_BATCH_SIZE];
+
+    for (size_t offset = 0; offset < n; offset += BLOOMFILTER_BATCH_SIZE) {
+        const size_t m = n - offset < BLOOMFILTER_BATCH_SIZE ? n - offset : BLOOMFILTER_BATCH_SIZE;
+
+        for (size_t i = 0; i < m; i++) {
+            KEY_TYPE key = keys[offset + i];
+
+            hashes[i] = HASH_FUNCTION(key);
+            indices[i] = BLOOMFILTER_BLOCK_INDEX(self, hashes[i]);
+
+            BLOOMFILTER_PREFETCH(&self->blocks[indices[i]], 1);
+        }
+        for (size_t i = 0; i < m; i++) {
+            BLOOMFILTER_BLOCK_SET(&self->blocks[indices[i]], hashes[i]);
+        }
+    }
+}
+
+FUNCTION_LINKAGE size_t JOIN(BLOOMFILTER_NAME, contains_n)(const BLOOMFILTER_TYPE *self, const size_t n,
+                                                           const KEY_TYPE *keys, bool *out)
+{
+    assert(self != NULL);
+    assert(n == 0 || keys != NULL);
+
+    uint32_t hashes[BLOOMFILTER_BATCH_SIZE];
+    uint32_t indices[BLOOMFILTER_BATCH_SIZE];
+
+    size_t contained_count = 0;
+
+    for (size_t offset = 0; offset < n; offset += BLOOMFILTER_BATCH_SIZE) {
+        const size_t m = n - offset < BLOOMFILTER_BATCH_SIZE ? n - offset : BLOOMFILTER_BATCH_SIZE;
+
+        for (size_t i = 0; i < m; i++) {
+            KEY_TYPE key = keys[offset + i];
+
+            hashes[i] = HASH_FUNCTION(key);
+            indices[i] = BLOOMFILTER_BLOCK_INDEX(self, hashes[i]);
+
+            BLOOMFILTER_PREFETCH(&self->blocks[indices[i]], 0);
+        }
+        for (size_t i = 0; i < m; i++) {
+            const bool is_contained = BLOOMFILTER_BLOCK_TEST(&self->blocks[indices[i]], hashes[i]);
+
+            if (out) {
+                out[offset + i] = is_contained;
+            }
+            contained_count += is_contained;
+        }
+    }
+
+    return contained_count;
+}
+
+FUNCTION_LINKAGE void JOIN(BLOOMFILTER_NAME, union_with)(BLOOMFILTER_TYPE *restrict dest_ptr,
+                                                         const BLOOMFILTER_TYPE *restrict src_ptr)
+{
+    assert(dest_ptr != NULL);
+    assert(src_ptr != NULL);
+    assert(dest_ptr->block_count == src_ptr->block_count);
+
+    for (uint32_t b = 0; b < dest_ptr->block_count; b++) {
+        for (uint32_t i = 0; i < BLOOMFILTER_BLOCK_WORDS; i++) {
+            dest_ptr->blocks[b].words[i] |= src_ptr->blocks[b].words[i];
+        }
+    }
+}
+
+FUNCTION_LINKAGE size_t JOIN(BLOOMFILTER_NAME, serialize)(const BLOOMFILTER_TYPE *self, uint8_t *buf)
+{
+    assert(self != NULL);
+    assert(buf != NULL);
+
+    const uint32_t header[BLOOMFILTER_HEADER_SIZE / sizeof(uint32_t)] = {
+        BLOOMFILTER_MAGIC,
+        BLOOMFILTER_VERSION,
+        self->block_count,
+        0,
+    };
+
+    uint8_t *p = buf;
+
+    for (size_t i = 0; i < BLOOMFILTER_HEADER_SIZE / sizeof(uint32_t); i++) {
+        for (uint32_t j = 0; j < sizeof(uint32_t); j++) {
+            *p++ = (uint8_t)(header[i] >> (8 * j));
+        }
+    }
+    for (uint32_t b = 0; b < self->block_count; b++) {
+        for (uint32_t i = 0; i < BLOOMFILTER_BLOCK_WORDS; i++) {
+            for (uint32_t j = 0; j < sizeof(uint64_t); j++) {
+                *p++ = (uint8_t)(self->blocks[b].words[i] >> (8 * j));
+            }
+        }
+    }
+
+    return (size_t)(p - buf);
+}
+
+FUNCTION_LINKAGE BLOOMFILTER_TYPE *JOIN(BLOOMFILTER_NAME, deserialize)(const uint8_t *buf, const size_t len)
+{
+    assert(buf != NULL);
+
+    if (len < BLOOMFILTER_HEADER_SIZE) {
+        return NULL;
+    }
+
+    uint32_t header[BLOOMFILTER_HEADER_SIZE / sizeof(uint32_t)] = {0};
+
+    const uint8_t *p = buf;
+
+    for (size_t i = 0; i < BLOOMFILTER_HEADER_SIZE / sizeof(uint32_t); i++) {
+        for (uint32_t j = 0; j < sizeof(uint32_t); j++) {
+            header[i] |= (uint32_t)*p++ << (8 * j);
+        }
+    }
+
+    const uint32_t block_count = header[2];
+
+    if (header[0] != BLOOMFILTER_MAGIC || header[1] != BLOOMFILTER_VERSION || block_count == 0
+        || (len - BLOOMFILTER_HEADER_SIZE) / BLOOMFILTER_BLOCK_SIZE != block_count
+        || (len - BLOOMFILTER_HEADER_SIZE) % BLOOMFILTER_BLOCK_SIZE != 0) {
+        return NULL;
+    }
+
+    BLOOMFILTER_TYPE *self = BLOOMFILTER_ALLOCATE(block_count);
+
+    if (!self) {
+        return NULL;
+    }
+
+    for (uint32_t b = 0; b < block_count; b++) {
+        for (uint32_t i = 0; i < BLOOMFILTER_BLOCK_WORDS; i++) {
+            uint64_t word = 0;
+            for (uint32_t j = 0; j < sizeof(uint64_t); j++) {
+                word |= (uint64_t)*p++ << (8 * j);
+            }
+            self->blocks[b].words[i] = word;
+        }
+    }
+
+    return self;
+}
+
+#endif
+
+// }}}
+
+// macro undefs: {{{
+
+#undef NAME
+#undef KEY_TYPE
+#undef HASH_FUNCTION
+#undef FUNCTION_LINKAGE
+#undef FUNCTION_DEFINITIONS
+#undef TYPE_DEFINITIONS
+
+#undef BLOOMFILTER_NAME
+#undef BLOOMFILTER_TYPE
+#undef BLOOMFILTER_BLOCK_TYPE
+#undef BLOOMFILTER_CLEAR
+#undef BLOOMFILTER_BLOCK_INDEX
+#undef BLOOMFILTER_MAKE_MASK
+#undef BLOOMFILTER_BLOCK_SET
+#undef BLOOMFILTER_BLOCK_TEST
+#undef BLOOMFILTER_ALLOCATE
+
+// }}}
+
+#ifdef __cplusplus
+}
+#endif
+
+// vim: ft=c fdm=marker
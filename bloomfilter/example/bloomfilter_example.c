@@ -0,0 +1,70 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "murmurhash.h"
+
+#define NAME               strset
+#define KEY_TYPE           const char *
+#define HASH_FUNCTION(key) (murmur3_32((const uint8_t *)(key), (uint32_t)strlen(key), 0))
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "bloomfilter_template.h"
+
+int main(void)
+{
+    struct strset *seen = strset_create(100, 16);
+
+    if (!seen) {
+        assert(false);
+    }
+
+    strset_insert(seen, "egg");
+    strset_insert(seen, "milk");
+
+    assert(strset_contains(seen, "egg"));
+    assert(strset_contains(seen, "milk"));
+
+    /* false positives are possible, false negatives are not */
+    printf("chocolate: %s\n", strset_contains(seen, "chocolate") ? "possibly seen" : "not seen");
+
+    const char *more[] = {"flour", "sugar", "butter"};
+    strset_insert_n(seen, 3, more);
+
+    bool out[3];
+    assert(strset_contains_n(seen, 3, more, out) == 3);
+    assert(out[0] && out[1] && out[2]);
+
+    /* send the filter elsewhere */
+    const size_t size = BLOOMFILTER_SERIALIZED_SIZE(seen->block_count);
+    uint8_t *buf = malloc(size);
+    if (!buf) {
+        assert(false);
+    }
+    assert(strset_serialize(seen, buf) == size);
+
+    struct strset *received = strset_deserialize(buf, size);
+    if (!received) {
+        assert(false);
+    }
+    assert(strset_contains(received, "butter"));
+
+    /* combine filters of equal size */
+    struct strset *other = strset_create(100, 16);
+    if (!other) {
+        assert(false);
+    }
+    strset_insert(other, "salt");
+    strset_union_with(received, other);
+    assert(strset_contains(received, "salt"));
+    assert(strset_contains(received, "egg"));
+
+    strset_destroy(other);
+    strset_destroy(received);
+    free(buf);
+    strset_destroy(seen);
+}
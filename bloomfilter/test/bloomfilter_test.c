@@ -0,0 +1,220 @@
+/*
+    Test cases (N):
+    - N := 1
+    - N := 1e+3
+    - N := 1e+5
+
+    Bits per key:
+    - 8
+    - 12
+    - 16
+
+    Non-mutating operation types / properties:
+    - .block_count
+    - contains
+    - contains_n (with and without out array, non-multiple of the batch size)
+    - false positive rate
+    - calc_sizeof (this is indirectly tested for with `create`)
+
+    Mutating operation types:
+    - insert
+    - insert_n
+    - union_with
+    - clear
+
+    Memory operations [to also be tested with sanitizers]:
+    - init
+    - create
+    - destroy
+    - serialize + deserialize (round trip, corrupted header, wrong length)
+*/
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "murmurhash.h"
+
+#define NAME               u64_bf
+#define KEY_TYPE           uint64_t
+#define HASH_FUNCTION(key) (murmur3_32((const uint8_t *)&(key), sizeof(uint64_t), 0))
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "bloomfilter_template.h"
+
+static uint64_t xorshift64(uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+static void create_test(void)
+{
+    assert(u64_bf_create(0, 16) == NULL);
+    assert(u64_bf_create(16, 0) == NULL);
+
+    struct u64_bf *bf = u64_bf_create(1, 1);
+    assert(bf != NULL);
+    assert(bf->block_count == 1);
+    assert((uintptr_t)bf->blocks % BLOOMFILTER_BLOCK_SIZE == 0);
+    u64_bf_destroy(bf);
+
+    bf = u64_bf_create(1000, 16);
+    assert(bf != NULL);
+    assert(bf->block_count == (1000 * 16 + 511) / 512);
+    for (uint32_t b = 0; b < bf->block_count; b++) {
+        for (uint32_t i = 0; i < BLOOMFILTER_BLOCK_WORDS; i++) {
+            assert(bf->blocks[b].words[i] == 0);
+        }
+    }
+    u64_bf_destroy(bf);
+}
+
+static void insert_contains_test(const uint32_t n, const uint32_t bits_per_key, const double max_fp_rate)
+{
+    struct u64_bf *bf = u64_bf_create(n, bits_per_key);
+    assert(bf != NULL);
+
+    uint64_t state = 0x9e3779b97f4a7c15;
+    uint64_t *keys = malloc(n * sizeof(uint64_t));
+    assert(keys != NULL);
+
+    for (uint32_t i = 0; i < n; i++) {
+        keys[i] = xorshift64(&state);
+    }
+
+    /* insert half one at a time, and half in a batch */
+    for (uint32_t i = 0; i < n / 2; i++) {
+        u64_bf_insert(bf, keys[i]);
+    }
+    u64_bf_insert_n(bf, n - n / 2, &keys[n / 2]);
+
+    for (uint32_t i = 0; i < n; i++) {
+        assert(u64_bf_contains(bf, keys[i]));
+    }
+
+    bool *out = malloc(n * sizeof(bool));
+    assert(out != NULL);
+    assert(u64_bf_contains_n(bf, n, keys, out) == n);
+    for (uint32_t i = 0; i < n; i++) {
+        assert(out[i]);
+    }
+    assert(u64_bf_contains_n(bf, n, keys, NULL) == n);
+
+    /* false positive rate */
+    const uint32_t m = n < 10000 ? 100000 : 10 * n;
+    uint64_t *others = malloc(m * sizeof(uint64_t));
+    assert(others != NULL);
+    for (uint32_t i = 0; i < m; i++) {
+        others[i] = xorshift64(&state);
+    }
+
+    size_t fp_count = 0;
+    for (uint32_t i = 0; i < m; i++) {
+        fp_count += u64_bf_contains(bf, others[i]);
+    }
+    assert(fp_count == u64_bf_contains_n(bf, m, others, NULL));
+    assert((double)fp_count / m <= max_fp_rate);
+
+    u64_bf_clear(bf);
+    assert(u64_bf_contains_n(bf, n, keys, NULL) == 0);
+
+    free(others);
+    free(out);
+    free(keys);
+    u64_bf_destroy(bf);
+}
+
+static void union_test(void)
+{
+    struct u64_bf *a = u64_bf_create(1000, 16);
+    struct u64_bf *b = u64_bf_create(1000, 16);
+    assert(a != NULL && b != NULL);
+    assert(a->block_count == b->block_count);
+
+    for (uint64_t i = 0; i < 1000; i++) {
+        u64_bf_insert(i % 2 == 0 ? a : b, i);
+    }
+    u64_bf_union_with(a, b);
+
+    for (uint64_t i = 0; i < 1000; i++) {
+        assert(u64_bf_contains(a, i));
+    }
+
+    u64_bf_destroy(b);
+    u64_bf_destroy(a);
+}
+
+static void init_test(void)
+{
+    static uint8_t buf[BLOOMFILTER_BLOCK_SIZE + 4 * BLOOMFILTER_BLOCK_SIZE] __attribute__((aligned(64)));
+    assert(BLOOMFILTER_CALC_SIZEOF(u64_bf, 4) == sizeof(buf));
+
+    memset(buf, 0xff, sizeof(buf));
+    struct u64_bf *bf = u64_bf_init((struct u64_bf *)buf, 4);
+    assert(bf->block_count == 4);
+    assert(!u64_bf_contains(bf, 42));
+    u64_bf_insert(bf, 42);
+    assert(u64_bf_contains(bf, 42));
+}
+
+static void serialize_test(void)
+{
+    struct u64_bf *bf = u64_bf_create(1000, 12);
+    assert(bf != NULL);
+    for (uint64_t i = 0; i < 1000; i++) {
+        u64_bf_insert(bf, i * i);
+    }
+
+    const size_t size = BLOOMFILTER_SERIALIZED_SIZE(bf->block_count);
+    uint8_t *buf = malloc(size);
+    assert(buf != NULL);
+    assert(u64_bf_serialize(bf, buf) == size);
+
+    /* little-endian header */
+    assert(memcmp(buf, "BLMF", 4) == 0);
+    assert(buf[4] == BLOOMFILTER_VERSION && buf[5] == 0 && buf[6] == 0 && buf[7] == 0);
+    assert(buf[8] == (uint8_t)bf->block_count);
+
+    struct u64_bf *copy = u64_bf_deserialize(buf, size);
+    assert(copy != NULL);
+    assert(copy->block_count == bf->block_count);
+    assert(memcmp(copy->blocks, bf->blocks, bf->block_count * sizeof(bf->blocks[0])) == 0);
+    for (uint64_t i = 0; i < 1000; i++) {
+        assert(u64_bf_contains(copy, i * i));
+    }
+    u64_bf_destroy(copy);
+
+    assert(u64_bf_deserialize(buf, 0) == NULL);
+    assert(u64_bf_deserialize(buf, BLOOMFILTER_HEADER_SIZE) == NULL);
+    assert(u64_bf_deserialize(buf, size - 1) == NULL);
+
+    buf[0] ^= 1;
+    assert(u64_bf_deserialize(buf, size) == NULL);
+    buf[0] ^= 1;
+
+    buf[4] = BLOOMFILTER_VERSION + 1;
+    assert(u64_bf_deserialize(buf, size) == NULL);
+
+    free(buf);
+    u64_bf_destroy(bf);
+}
+
+int main(void)
+{
+    create_test();
+    insert_contains_test(1, 8, 0.01);
+    insert_contains_test(1000, 8, 0.05);
+    insert_contains_test(1000, 12, 0.02);
+    insert_contains_test(100000, 12, 0.015);
+    insert_contains_test(100000, 16, 0.005);
+    union_test();
+    init_test();
+    serialize_test();
+}
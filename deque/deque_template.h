@@ -0,0 +1,609 @@
+/*  deque_template.h
+ *
+ *  Copyright (C) 2025 abxh
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *  See the file LICENSE included with this distribution for more
+ *  information. */
+
+/**
+ * @file deque_template.h
+ * @brief Growable double-ended queue based on ring buffer
+ *
+ * Like `fqueue_template.h`, the values are stored in a ring of a power-of-2
+ * capacity, but values can be pushed and popped at both ends, and the ring
+ * grows when full:
+ *      @li The capacity is doubled, such that pushing is amortized O(1).
+ *      @li The values are unwrapped into the new ring (with at most two
+ *          `memcpy`s), such that the front is at index 0 again.
+ *
+ * The ring is allocated separately from the deque struct, such that pointers
+ * to the deque stay valid when it grows. Pointers to values do not.
+ */
+
+/**
+ * @example deque_example.c
+ * Example of how `deque_template.h` header file is used in practice.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// macro definitions: {{{
+
+/**
+ * @def PASTE(a,b)
+ * @brief Paste two tokens together.
+ */
+#ifndef PASTE
+#define PASTE(a, b) a##b
+#endif
+
+/**
+ * @def XPASTE(a,b)
+ * @brief First expand tokens, then paste them together.
+ */
+#ifndef XPASTE
+#define XPASTE(a, b) PASTE(a, b)
+#endif
+
+/**
+ * @def JOIN(a,b)
+ * @brief First expand tokens, then paste them together with a _ in between.
+ */
+#ifndef JOIN
+#define JOIN(a, b) XPASTE(a, XPASTE(_, b))
+#endif
+
+/**
+ * @def DEQUE_FOR_EACH(self, index, value)
+ * @brief Iterate over the values in the deque from the front to back.
+ *
+ * @warning Modifying the deque under the iteration may result in errors.
+ *
+ * @param[in] self              Deque pointer.
+ * @param[in] index             Temporary indexing variable. Should be `SIZE_TYPE`.
+ * @param[out] value            Current value. Should be `VALUE_TYPE`.
+ */
+#ifndef DEQUE_FOR_EACH
+#define DEQUE_FOR_EACH(self, index, value)                                                                           \
+    for ((index) = 0; (index) < (self)->count                                                                        \
+                      && ((value) = (self)->values[((self)->begin_index + (index)) & ((self)->capacity - 1)], true); \
+         (index)++)
+#endif
+
+/**
+ * @def NAME
+ * @brief Prefix to deque type and operations. This must be manually defined
+ *        before including this header file.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef NAME
+#define NAME deque
+#error "Must define NAME."
+#else
+#define DEQUE_NAME NAME
+#endif
+
+/**
+ * @def VALUE_TYPE
+ * @brief Deque value type. This must be manually defined before including this
+ *        header file.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef VALUE_TYPE
+#define VALUE_TYPE int
+#define FUNCTION_DEFINITIONS
+#define TYPE_DEFINITIONS
+#error "Must define VALUE_TYPE."
+#endif
+
+/**
+ * @def SIZE_TYPE
+ * @brief Deque count, capacity and index type. Defaults to `uint32_t`.
+ *
+ * Define as `uint64_t` (or `size_t`) for deques of more than
+ * `UINT32_MAX / 2 + 1` values. Must be an unsigned integer type.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef SIZE_TYPE
+#define SIZE_TYPE uint32_t
+#endif
+
+/**
+ * @def ALLOCATOR(ctx, size)
+ * @brief Used to allocate the memory of the deque struct and its ring.
+ *        Defaults to malloc().
+ *
+ * Is undefined once header is included.
+ *
+ * @note The memory need not be zeroed.
+ *
+ * @param ctx The context pointer given to `create_with_context` (or NULL).
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the memory, or NULL if the allocation fails.
+ */
+#if defined(ALLOCATOR) != defined(DEALLOCATOR)
+#error "Must define both ALLOCATOR and DEALLOCATOR."
+#endif
+#ifndef ALLOCATOR
+#define ALLOCATOR(ctx, size) ((void)(ctx), malloc(size))
+#endif
+
+/**
+ * @def DEALLOCATOR(ctx, ptr, size)
+ * @brief Used to free the memory of the deque struct and its ring. Defaults to
+ *        free().
+ *
+ * Is undefined once header is included.
+ *
+ * @param ctx The context pointer given to `create_with_context` (or NULL).
+ * @param ptr The pointer returned by `ALLOCATOR`.
+ * @param size The number of bytes allocated.
+ */
+#ifndef DEALLOCATOR
+#define DEALLOCATOR(ctx, ptr, size) ((void)(ctx), (void)(size), free(ptr))
+#endif
+
+/**
+ * @def FUNCTION_LINKAGE
+ * @brief Specify function linkage e.g. static inline
+ */
+#ifndef FUNCTION_LINKAGE
+#define FUNCTION_LINKAGE
+#endif
+
+/// @cond DO_NOT_DOCUMENT
+#define DEQUE_TYPE     struct DEQUE_NAME
+#define DEQUE_IS_EMPTY JOIN(DEQUE_NAME, is_empty)
+#define DEQUE_SIZE_MAX ((SIZE_TYPE)-1)
+#define DEQUE_ROUND_UP JOIN(internal, JOIN(DEQUE_NAME, round_up_pow2))
+#define DEQUE_GROW     JOIN(internal, JOIN(DEQUE_NAME, grow))
+/// @endcond
+
+// }}}
+
+// type definitions: {{{
+
+/**
+ * @def TYPE_DEFINITIONS
+ * @brief Define the types
+ */
+#ifdef TYPE_DEFINITIONS
+
+/**
+ * @brief Generated deque struct type for a `VALUE_TYPE`.
+ */
+struct DEQUE_NAME {
+    SIZE_TYPE begin_index; ///< Index used to track the front of the deque.
+    SIZE_TYPE count;       ///< Number of values.
+    SIZE_TYPE capacity;    ///< Number of values allocated for. A power of 2.
+    void *ctx;             ///< Context pointer passed to `ALLOCATOR` and `DEALLOCATOR`.
+    VALUE_TYPE *values;    ///< Ring of values.
+};
+
+#endif
+
+// }}}
+
+// function declarations: {{{
+
+/**
+ * @brief Create a deque struct with `ALLOCATOR`, with room for at least a
+ *        given number of values.
+ *
+ * @param[in] min_capacity      Minimum capacity. Rounded up to a power of 2,
+ *                              and to at least 1.
+ *
+ * @return                      A pointer to the deque.
+ * @retval NULL
+ *   @li                        If min_capacity is larger than
+ *                              `SIZE_TYPE_MAX / 2 + 1` or the equivalent size
+ *                              overflows.
+ *   @li                        If the allocation fails.
+ */
+FUNCTION_LINKAGE DEQUE_TYPE *JOIN(DEQUE_NAME, create)(const SIZE_TYPE min_capacity);
+
+/**
+ * @brief Create a deque struct with `ALLOCATOR`, given a context pointer. The
+ *        context pointer is passed to `ALLOCATOR` and `DEALLOCATOR` whenever
+ *        the deque allocates or frees memory.
+ *
+ * @param[in] min_capacity      Minimum capacity. See `create`.
+ * @param[in] ctx               The context pointer.
+ *
+ * @return                      A pointer to the deque, or NULL. See `create`.
+ */
+FUNCTION_LINKAGE DEQUE_TYPE *JOIN(DEQUE_NAME, create_with_context)(const SIZE_TYPE min_capacity, void *ctx);
+
+/**
+ * @brief Destroy a deque struct and its ring with `DEALLOCATOR`.
+ *
+ * @param[in] self              The deque pointer.
+ */
+FUNCTION_LINKAGE void JOIN(DEQUE_NAME, destroy)(DEQUE_TYPE *self);
+
+/**
+ * @brief Grow the ring, if needed, such that it has room for at least a given
+ *        number of values.
+ *
+ * @param[in] self              The deque pointer.
+ * @param[in] min_capacity      Minimum capacity.
+ *
+ * @return                      Whether there is room. False if the allocation
+ *                              fails or the capacity would overflow, in which
+ *                              case the deque is unchanged.
+ */
+FUNCTION_LINKAGE bool JOIN(DEQUE_NAME, reserve)(DEQUE_TYPE *self, const SIZE_TYPE min_capacity);
+
+/**
+ * @brief Return whether the deque is empty.
+ *
+ * @param[in] self              The deque pointer.
+ *
+ * @return                      Whether the deque is empty.
+ */
+FUNCTION_LINKAGE bool JOIN(DEQUE_NAME, is_empty)(const DEQUE_TYPE *self);
+
+/**
+ * @brief Get the value at index.
+ *
+ * @note Index starts from the front as 0 and is counted upward to count - 1
+ *       as back.
+ *
+ * @param[in] self              The deque pointer.
+ * @param[in] index             The index to retrieve a copy of the value.
+ *
+ * @return                      The value at index.
+ */
+FUNCTION_LINKAGE VALUE_TYPE JOIN(DEQUE_NAME, at)(const DEQUE_TYPE *self, const SIZE_TYPE index);
+
+/**
+ * @brief Get a pointer to the value at index, to modify it in place. Valid
+ *        until the deque grows.
+ *
+ * @param[in] self              The deque pointer.
+ * @param[in] index             The index. See `at`.
+ *
+ * @return                      A pointer to the value at index.
+ */
+FUNCTION_LINKAGE VALUE_TYPE *JOIN(DEQUE_NAME, at_ptr)(DEQUE_TYPE *self, const SIZE_TYPE index);
+
+/**
+ * @brief Get the value from the front of a non-empty deque.
+ *
+ * @param[in] self              The deque pointer.
+ *
+ * @return                      The front value.
+ */
+FUNCTION_LINKAGE VALUE_TYPE JOIN(DEQUE_NAME, get_front)(const DEQUE_TYPE *self);
+
+/**
+ * @brief Get the value from the back of a non-empty deque.
+ *
+ * @param[in] self              The deque pointer.
+ *
+ * @return                      The back value.
+ */
+FUNCTION_LINKAGE VALUE_TYPE JOIN(DEQUE_NAME, get_back)(const DEQUE_TYPE *self);
+
+/**
+ * @brief Push a value to the back of the deque, growing it when full.
+ *
+ * @param[in] self              The deque pointer.
+ * @param[in] value             The value.
+ *
+ * @return                      Whether the value was pushed. False if the
+ *                              deque was full and could not grow.
+ */
+FUNCTION_LINKAGE bool JOIN(DEQUE_NAME, push_back)(DEQUE_TYPE *self, const VALUE_TYPE value);
+
+/**
+ * @brief Push a value to the front of the deque, growing it when full.
+ *
+ * @param[in] self              The deque pointer.
+ * @param[in] value             The value.
+ *
+ * @return                      Whether the value was pushed. See `push_back`.
+ */
+FUNCTION_LINKAGE bool JOIN(DEQUE_NAME, push_front)(DEQUE_TYPE *self, const VALUE_TYPE value);
+
+/**
+ * @brief Pop a value from the back of a non-empty deque.
+ *
+ * @param[in] self              The deque pointer.
+ *
+ * @return                      The back value.
+ */
+FUNCTION_LINKAGE VALUE_TYPE JOIN(DEQUE_NAME, pop_back)(DEQUE_TYPE *self);
+
+/**
+ * @brief Pop a value from the front of a non-empty deque.
+ *
+ * @param[in] self              The deque pointer.
+ *
+ * @return                      The front value.
+ */
+FUNCTION_LINKAGE VALUE_TYPE JOIN(DEQUE_NAME, pop_front)(DEQUE_TYPE *self);
+
+/**
+ * @brief Clear the values in the deque. The capacity is kept.
+ *
+ * @param[in] self              The deque pointer.
+ */
+FUNCTION_LINKAGE void JOIN(DEQUE_NAME, clear)(DEQUE_TYPE *self);
+
+// }}}
+
+// function definitions: {{{
+
+/**
+ * @def FUNCTION_DEFINITIONS
+ * @brief Define the functions
+ */
+#ifdef FUNCTION_DEFINITIONS
+
+#include "round_up_pow2_32.h" // round_up_pow2_32
+#include "round_up_pow2_64.h" // round_up_pow2_64
+
+/// @cond DO_NOT_DOCUMENT
+static inline SIZE_TYPE JOIN(internal, JOIN(DEQUE_NAME, round_up_pow2))(const SIZE_TYPE x)
+{
+    if (sizeof(SIZE_TYPE) <= sizeof(uint32_t)) {
+        return (SIZE_TYPE)round_up_pow2_32((uint32_t)x);
+    }
+    return (SIZE_TYPE)round_up_pow2_64((uint64_t)x);
+}
+
+/* move the values into a new ring, unwrapped such that the front is at index 0 */
+static inline bool JOIN(internal, JOIN(DEQUE_NAME, grow))(DEQUE_TYPE *self, const SIZE_TYPE new_capacity)
+{
+    assert(new_capacity > self->capacity);
+
+    if ((uintmax_t)0 + new_capacity > SIZE_MAX / sizeof(VALUE_TYPE)) {
+        return false;
+    }
+
+    VALUE_TYPE *new_values = (VALUE_TYPE *)ALLOCATOR(self->ctx, (size_t)new_capacity * sizeof(VALUE_TYPE));
+
+    if (!new_values) {
+        return false;
+    }
+
+    const SIZE_TYPE until_end = self->capacity - self->begin_index;
+    const SIZE_TYPE first_n = self->count < until_end ? self->count : until_end;
+
+    memcpy(new_values, &self->values[self->begin_index], (size_t)first_n * sizeof(VALUE_TYPE));
+    memcpy(&new_values[first_n], &self->values[0], (size_t)(self->count - first_n) * sizeof(VALUE_TYPE));
+
+    DEALLOCATOR(self->ctx, self->values, (size_t)self->capacity * sizeof(VALUE_TYPE));
+
+    self->values = new_values;
+    self->capacity = new_capacity;
+    self->begin_index = 0;
+
+    return true;
+}
+/// @endcond
+
+FUNCTION_LINKAGE DEQUE_TYPE *JOIN(DEQUE_NAME, create)(const SIZE_TYPE min_capacity)
+{
+    return JOIN(DEQUE_NAME, create_with_context)(min_capacity, NULL);
+}
+
+FUNCTION_LINKAGE DEQUE_TYPE *JOIN(DEQUE_NAME, create_with_context)(const SIZE_TYPE min_capacity, void *ctx)
+{
+    if (min_capacity > DEQUE_SIZE_MAX / 2 + 1) {
+        return NULL;
+    }
+
+    const SIZE_TYPE capacity = DEQUE_ROUND_UP(min_capacity == 0 ? 1 : min_capacity);
+
+    if ((uintmax_t)0 + capacity > SIZE_MAX / sizeof(VALUE_TYPE)) {
+        return NULL;
+    }
+
+    DEQUE_TYPE *self = (DEQUE_TYPE *)ALLOCATOR(ctx, sizeof(DEQUE_TYPE));
+
+    if (!self) {
+        return NULL;
+    }
+
+    self->values = (VALUE_TYPE *)ALLOCATOR(ctx, (size_t)capacity * sizeof(VALUE_TYPE));
+
+    if (!self->values) {
+        DEALLOCATOR(ctx, self, sizeof(DEQUE_TYPE));
+        return NULL;
+    }
+
+    self->begin_index = 0;
+    self->count = 0;
+    self->capacity = capacity;
+    self->ctx = ctx;
+
+    return self;
+}
+
+FUNCTION_LINKAGE void JOIN(DEQUE_NAME, destroy)(DEQUE_TYPE *self)
+{
+    assert(self != NULL);
+
+    void *ctx = self->ctx;
+
+    DEALLOCATOR(ctx, self->values, (size_t)self->capacity * sizeof(VALUE_TYPE));
+    DEALLOCATOR(ctx, self, sizeof(DEQUE_TYPE));
+}
+
+FUNCTION_LINKAGE bool JOIN(DEQUE_NAME, reserve)(DEQUE_TYPE *self, const SIZE_TYPE min_capacity)
+{
+    assert(self != NULL);
+
+    if (min_capacity <= self->capacity) {
+        return true;
+    }
+    if (min_capacity > DEQUE_SIZE_MAX / 2 + 1) {
+        return false;
+    }
+
+    return DEQUE_GROW(self, DEQUE_ROUND_UP(min_capacity));
+}
+
+FUNCTION_LINKAGE bool JOIN(DEQUE_NAME, is_empty)(const DEQUE_TYPE *self)
+{
+    assert(self != NULL);
+
+    return self->count == 0;
+}
+
+FUNCTION_LINKAGE VALUE_TYPE JOIN(DEQUE_NAME, at)(const DEQUE_TYPE *self, const SIZE_TYPE index)
+{
+    assert(self != NULL);
+    assert(index < self->count);
+
+    const SIZE_TYPE index_mask = (self->capacity - 1);
+
+    return self->values[(self->begin_index + index) & index_mask];
+}
+
+FUNCTION_LINKAGE VALUE_TYPE *JOIN(DEQUE_NAME, at_ptr)(DEQUE_TYPE *self, const SIZE_TYPE index)
+{
+    assert(self != NULL);
+    assert(index < self->count);
+
+    const SIZE_TYPE index_mask = (self->capacity - 1);
+
+    return &self->values[(self->begin_index + index) & index_mask];
+}
+
+FUNCTION_LINKAGE VALUE_TYPE JOIN(DEQUE_NAME, get_front)(const DEQUE_TYPE *self)
+{
+    assert(self != NULL);
+    assert(!DEQUE_IS_EMPTY(self));
+
+    return self->values[self->begin_index];
+}
+
+FUNCTION_LINKAGE VALUE_TYPE JOIN(DEQUE_NAME, get_back)(const DEQUE_TYPE *self)
+{
+    assert(self != NULL);
+    assert(!DEQUE_IS_EMPTY(self));
+
+    const SIZE_TYPE index_mask = (self->capacity - 1);
+
+    return self->values[(self->begin_index + self->count - 1) & index_mask];
+}
+
+FUNCTION_LINKAGE bool JOIN(DEQUE_NAME, push_back)(DEQUE_TYPE *self, const VALUE_TYPE value)
+{
+    assert(self != NULL);
+
+    if (self->count == self->capacity) {
+        if (self->capacity > DEQUE_SIZE_MAX / 2 || !DEQUE_GROW(self, self->capacity * 2)) {
+            return false;
+        }
+    }
+
+    const SIZE_TYPE index_mask = (self->capacity - 1);
+
+    self->values[(self->begin_index + self->count) & index_mask] = value;
+    self->count++;
+
+    return true;
+}
+
+FUNCTION_LINKAGE bool JOIN(DEQUE_NAME, push_front)(DEQUE_TYPE *self, const VALUE_TYPE value)
+{
+    assert(self != NULL);
+
+    if (self->count == self->capacity) {
+        if (self->capacity > DEQUE_SIZE_MAX / 2 || !DEQUE_GROW(self, self->capacity * 2)) {
+            return false;
+        }
+    }
+
+    const SIZE_TYPE index_mask = (self->capacity - 1);
+
+    self->begin_index = (self->begin_index - 1) & index_mask;
+    self->values[self->begin_index] = value;
+    self->count++;
+
+    return true;
+}
+
+FUNCTION_LINKAGE VALUE_TYPE JOIN(DEQUE_NAME, pop_back)(DEQUE_TYPE *self)
+{
+    assert(self != NULL);
+    assert(!DEQUE_IS_EMPTY(self));
+
+    const SIZE_TYPE index_mask = (self->capacity - 1);
+
+    self->count--;
+
+    return self->values[(self->begin_index + self->count) & index_mask];
+}
+
+FUNCTION_LINKAGE VALUE_TYPE JOIN(DEQUE_NAME, pop_front)(DEQUE_TYPE *self)
+{
+    assert(self != NULL);
+    assert(!DEQUE_IS_EMPTY(self));
+
+    const SIZE_TYPE index_mask = (self->capacity - 1);
+
+    const VALUE_TYPE value = self->values[self->begin_index];
+    self->begin_index = (self->begin_index + 1) & index_mask;
+    self->count--;
+
+    return value;
+}
+
+FUNCTION_LINKAGE void JOIN(DEQUE_NAME, clear)(DEQUE_TYPE *self)
+{
+    assert(self != NULL);
+
+    self->begin_index = 0;
+    self->count = 0;
+}
+
+#endif
+
+// }}}
+
+// macro undefs: {{{
+
+#undef NAME
+#undef VALUE_TYPE
+#undef SIZE_TYPE
+#undef ALLOCATOR
+#undef DEALLOCATOR
+#undef FUNCTION_LINKAGE
+#undef FUNCTION_DEFINITIONS
+#undef TYPE_DEFINITIONS
+
+#undef DEQUE_NAME
+#undef DEQUE_TYPE
+#undef DEQUE_IS_EMPTY
+#undef DEQUE_SIZE_MAX
+#undef DEQUE_ROUND_UP
+#undef DEQUE_GROW
+
+// }}}
+
+#ifdef __cplusplus
+}
+#endif
+
+// vim: ft=c fdm=marker
@@ -0,0 +1,74 @@
+#include <assert.h>
+#include <stdio.h>
+
+#define NAME       int_deque
+#define VALUE_TYPE int
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "deque_template.h"
+
+#define WINDOW_SIZE (3)
+
+// sliding window maximum: the deque holds the indices of decreasing values
+static void print_window_maxima(const int *values, const int count)
+{
+    struct int_deque *d = int_deque_create(WINDOW_SIZE);
+    if (!d) {
+        assert(false);
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        while (!int_deque_is_empty(d) && values[int_deque_get_back(d)] <= values[i]) {
+            int_deque_pop_back(d);
+        }
+        int_deque_push_back(d, i);
+
+        if (int_deque_get_front(d) <= i - WINDOW_SIZE) {
+            int_deque_pop_front(d);
+        }
+        if (i >= WINDOW_SIZE - 1) {
+            printf("%d ", values[int_deque_get_front(d)]);
+        }
+    }
+    printf("\n");
+
+    int_deque_destroy(d);
+}
+
+int main(void)
+{
+    struct int_deque *d = int_deque_create(2);
+    if (!d) {
+        assert(false);
+        return 1;
+    }
+
+    int_deque_push_back(d, 2);
+    int_deque_push_back(d, 3);
+    int_deque_push_front(d, 1);  // full: grows to a capacity of 4
+    int_deque_push_front(d, 0);
+    int_deque_push_back(d, 4);   // full: grows to a capacity of 8
+    assert(d->capacity == 8);
+
+    assert(int_deque_at(d, 2) == 2);
+    assert(int_deque_get_front(d) == 0);
+    assert(int_deque_get_back(d) == 4);
+
+    uint32_t index;
+    int value;
+    DEQUE_FOR_EACH(d, index, value)
+    {
+        assert(value == (int)index);
+    }
+
+    assert(int_deque_pop_front(d) == 0);
+    assert(int_deque_pop_back(d) == 4);
+    assert(d->count == 3);
+
+    int_deque_destroy(d);
+
+    const int values[] = {1, 3, -1, -3, 5, 3, 6, 7};
+    print_window_maxima(values, sizeof(values) / sizeof(values[0])); // 3 3 5 5 6 7
+}
@@ -0,0 +1,228 @@
+/*
+    Test cases:
+    - Create:
+      - The capacity is rounded up to a power of 2, and to at least 1
+      - Too large capacities are rejected
+    - Both ends:
+      - push_front / push_back / pop_front / pop_back / get_front / get_back / at
+        against an array model, with random operations
+      - at_ptr modifies in place
+      - DEQUE_FOR_EACH iterates from front to back
+      - clear
+    - Growth:
+      - Order is preserved when growing with the values wrapped around the end
+        of the ring, and with the values not wrapped
+      - reserve grows to the next power of 2, and keeps a larger capacity
+      - A failed allocation leaves the deque unchanged
+      - create_with_context passes the context, and every allocation is freed
+*/
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define NAME       i32_deque
+#define VALUE_TYPE int32_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "deque_template.h"
+
+struct alloc_stats {
+    size_t allocated_size;
+    size_t freed_size;
+    size_t fail_above_size;
+};
+
+static void *counting_alloc(struct alloc_stats *stats, const size_t size)
+{
+    if (size > stats->fail_above_size) {
+        return NULL;
+    }
+    stats->allocated_size += size;
+    return malloc(size);
+}
+
+static void counting_free(struct alloc_stats *stats, void *ptr, const size_t size)
+{
+    stats->freed_size += size;
+    free(ptr);
+}
+
+#define NAME                        i32_deque_ctx
+#define VALUE_TYPE                  int32_t
+#define ALLOCATOR(ctx, size)        counting_alloc((ctx), (size))
+#define DEALLOCATOR(ctx, ptr, size) counting_free((ctx), (ptr), (size))
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "deque_template.h"
+
+#define RANDOM_OPERATION_COUNT (100000)
+#define MODEL_SIZE             (2 * RANDOM_OPERATION_COUNT + 1)
+
+static void create_test(void)
+{
+    struct i32_deque *d = i32_deque_create(0);
+    assert(d != NULL);
+    assert(d->capacity == 1 && d->count == 0);
+    assert(i32_deque_is_empty(d));
+    i32_deque_destroy(d);
+
+    d = i32_deque_create(5);
+    assert(d != NULL);
+    assert(d->capacity == 8);
+    i32_deque_destroy(d);
+
+    assert(i32_deque_create(UINT32_MAX / 2 + 2) == NULL);
+}
+
+static void both_ends_test(void)
+{
+    struct i32_deque *d = i32_deque_create(1);
+    assert(d != NULL);
+
+    /* the model holds the values from index model_begin to model_end, starting in the middle */
+    int32_t *model = malloc(MODEL_SIZE * sizeof(int32_t));
+    assert(model != NULL);
+    uint32_t model_begin = MODEL_SIZE / 2, model_end = MODEL_SIZE / 2;
+
+    srand(42);
+    for (int32_t i = 0; i < RANDOM_OPERATION_COUNT; i++) {
+        switch (rand() % 6) {
+        case 0:
+        case 1:
+            assert(i32_deque_push_back(d, i));
+            model[model_end++] = i;
+            break;
+        case 2:
+        case 3:
+            assert(i32_deque_push_front(d, i));
+            model[--model_begin] = i;
+            break;
+        case 4:
+            if (model_begin != model_end) {
+                assert(i32_deque_pop_back(d) == model[--model_end]);
+            }
+            break;
+        case 5:
+            if (model_begin != model_end) {
+                assert(i32_deque_pop_front(d) == model[model_begin++]);
+            }
+            break;
+        }
+        assert(d->count == model_end - model_begin);
+        if (d->count != 0) {
+            assert(i32_deque_get_front(d) == model[model_begin]);
+            assert(i32_deque_get_back(d) == model[model_end - 1]);
+            const uint32_t index = (uint32_t)rand() % d->count;
+            assert(i32_deque_at(d, index) == model[model_begin + index]);
+        }
+    }
+    assert(d->count > 0);
+
+    uint32_t index;
+    int32_t value;
+    DEQUE_FOR_EACH(d, index, value)
+    {
+        assert(value == model[model_begin + index]);
+    }
+    assert(index == d->count);
+
+    *i32_deque_at_ptr(d, 0) = -1;
+    assert(i32_deque_get_front(d) == -1);
+
+    const uint32_t capacity = d->capacity;
+    i32_deque_clear(d);
+    assert(i32_deque_is_empty(d));
+    assert(d->capacity == capacity);
+    assert(i32_deque_push_front(d, 7));
+    assert(i32_deque_get_back(d) == 7);
+
+    free(model);
+    i32_deque_destroy(d);
+}
+
+static void growth_test(void)
+{
+    /* wrapped: push_front wraps the front around the end of the ring */
+    struct i32_deque *d = i32_deque_create(4);
+    assert(d != NULL);
+    assert(i32_deque_push_back(d, 2));
+    assert(i32_deque_push_back(d, 3));
+    assert(i32_deque_push_front(d, 1));
+    assert(i32_deque_push_front(d, 0));
+    assert(d->capacity == 4 && d->begin_index == 2);
+
+    assert(i32_deque_push_back(d, 4));
+    assert(d->capacity == 8 && d->begin_index == 0);
+    for (int32_t i = 0; i < 5; i++) {
+        assert(d->values[i] == i);
+    }
+
+    /* not wrapped */
+    i32_deque_clear(d);
+    for (int32_t i = 0; i < 8; i++) {
+        assert(i32_deque_push_back(d, i));
+    }
+    assert(i32_deque_push_front(d, -1));
+    assert(d->capacity == 16);
+    for (uint32_t i = 0; i < 9; i++) {
+        assert(i32_deque_at(d, i) == (int32_t)i - 1);
+    }
+
+    assert(i32_deque_reserve(d, 8));
+    assert(d->capacity == 16);
+    assert(i32_deque_reserve(d, 33));
+    assert(d->capacity == 64);
+    for (uint32_t i = 0; i < 9; i++) {
+        assert(i32_deque_at(d, i) == (int32_t)i - 1);
+    }
+    assert(!i32_deque_reserve(d, UINT32_MAX));
+    assert(d->capacity == 64);
+
+    i32_deque_destroy(d);
+}
+
+static void context_test(void)
+{
+    struct alloc_stats stats = {0, 0, SIZE_MAX};
+
+    struct i32_deque_ctx *d = i32_deque_ctx_create_with_context(2, &stats);
+    assert(d != NULL && d->ctx == &stats);
+    assert(stats.allocated_size == sizeof(struct i32_deque_ctx) + 2 * sizeof(int32_t));
+
+    for (int32_t i = 0; i < 100; i++) {
+        assert(i32_deque_ctx_push_back(d, i));
+    }
+    assert(d->capacity == 128);
+
+    /* failing to grow leaves the deque unchanged */
+    stats.fail_above_size = 128 * sizeof(int32_t);
+    for (int32_t i = 100; i < 128; i++) {
+        assert(i32_deque_ctx_push_front(d, i));
+    }
+    assert(!i32_deque_ctx_push_back(d, 128));
+    assert(!i32_deque_ctx_push_front(d, 128));
+    assert(!i32_deque_ctx_reserve(d, 129));
+    assert(d->count == 128 && d->capacity == 128);
+    assert(i32_deque_ctx_get_front(d) == 127);
+    assert(i32_deque_ctx_get_back(d) == 99);
+
+    i32_deque_ctx_destroy(d);
+    assert(stats.allocated_size == stats.freed_size);
+
+    /* failing to allocate the ring frees the struct */
+    stats.fail_above_size = sizeof(struct i32_deque_ctx);
+    assert(i32_deque_ctx_create_with_context(1024, &stats) == NULL);
+    assert(stats.allocated_size == stats.freed_size);
+}
+
+int main(void)
+{
+    create_test();
+    both_ends_test();
+    growth_test();
+    context_test();
+}
@@ -0,0 +1,332 @@
+/*  cuckoofilter.h
+ *
+ *  Copyright (C) 2025 abxh
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *  See the file LICENSE included with this distribution for more
+ *  information. */
+
+/**
+ * @file cuckoofilter.h
+ * @brief Cuckoo filter over 32-bit hashes
+ *
+ * Approximate set membership with deletion support. A query answers either
+ * "definitely not contained" or "possibly contained". Buckets hold 4 16-bit
+ * fingerprints, so a query inspects at most two 8-byte buckets.
+ *
+ * The filter stores hashes rather than keys, such that it can be put in front
+ * of a hashtable with the hashes the hashtable already computes. See
+ * `LOOKUP_FILTER` in `fhashtable_template.h`.
+ *
+ * @note Only delete hashes which were previously inserted.
+ *
+ * @note Should a fingerprint be lost because the filter is overfilled, the
+ *       filter becomes saturated, and answers "possibly contained" to every
+ *       query until it is cleared.
+ *
+ * Source(s) used:
+ *  @li https://www.cs.cmu.edu/~dga/papers/cuckoo-conext2014.pdf
+ *  @li https://graphics.stanford.edu/~seander/bithacks.html#ZeroInWord
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "murmurhash.h"       // murmur3_32
+#include "round_up_pow2_32.h" // round_up_pow2_32
+
+/**
+ * @def CUCKOOFILTER_BUCKET_SIZE
+ * @brief Number of fingerprints per bucket.
+ */
+#define CUCKOOFILTER_BUCKET_SIZE (4)
+
+/**
+ * @def CUCKOOFILTER_MAX_KICKS
+ * @brief Maximum number of relocations tried by an insertion.
+ */
+#define CUCKOOFILTER_MAX_KICKS (500)
+
+/**
+ * @brief Cuckoo filter struct.
+ */
+struct cuckoofilter {
+    uint32_t count;                               ///< Number of fingerprints stored.
+    uint32_t bucket_count;                        ///< Number of buckets. A power of 2.
+    uint32_t kick_index;                          ///< Rotating slot index used for relocations.
+    uint32_t victim_index;                        ///< Bucket index of the stashed fingerprint.
+    uint16_t victim_fingerprint;                  ///< Fingerprint which could not be placed (0 if none).
+    bool is_saturated;                            ///< Whether a fingerprint was lost.
+    uint16_t buckets[][CUCKOOFILTER_BUCKET_SIZE]; ///< Array of buckets. 0 flags an empty slot.
+};
+
+/// @cond DO_NOT_DOCUMENT
+static inline uint16_t internal_cuckoofilter_fingerprint(const uint32_t hash)
+{
+    const uint32_t h = murmur3_32((const uint8_t *)&hash, sizeof(uint32_t), 0x9747b28c);
+    const uint16_t fingerprint = (uint16_t)(h >> 16);
+
+    return fingerprint == 0 ? 1 : fingerprint;
+}
+
+static inline uint32_t internal_cuckoofilter_index(const struct cuckoofilter *self, const uint32_t hash)
+{
+    return murmur3_32((const uint8_t *)&hash, sizeof(uint32_t), 0x5bd1e995) & (self->bucket_count - 1);
+}
+
+static inline uint32_t internal_cuckoofilter_alt_index(const struct cuckoofilter *self, const uint32_t index,
+                                                       const uint16_t fingerprint)
+{
+    const uint32_t h = murmur3_32((const uint8_t *)&fingerprint, sizeof(uint16_t), 0);
+
+    return (index ^ h) & (self->bucket_count - 1);
+}
+
+static inline bool internal_cuckoofilter_bucket_contains(const struct cuckoofilter *self, const uint32_t index,
+                                                         const uint16_t fingerprint)
+{
+    uint64_t bucket;
+    memcpy(&bucket, self->buckets[index], sizeof(uint64_t));
+
+    /* check all four 16-bit lanes at once: a lane is zero iff it equals the fingerprint */
+    const uint64_t x = bucket ^ (fingerprint * UINT64_C(0x0001000100010001));
+
+    return ((x - UINT64_C(0x0001000100010001)) & ~x & UINT64_C(0x8000800080008000)) != 0;
+}
+
+static inline bool internal_cuckoofilter_bucket_insert(struct cuckoofilter *self, const uint32_t index,
+                                                       const uint16_t fingerprint)
+{
+    for (uint32_t i = 0; i < CUCKOOFILTER_BUCKET_SIZE; i++) {
+        if (self->buckets[index][i] == 0) {
+            self->buckets[index][i] = fingerprint;
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline bool internal_cuckoofilter_bucket_delete(struct cuckoofilter *self, const uint32_t index,
+                                                       const uint16_t fingerprint)
+{
+    for (uint32_t i = 0; i < CUCKOOFILTER_BUCKET_SIZE; i++) {
+        if (self->buckets[index][i] == fingerprint) {
+            self->buckets[index][i] = 0;
+            return true;
+        }
+    }
+    return false;
+}
+/// @endcond
+
+/**
+ * @brief Calculate the size of the cuckoo filter struct. No overflow checks.
+ *
+ * @param[in] bucket_count      Number of buckets.
+ *
+ * @return                      The equivalent size.
+ */
+static inline size_t cuckoofilter_calc_sizeof(const uint32_t bucket_count)
+{
+    return offsetof(struct cuckoofilter, buckets) + bucket_count * sizeof(((struct cuckoofilter *)0)->buckets[0]);
+}
+
+/**
+ * @brief Clear the cuckoo filter.
+ *
+ * @param[in] self              The cuckoo filter pointer.
+ */
+static inline void cuckoofilter_clear(struct cuckoofilter *self)
+{
+    assert(self != NULL);
+
+    self->count = 0;
+    self->kick_index = 0;
+    self->victim_index = 0;
+    self->victim_fingerprint = 0;
+    self->is_saturated = false;
+
+    memset(self->buckets, 0, self->bucket_count * sizeof(self->buckets[0]));
+}
+
+/**
+ * @brief Create a cuckoo filter sized for a given number of hashes with
+ *        malloc().
+ *
+ * The load factor is kept below 50%, where insertions practically never fail.
+ *
+ * @param[in] max_count         Maximum number of hashes expected to be stored.
+ *
+ * @return                      A pointer to the cuckoo filter.
+ * @retval NULL
+ *   @li                        If malloc fails.
+ *   @li                        If max_count is 0 or larger than UINT32_MAX / 2 + 1.
+ */
+static inline struct cuckoofilter *cuckoofilter_create(const uint32_t max_count)
+{
+    if (max_count == 0 || max_count > UINT32_MAX / 2 + 1) {
+        return NULL;
+    }
+
+    const uint32_t bucket_count = round_up_pow2_32((max_count + CUCKOOFILTER_BUCKET_SIZE / 2 - 1)
+                                                   / (CUCKOOFILTER_BUCKET_SIZE / 2));
+
+    struct cuckoofilter *self = (struct cuckoofilter *)malloc(cuckoofilter_calc_sizeof(bucket_count));
+
+    if (!self) {
+        return NULL;
+    }
+
+    self->bucket_count = bucket_count;
+    cuckoofilter_clear(self);
+
+    return self;
+}
+
+/**
+ * @brief Destroy a cuckoo filter and free the underlying memory with free().
+ *
+ * @param[in] self              The cuckoo filter pointer.
+ */
+static inline void cuckoofilter_destroy(struct cuckoofilter *self)
+{
+    assert(self != NULL);
+
+    free(self);
+}
+
+/**
+ * @brief Check whether a hash is possibly contained in the cuckoo filter.
+ *
+ * @param[in] self              The cuckoo filter pointer.
+ * @param[in] hash              The hash.
+ *
+ * @retval false                If the hash is definitely not contained.
+ * @retval true                 If the hash is possibly contained.
+ */
+static inline bool cuckoofilter_contains(const struct cuckoofilter *self, const uint32_t hash)
+{
+    assert(self != NULL);
+
+    const uint16_t fingerprint = internal_cuckoofilter_fingerprint(hash);
+    const uint32_t i1 = internal_cuckoofilter_index(self, hash);
+    const uint32_t i2 = internal_cuckoofilter_alt_index(self, i1, fingerprint);
+
+    const bool is_victim =
+        self->victim_fingerprint == fingerprint && (self->victim_index == i1 || self->victim_index == i2);
+
+    return internal_cuckoofilter_bucket_contains(self, i1, fingerprint)
+           || internal_cuckoofilter_bucket_contains(self, i2, fingerprint) || is_victim || self->is_saturated;
+}
+
+/**
+ * @brief Insert a hash into the cuckoo filter. Allows duplicates.
+ *
+ * @param[in] self              The cuckoo filter pointer.
+ * @param[in] hash              The hash.
+ *
+ * @return                      Whether the fingerprint was placed without
+ *                              saturating the filter.
+ */
+static inline bool cuckoofilter_insert(struct cuckoofilter *self, const uint32_t hash)
+{
+    assert(self != NULL);
+
+    uint16_t fingerprint = internal_cuckoofilter_fingerprint(hash);
+    uint32_t index = internal_cuckoofilter_index(self, hash);
+
+    self->count++;
+
+    if (internal_cuckoofilter_bucket_insert(self, index, fingerprint)) {
+        return true;
+    }
+
+    index = internal_cuckoofilter_alt_index(self, index, fingerprint);
+
+    for (uint32_t kick = 0; kick < CUCKOOFILTER_MAX_KICKS; kick++) {
+        if (internal_cuckoofilter_bucket_insert(self, index, fingerprint)) {
+            return true;
+        }
+
+        /* relocate a resident fingerprint to its alternate bucket */
+        const uint32_t slot = self->kick_index++ % CUCKOOFILTER_BUCKET_SIZE;
+        const uint16_t evicted = self->buckets[index][slot];
+        self->buckets[index][slot] = fingerprint;
+
+        fingerprint = evicted;
+        index = internal_cuckoofilter_alt_index(self, index, fingerprint);
+    }
+
+    if (self->victim_fingerprint == 0) {
+        self->victim_fingerprint = fingerprint;
+        self->victim_index = index;
+        return true;
+    }
+
+    self->is_saturated = true;
+
+    return false;
+}
+
+/**
+ * @brief Delete a previously inserted hash from the cuckoo filter.
+ *
+ * @param[in] self              The cuckoo filter pointer.
+ * @param[in] hash              The hash.
+ *
+ * @return                      Whether a matching fingerprint was found.
+ */
+static inline bool cuckoofilter_delete(struct cuckoofilter *self, const uint32_t hash)
+{
+    assert(self != NULL);
+
+    const uint16_t fingerprint = internal_cuckoofilter_fingerprint(hash);
+    const uint32_t i1 = internal_cuckoofilter_index(self, hash);
+    const uint32_t i2 = internal_cuckoofilter_alt_index(self, i1, fingerprint);
+
+    bool found = self->victim_fingerprint == fingerprint && (self->victim_index == i1 || self->victim_index == i2);
+
+    if (found) {
+        self->victim_fingerprint = 0;
+    }
+    else {
+        found = internal_cuckoofilter_bucket_delete(self, i1, fingerprint)
+                || internal_cuckoofilter_bucket_delete(self, i2, fingerprint);
+    }
+
+    if (found) {
+        self->count--;
+
+        /* give the stashed fingerprint another chance */
+        if (self->victim_fingerprint != 0) {
+            const uint32_t victim_alt_index =
+                internal_cuckoofilter_alt_index(self, self->victim_index, self->victim_fingerprint);
+
+            if (internal_cuckoofilter_bucket_insert(self, self->victim_index, self->victim_fingerprint)
+                || internal_cuckoofilter_bucket_insert(self, victim_alt_index, self->victim_fingerprint)) {
+                self->victim_fingerprint = 0;
+            }
+        }
+    }
+
+    return found;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+// vim: ft=c
@@ -33,6 +33,12 @@
  *      @li `KEY_IS_EQUAL(a,b)`
  *      @li `HASH_FUNCTION(key)`
  *
+ * The following macros may be defined:
+ *      @li `TIME_TO_LIVE`
+ *      @li `LOOKUP_FILTER`
+ *      @li `ALLOCATOR(ctx,size)` and `DEALLOCATOR(ctx,ptr,size)`
+ *      @li `ARENA`
+ *
  * Source(s) used:
  *  @li https://thenumb.at/Hashtables/#robin-hood-linear-probing
  *  @li https://www.sebastiansylvan.com/post/robin-hood-hashing-should-be-your-default-hash-table-implementation/
@@ -57,6 +63,15 @@ extern "C" {
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#ifdef ARENA
+#include <stdalign.h> // alignof
+#endif
+
+#ifdef LOOKUP_FILTER
+#include "cuckoofilter.h" // struct cuckoofilter, cuckoofilter_*
+#endif
 
 // macro definitions: {{{
 
@@ -103,15 +118,31 @@ extern "C" {
 #define FHASHTABLE_EMPTY_SLOT_OFFSET (UINT32_MAX)
 #endif
 
+/**
+ * @def FHASHTABLE_NO_EXPIRY
+ * @brief Expiry timestamp used for slots that never expire. Only used with
+ *        `TIME_TO_LIVE`.
+ */
+#ifndef FHASHTABLE_NO_EXPIRY
+#define FHASHTABLE_NO_EXPIRY (UINT64_MAX)
+#endif
+
 /**
  * @def FHASHTABLE_FOR_EACH(self, index, key_, value_)
  *
  * @brief Iterate over the non-empty slots in the hashtable in arbitary order.
  *
  * @warning Modifying the hashtable under the iteration may result in errors.
+ *          Use `iter_begin` and `iter_next` to iterate incrementally while
+ *          modifying the hashtable.
+ *
+ * @note With `TIME_TO_LIVE`, expired slots which are not removed yet are
+ *       iterated over as well. Check `slots[index].expiry_time` if needed.
+ *
+ * @note With `LAZY_CLEAR`, use `FHASHTABLE_FOR_EACH_LAZY_CLEAR` instead.
  *
  * @param[in] self              Hashtable pointer.
- * @param[in] index             Temporary indexing variable. Should be `uint32_t`.
+ * @param[in] index             Temporary indexing variable. Should be `SIZE_TYPE`.
  * @param[out] key_             Current key. Should be `KEY_TYPE`.
  * @param[out] value_           Current value. Should be `VALUE_TYPE`.
  */
@@ -122,6 +153,26 @@ extern "C" {
             && ((key_) = (self)->slots[(index)].key, (value_) = (self)->slots[(index)].value, true))
 #endif
 
+/**
+ * @def FHASHTABLE_FOR_EACH_LAZY_CLEAR(self, index, key_, value_)
+ *
+ * @brief Iterate over the non-empty slots in a hashtable defined with
+ *        `LAZY_CLEAR` in arbitary order. Slots of an earlier generation are
+ *        skipped.
+ *
+ * @param[in] self              Hashtable pointer.
+ * @param[in] index             Temporary indexing variable. Should be `SIZE_TYPE`.
+ * @param[out] key_             Current key. Should be `KEY_TYPE`.
+ * @param[out] value_           Current value. Should be `VALUE_TYPE`.
+ */
+#ifndef FHASHTABLE_FOR_EACH_LAZY_CLEAR
+#define FHASHTABLE_FOR_EACH_LAZY_CLEAR(self, index, key_, value_)         \
+    for ((index) = 0; (index) < (self)->capacity; (index)++)              \
+        if ((self)->slots[(index)].offset != FHASHTABLE_EMPTY_SLOT_OFFSET \
+            && (self)->slots[(index)].generation == (self)->generation    \
+            && ((key_) = (self)->slots[(index)].key, (value_) = (self)->slots[(index)].value, true))
+#endif
+
 /**
  * @def FHASHTABLE_CALC_SIZEOF(fhashtable_name, capacity)
  *
@@ -134,7 +185,7 @@ extern "C" {
  */
 #ifndef FHASHTABLE_CALC_SIZEOF
 #define FHASHTABLE_CALC_SIZEOF(fhashtable_name, capacity) \
-    (uint32_t)(offsetof(struct fhashtable_name, slots) + capacity * sizeof(((struct fhashtable_name *)0)->slots[0]))
+    (offsetof(struct fhashtable_name, slots) + (size_t)(capacity) * sizeof(((struct fhashtable_name *)0)->slots[0]))
 #endif
 
 /**
@@ -149,8 +200,8 @@ extern "C" {
  */
 #ifndef FHASHTABLE_CALC_SIZEOF_OVERFLOWS
 #define FHASHTABLE_CALC_SIZEOF_OVERFLOWS(fhashtable_name, capacity) \
-    (capacity                                                       \
-     > (UINT32_MAX - offsetof(struct fhashtable_name, slots)) / sizeof(((struct fhashtable_name *)0)->slots[0]))
+    ((uintmax_t)0 + (capacity)                                      \
+     > (SIZE_MAX - offsetof(struct fhashtable_name, slots)) / sizeof(((struct fhashtable_name *)0)->slots[0]))
 #endif
 
 /**
@@ -222,13 +273,122 @@ extern "C" {
  * Is undefined once header is included.
  *
  * @param key The key.
- * @return The hash of the key as `uint32_t`.
+ * @return The hash of the key as `uint32_t`. Or as `uint64_t` if `SIZE_TYPE`
+ *         is 64-bit, such that more than 2^32 slots can be indexed.
  */
 #ifndef HASH_FUNCTION
 #error "Must define HASH_FUNCTION."
 #define HASH_FUNCTION(key) (0)
 #endif
 
+/**
+ * @def SIZE_TYPE
+ * @brief Hashtable count, capacity and index type. Defaults to `uint32_t`.
+ *
+ * Define as `uint64_t` (or `size_t`) for hashtables of more than
+ * `UINT32_MAX / 2 + 1` slots. Must be an unsigned integer type.
+ *
+ * Is undefined once header is included.
+ */
+#ifndef SIZE_TYPE
+#define SIZE_TYPE uint32_t
+#endif
+
+/**
+ * @def TIME_TO_LIVE
+ * @brief Store an expiry timestamp in every slot.
+ *
+ * The hashtable keeps a clock, which is advanced with `set_time`. Entries whose
+ * expiry timestamp is less than or equal to the clock are treated as absent by
+ * all lookups. They are removed lazily by the mutating operations that find
+ * them, and incrementally by `expire_step`, which examines a bounded number of
+ * slots per call.
+ *
+ * The unit of the timestamps is up to the user (e.g. seconds or ticks).
+ *
+ * @note `count` includes expired entries which are not removed yet.
+ */
+#ifdef TIME_TO_LIVE
+#endif
+
+/**
+ * @def LOOKUP_FILTER
+ * @brief Allow a cuckoo filter (see `cuckoofilter.h`) to be attached to the
+ *        hashtable with `attach_filter`.
+ *
+ * The attached filter is kept up to date by the operations inserting and
+ * removing entries. Lookups of keys which are not contained are then mostly
+ * answered by the (much smaller) filter, without probing the slots.
+ *
+ * @note Prefer this when most lookups are expected to miss and the hashtable
+ *       does not fit in the cache.
+ */
+#ifdef LOOKUP_FILTER
+#endif
+
+/**
+ * @def LAZY_CLEAR
+ * @brief Tag every slot with the generation of the hashtable it was written in.
+ *
+ * `clear` then increments the generation of the hashtable instead of flagging
+ * every slot as empty, and slots of an earlier generation are treated as
+ * empty. This makes `clear` O(1), at the cost of 4 bytes per slot. Once the
+ * generation wraps around, the slots are flagged as empty as usual.
+ *
+ * @note Prefer this when a large hashtable is cleared often while only a few
+ *       slots are used in between.
+ */
+#ifdef LAZY_CLEAR
+#endif
+
+/**
+ * @def ALLOCATOR(ctx, size)
+ * @brief Used by `create` and `create_with_context` to allocate the memory of
+ *        the hashtable. Defaults to malloc().
+ *
+ * Is undefined once header is included.
+ *
+ * @note The memory need not be zeroed. `init` initializes what is read.
+ *
+ * @param ctx The context pointer given to `create_with_context` (or NULL).
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the memory, or NULL if the allocation fails.
+ */
+#if defined(ALLOCATOR) != defined(DEALLOCATOR)
+#error "Must define both ALLOCATOR and DEALLOCATOR."
+#endif
+#ifndef ALLOCATOR
+#define ALLOCATOR(ctx, size) ((void)(ctx), malloc(size))
+#endif
+
+/**
+ * @def DEALLOCATOR(ctx, ptr, size)
+ * @brief Used by `destroy` and `destroy_with_context` to free the memory of
+ *        the hashtable. Defaults to free().
+ *
+ * Is undefined once header is included.
+ *
+ * @param ctx The context pointer given to `destroy_with_context` (or NULL).
+ * @param ptr The pointer returned by `ALLOCATOR`.
+ * @param size The number of bytes allocated.
+ */
+#ifndef DEALLOCATOR
+#define DEALLOCATOR(ctx, ptr, size) ((void)(ctx), (void)(size), free(ptr))
+#endif
+
+/**
+ * @def ARENA
+ * @brief The `NAME` of an arena defined with `arena_template.h`. Generates
+ *        `create_in_arena` if defined.
+ *
+ * The arena type and functions must be declared before including this header
+ * file.
+ *
+ * Is undefined once header is included.
+ */
+#ifdef ARENA
+#endif
+
 /**
  * @def FUNCTION_LINKAGE
  * @brief Specify function linkage e.g. static inline
@@ -241,11 +401,38 @@ extern "C" {
 #define FHASHTABLE_TYPE         struct FHASHTABLE_NAME
 #define FHASHTABLE_SLOT_TYPE    struct JOIN(FHASHTABLE_NAME, slot)
 #define FHASHTABLE_SLOT         JOIN(FHASHTABLE_NAME, slot)
+#define FHASHTABLE_ENTRY_TYPE   struct JOIN(FHASHTABLE_NAME, entry)
+#define FHASHTABLE_CURSOR_TYPE  struct JOIN(FHASHTABLE_NAME, cursor)
 #define FHASHTABLE_INIT         JOIN(FHASHTABLE_NAME, init)
 #define FHASHTABLE_IS_FULL      JOIN(FHASHTABLE_NAME, is_full)
 #define FHASHTABLE_CONTAINS_KEY JOIN(FHASHTABLE_NAME, contains_key)
 #define FHASHTABLE_SWAP_SLOTS   JOIN(internal, JOIN(FHASHTABLE_NAME, swap_slots))
 #define FHASHTABLE_BACKSHIFT    JOIN(internal, JOIN(FHASHTABLE_NAME, backshift))
+#define FHASHTABLE_REMOVE_AT    JOIN(internal, JOIN(FHASHTABLE_NAME, remove_at))
+#define FHASHTABLE_INSERT_SLOT  JOIN(internal, JOIN(FHASHTABLE_NAME, insert_slot))
+#define FHASHTABLE_UPDATE_SLOT  JOIN(internal, JOIN(FHASHTABLE_NAME, update_slot))
+#define FHASHTABLE_FILL_EMPTY   JOIN(internal, JOIN(FHASHTABLE_NAME, fill_empty))
+#define FHASHTABLE_ROUND_UP     JOIN(internal, JOIN(FHASHTABLE_NAME, round_up_pow2))
+#define FHASHTABLE_RESUME_COUNT JOIN(internal, JOIN(FHASHTABLE_NAME, resume_count))
+#define FHASHTABLE_SIZE_MAX     ((SIZE_TYPE)-1)
+#ifdef LAZY_CLEAR
+#define FHASHTABLE_SLOT_IS_EMPTY(self, index)                      \
+    ((self)->slots[(index)].offset == FHASHTABLE_EMPTY_SLOT_OFFSET \
+     || (self)->slots[(index)].generation != (self)->generation)
+#else
+#define FHASHTABLE_SLOT_IS_EMPTY(self, index) ((self)->slots[(index)].offset == FHASHTABLE_EMPTY_SLOT_OFFSET)
+#endif
+#ifdef TIME_TO_LIVE
+#define FHASHTABLE_SLOT_IS_EXPIRED(self, index) ((self)->slots[(index)].expiry_time <= (self)->current_time)
+#else
+#define FHASHTABLE_SLOT_IS_EXPIRED(self, index) (false)
+#endif
+#ifdef LOOKUP_FILTER
+#define FHASHTABLE_FILTER_EXCLUDES(self, key_hash) \
+    ((self)->filter != NULL && !cuckoofilter_contains((self)->filter, (uint32_t)(key_hash)))
+#else
+#define FHASHTABLE_FILTER_EXCLUDES(self, key_hash) (false)
+#endif
 /// @endcond
 
 // }}}
@@ -263,9 +450,15 @@ extern "C" {
  *        `VALUE_TYPE`.
  */
 struct JOIN(FHASHTABLE_NAME, slot) {
-    uint32_t offset;  ///< Offset from the ideal slot index.
-    KEY_TYPE key;     ///< The key in this slot
-    VALUE_TYPE value; ///< The value in this slot
+    uint32_t offset;      ///< Offset from the ideal slot index.
+    KEY_TYPE key;         ///< The key in this slot
+    VALUE_TYPE value;     ///< The value in this slot
+#ifdef TIME_TO_LIVE
+    uint64_t expiry_time; ///< Timestamp from which the slot is expired.
+#endif
+#ifdef LAZY_CLEAR
+    uint32_t generation;  ///< Generation of the hashtable the slot was written in.
+#endif
 };
 
 /**
@@ -273,11 +466,42 @@ struct JOIN(FHASHTABLE_NAME, slot) {
  *        `VALUE_TYPE`.
  */
 struct FHASHTABLE_NAME {
-    uint32_t count;               ///< Number of non-empty slots.
-    uint32_t capacity;            ///< Number of slots.
+    SIZE_TYPE count;              ///< Number of non-empty slots.
+    SIZE_TYPE capacity;           ///< Number of slots.
+#ifdef TIME_TO_LIVE
+    SIZE_TYPE sweep_index;        ///< Slot index `expire_step` resumes from.
+    uint64_t current_time;        ///< Current time of the hashtable clock.
+#endif
+#ifdef LOOKUP_FILTER
+    struct cuckoofilter *filter;  ///< Attached filter (or NULL).
+#endif
+#ifdef LAZY_CLEAR
+    uint32_t generation;          ///< Current generation. Incremented by `clear`.
+#endif
     FHASHTABLE_SLOT_TYPE slots[]; ///< Array of slots.
 };
 
+/**
+ * @brief Generated hashtable entry struct type yielded by `iter_next`.
+ */
+struct JOIN(FHASHTABLE_NAME, entry) {
+    KEY_TYPE key;     ///< The key of the entry.
+    VALUE_TYPE value; ///< The value of the entry.
+};
+
+/**
+ * @brief Generated hashtable cursor struct type used to resume an iteration.
+ *
+ * Entries are visited in the order of their ideal slot index, which is
+ * preserved by robin hood insertion and backshift deletion. Entries with the
+ * same ideal slot index are visited in the order they were inserted.
+ */
+struct JOIN(FHASHTABLE_NAME, cursor) {
+    SIZE_TYPE home_index; ///< Ideal slot index of the entries to visit next.
+    uint32_t skip_count;  ///< Number of entries already visited with the ideal slot index.
+    KEY_TYPE last_key;    ///< Key of the last entry visited, if `skip_count` is non-zero.
+};
+
 #endif
 
 // }}}
@@ -290,24 +514,39 @@ struct FHASHTABLE_NAME {
  * @param[in] self              Hashtable pointer
  * @param[in] pow2_capacity     Power of 2 capacity.
  */
-FUNCTION_LINKAGE FHASHTABLE_TYPE *JOIN(FHASHTABLE_NAME, init)(FHASHTABLE_TYPE *self, const uint32_t pow2_capacity);
+FUNCTION_LINKAGE FHASHTABLE_TYPE *JOIN(FHASHTABLE_NAME, init)(FHASHTABLE_TYPE *self, const SIZE_TYPE pow2_capacity);
 
 /**
- * @brief Create an hashtable with a given capacity with malloc().
+ * @brief Create an hashtable with a given capacity with `ALLOCATOR`.
  *
  * @param[in] min_capacity      Maximum number of elements to be stored.
  *
  * @return                      A pointer to the queue.
  * @retval NULL
- *   @li                        If malloc fails.
- *   @li                        If capacity is equal to 0 or larger than UINT32_MAX / 2 + 1 or the equivalent size
- *                              overflows.
+ *   @li                        If the allocation fails.
+ *   @li                        If capacity is equal to 0 or larger than the maximum of `SIZE_TYPE` / 2 + 1 or the
+ *                              equivalent size overflows.
  */
-FUNCTION_LINKAGE FHASHTABLE_TYPE *JOIN(FHASHTABLE_NAME, create)(const uint32_t min_capacity);
+FUNCTION_LINKAGE FHASHTABLE_TYPE *JOIN(FHASHTABLE_NAME, create)(const SIZE_TYPE min_capacity);
+
+/**
+ * @brief Create a hashtable struct with a given capacity with `ALLOCATOR`, given
+ *        a context pointer.
+ *
+ * @param[in] min_capacity      Maximum number of elements to be stored.
+ * @param[in] ctx               The context pointer passed to `ALLOCATOR`.
+ *
+ * @return                      A pointer to the queue.
+ * @retval NULL
+ *   @li                        If the allocation fails.
+ *   @li                        If capacity is equal to 0 or larger than the maximum of `SIZE_TYPE` / 2 + 1 or the
+ *                              equivalent size overflows.
+ */
+FUNCTION_LINKAGE FHASHTABLE_TYPE *JOIN(FHASHTABLE_NAME, create_with_context)(const SIZE_TYPE min_capacity, void *ctx);
 
 /**
  * @brief Destroy an hashtable struct and free the underlying memory with
- *        free().
+ *        `DEALLOCATOR`.
  *
  * @warning May not be called twice in a row on the same object.
  *
@@ -315,6 +554,39 @@ FUNCTION_LINKAGE FHASHTABLE_TYPE *JOIN(FHASHTABLE_NAME, create)(const uint32_t m
  */
 FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, destroy)(FHASHTABLE_TYPE *self);
 
+/**
+ * @brief Destroy a hashtable struct and free the underlying memory with
+ *        `DEALLOCATOR`, given a context pointer.
+ *
+ * @warning May not be called twice in a row on the same object.
+ *
+ * @param[in] self              The hashtable pointer.
+ * @param[in] ctx               The context pointer passed to `DEALLOCATOR`.
+ */
+FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, destroy_with_context)(FHASHTABLE_TYPE *self, void *ctx);
+
+#ifdef ARENA
+
+/**
+ * @brief Create a hashtable struct with a given capacity in an arena.
+ *
+ * The hashtable is freed along with the arena memory, and must not be
+ * destroyed.
+ *
+ * @param[in] arena_ptr         The arena pointer.
+ * @param[in] min_capacity      Maximum number of elements to be stored.
+ *
+ * @return                      A pointer to the queue.
+ * @retval NULL
+ *   @li                        If the arena is out of memory.
+ *   @li                        If capacity is equal to 0 or larger than the maximum of `SIZE_TYPE` / 2 + 1 or the
+ *                              equivalent size overflows.
+ */
+FUNCTION_LINKAGE FHASHTABLE_TYPE *JOIN(FHASHTABLE_NAME, create_in_arena)(struct ARENA *arena_ptr,
+                                                                         const SIZE_TYPE min_capacity);
+
+#endif
+
 /**
  * @brief Return whether the hashtable is empty.
  *
@@ -422,6 +694,9 @@ FUNCTION_LINKAGE bool JOIN(FHASHTABLE_NAME, delete)(FHASHTABLE_TYPE *self, const
 /**
  * @brief Clear an existing hashtable and flag all slots as empty.
  *
+ * With `LAZY_CLEAR`, this is O(1) and the slots are only flagged as empty
+ * once in every 2^32 calls.
+ *
  * @param[in] self              The pointer of the hashtable to clear.
  */
 FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, clear)(FHASHTABLE_TYPE *self);
@@ -435,6 +710,112 @@ FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, clear)(FHASHTABLE_TYPE *self);
 FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, copy)(FHASHTABLE_TYPE *restrict dest_ptr,
                                                   const FHASHTABLE_TYPE *restrict src_ptr);
 
+/**
+ * @brief Get a cursor positioned at the beginning of the hashtable.
+ *
+ * @param[in] self              The hashtable pointer.
+ *
+ * @return                      The cursor.
+ */
+FUNCTION_LINKAGE FHASHTABLE_CURSOR_TYPE JOIN(FHASHTABLE_NAME, iter_begin)(const FHASHTABLE_TYPE *self);
+
+/**
+ * @brief Copy at most `n` entries to `out`, starting from where the cursor
+ *        is positioned, and advance the cursor past them.
+ *
+ * The hashtable may be modified in between the calls. Each entry which is
+ * contained in the hashtable during the whole iteration is yielded at least
+ * once. Entries inserted or deleted during the iteration may or may not be
+ * yielded.
+ *
+ * If the iteration stopped within the entries of an ideal slot index, it is
+ * resumed after the last yielded key. If that key was deleted, the entries of
+ * the ideal slot index are yielded again from the first.
+ *
+ * @warning If the last yielded key is deleted and inserted again in between
+ *          the calls, entries with the same ideal slot index may be skipped.
+ *
+ * @param[in] self              The hashtable pointer.
+ * @param[in,out] cursor_ptr    The cursor pointer.
+ * @param[in] n                 Maximum number of entries to yield.
+ * @param[out] out              Array of at least `n` entries.
+ *
+ * @return                      The number of entries yielded.
+ * @retval 0                    If the iteration is finished (and `n` is non-zero).
+ */
+FUNCTION_LINKAGE uint32_t JOIN(FHASHTABLE_NAME, iter_next)(const FHASHTABLE_TYPE *self,
+                                                           FHASHTABLE_CURSOR_TYPE *cursor_ptr, const uint32_t n,
+                                                           FHASHTABLE_ENTRY_TYPE *out);
+
+#ifdef LOOKUP_FILTER
+
+/**
+ * @brief Attach a cuckoo filter to the hashtable, or detach it with NULL.
+ *
+ * The filter is cleared and filled with the hashes of the current entries.
+ * The hashtable does not take ownership of the filter.
+ *
+ * @param[in] self              The hashtable pointer.
+ * @param[in] filter            The cuckoo filter pointer, sized for at least
+ *                              `capacity` hashes (or NULL).
+ */
+FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, attach_filter)(FHASHTABLE_TYPE *self, struct cuckoofilter *filter);
+
+#endif
+
+#ifdef TIME_TO_LIVE
+
+/**
+ * @brief Advance the hashtable clock. Entries with an expiry timestamp less
+ *        than or equal to `current_time` are expired from now on.
+ *
+ * @param[in] self              The hashtable pointer.
+ * @param[in] current_time      The current time.
+ */
+FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, set_time)(FHASHTABLE_TYPE *self, const uint64_t current_time);
+
+/**
+ * @brief Insert a non-duplicate key and it's corresponding value inside the
+ *        hashtable, which expires at a given timestamp.
+ *
+ * An expired entry with the same key is replaced.
+ *
+ * @param[in] self              The hashtable pointer.
+ * @param[in] key               The key.
+ * @param[in] value             The value.
+ * @param[in] expiry_time       The timestamp from which the entry is expired.
+ */
+FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, insert_with_expiry)(FHASHTABLE_TYPE *self, KEY_TYPE key, VALUE_TYPE value,
+                                                                const uint64_t expiry_time);
+
+/**
+ * @brief Update a key's corresponding value and expiry timestamp inside the
+ *        hashtable. Allows duplicates.
+ *
+ * @param[in] self              The hashtable pointer.
+ * @param[in] key               The key.
+ * @param[in] value             The value.
+ * @param[in] expiry_time       The timestamp from which the entry is expired.
+ */
+FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, update_with_expiry)(FHASHTABLE_TYPE *self, KEY_TYPE key, VALUE_TYPE value,
+                                                                const uint64_t expiry_time);
+
+/**
+ * @brief Examine at most `max_slots` slots, resuming from where the previous
+ *        call stopped, and remove the expired entries found.
+ *
+ * Call this regularly (e.g. once per request) to smooth the cost of expiration
+ * over time, instead of sweeping the whole hashtable at once.
+ *
+ * @param[in] self              The hashtable pointer.
+ * @param[in] max_slots         Maximum number of slots to examine.
+ *
+ * @return                      The number of entries removed.
+ */
+FUNCTION_LINKAGE uint32_t JOIN(FHASHTABLE_NAME, expire_step)(FHASHTABLE_TYPE *self, const uint32_t max_slots);
+
+#endif
+
 // @}}}
 
 // function definitions: {{{
@@ -446,37 +827,81 @@ FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, copy)(FHASHTABLE_TYPE *restrict dest
 #ifdef FUNCTION_DEFINITIONS
 
 #include "round_up_pow2_32.h" // round_up_pow2_32
+#include "round_up_pow2_64.h" // round_up_pow2_64
 
-FUNCTION_LINKAGE FHASHTABLE_TYPE *JOIN(FHASHTABLE_NAME, init)(FHASHTABLE_TYPE *self, const uint32_t pow2_capacity)
+/// @cond DO_NOT_DOCUMENT
+
+static inline SIZE_TYPE JOIN(internal, JOIN(FHASHTABLE_NAME, round_up_pow2))(const SIZE_TYPE x)
+{
+    if (sizeof(SIZE_TYPE) <= sizeof(uint32_t)) {
+        return (SIZE_TYPE)round_up_pow2_32((uint32_t)x);
+    }
+    return (SIZE_TYPE)round_up_pow2_64((uint64_t)x);
+}
+
+/* flag the slot at index as empty and restore the robin hood invariant */
+static inline void JOIN(internal, JOIN(FHASHTABLE_NAME, remove_at))(FHASHTABLE_TYPE *self, const SIZE_TYPE index_mask,
+                                                                    const SIZE_TYPE index);
+
+/* flag all slots as empty. with the default empty slot offset, an all-0xff slot is empty, such that a single
+   (vectorized) memset can be used rather than a strided store per slot */
+static inline void JOIN(internal, JOIN(FHASHTABLE_NAME, fill_empty))(FHASHTABLE_TYPE *self)
+{
+    if (FHASHTABLE_EMPTY_SLOT_OFFSET == UINT32_MAX) {
+        memset(self->slots, 0xff, (size_t)self->capacity * sizeof(self->slots[0]));
+    }
+    else {
+        for (SIZE_TYPE i = 0; i < self->capacity; i++) {
+            self->slots[i].offset = FHASHTABLE_EMPTY_SLOT_OFFSET;
+        }
+    }
+}
+
+/// @endcond
+
+FUNCTION_LINKAGE FHASHTABLE_TYPE *JOIN(FHASHTABLE_NAME, init)(FHASHTABLE_TYPE *self, const SIZE_TYPE pow2_capacity)
 {
     assert(self);
     assert(IS_POW2(pow2_capacity));
 
     self->count = 0;
     self->capacity = pow2_capacity;
+#ifdef TIME_TO_LIVE
+    self->sweep_index = 0;
+    self->current_time = 0;
+#endif
+#ifdef LOOKUP_FILTER
+    self->filter = NULL;
+#endif
+#ifdef LAZY_CLEAR
+    self->generation = 0;
+#endif
 
-    for (uint32_t i = 0; i < self->capacity; i++) {
-        self->slots[i].offset = FHASHTABLE_EMPTY_SLOT_OFFSET;
-    }
+    FHASHTABLE_FILL_EMPTY(self);
 
     return self;
 }
 
-FUNCTION_LINKAGE FHASHTABLE_TYPE *JOIN(FHASHTABLE_NAME, create)(const uint32_t min_capacity)
+FUNCTION_LINKAGE FHASHTABLE_TYPE *JOIN(FHASHTABLE_NAME, create)(const SIZE_TYPE min_capacity)
+{
+    return JOIN(FHASHTABLE_NAME, create_with_context)(min_capacity, NULL);
+}
+
+FUNCTION_LINKAGE FHASHTABLE_TYPE *JOIN(FHASHTABLE_NAME, create_with_context)(const SIZE_TYPE min_capacity, void *ctx)
 {
-    if (min_capacity == 0 || min_capacity > UINT32_MAX / 2 + 1) {
+    if (min_capacity == 0 || min_capacity > FHASHTABLE_SIZE_MAX / 2 + 1) {
         return NULL;
     }
 
-    const uint32_t capacity = round_up_pow2_32(min_capacity);
+    const SIZE_TYPE capacity = FHASHTABLE_ROUND_UP(min_capacity);
 
     if (FHASHTABLE_CALC_SIZEOF_OVERFLOWS(FHASHTABLE_NAME, capacity)) {
         return NULL;
     }
 
-    const uint32_t size = FHASHTABLE_CALC_SIZEOF(FHASHTABLE_NAME, capacity);
+    const size_t size = FHASHTABLE_CALC_SIZEOF(FHASHTABLE_NAME, capacity);
 
-    FHASHTABLE_TYPE *self = (FHASHTABLE_TYPE *)calloc(1, size);
+    FHASHTABLE_TYPE *self = (FHASHTABLE_TYPE *)ALLOCATOR(ctx, size);
 
     if (!self) {
         return NULL;
@@ -489,11 +914,49 @@ FUNCTION_LINKAGE FHASHTABLE_TYPE *JOIN(FHASHTABLE_NAME, create)(const uint32_t m
 
 FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, destroy)(FHASHTABLE_TYPE *self)
 {
-    assert(self);
+    JOIN(FHASHTABLE_NAME, destroy_with_context)(self, NULL);
+}
 
-    free(self);
+FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, destroy_with_context)(FHASHTABLE_TYPE *self, void *ctx)
+{
+    assert(self != NULL);
+
+    DEALLOCATOR(ctx, self, FHASHTABLE_CALC_SIZEOF(FHASHTABLE_NAME, self->capacity));
 }
 
+#ifdef ARENA
+
+FUNCTION_LINKAGE FHASHTABLE_TYPE *JOIN(FHASHTABLE_NAME, create_in_arena)(struct ARENA *arena_ptr,
+                                                                         const SIZE_TYPE min_capacity)
+{
+    assert(arena_ptr != NULL);
+
+    if (min_capacity == 0 || min_capacity > FHASHTABLE_SIZE_MAX / 2 + 1) {
+        return NULL;
+    }
+
+    const SIZE_TYPE capacity = FHASHTABLE_ROUND_UP(min_capacity);
+
+    if (FHASHTABLE_CALC_SIZEOF_OVERFLOWS(FHASHTABLE_NAME, capacity)) {
+        return NULL;
+    }
+
+    const size_t size = FHASHTABLE_CALC_SIZEOF(FHASHTABLE_NAME, capacity);
+
+    FHASHTABLE_TYPE *self =
+        (FHASHTABLE_TYPE *)JOIN(ARENA, allocate_aligned_uninitialized)(arena_ptr, alignof(FHASHTABLE_TYPE), size);
+
+    if (!self) {
+        return NULL;
+    }
+
+    FHASHTABLE_INIT(self, capacity);
+
+    return self;
+}
+
+#endif
+
 FUNCTION_LINKAGE bool JOIN(FHASHTABLE_NAME, is_empty)(const FHASHTABLE_TYPE *self)
 {
     assert(self != NULL);
@@ -512,14 +975,18 @@ FUNCTION_LINKAGE bool JOIN(FHASHTABLE_NAME, contains_key)(const FHASHTABLE_TYPE
 {
     assert(self != NULL);
 
-    const uint32_t key_hash = HASH_FUNCTION(key);
-    const uint32_t index_mask = self->capacity - 1;
+    const SIZE_TYPE key_hash = (SIZE_TYPE)HASH_FUNCTION(key);
+    const SIZE_TYPE index_mask = self->capacity - 1;
 
-    uint32_t index = key_hash & index_mask;
+    SIZE_TYPE index = key_hash & index_mask;
     uint32_t max_possible_offset = 0;
 
+    if (FHASHTABLE_FILTER_EXCLUDES(self, key_hash)) {
+        return false;
+    }
+
     while (true) {
-        const bool not_empty = self->slots[index].offset != FHASHTABLE_EMPTY_SLOT_OFFSET;
+        const bool not_empty = !FHASHTABLE_SLOT_IS_EMPTY(self, index);
 
         const bool below_max = max_possible_offset <= self->slots[index].offset;
 
@@ -528,7 +995,7 @@ FUNCTION_LINKAGE bool JOIN(FHASHTABLE_NAME, contains_key)(const FHASHTABLE_TYPE
         }
 
         if (KEY_IS_EQUAL(self->slots[index].key, key)) {
-            return true;
+            return !FHASHTABLE_SLOT_IS_EXPIRED(self, index);
         }
 
         index++;
@@ -542,14 +1009,18 @@ FUNCTION_LINKAGE VALUE_TYPE *JOIN(FHASHTABLE_NAME, get_value_mut)(FHASHTABLE_TYP
 {
     assert(self != NULL);
 
-    const uint32_t key_hash = HASH_FUNCTION(key);
-    const uint32_t index_mask = self->capacity - 1;
+    const SIZE_TYPE key_hash = (SIZE_TYPE)HASH_FUNCTION(key);
+    const SIZE_TYPE index_mask = self->capacity - 1;
 
-    uint32_t index = key_hash & index_mask;
+    SIZE_TYPE index = key_hash & index_mask;
     uint32_t max_possible_offset = 0;
 
+    if (FHASHTABLE_FILTER_EXCLUDES(self, key_hash)) {
+        return NULL;
+    }
+
     while (true) {
-        const bool not_empty = self->slots[index].offset != FHASHTABLE_EMPTY_SLOT_OFFSET;
+        const bool not_empty = !FHASHTABLE_SLOT_IS_EMPTY(self, index);
 
         const bool below_max = max_possible_offset <= self->slots[index].offset;
 
@@ -558,6 +1029,10 @@ FUNCTION_LINKAGE VALUE_TYPE *JOIN(FHASHTABLE_NAME, get_value_mut)(FHASHTABLE_TYP
         }
 
         if (KEY_IS_EQUAL(self->slots[index].key, key)) {
+            if (FHASHTABLE_SLOT_IS_EXPIRED(self, index)) {
+                FHASHTABLE_REMOVE_AT(self, index_mask, index);
+                return NULL;
+            }
             return &self->slots[index].value;
         }
 
@@ -573,14 +1048,18 @@ FUNCTION_LINKAGE VALUE_TYPE JOIN(FHASHTABLE_NAME, get_value)(const FHASHTABLE_TY
 {
     assert(self != NULL);
 
-    const uint32_t key_hash = HASH_FUNCTION(key);
-    const uint32_t index_mask = self->capacity - 1;
+    const SIZE_TYPE key_hash = (SIZE_TYPE)HASH_FUNCTION(key);
+    const SIZE_TYPE index_mask = self->capacity - 1;
 
-    uint32_t index = key_hash & index_mask;
+    SIZE_TYPE index = key_hash & index_mask;
     uint32_t max_possible_offset = 0;
 
+    if (FHASHTABLE_FILTER_EXCLUDES(self, key_hash)) {
+        return default_value;
+    }
+
     while (true) {
-        const bool not_empty = self->slots[index].offset != FHASHTABLE_EMPTY_SLOT_OFFSET;
+        const bool not_empty = !FHASHTABLE_SLOT_IS_EMPTY(self, index);
 
         const bool below_max = max_possible_offset <= self->slots[index].offset;
 
@@ -589,7 +1068,7 @@ FUNCTION_LINKAGE VALUE_TYPE JOIN(FHASHTABLE_NAME, get_value)(const FHASHTABLE_TY
         }
 
         if (KEY_IS_EQUAL(self->slots[index].key, key)) {
-            return self->slots[index].value;
+            return FHASHTABLE_SLOT_IS_EXPIRED(self, index) ? default_value : self->slots[index].value;
         }
 
         index++;
@@ -613,19 +1092,23 @@ static inline void JOIN(internal, JOIN(FHASHTABLE_NAME, swap_slots))(FHASHTABLE_
 }
 /// @endcond
 
-FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, insert)(FHASHTABLE_TYPE *self, KEY_TYPE key, VALUE_TYPE value)
+/// @cond DO_NOT_DOCUMENT
+static inline void JOIN(internal, JOIN(FHASHTABLE_NAME, insert_slot))(FHASHTABLE_TYPE *self,
+                                                                      FHASHTABLE_SLOT_TYPE current_slot)
 {
     assert(self != NULL);
-    assert(FHASHTABLE_CONTAINS_KEY(self, key) == false);
 
-    const uint32_t index_mask = self->capacity - 1;
-    const uint32_t key_hash = HASH_FUNCTION(key);
+    const SIZE_TYPE index_mask = self->capacity - 1;
+    const SIZE_TYPE key_hash = (SIZE_TYPE)HASH_FUNCTION(current_slot.key);
+
+    SIZE_TYPE index = key_hash & index_mask;
 
-    uint32_t index = key_hash & index_mask;
-    FHASHTABLE_SLOT_TYPE current_slot = {.offset = 0, .key = key, .value = value};
+#ifdef LAZY_CLEAR
+    current_slot.generation = self->generation;
+#endif
 
     while (true) {
-        const bool not_empty = self->slots[index].offset != FHASHTABLE_EMPTY_SLOT_OFFSET;
+        const bool not_empty = !FHASHTABLE_SLOT_IS_EMPTY(self, index);
 
         if (!not_empty) {
             break;
@@ -641,20 +1124,30 @@ FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, insert)(FHASHTABLE_TYPE *self, KEY_T
     }
     self->slots[index] = current_slot;
     self->count++;
+
+#ifdef LOOKUP_FILTER
+    if (self->filter != NULL) {
+        cuckoofilter_insert(self->filter, (uint32_t)key_hash);
+    }
+#endif
 }
 
-FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, update)(FHASHTABLE_TYPE *self, KEY_TYPE key, VALUE_TYPE value)
+static inline void JOIN(internal, JOIN(FHASHTABLE_NAME, update_slot))(FHASHTABLE_TYPE *self,
+                                                                      FHASHTABLE_SLOT_TYPE current_slot)
 {
     assert(self != NULL);
 
-    const uint32_t index_mask = self->capacity - 1;
-    const uint32_t key_hash = HASH_FUNCTION(key);
+    const SIZE_TYPE index_mask = self->capacity - 1;
+    const SIZE_TYPE key_hash = (SIZE_TYPE)HASH_FUNCTION(current_slot.key);
+
+    SIZE_TYPE index = key_hash & index_mask;
 
-    uint32_t index = key_hash & index_mask;
-    FHASHTABLE_SLOT_TYPE current_slot = {.offset = 0, .key = key, .value = value};
+#ifdef LAZY_CLEAR
+    current_slot.generation = self->generation;
+#endif
 
     while (true) {
-        const bool not_empty = self->slots[index].offset != FHASHTABLE_EMPTY_SLOT_OFFSET;
+        const bool not_empty = !FHASHTABLE_SLOT_IS_EMPTY(self, index);
 
         if (!not_empty) {
             break;
@@ -666,6 +1159,9 @@ FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, update)(FHASHTABLE_TYPE *self, KEY_T
 
         if (offset_is_same && key_is_equal) {
             self->slots[index].value = current_slot.value;
+#ifdef TIME_TO_LIVE
+            self->slots[index].expiry_time = current_slot.expiry_time;
+#endif
             return;
         }
 
@@ -680,18 +1176,48 @@ FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, update)(FHASHTABLE_TYPE *self, KEY_T
 
     self->slots[index] = current_slot;
     self->count++;
+
+#ifdef LOOKUP_FILTER
+    if (self->filter != NULL) {
+        cuckoofilter_insert(self->filter, (uint32_t)key_hash);
+    }
+#endif
+}
+/// @endcond
+
+FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, insert)(FHASHTABLE_TYPE *self, KEY_TYPE key, VALUE_TYPE value)
+{
+#ifdef TIME_TO_LIVE
+    JOIN(FHASHTABLE_NAME, insert_with_expiry)(self, key, value, FHASHTABLE_NO_EXPIRY);
+#else
+    assert(self != NULL);
+    assert(FHASHTABLE_CONTAINS_KEY(self, key) == false);
+
+    FHASHTABLE_INSERT_SLOT(self, (FHASHTABLE_SLOT_TYPE){.offset = 0, .key = key, .value = value});
+#endif
+}
+
+FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, update)(FHASHTABLE_TYPE *self, KEY_TYPE key, VALUE_TYPE value)
+{
+#ifdef TIME_TO_LIVE
+    JOIN(FHASHTABLE_NAME, update_with_expiry)(self, key, value, FHASHTABLE_NO_EXPIRY);
+#else
+    assert(self != NULL);
+
+    FHASHTABLE_UPDATE_SLOT(self, (FHASHTABLE_SLOT_TYPE){.offset = 0, .key = key, .value = value});
+#endif
 }
 
 /// @cond DO_NOT_DOCUMENT
-static inline void JOIN(internal, JOIN(FHASHTABLE_NAME, backshift))(FHASHTABLE_TYPE *self, const uint32_t index_mask,
-                                                                    uint32_t index)
+static inline void JOIN(internal, JOIN(FHASHTABLE_NAME, backshift))(FHASHTABLE_TYPE *self, const SIZE_TYPE index_mask,
+                                                                    SIZE_TYPE index)
 {
     assert(self);
 
-    uint32_t next_index = (index + 1) & index_mask;
+    SIZE_TYPE next_index = (index + 1) & index_mask;
 
     while (true) {
-        const bool not_empty = self->slots[next_index].offset != FHASHTABLE_EMPTY_SLOT_OFFSET;
+        const bool not_empty = !FHASHTABLE_SLOT_IS_EMPTY(self, next_index);
 
         const bool offset_is_non_zero = self->slots[next_index].offset > 0;
 
@@ -708,20 +1234,42 @@ static inline void JOIN(internal, JOIN(FHASHTABLE_NAME, backshift))(FHASHTABLE_T
         next_index = (index + 1) & index_mask;
     }
 }
+
+static inline void JOIN(internal, JOIN(FHASHTABLE_NAME, remove_at))(FHASHTABLE_TYPE *self, const SIZE_TYPE index_mask,
+                                                                    const SIZE_TYPE index)
+{
+    assert(self);
+    assert(!FHASHTABLE_SLOT_IS_EMPTY(self, index));
+
+#ifdef LOOKUP_FILTER
+    if (self->filter != NULL) {
+        cuckoofilter_delete(self->filter, (uint32_t)HASH_FUNCTION(self->slots[index].key));
+    }
+#endif
+
+    self->slots[index].offset = FHASHTABLE_EMPTY_SLOT_OFFSET;
+    self->count--;
+
+    FHASHTABLE_BACKSHIFT(self, index_mask, index);
+}
 /// @endcond
 
 FUNCTION_LINKAGE bool JOIN(FHASHTABLE_NAME, delete)(FHASHTABLE_TYPE *self, const KEY_TYPE key)
 {
     assert(self != NULL);
 
-    const uint32_t index_mask = self->capacity - 1;
-    const uint32_t key_hash = HASH_FUNCTION(key);
+    const SIZE_TYPE index_mask = self->capacity - 1;
+    const SIZE_TYPE key_hash = (SIZE_TYPE)HASH_FUNCTION(key);
 
-    uint32_t index = key_hash & index_mask;
+    SIZE_TYPE index = key_hash & index_mask;
     uint32_t max_possible_offset = 0;
 
+    if (FHASHTABLE_FILTER_EXCLUDES(self, key_hash)) {
+        return false;
+    }
+
     while (true) {
-        const bool not_empty = self->slots[index].offset != FHASHTABLE_EMPTY_SLOT_OFFSET;
+        const bool not_empty = !FHASHTABLE_SLOT_IS_EMPTY(self, index);
 
         const bool below_max = max_possible_offset <= self->slots[index].offset;
 
@@ -737,12 +1285,11 @@ FUNCTION_LINKAGE bool JOIN(FHASHTABLE_NAME, delete)(FHASHTABLE_TYPE *self, const
             continue;
         }
 
-        self->slots[index].offset = FHASHTABLE_EMPTY_SLOT_OFFSET;
-        self->count--;
+        const bool is_expired = FHASHTABLE_SLOT_IS_EXPIRED(self, index);
 
-        FHASHTABLE_BACKSHIFT(self, index_mask, index);
+        FHASHTABLE_REMOVE_AT(self, index_mask, index);
 
-        return true;
+        return !is_expired;
     }
     return false;
 }
@@ -751,10 +1298,23 @@ FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, clear)(FHASHTABLE_TYPE *self)
 {
     assert(self != NULL);
 
-    for (uint32_t i = 0; i < self->capacity; i++) {
-        self->slots[i].offset = FHASHTABLE_EMPTY_SLOT_OFFSET;
+#ifdef LAZY_CLEAR
+    /* slots of an earlier generation would be considered non-empty again after a wrap-around */
+    if (++self->generation == 0) {
+        FHASHTABLE_FILL_EMPTY(self);
     }
+#else
+    FHASHTABLE_FILL_EMPTY(self);
+#endif
     self->count = 0;
+#ifdef TIME_TO_LIVE
+    self->sweep_index = 0;
+#endif
+#ifdef LOOKUP_FILTER
+    if (self->filter != NULL) {
+        cuckoofilter_clear(self->filter);
+    }
+#endif
 }
 
 FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, copy)(FHASHTABLE_TYPE *restrict dest_ptr,
@@ -765,13 +1325,208 @@ FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, copy)(FHASHTABLE_TYPE *restrict dest
     assert(src_ptr->capacity <= dest_ptr->capacity);
     assert(dest_ptr->count == 0);
 
-    uint32_t index;
-    KEY_TYPE key;
-    VALUE_TYPE value;
-    FHASHTABLE_FOR_EACH(src_ptr, index, key, value) {
-        JOIN(FHASHTABLE_NAME, insert)(dest_ptr, key, value);
+#ifdef TIME_TO_LIVE
+    dest_ptr->current_time = src_ptr->current_time;
+#endif
+
+    for (SIZE_TYPE i = 0; i < src_ptr->capacity; i++) {
+        const bool not_empty = !FHASHTABLE_SLOT_IS_EMPTY(src_ptr, i);
+
+        if (!not_empty || FHASHTABLE_SLOT_IS_EXPIRED(src_ptr, i)) {
+            continue;
+        }
+
+        FHASHTABLE_SLOT_TYPE slot = src_ptr->slots[i];
+        slot.offset = 0;
+
+        FHASHTABLE_INSERT_SLOT(dest_ptr, slot);
+    }
+}
+
+/// @cond DO_NOT_DOCUMENT
+/* number of entries to skip with the cursor's ideal slot index: the ones up to the last yielded key. entries with
+   the same ideal slot index are only appended, so the key is found at the same position or earlier (if entries
+   before it were deleted). if it is not found, it was deleted, and the entries are visited from the first again */
+static inline uint32_t JOIN(internal, JOIN(FHASHTABLE_NAME, resume_count))(const FHASHTABLE_TYPE *self,
+                                                                           const FHASHTABLE_CURSOR_TYPE *cursor_ptr)
+{
+    const SIZE_TYPE index_mask = self->capacity - 1;
+
+    SIZE_TYPE index = cursor_ptr->home_index;
+    SIZE_TYPE distance = 0;
+    uint32_t seen_count = 0;
+
+    while (distance < self->capacity && seen_count < cursor_ptr->skip_count) {
+        if (FHASHTABLE_SLOT_IS_EMPTY(self, index) || distance > self->slots[index].offset) {
+            break;
+        }
+        if (distance == self->slots[index].offset) {
+            if (KEY_IS_EQUAL(self->slots[index].key, cursor_ptr->last_key)) {
+                return seen_count + 1;
+            }
+            seen_count++;
+        }
+
+        index++;
+        index &= index_mask;
+        distance++;
     }
+
+    return 0;
 }
+/// @endcond
+
+FUNCTION_LINKAGE FHASHTABLE_CURSOR_TYPE JOIN(FHASHTABLE_NAME, iter_begin)(const FHASHTABLE_TYPE *self)
+{
+    assert(self != NULL);
+    (void)(self);
+
+    FHASHTABLE_CURSOR_TYPE cursor;
+    memset(&cursor, 0, sizeof(cursor)); // last_key is unused while skip_count is 0
+
+    return cursor;
+}
+
+FUNCTION_LINKAGE uint32_t JOIN(FHASHTABLE_NAME, iter_next)(const FHASHTABLE_TYPE *self,
+                                                           FHASHTABLE_CURSOR_TYPE *cursor_ptr, const uint32_t n,
+                                                           FHASHTABLE_ENTRY_TYPE *out)
+{
+    assert(self != NULL);
+    assert(cursor_ptr != NULL);
+    assert(n == 0 || out != NULL);
+
+    const SIZE_TYPE index_mask = self->capacity - 1;
+
+    uint32_t written_count = 0;
+
+    if (cursor_ptr->skip_count > 0) {
+        cursor_ptr->skip_count = FHASHTABLE_RESUME_COUNT(self, cursor_ptr);
+    }
+
+    while (cursor_ptr->home_index < self->capacity) {
+        SIZE_TYPE index = cursor_ptr->home_index;
+        SIZE_TYPE distance = 0;
+        uint32_t seen_count = 0;
+
+        /* the entries with the same ideal slot index are stored contiguously, after the entries displaced from
+           earlier slots and before the entries displaced from later slots */
+        while (distance < self->capacity) {
+            const bool not_empty = !FHASHTABLE_SLOT_IS_EMPTY(self, index);
+
+            const bool before_later_entries = distance <= self->slots[index].offset;
+
+            if (!(not_empty && before_later_entries)) {
+                break;
+            }
+
+            const bool is_home = distance == self->slots[index].offset;
+
+            if (is_home && seen_count >= cursor_ptr->skip_count && !FHASHTABLE_SLOT_IS_EXPIRED(self, index)) {
+                if (written_count == n) {
+                    cursor_ptr->skip_count = seen_count;
+                    return written_count;
+                }
+                out[written_count++] =
+                    (FHASHTABLE_ENTRY_TYPE){.key = self->slots[index].key, .value = self->slots[index].value};
+                cursor_ptr->last_key = self->slots[index].key;
+            }
+            seen_count += is_home;
+
+            index++;
+            index &= index_mask;
+            distance++;
+        }
+
+        cursor_ptr->home_index++;
+        cursor_ptr->skip_count = 0;
+    }
+
+    return written_count;
+}
+
+#ifdef LOOKUP_FILTER
+
+FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, attach_filter)(FHASHTABLE_TYPE *self, struct cuckoofilter *filter)
+{
+    assert(self != NULL);
+
+    self->filter = filter;
+
+    if (filter == NULL) {
+        return;
+    }
+
+    cuckoofilter_clear(filter);
+
+    for (SIZE_TYPE i = 0; i < self->capacity; i++) {
+        if (!FHASHTABLE_SLOT_IS_EMPTY(self, i)) {
+            cuckoofilter_insert(filter, (uint32_t)HASH_FUNCTION(self->slots[i].key));
+        }
+    }
+}
+
+#endif
+
+#ifdef TIME_TO_LIVE
+
+FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, set_time)(FHASHTABLE_TYPE *self, const uint64_t current_time)
+{
+    assert(self != NULL);
+
+    self->current_time = current_time;
+}
+
+FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, insert_with_expiry)(FHASHTABLE_TYPE *self, KEY_TYPE key, VALUE_TYPE value,
+                                                                const uint64_t expiry_time)
+{
+    assert(self != NULL);
+    assert(FHASHTABLE_CONTAINS_KEY(self, key) == false);
+
+    /* remove an expired entry with the same key, if not already removed */
+    JOIN(FHASHTABLE_NAME, delete)(self, key);
+
+    FHASHTABLE_INSERT_SLOT(self,
+                           (FHASHTABLE_SLOT_TYPE){.offset = 0, .key = key, .value = value, .expiry_time = expiry_time});
+}
+
+FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, update_with_expiry)(FHASHTABLE_TYPE *self, KEY_TYPE key, VALUE_TYPE value,
+                                                                const uint64_t expiry_time)
+{
+    assert(self != NULL);
+
+    FHASHTABLE_UPDATE_SLOT(self,
+                           (FHASHTABLE_SLOT_TYPE){.offset = 0, .key = key, .value = value, .expiry_time = expiry_time});
+}
+
+FUNCTION_LINKAGE uint32_t JOIN(FHASHTABLE_NAME, expire_step)(FHASHTABLE_TYPE *self, const uint32_t max_slots)
+{
+    assert(self != NULL);
+
+    const SIZE_TYPE index_mask = self->capacity - 1;
+
+    SIZE_TYPE index = self->sweep_index;
+    uint32_t removed_count = 0;
+
+    for (uint32_t i = 0; i < max_slots && self->count > 0; i++) {
+        const bool not_empty = !FHASHTABLE_SLOT_IS_EMPTY(self, index);
+
+        if (not_empty && FHASHTABLE_SLOT_IS_EXPIRED(self, index)) {
+            FHASHTABLE_REMOVE_AT(self, index_mask, index);
+            removed_count++;
+
+            /* the next entry may have been shifted into this slot */
+            continue;
+        }
+
+        index++;
+        index &= index_mask;
+    }
+    self->sweep_index = index;
+
+    return removed_count;
+}
+
+#endif
 
 #endif
 
@@ -784,6 +1539,13 @@ FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, copy)(FHASHTABLE_TYPE *restrict dest
 #undef VALUE_TYPE
 #undef KEY_IS_EQUAL
 #undef HASH_FUNCTION
+#undef SIZE_TYPE
+#undef TIME_TO_LIVE
+#undef LOOKUP_FILTER
+#undef LAZY_CLEAR
+#undef ALLOCATOR
+#undef DEALLOCATOR
+#undef ARENA
 #undef FUNCTION_LINKAGE
 #undef FUNCTION_DEFINITIONS
 #undef TYPE_DEFINITIONS
@@ -791,12 +1553,23 @@ FUNCTION_LINKAGE void JOIN(FHASHTABLE_NAME, copy)(FHASHTABLE_TYPE *restrict dest
 #undef FHASHTABLE_NAME
 #undef FHASHTABLE_TYPE
 #undef FHASHTABLE_SLOT_TYPE
+#undef FHASHTABLE_ENTRY_TYPE
+#undef FHASHTABLE_CURSOR_TYPE
 #undef FHASHTABLE_INIT
 #undef FHASHTABLE_IS_FULL
 #undef FHASHTABLE_CONTAINS_KEY
-#undef FHASHTABLE_CALC_SIZEOF
 #undef FHASHTABLE_SWAP_SLOTS
 #undef FHASHTABLE_BACKSHIFT
+#undef FHASHTABLE_REMOVE_AT
+#undef FHASHTABLE_INSERT_SLOT
+#undef FHASHTABLE_UPDATE_SLOT
+#undef FHASHTABLE_FILL_EMPTY
+#undef FHASHTABLE_ROUND_UP
+#undef FHASHTABLE_RESUME_COUNT
+#undef FHASHTABLE_SIZE_MAX
+#undef FHASHTABLE_SLOT_IS_EMPTY
+#undef FHASHTABLE_SLOT_IS_EXPIRED
+#undef FHASHTABLE_FILTER_EXCLUDES
 
 // }}}
 
@@ -20,6 +20,10 @@
 
 #pragma once
 
+/* the header is copied next to each template using it. guarded such that copies may be included together */
+#ifndef ROUND_UP_POW2_32_H
+#define ROUND_UP_POW2_32_H
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -80,4 +84,6 @@ static inline uint32_t round_up_pow2_32(uint32_t x)
 }
 #endif
 
+#endif // ROUND_UP_POW2_32_H
+
 // vim: ft=c
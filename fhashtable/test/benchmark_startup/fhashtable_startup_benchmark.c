@@ -0,0 +1,146 @@
+// Compares the time to create a large fhashtable the way it used to be done
+// (calloc, then a strided store of the empty offset into every slot) with
+// `create` (malloc, then a single memset of the slots), and the time to clear
+// it with and without `LAZY_CLEAR`. Run with `make bench`, or with
+// `make bench_large` for a table beyond 4GiB (`SIZE_TYPE` is uint64_t).
+//
+// usage: ./a.out [table size in MiB]
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "murmurhash.h"
+#include "round_up_pow2_64.h"
+
+#define NAME               u64_ht
+#define KEY_TYPE           uint64_t
+#define VALUE_TYPE         uint64_t
+#define KEY_IS_EQUAL(a, b) ((a) == (b))
+#define HASH_FUNCTION(key) (murmur3_32((uint8_t *)&(key), sizeof(uint64_t), 0))
+#define SIZE_TYPE          uint64_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fhashtable_template.h"
+
+#define NAME               u64_lazy_ht
+#define KEY_TYPE           uint64_t
+#define VALUE_TYPE         uint64_t
+#define KEY_IS_EQUAL(a, b) ((a) == (b))
+#define HASH_FUNCTION(key) (murmur3_32((uint8_t *)&(key), sizeof(uint64_t), 0))
+#define SIZE_TYPE          uint64_t
+#define LAZY_CLEAR
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fhashtable_template.h"
+
+#define REPEAT_COUNT (5)
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* previous create: every page is zeroed by calloc, then written again */
+static struct u64_ht *legacy_create(const uint64_t capacity)
+{
+    struct u64_ht *self = calloc(1, FHASHTABLE_CALC_SIZEOF(u64_ht, capacity));
+    if (!self) {
+        return NULL;
+    }
+    self->count = 0;
+    self->capacity = capacity;
+    for (uint64_t i = 0; i < capacity; i++) {
+        self->slots[i].offset = UINT32_MAX;
+    }
+    return self;
+}
+
+static void legacy_clear(struct u64_ht *self)
+{
+    self->count = 0;
+    for (uint64_t i = 0; i < self->capacity; i++) {
+        self->slots[i].offset = UINT32_MAX;
+    }
+}
+
+/* the table is touched after create, such that lazily faulted pages are paid for */
+static uint64_t touch(struct u64_ht *ht)
+{
+    u64_ht_update(ht, 42, 42);
+    return ht->count;
+}
+
+int main(int argc, char **argv)
+{
+    const size_t target_size = (argc > 1 ? strtoull(argv[1], NULL, 10) : 1024) * 1024 * 1024;
+    const uint64_t capacity = round_up_pow2_64(target_size / sizeof(struct u64_ht_slot));
+
+    printf("table of %" PRIu64 " slots (%.2f GiB), best of %d\n", capacity,
+           (double)FHASHTABLE_CALC_SIZEOF(u64_ht, capacity) / (1024 * 1024 * 1024), REPEAT_COUNT);
+
+    double legacy_create_s = 1e9, create_s = 1e9;
+    double legacy_clear_s = 1e9, clear_s = 1e9, lazy_clear_s = 1e9;
+    uint64_t checksum = 0;
+
+    for (int r = 0; r < REPEAT_COUNT; r++) {
+        double start = now_s();
+        struct u64_ht *ht = legacy_create(capacity);
+        if (!ht) {
+            fprintf(stderr, "calloc failed\n");
+            return EXIT_FAILURE;
+        }
+        checksum += touch(ht);
+        double end = now_s();
+        legacy_create_s = end - start < legacy_create_s ? end - start : legacy_create_s;
+
+        start = now_s();
+        legacy_clear(ht);
+        end = now_s();
+        legacy_clear_s = end - start < legacy_clear_s ? end - start : legacy_clear_s;
+        u64_ht_destroy(ht);
+
+        start = now_s();
+        ht = u64_ht_create(capacity);
+        if (!ht) {
+            fprintf(stderr, "malloc failed\n");
+            return EXIT_FAILURE;
+        }
+        checksum += touch(ht);
+        end = now_s();
+        create_s = end - start < create_s ? end - start : create_s;
+
+        start = now_s();
+        u64_ht_clear(ht);
+        end = now_s();
+        clear_s = end - start < clear_s ? end - start : clear_s;
+        u64_ht_destroy(ht);
+
+        struct u64_lazy_ht *lazy_ht = u64_lazy_ht_create(capacity);
+        if (!lazy_ht) {
+            fprintf(stderr, "malloc failed\n");
+            return EXIT_FAILURE;
+        }
+        u64_lazy_ht_update(lazy_ht, 42, 42);
+
+        start = now_s();
+        u64_lazy_ht_clear(lazy_ht);
+        end = now_s();
+        lazy_clear_s = end - start < lazy_clear_s ? end - start : lazy_clear_s;
+        checksum += lazy_ht->generation;
+        u64_lazy_ht_destroy(lazy_ht);
+    }
+
+    printf("calloc + strided fill: create %.3f ms, clear %.3f ms\n", legacy_create_s * 1e3, legacy_clear_s * 1e3);
+    printf("malloc + memset fill:  create %.3f ms, clear %.3f ms\n", create_s * 1e3, clear_s * 1e3);
+    printf("LAZY_CLEAR:            clear %.6f ms\n", lazy_clear_s * 1e3);
+    printf("(checksum %" PRIu64 ")\n", checksum);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,142 @@
+/*
+    Test cases:
+    - Creation:
+      - Zero / overly large counts are rejected
+    - Insertion:
+      - Inserted hashes are always reported as possibly contained
+      - Overfilling saturates the filter instead of losing hashes
+    - Deletion:
+      - Deleted hashes are reported as not contained (modulo false positives)
+    - False positives:
+      - The false positive rate stays well below 1%
+    - Clearing:
+      - A cleared filter contains nothing and is no longer saturated
+*/
+
+#include "cuckoofilter.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define N (4096)
+
+static uint32_t xorshift32(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static void creation_test(void)
+{
+    assert(cuckoofilter_create(0) == NULL);
+    assert(cuckoofilter_create(UINT32_MAX) == NULL);
+
+    struct cuckoofilter *filter = cuckoofilter_create(1);
+    assert(filter != NULL);
+    assert(filter->count == 0);
+    assert(filter->bucket_count == 1);
+    cuckoofilter_destroy(filter);
+
+    filter = cuckoofilter_create(N);
+    assert(filter != NULL);
+    assert(filter->bucket_count == N / 2);
+    cuckoofilter_destroy(filter);
+}
+
+static void insert_delete_test(void)
+{
+    struct cuckoofilter *filter = cuckoofilter_create(N);
+    assert(filter != NULL);
+
+    uint32_t state = 0x12345678;
+    uint32_t *hashes = malloc(N * sizeof(uint32_t));
+    assert(hashes != NULL);
+
+    for (uint32_t i = 0; i < N; i++) {
+        hashes[i] = xorshift32(&state);
+        assert(cuckoofilter_insert(filter, hashes[i]));
+    }
+    assert(filter->count == N);
+    assert(!filter->is_saturated);
+
+    for (uint32_t i = 0; i < N; i++) {
+        assert(cuckoofilter_contains(filter, hashes[i]));
+    }
+
+    uint32_t false_positives = 0;
+    for (uint32_t i = 0; i < 16 * N; i++) {
+        false_positives += cuckoofilter_contains(filter, xorshift32(&state));
+    }
+    assert(false_positives < 16 * N / 100);
+
+    /* delete the even ones */
+    for (uint32_t i = 0; i < N; i += 2) {
+        assert(cuckoofilter_delete(filter, hashes[i]));
+    }
+    assert(filter->count == N / 2);
+
+    for (uint32_t i = 1; i < N; i += 2) {
+        assert(cuckoofilter_contains(filter, hashes[i]));
+    }
+
+    uint32_t deleted_but_contained = 0;
+    for (uint32_t i = 0; i < N; i += 2) {
+        deleted_but_contained += cuckoofilter_contains(filter, hashes[i]);
+    }
+    assert(deleted_but_contained < N / 2 / 100);
+
+    /* duplicates are counted twice, and must be deleted twice */
+    assert(cuckoofilter_insert(filter, hashes[1]));
+    assert(cuckoofilter_delete(filter, hashes[1]));
+    assert(cuckoofilter_contains(filter, hashes[1]));
+
+    cuckoofilter_clear(filter);
+    assert(filter->count == 0);
+    for (uint32_t i = 0; i < N; i++) {
+        assert(!cuckoofilter_contains(filter, hashes[i]));
+    }
+
+    free(hashes);
+    cuckoofilter_destroy(filter);
+}
+
+static void saturation_test(void)
+{
+    struct cuckoofilter *filter = cuckoofilter_create(4);
+    assert(filter != NULL);
+
+    const uint32_t capacity = filter->bucket_count * CUCKOOFILTER_BUCKET_SIZE;
+
+    uint32_t state = 0xdeadbeef;
+    uint32_t hashes[64];
+    for (uint32_t i = 0; i < 64; i++) {
+        hashes[i] = xorshift32(&state);
+        cuckoofilter_insert(filter, hashes[i]);
+    }
+    assert(filter->count == 64);
+    assert(64 > capacity + 1);
+    assert(filter->is_saturated);
+
+    /* no false negatives, even when overfilled */
+    for (uint32_t i = 0; i < 64; i++) {
+        assert(cuckoofilter_contains(filter, hashes[i]));
+    }
+
+    cuckoofilter_clear(filter);
+    assert(!filter->is_saturated);
+    assert(!cuckoofilter_contains(filter, hashes[0]));
+
+    cuckoofilter_destroy(filter);
+}
+
+int main(void)
+{
+    creation_test();
+    insert_delete_test();
+    saturation_test();
+}
@@ -25,6 +25,8 @@
     - create
     - destroy
     - copy
+    - create_with_context + destroy_with_context (custom ALLOCATOR / DEALLOCATOR)
+    - create_in_arena
 
     Key / value types => KEY_IS_EQUAL():
     - scalar [numeric / pointers] => (==)
@@ -42,6 +44,33 @@
     - <50%
     - <75%
     - <100%
+
+    Time to live:
+    - set_time + insert_with_expiry + update_with_expiry
+    - lazy expiry on lookup / delete / reinsert
+    - expire_step with a bounded number of slots
+
+    Cursor iteration:
+    - iter_begin + iter_next without modifications (each entry once)
+    - iter_next interleaved with insert / delete (each untouched entry at least once)
+    - iter_next with more entries sharing an ideal slot than the chunk size
+    - iter_next with more entries sharing an ideal slot than the chunk size, while deleting yielded entries of the
+      ideal slot (each untouched entry at least once)
+
+    Lookup filter:
+    - attach_filter on a non-empty hashtable
+    - insert / update / delete / clear keep the filter in sync
+    - copy with a filter attached to the destination
+    - detaching with NULL
+
+    Lazy clear:
+    - clear does not touch the slots, and stale slots are treated as empty
+    - insert / update / delete / copy / cursor iteration over stale slots
+    - generation wrap-around
+
+    64-bit SIZE_TYPE:
+    - calc_sizeof / calc_sizeof_overflows beyond 4GiB
+    - insert / update / delete / iteration with a 64-bit hash
 */
 
 #include <assert.h>
@@ -448,9 +477,581 @@ void struct_key_value_test()
     }
 }
 
+#define NAME               ttl_ht
+#define KEY_TYPE           int
+#define VALUE_TYPE         int
+#define KEY_IS_EQUAL(a, b) ((a) == (b))
+#define HASH_FUNCTION(key) fnvhash_32((uint8_t *)&(key), sizeof(int))
+#define TIME_TO_LIVE
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fhashtable_template.h"
+
+void time_to_live_test()
+{
+    // N = 16, insert with and without expiry -> advance time -> lazy expiry
+    {
+        struct ttl_ht *ht_p = ttl_ht_create(16);
+        if (!ht_p) {
+            assert(false);
+        }
+        ttl_ht_insert(ht_p, 1, 10);
+        ttl_ht_insert_with_expiry(ht_p, 2, 20, 5);
+        ttl_ht_update_with_expiry(ht_p, 3, 30, 10);
+
+        ttl_ht_set_time(ht_p, 4);
+        assert(ttl_ht_contains_key(ht_p, 2));
+        assert(ttl_ht_get_value(ht_p, 3, -1) == 30);
+
+        ttl_ht_set_time(ht_p, 5);
+        assert(ttl_ht_contains_key(ht_p, 1));
+        assert(!ttl_ht_contains_key(ht_p, 2));
+        assert(ttl_ht_get_value(ht_p, 2, -1) == -1);
+        assert(ht_p->count == 3); // not removed yet
+
+        assert(ttl_ht_get_value_mut(ht_p, 2) == NULL);
+        assert(ht_p->count == 2); // removed lazily
+
+        // refreshing the expiry of an entry:
+        ttl_ht_update_with_expiry(ht_p, 3, 31, 100);
+        ttl_ht_set_time(ht_p, 50);
+        assert(ttl_ht_get_value(ht_p, 3, -1) == 31);
+
+        // reinserting an expired, but not removed key:
+        ttl_ht_insert_with_expiry(ht_p, 4, 40, 60);
+        ttl_ht_set_time(ht_p, 60);
+        assert(!ttl_ht_contains_key(ht_p, 4));
+        ttl_ht_insert(ht_p, 4, 41);
+        assert(ttl_ht_get_value(ht_p, 4, -1) == 41);
+        assert(ht_p->count == 3);
+
+        // deleting an expired key:
+        ttl_ht_insert_with_expiry(ht_p, 5, 50, 61);
+        ttl_ht_set_time(ht_p, 61);
+        assert(!ttl_ht_delete(ht_p, 5));
+        assert(ht_p->count == 3);
+
+        ttl_ht_destroy(ht_p);
+    }
+    // N = 1e+4, insert 1e+4 with expiry -> expire_step
+    {
+        struct ttl_ht *ht_p = ttl_ht_create((uint32_t)1e+4);
+        if (!ht_p) {
+            assert(false);
+        }
+        for (int i = 0; i < (int)1e+4; i++) {
+            ttl_ht_insert_with_expiry(ht_p, i, i, (uint64_t)(i % 2 == 0 ? 100 : 200));
+        }
+        ttl_ht_set_time(ht_p, 100);
+
+        // every call examines a bounded amount of slots:
+        const uint32_t removed_count = ttl_ht_expire_step(ht_p, 16);
+        assert(removed_count <= 16);
+        assert(ht_p->count == (uint32_t)1e+4 - removed_count);
+
+        struct ttl_ht *ht_copy_p = ttl_ht_create((uint32_t)1e+4);
+        if (!ht_copy_p) {
+            assert(false);
+        }
+        ttl_ht_copy(ht_copy_p, ht_p);
+        assert(ht_copy_p->count == (uint32_t)1e+4 / 2);
+        ttl_ht_destroy(ht_copy_p);
+
+        uint32_t total_removed_count = removed_count;
+        for (uint32_t i = 0; i < 2 * ht_p->capacity / 16; i++) {
+            total_removed_count += ttl_ht_expire_step(ht_p, 16);
+        }
+        assert(total_removed_count == (uint32_t)1e+4 / 2);
+        assert(ht_p->count == (uint32_t)1e+4 / 2);
+
+        for (int i = 0; i < (int)1e+4; i++) {
+            assert(ttl_ht_contains_key(ht_p, i) == (i % 2 != 0));
+        }
+
+        ttl_ht_set_time(ht_p, 200);
+        for (uint32_t i = 0; i < 2 * ht_p->capacity / 16; i++) {
+            ttl_ht_expire_step(ht_p, 16);
+        }
+        assert(ttl_ht_is_empty(ht_p));
+
+        ttl_ht_destroy(ht_p);
+    }
+}
+
+void cursor_iteration_test()
+{
+    // N = 1e+3, insert 1e+3 -> iterate in chunks of 7
+    {
+        struct int_to_int_ht *ht_p = int_to_int_ht_create((uint32_t)1e+3);
+        if (!ht_p) {
+            assert(false);
+        }
+        for (int i = 0; i < (int)1e+3; i++) {
+            int_to_int_ht_insert(ht_p, i, i + 1);
+        }
+
+        uint32_t *seen = calloc((size_t)1e+3, sizeof(uint32_t));
+        struct int_to_int_ht_entry out[7];
+        struct int_to_int_ht_cursor cursor = int_to_int_ht_iter_begin(ht_p);
+        uint32_t n;
+        while ((n = int_to_int_ht_iter_next(ht_p, &cursor, 7, out)) != 0) {
+            assert(n <= 7);
+            for (uint32_t i = 0; i < n; i++) {
+                assert(out[i].value == out[i].key + 1);
+                seen[out[i].key]++;
+            }
+        }
+        for (int i = 0; i < (int)1e+3; i++) {
+            assert(seen[i] == 1);
+        }
+        assert(int_to_int_ht_iter_next(ht_p, &cursor, 7, out) == 0);
+
+        free(seen);
+        int_to_int_ht_destroy(ht_p);
+    }
+    // N = 2e+3, insert 1e+3 -> iterate in chunks of 5, while inserting 1e+3 and deleting the odd keys
+    {
+        struct int_to_int_ht *ht_p = int_to_int_ht_create((uint32_t)2e+3);
+        if (!ht_p) {
+            assert(false);
+        }
+        for (int i = 0; i < (int)1e+3; i++) {
+            int_to_int_ht_insert(ht_p, i, i);
+        }
+
+        bool *seen = calloc((size_t)2e+3, sizeof(bool));
+        struct int_to_int_ht_entry out[5];
+        struct int_to_int_ht_cursor cursor = int_to_int_ht_iter_begin(ht_p);
+        int step = 0;
+        uint32_t n;
+        while ((n = int_to_int_ht_iter_next(ht_p, &cursor, 5, out)) != 0) {
+            for (uint32_t i = 0; i < n; i++) {
+                seen[out[i].key] = true;
+            }
+            if (step < (int)1e+3 / 2) {
+                int_to_int_ht_delete(ht_p, 2 * step + 1);
+                int_to_int_ht_insert(ht_p, (int)1e+3 + 2 * step, 0);
+                int_to_int_ht_insert(ht_p, (int)1e+3 + 2 * step + 1, 0);
+            }
+            step++;
+        }
+        for (int i = 0; i < (int)1e+3; i += 2) {
+            assert(seen[i]);
+        }
+
+        free(seen);
+        int_to_int_ht_destroy(ht_p);
+    }
+    // N = 100, insert 100 keys with the same hash -> iterate in chunks of 3
+    {
+        struct strmap *strmap_p = strmap_create(100);
+        if (!strmap_p) {
+            assert(false);
+        }
+        static char keys[100][4];
+        for (int i = 0; i < 100; i++) {
+            keys[i][0] = 'a';
+            keys[i][1] = (char)('0' + i / 10);
+            keys[i][2] = (char)('0' + i % 10);
+            keys[i][3] = '\0';
+            strmap_insert(strmap_p, keys[i], keys[i]);
+        }
+
+        int seen_count = 0;
+        struct strmap_entry out[3];
+        struct strmap_cursor cursor = strmap_iter_begin(strmap_p);
+        uint32_t n;
+        while ((n = strmap_iter_next(strmap_p, &cursor, 3, out)) != 0) {
+            for (uint32_t i = 0; i < n; i++) {
+                assert(out[i].key == out[i].value);
+                assert(out[i].key[0] == 'a');
+            }
+            seen_count += (int)n;
+        }
+        assert(seen_count == 100);
+
+        strmap_destroy(strmap_p);
+    }
+    // N = 100, insert 100 keys with the same hash -> iterate in chunks of 3, while deleting the first or last key of
+    // each chunk, such that the following entries are shifted back
+    for (uint32_t delete_last = 0; delete_last < 2; delete_last++) {
+        struct strmap *strmap_p = strmap_create(100);
+        if (!strmap_p) {
+            assert(false);
+        }
+        static char keys[100][4];
+        for (int i = 0; i < 100; i++) {
+            keys[i][0] = 'a';
+            keys[i][1] = (char)('0' + i / 10);
+            keys[i][2] = (char)('0' + i % 10);
+            keys[i][3] = '\0';
+            strmap_insert(strmap_p, keys[i], keys[i]);
+        }
+
+        bool seen[100] = {false};
+        bool deleted[100] = {false};
+        struct strmap_entry out[3];
+        struct strmap_cursor cursor = strmap_iter_begin(strmap_p);
+        uint32_t n;
+        while ((n = strmap_iter_next(strmap_p, &cursor, 3, out)) != 0) {
+            for (uint32_t i = 0; i < n; i++) {
+                seen[(out[i].key[1] - '0') * 10 + (out[i].key[2] - '0')] = true;
+            }
+            const char *key = out[delete_last ? n - 1 : 0].key;
+            deleted[(key[1] - '0') * 10 + (key[2] - '0')] = true;
+            strmap_delete(strmap_p, key);
+        }
+        for (int i = 0; i < 100; i++) {
+            assert(seen[i] || deleted[i]);
+        }
+
+        strmap_destroy(strmap_p);
+    }
+}
+
+#define NAME               filter_ht
+#define KEY_TYPE           int
+#define VALUE_TYPE         int
+#define KEY_IS_EQUAL(a, b) ((a) == (b))
+#define HASH_FUNCTION(key) fnvhash_32((uint8_t *)&(key), sizeof(int))
+#define LOOKUP_FILTER
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fhashtable_template.h"
+
+void lookup_filter_test()
+{
+    const int n = 1000;
+
+    struct filter_ht *ht_p = filter_ht_create((uint32_t)n);
+    struct cuckoofilter *filter = cuckoofilter_create(ht_p->capacity);
+    assert(ht_p != NULL && filter != NULL);
+
+    // attach to a non-empty hashtable
+    for (int i = 0; i < n / 2; i++) {
+        filter_ht_insert(ht_p, i, -i);
+    }
+    filter_ht_attach_filter(ht_p, filter);
+    assert(filter->count == ht_p->count);
+
+    // insert / update
+    for (int i = n / 2; i < n; i++) {
+        if (i % 2 == 0) {
+            filter_ht_insert(ht_p, i, -i);
+        }
+        else {
+            filter_ht_update(ht_p, i, -i);
+        }
+    }
+    filter_ht_update(ht_p, 0, 42);
+    assert(filter->count == ht_p->count);
+
+    for (int i = 0; i < n; i++) {
+        assert(filter_ht_contains_key(ht_p, i));
+        assert(filter_ht_get_value(ht_p, i, 1) == (i == 0 ? 42 : -i));
+    }
+    for (int i = n; i < 2 * n; i++) {
+        assert(!filter_ht_contains_key(ht_p, i));
+        assert(filter_ht_get_value_mut(ht_p, i) == NULL);
+        assert(!filter_ht_delete(ht_p, i));
+    }
+
+    // delete
+    for (int i = 0; i < n; i += 2) {
+        assert(filter_ht_delete(ht_p, i));
+    }
+    assert(filter->count == ht_p->count);
+    for (int i = 0; i < n; i++) {
+        assert(filter_ht_contains_key(ht_p, i) == (i % 2 != 0));
+    }
+
+    // copy into a hashtable with its own filter
+    struct filter_ht *copy_p = filter_ht_create((uint32_t)n);
+    struct cuckoofilter *copy_filter = cuckoofilter_create(copy_p->capacity);
+    assert(copy_p != NULL && copy_filter != NULL);
+    filter_ht_attach_filter(copy_p, copy_filter);
+    filter_ht_copy(copy_p, ht_p);
+    assert(copy_filter->count == copy_p->count);
+    for (int i = 0; i < n; i++) {
+        assert(filter_ht_contains_key(copy_p, i) == (i % 2 != 0));
+    }
+
+    // clear
+    filter_ht_clear(ht_p);
+    assert(filter->count == 0);
+    for (int i = 0; i < n; i++) {
+        assert(!filter_ht_contains_key(ht_p, i));
+    }
+
+    // detach
+    filter_ht_attach_filter(ht_p, NULL);
+    filter_ht_insert(ht_p, 1, 1);
+    assert(filter_ht_contains_key(ht_p, 1));
+    assert(filter->count == 0);
+
+    filter_ht_destroy(copy_p);
+    filter_ht_destroy(ht_p);
+    cuckoofilter_destroy(copy_filter);
+    cuckoofilter_destroy(filter);
+}
+
+#define NAME               lazy_ht
+#define KEY_TYPE           int
+#define VALUE_TYPE         int
+#define KEY_IS_EQUAL(a, b) ((a) == (b))
+#define HASH_FUNCTION(key) ((uint32_t)(key) % 8) // clusters, such that entries are shifted over stale slots
+#define LAZY_CLEAR
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fhashtable_template.h"
+
+void lazy_clear_test()
+{
+    const int n = 48;
+
+    struct lazy_ht *ht_p = lazy_ht_create(64);
+    assert(ht_p != NULL);
+    assert(ht_p->generation == 0);
+
+    for (int i = 0; i < n; i++) {
+        lazy_ht_insert(ht_p, i, i);
+    }
+
+    // clear only bumps the generation
+    lazy_ht_clear(ht_p);
+    assert(ht_p->generation == 1);
+    assert(lazy_ht_is_empty(ht_p));
+    assert(ht_p->slots[0].offset != FHASHTABLE_EMPTY_SLOT_OFFSET);
+    for (int i = 0; i < n; i++) {
+        assert(!lazy_ht_contains_key(ht_p, i));
+        assert(lazy_ht_get_value_mut(ht_p, i) == NULL);
+        assert(!lazy_ht_delete(ht_p, i));
+    }
+
+    uint32_t index;
+    int key, value;
+    FHASHTABLE_FOR_EACH_LAZY_CLEAR(ht_p, index, key, value)
+    {
+        assert(false);
+    }
+
+    // reuse over the stale slots
+    for (int i = 0; i < n; i += 2) {
+        lazy_ht_update(ht_p, i, -i);
+    }
+    for (int i = 0; i < n; i += 4) {
+        lazy_ht_update(ht_p, i, i);
+    }
+    assert(ht_p->count == (uint32_t)n / 2);
+    for (int i = 0; i < n; i++) {
+        assert(lazy_ht_get_value(ht_p, i, 1) == (i % 2 != 0 ? 1 : i % 4 == 0 ? i : -i));
+    }
+
+    // deletion shifts back the entries, but not the stale ones
+    for (int i = 0; i < n; i += 4) {
+        assert(lazy_ht_delete(ht_p, i));
+    }
+    assert(ht_p->count == (uint32_t)n / 4);
+    for (int i = 0; i < n; i++) {
+        assert(lazy_ht_contains_key(ht_p, i) == (i % 4 == 2));
+    }
+
+    int sum = 0;
+    FHASHTABLE_FOR_EACH_LAZY_CLEAR(ht_p, index, key, value)
+    {
+        assert(key % 4 == 2 && value == -key);
+        sum += key;
+    }
+    assert(sum == 2 + 6 + 10 + 14 + 18 + 22 + 26 + 30 + 34 + 38 + 42 + 46);
+
+    struct lazy_ht_cursor cursor = lazy_ht_iter_begin(ht_p);
+    struct lazy_ht_entry entries[64];
+    assert(lazy_ht_iter_next(ht_p, &cursor, 64, entries) == (uint32_t)n / 4);
+
+    // copy skips stale slots of the source
+    struct lazy_ht *copy_p = lazy_ht_create(64);
+    assert(copy_p != NULL);
+    lazy_ht_clear(copy_p);
+    lazy_ht_copy(copy_p, ht_p);
+    assert(copy_p->count == (uint32_t)n / 4);
+    for (int i = 0; i < n; i++) {
+        assert(lazy_ht_contains_key(copy_p, i) == (i % 4 == 2));
+    }
+
+    // wrap-around flags the slots as empty
+    ht_p->generation = UINT32_MAX;
+    for (int i = 0; i < n; i++) {
+        lazy_ht_update(ht_p, i, i);
+    }
+    lazy_ht_clear(ht_p);
+    assert(ht_p->generation == 0);
+    for (uint32_t i = 0; i < ht_p->capacity; i++) {
+        assert(ht_p->slots[i].offset == FHASHTABLE_EMPTY_SLOT_OFFSET);
+    }
+    for (int i = 0; i < n; i++) {
+        assert(!lazy_ht_contains_key(ht_p, i));
+    }
+
+    lazy_ht_destroy(copy_p);
+    lazy_ht_destroy(ht_p);
+}
+
+#define NAME               u64_ht64
+#define KEY_TYPE           uint64_t
+#define VALUE_TYPE         uint64_t
+#define KEY_IS_EQUAL(a, b) ((a) == (b))
+#define HASH_FUNCTION(key) ((uint64_t)(key) * 0x9e3779b97f4a7c15)
+#define SIZE_TYPE          uint64_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fhashtable_template.h"
+
+void size_type_test()
+{
+    const uint64_t capacity = (uint64_t)1 << 32;
+    const size_t size = FHASHTABLE_CALC_SIZEOF(u64_ht64, capacity);
+
+    assert(size == offsetof(struct u64_ht64, slots) + capacity * sizeof(struct u64_ht64_slot));
+    assert(!FHASHTABLE_CALC_SIZEOF_OVERFLOWS(u64_ht64, capacity));
+    assert(FHASHTABLE_CALC_SIZEOF_OVERFLOWS(u64_ht64, UINT64_MAX / 2 + 1));
+    assert(u64_ht64_create(UINT64_MAX / 2 + 2) == NULL);
+    assert(u64_ht64_create(UINT64_MAX / 2 + 1) == NULL);
+
+    struct u64_ht64 *ht_p = u64_ht64_create(1000);
+    assert(ht_p != NULL);
+    assert(ht_p->capacity == 1024);
+
+    for (uint64_t i = 0; i < 1000; i++) {
+        u64_ht64_insert(ht_p, i << 40, i);
+    }
+    for (uint64_t i = 0; i < 1000; i += 2) {
+        u64_ht64_update(ht_p, i << 40, i + 1);
+    }
+    assert(ht_p->count == 1000);
+    for (uint64_t i = 0; i < 1000; i++) {
+        assert(u64_ht64_get_value(ht_p, i << 40, 0) == (i % 2 == 0 ? i + 1 : i));
+        assert(!u64_ht64_contains_key(ht_p, (i << 40) + 1));
+    }
+    for (uint64_t i = 0; i < 1000; i += 2) {
+        assert(u64_ht64_delete(ht_p, i << 40));
+    }
+
+    uint64_t index, key, value, count = 0;
+    FHASHTABLE_FOR_EACH(ht_p, index, key, value)
+    {
+        assert(key >> 40 == value && value % 2 == 1);
+        count++;
+    }
+    assert(count == 500 && ht_p->count == 500);
+
+    u64_ht64_destroy(ht_p);
+}
+
+#define NAME arena
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "arena_template.h"
+
+struct alloc_stats {
+    size_t allocated_size;
+    size_t freed_size;
+};
+
+static void *counting_alloc(struct alloc_stats *stats, const size_t size)
+{
+    if (stats) {
+        stats->allocated_size += size;
+    }
+    return malloc(size);
+}
+
+static void counting_free(struct alloc_stats *stats, void *ptr, const size_t size)
+{
+    if (stats) {
+        stats->freed_size += size;
+    }
+    free(ptr);
+}
+
+#define NAME               int_ht_ctx
+#define KEY_TYPE           int
+#define VALUE_TYPE         int
+#define KEY_IS_EQUAL(a, b) ((a) == (b))
+#define HASH_FUNCTION(key) fnvhash_32((uint8_t *)&(key), sizeof(int))
+#define ALLOCATOR(ctx, size)        counting_alloc((ctx), (size))
+#define DEALLOCATOR(ctx, ptr, size) counting_free((ctx), (ptr), (size))
+#define ARENA                       arena
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fhashtable_template.h"
+
+void allocator_test()
+{
+    // custom allocator
+    {
+        struct alloc_stats stats = {0, 0};
+
+        struct int_ht_ctx *ht_p = int_ht_ctx_create_with_context(10, &stats);
+        if (!ht_p) {
+            assert(false);
+        }
+        assert(stats.allocated_size == FHASHTABLE_CALC_SIZEOF(int_ht_ctx, ht_p->capacity));
+
+        for (int i = 0; i < 10; i++) {
+            int_ht_ctx_insert(ht_p, i, -i);
+        }
+        assert(int_ht_ctx_get_value(ht_p, 9, 0) == -9);
+
+        int_ht_ctx_destroy_with_context(ht_p, &stats);
+        assert(stats.freed_size == stats.allocated_size);
+
+        ht_p = int_ht_ctx_create(10);
+        if (!ht_p) {
+            assert(false);
+        }
+        int_ht_ctx_destroy(ht_p);
+    }
+    // arena, with leftover garbage in its memory: create_in_arena must not rely on it being zeroed
+    {
+        unsigned char buf[1024];
+        memset(buf, 0xa5, sizeof(buf));
+        struct arena arena;
+        arena_init(&arena, sizeof(buf), buf);
+
+        struct int_ht_ctx *ht_p = int_ht_ctx_create_in_arena(&arena, 10);
+        if (!ht_p) {
+            assert(false);
+        }
+        assert((unsigned char *)ht_p >= buf && (unsigned char *)ht_p < buf + sizeof(buf));
+        assert(int_ht_ctx_is_empty(ht_p));
+        for (int i = 0; i < 10; i++) {
+            assert(!int_ht_ctx_contains_key(ht_p, i));
+        }
+
+        for (int i = 0; i < 10; i++) {
+            int_ht_ctx_insert(ht_p, i, -i);
+        }
+        assert(int_ht_ctx_get_value(ht_p, 9, 0) == -9);
+
+        assert(int_ht_ctx_create_in_arena(&arena, 1024) == NULL);
+    }
+}
+
 int main(void)
 {
     int_int_full_test();
     bad_hash_func_test();
     struct_key_value_test();
+    time_to_live_test();
+    cursor_iteration_test();
+    lookup_filter_test();
+    lazy_clear_test();
+    size_type_test();
+    allocator_test();
 }
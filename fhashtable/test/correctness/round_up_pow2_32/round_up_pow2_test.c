@@ -9,9 +9,12 @@
     - N := 1e+6
     - N := 1e+9
     - N := UINT32_MAX / 2 + 1
+    - N := UINT32_MAX / 2 + 2 (64-bit only)
+    - N := UINT64_MAX / 2 + 1 (64-bit only)
 */
 
 #include "round_up_pow2_32.h"
+#include "round_up_pow2_64.h"
 #include "math.h"
 
 int main(void)
@@ -36,4 +39,16 @@ int main(void)
         assert(round_up_pow2_32(UINT32_MAX / 2 + 1) == (uint32_t)pow(2, 31));
         assert(round_up_pow2_32_fallback(UINT32_MAX / 2 + 1) == (uint32_t)pow(2, 31));
     }
+    {
+        assert(round_up_pow2_64(1) == 1);
+        assert(round_up_pow2_64_fallback(1) == 1);
+        assert(round_up_pow2_64(129) == 256);
+        assert(round_up_pow2_64_fallback(129) == 256);
+        assert(round_up_pow2_64(UINT32_MAX / 2 + 1) == (uint64_t)1 << 31);
+        assert(round_up_pow2_64_fallback(UINT32_MAX / 2 + 1) == (uint64_t)1 << 31);
+        assert(round_up_pow2_64((uint64_t)UINT32_MAX / 2 + 2) == (uint64_t)1 << 32);
+        assert(round_up_pow2_64_fallback((uint64_t)UINT32_MAX / 2 + 2) == (uint64_t)1 << 32);
+        assert(round_up_pow2_64(UINT64_MAX / 2 + 1) == (uint64_t)1 << 63);
+        assert(round_up_pow2_64_fallback(UINT64_MAX / 2 + 1) == (uint64_t)1 << 63);
+    }
 }
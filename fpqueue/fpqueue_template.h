@@ -17,6 +17,10 @@
  *  @li `NAME`
  *  @li `VALUE_TYPE`
  *
+ * The following macros may be defined:
+ *  @li `ALLOCATOR(ctx,size)` and `DEALLOCATOR(ctx,ptr,size)`
+ *  @li `ARENA`
+ *
  * Source used:
  * @li CLRS
  */
@@ -41,6 +45,10 @@ extern "C" {
 #include <stdint.h>
 #include <stdlib.h>
 
+#ifdef ARENA
+#include <stdalign.h> // alignof
+#endif
+
 // macro definitions: {{{
 
 /**
@@ -105,7 +113,7 @@ extern "C" {
  *          errors.
  *
  * @param[in] self              Priority queue pointer.
- * @param[in] index             Temporary indexing variable. Should be `uint32_t`.
+ * @param[in] index             Temporary indexing variable. Should be `SIZE_TYPE`.
  * @param[out] value_           Current value. Should be `VALUE_TYPE`.
  */
 #ifndef FPQUEUE_FOR_EACH
@@ -125,7 +133,7 @@ extern "C" {
  */
 #ifndef FPQUEUE_CALC_SIZEOF
 #define FPQUEUE_CALC_SIZEOF(fpqueue_name, capacity) \
-    (uint32_t)(offsetof(struct fpqueue_name, elements) + capacity * sizeof(((struct fpqueue_name *)0)->elements[0]))
+    (offsetof(struct fpqueue_name, elements) + (size_t)(capacity) * sizeof(((struct fpqueue_name *)0)->elements[0]))
 #endif
 
 /**
@@ -140,8 +148,8 @@ extern "C" {
  */
 #ifndef FPQUEUE_CALC_SIZEOF_OVERFLOWS
 #define FPQUEUE_CALC_SIZEOF_OVERFLOWS(fpqueue_name, capacity) \
-    (capacity                                                 \
-     > (UINT32_MAX - offsetof(struct fpqueue_name, elements)) / sizeof(((struct fpqueue_name *)0)->elements[0]))
+    ((uintmax_t)0 + (capacity)                                \
+     > (SIZE_MAX - offsetof(struct fpqueue_name, elements)) / sizeof(((struct fpqueue_name *)0)->elements[0]))
 #endif
 
 /**
@@ -171,6 +179,68 @@ extern "C" {
 #error "Must declare VALUE_TYPE."
 #endif
 
+/**
+ * @def SIZE_TYPE
+ * @brief Priority queue count, capacity and index type. Defaults to
+ *        `uint32_t`.
+ *
+ * Define as `uint64_t` (or `size_t`) for priority queues of more than
+ * `UINT32_MAX` values. Must be an unsigned integer type.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef SIZE_TYPE
+#define SIZE_TYPE uint32_t
+#endif
+
+/**
+ * @def ALLOCATOR(ctx, size)
+ * @brief Used by `create` and `create_with_context` to allocate the memory of
+ *        the priority queue. Defaults to malloc().
+ *
+ * Is undefined once header is included.
+ *
+ * @note The memory need not be zeroed. `init` initializes what is read.
+ *
+ * @param ctx The context pointer given to `create_with_context` (or NULL).
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the memory, or NULL if the allocation fails.
+ */
+#if defined(ALLOCATOR) != defined(DEALLOCATOR)
+#error "Must define both ALLOCATOR and DEALLOCATOR."
+#endif
+#ifndef ALLOCATOR
+#define ALLOCATOR(ctx, size) ((void)(ctx), malloc(size))
+#endif
+
+/**
+ * @def DEALLOCATOR(ctx, ptr, size)
+ * @brief Used by `destroy` and `destroy_with_context` to free the memory of
+ *        the priority queue. Defaults to free().
+ *
+ * Is undefined once header is included.
+ *
+ * @param ctx The context pointer given to `destroy_with_context` (or NULL).
+ * @param ptr The pointer returned by `ALLOCATOR`.
+ * @param size The number of bytes allocated.
+ */
+#ifndef DEALLOCATOR
+#define DEALLOCATOR(ctx, ptr, size) ((void)(ctx), (void)(size), free(ptr))
+#endif
+
+/**
+ * @def ARENA
+ * @brief The `NAME` of an arena defined with `arena_template.h`. Generates
+ *        `create_in_arena` if defined.
+ *
+ * The arena type and functions must be declared before including this header
+ * file.
+ *
+ * Is undefined once header is included.
+ */
+#ifdef ARENA
+#endif
+
 /**
  * @def FUNCTION_LINKAGE
  * @brief Specify function linkage e.g. static inline
@@ -211,8 +281,8 @@ struct JOIN(FPQUEUE_NAME, element) {
  * @brief Generated priority queue struct type for a given `VALUE_TYPE`.
  */
 struct FPQUEUE_NAME {
-    uint32_t count;                  ///< Number of non-empty elements.
-    uint32_t capacity;               ///< Number of elements allocated for.
+    SIZE_TYPE count;                 ///< Number of non-empty elements.
+    SIZE_TYPE capacity;              ///< Number of elements allocated for.
     FPQUEUE_ELEMENT_TYPE elements[]; ///< Array of elements.
 };
 
@@ -228,22 +298,37 @@ struct FPQUEUE_NAME {
  * @param[in] self              Priority queue pointer
  * @param[in] capacity          Capacity
  */
-FUNCTION_LINKAGE FPQUEUE_TYPE *JOIN(FPQUEUE_NAME, init)(FPQUEUE_TYPE *self, const uint32_t capacity);
+FUNCTION_LINKAGE FPQUEUE_TYPE *JOIN(FPQUEUE_NAME, init)(FPQUEUE_TYPE *self, const SIZE_TYPE capacity);
 
 /**
- * @brief Create an priority queue struct with a given capacity with malloc().
+ * @brief Create an priority queue struct with a given capacity with `ALLOCATOR`.
  *
  * @param[in] capacity          Maximum number of elements expected to be stored.
  *
  * @return                      A pointer to the priority queue.
  * @retval NULL
  *   @li                        If capacity is 0 or the equivalent size overflows.
- *   @li                        If malloc fails.
+ *   @li                        If the allocation fails.
  */
-FUNCTION_LINKAGE FPQUEUE_TYPE *JOIN(FPQUEUE_NAME, create)(const uint32_t capacity);
+FUNCTION_LINKAGE FPQUEUE_TYPE *JOIN(FPQUEUE_NAME, create)(const SIZE_TYPE capacity);
 
 /**
- * @brief Destroy an priority queue struct and free the underlying memory with free().
+ * @brief Create a priority queue struct with a given capacity with `ALLOCATOR`, given
+ *        a context pointer.
+ *
+ * @param[in] capacity          Maximum number of elements expected to be stored.
+ * @param[in] ctx               The context pointer passed to `ALLOCATOR`.
+ *
+ * @return                      A pointer to the priority queue.
+ * @retval NULL
+ *   @li                        If capacity is 0 or the equivalent size overflows.
+ *   @li                        If the allocation fails.
+ */
+FUNCTION_LINKAGE FPQUEUE_TYPE *JOIN(FPQUEUE_NAME, create_with_context)(const SIZE_TYPE capacity, void *ctx);
+
+/**
+ * @brief Destroy an priority queue struct and free the underlying memory with
+ *        `DEALLOCATOR`.
  *
  * @warning May not be called twice in a row on the same object.
  *
@@ -251,6 +336,37 @@ FUNCTION_LINKAGE FPQUEUE_TYPE *JOIN(FPQUEUE_NAME, create)(const uint32_t capacit
  */
 FUNCTION_LINKAGE void JOIN(FPQUEUE_NAME, destroy)(FPQUEUE_TYPE *self);
 
+/**
+ * @brief Destroy a priority queue struct and free the underlying memory with
+ *        `DEALLOCATOR`, given a context pointer.
+ *
+ * @warning May not be called twice in a row on the same object.
+ *
+ * @param[in] self              The priority queue pointer.
+ * @param[in] ctx               The context pointer passed to `DEALLOCATOR`.
+ */
+FUNCTION_LINKAGE void JOIN(FPQUEUE_NAME, destroy_with_context)(FPQUEUE_TYPE *self, void *ctx);
+
+#ifdef ARENA
+
+/**
+ * @brief Create a priority queue struct with a given capacity in an arena.
+ *
+ * The priority queue is freed along with the arena memory, and must not be
+ * destroyed.
+ *
+ * @param[in] arena_ptr         The arena pointer.
+ * @param[in] capacity          Maximum number of elements expected to be stored.
+ *
+ * @return                      A pointer to the priority queue.
+ * @retval NULL
+ *   @li                        If capacity is 0 or the equivalent size overflows.
+ *   @li                        If the arena is out of memory.
+ */
+FUNCTION_LINKAGE FPQUEUE_TYPE *JOIN(FPQUEUE_NAME, create_in_arena)(struct ARENA *arena_ptr, const SIZE_TYPE capacity);
+
+#endif
+
 /**
  * @brief Return whether the priority queue is empty.
  *
@@ -346,14 +462,14 @@ FUNCTION_LINKAGE void JOIN(FPQUEUE_NAME, copy)(FPQUEUE_TYPE *restrict dest_ptr,
 /// @cond DO_NOT_DOCUMENT
 
 /* push a node down the heap. for restoring the heap property after insertion */
-static inline void JOIN(internal, JOIN(FPQUEUE_NAME, downheap))(FPQUEUE_TYPE *self, const uint32_t index);
+static inline void JOIN(internal, JOIN(FPQUEUE_NAME, downheap))(FPQUEUE_TYPE *self, const SIZE_TYPE index);
 
 /* push a node up the heap. for restoring the heap property after deletion */
-static inline void JOIN(internal, JOIN(FPQUEUE_NAME, upheap))(FPQUEUE_TYPE *self, uint32_t index);
+static inline void JOIN(internal, JOIN(FPQUEUE_NAME, upheap))(FPQUEUE_TYPE *self, SIZE_TYPE index);
 
 /// @endcond
 
-FUNCTION_LINKAGE FPQUEUE_TYPE *JOIN(FPQUEUE_NAME, init)(FPQUEUE_TYPE *self, const uint32_t capacity)
+FUNCTION_LINKAGE FPQUEUE_TYPE *JOIN(FPQUEUE_NAME, init)(FPQUEUE_TYPE *self, const SIZE_TYPE capacity)
 {
     assert(self);
 
@@ -363,15 +479,20 @@ FUNCTION_LINKAGE FPQUEUE_TYPE *JOIN(FPQUEUE_NAME, init)(FPQUEUE_TYPE *self, cons
     return self;
 }
 
-FUNCTION_LINKAGE FPQUEUE_TYPE *JOIN(FPQUEUE_NAME, create)(const uint32_t capacity)
+FUNCTION_LINKAGE FPQUEUE_TYPE *JOIN(FPQUEUE_NAME, create)(const SIZE_TYPE capacity)
+{
+    return JOIN(FPQUEUE_NAME, create_with_context)(capacity, NULL);
+}
+
+FUNCTION_LINKAGE FPQUEUE_TYPE *JOIN(FPQUEUE_NAME, create_with_context)(const SIZE_TYPE capacity, void *ctx)
 {
     if (capacity == 0 || FPQUEUE_CALC_SIZEOF_OVERFLOWS(FPQUEUE_NAME, capacity)) {
         return NULL;
     }
 
-    const uint32_t size = FPQUEUE_CALC_SIZEOF(FPQUEUE_NAME, capacity);
+    const size_t size = FPQUEUE_CALC_SIZEOF(FPQUEUE_NAME, capacity);
 
-    FPQUEUE_TYPE *self = (FPQUEUE_TYPE *)calloc(1, size);
+    FPQUEUE_TYPE *self = (FPQUEUE_TYPE *)ALLOCATOR(ctx, size);
 
     if (!self) {
         return NULL;
@@ -383,12 +504,43 @@ FUNCTION_LINKAGE FPQUEUE_TYPE *JOIN(FPQUEUE_NAME, create)(const uint32_t capacit
 }
 
 FUNCTION_LINKAGE void JOIN(FPQUEUE_NAME, destroy)(FPQUEUE_TYPE *self)
+{
+    JOIN(FPQUEUE_NAME, destroy_with_context)(self, NULL);
+}
+
+FUNCTION_LINKAGE void JOIN(FPQUEUE_NAME, destroy_with_context)(FPQUEUE_TYPE *self, void *ctx)
 {
     assert(self != NULL);
 
-    free(self);
+    DEALLOCATOR(ctx, self, FPQUEUE_CALC_SIZEOF(FPQUEUE_NAME, self->capacity));
 }
 
+#ifdef ARENA
+
+FUNCTION_LINKAGE FPQUEUE_TYPE *JOIN(FPQUEUE_NAME, create_in_arena)(struct ARENA *arena_ptr, const SIZE_TYPE capacity)
+{
+    assert(arena_ptr != NULL);
+
+    if (capacity == 0 || FPQUEUE_CALC_SIZEOF_OVERFLOWS(FPQUEUE_NAME, capacity)) {
+        return NULL;
+    }
+
+    const size_t size = FPQUEUE_CALC_SIZEOF(FPQUEUE_NAME, capacity);
+
+    FPQUEUE_TYPE *self =
+        (FPQUEUE_TYPE *)JOIN(ARENA, allocate_aligned_uninitialized)(arena_ptr, alignof(FPQUEUE_TYPE), size);
+
+    if (!self) {
+        return NULL;
+    }
+
+    FPQUEUE_INIT(self, capacity);
+
+    return self;
+}
+
+#endif
+
 FUNCTION_LINKAGE bool JOIN(FPQUEUE_NAME, is_empty)(const FPQUEUE_TYPE *self)
 {
     assert(self != NULL);
@@ -437,7 +589,7 @@ FUNCTION_LINKAGE void JOIN(FPQUEUE_NAME, push)(FPQUEUE_TYPE *self, VALUE_TYPE va
     assert(self != NULL);
     assert(FPQUEUE_IS_FULL(self) == false);
 
-    const uint32_t index = self->count;
+    const SIZE_TYPE index = self->count;
 
     self->elements[index] = (FPQUEUE_ELEMENT_TYPE){.priority = priority, .value = value};
 
@@ -460,7 +612,7 @@ FUNCTION_LINKAGE void JOIN(FPQUEUE_NAME, copy)(FPQUEUE_TYPE *restrict dest_ptr,
     assert(src_ptr->count <= dest_ptr->capacity);
     assert(FPQUEUE_IS_EMPTY(dest_ptr));
 
-    for (uint32_t i = 0; i < src_ptr->count; i++) {
+    for (SIZE_TYPE i = 0; i < src_ptr->count; i++) {
         dest_ptr->elements[i] = src_ptr->elements[i];
     }
     dest_ptr->count = src_ptr->count;
@@ -468,12 +620,12 @@ FUNCTION_LINKAGE void JOIN(FPQUEUE_NAME, copy)(FPQUEUE_TYPE *restrict dest_ptr,
 
 /// @cond DO_NOT_DOCUMENT
 
-static inline void JOIN(internal, JOIN(FPQUEUE_NAME, upheap))(FPQUEUE_TYPE *self, uint32_t index)
+static inline void JOIN(internal, JOIN(FPQUEUE_NAME, upheap))(FPQUEUE_TYPE *self, SIZE_TYPE index)
 {
     assert(self != NULL);
     assert(index < self->count);
 
-    uint32_t parent;
+    SIZE_TYPE parent;
     while (index > 0) {
         parent = FPQUEUE_PARENT(index);
 
@@ -491,15 +643,15 @@ static inline void JOIN(internal, JOIN(FPQUEUE_NAME, upheap))(FPQUEUE_TYPE *self
     }
 }
 
-static inline void JOIN(internal, JOIN(FPQUEUE_NAME, downheap))(FPQUEUE_TYPE *self, const uint32_t index)
+static inline void JOIN(internal, JOIN(FPQUEUE_NAME, downheap))(FPQUEUE_TYPE *self, const SIZE_TYPE index)
 {
     assert(self != NULL);
     assert(self->count == 0 || index < self->count);
 
-    const uint32_t l = FPQUEUE_LEFT_CHILD(index);
-    const uint32_t r = FPQUEUE_RIGHT_CHILD(index);
+    const SIZE_TYPE l = FPQUEUE_LEFT_CHILD(index);
+    const SIZE_TYPE r = FPQUEUE_RIGHT_CHILD(index);
 
-    uint32_t largest = index;
+    SIZE_TYPE largest = index;
     if (l < self->count && self->elements[l].priority > self->elements[index].priority) {
         largest = l;
     }
@@ -527,6 +679,10 @@ static inline void JOIN(internal, JOIN(FPQUEUE_NAME, downheap))(FPQUEUE_TYPE *se
 
 #undef NAME
 #undef VALUE_TYPE
+#undef SIZE_TYPE
+#undef ALLOCATOR
+#undef DEALLOCATOR
+#undef ARENA
 #undef FUNCTION_LINKAGE
 #undef FUNCTION_DEFINITIONS
 #undef TYPE_DEFINITIONS
@@ -537,7 +693,6 @@ static inline void JOIN(internal, JOIN(FPQUEUE_NAME, downheap))(FPQUEUE_TYPE *se
 #undef FPQUEUE_INIT
 #undef FPQUEUE_IS_EMPTY
 #undef FPQUEUE_IS_FULL
-#undef FPQUEUE_CALC_SIZEOF
 #undef FHASHTABLE_UPHEAP
 #undef FHASHTABLE_DOWNHEAP
 
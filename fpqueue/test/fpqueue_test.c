@@ -26,6 +26,12 @@
     - create
     - destroy
     - copy
+    - create_with_context + destroy_with_context (custom ALLOCATOR / DEALLOCATOR)
+    - create_in_arena
+
+    64-bit SIZE_TYPE:
+    - calc_sizeof / calc_sizeof_overflows beyond 4GiB
+    - push / pop with more than UINT32_MAX elements (in reserved address space)
 */
 
 #define NAME       i64_pque
@@ -126,6 +132,62 @@ static inline bool copy_values_and_check_ordered_values(const struct i64_pque *q
     return res;
 }
 
+#define NAME arena
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "arena_template.h"
+
+struct alloc_stats {
+    size_t allocated_size;
+    size_t freed_size;
+};
+
+static void *counting_alloc(struct alloc_stats *stats, const size_t size)
+{
+    if (stats) {
+        stats->allocated_size += size;
+    }
+    return malloc(size);
+}
+
+static void counting_free(struct alloc_stats *stats, void *ptr, const size_t size)
+{
+    if (stats) {
+        stats->freed_size += size;
+    }
+    free(ptr);
+}
+
+#define NAME       i64_pque_ctx
+#define VALUE_TYPE int64_t
+#define ALLOCATOR(ctx, size)        counting_alloc((ctx), (size))
+#define DEALLOCATOR(ctx, ptr, size) counting_free((ctx), (ptr), (size))
+#define ARENA                       arena
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fpqueue_template.h"
+
+#define NAME       u8_pque64
+#define VALUE_TYPE uint8_t
+#define SIZE_TYPE  uint64_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fpqueue_template.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+
+// reserve address space without backing it, such that only the touched pages use memory
+static void *map_large(const size_t size)
+{
+    void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return ptr == MAP_FAILED ? NULL : ptr;
+}
+#endif
+
 int main(void)
 {
     // N = 0
@@ -308,4 +370,89 @@ int main(void)
 
         i64_pque_destroy(que_p);
     }
+    // custom allocator
+    {
+        struct alloc_stats stats = {0, 0};
+
+        struct i64_pque_ctx *que_p = i64_pque_ctx_create_with_context(10, &stats);
+        if (!que_p) {
+            assert(false);
+        }
+        assert(stats.allocated_size == FPQUEUE_CALC_SIZEOF(i64_pque_ctx, que_p->capacity));
+
+        for (int64_t i = 0; i < 10; i++) {
+            i64_pque_ctx_push(que_p, i, (uint32_t)i);
+        }
+        assert(i64_pque_ctx_pop_max(que_p) == 9);
+
+        i64_pque_ctx_destroy_with_context(que_p, &stats);
+        assert(stats.freed_size == stats.allocated_size);
+
+        que_p = i64_pque_ctx_create(10);
+        if (!que_p) {
+            assert(false);
+        }
+        i64_pque_ctx_destroy(que_p);
+    }
+    // arena, with leftover garbage in its memory: create_in_arena must not rely on it being zeroed
+    {
+        unsigned char buf[1024];
+        memset(buf, 0xa5, sizeof(buf));
+        struct arena arena;
+        arena_init(&arena, sizeof(buf), buf);
+
+        struct i64_pque_ctx *que_p = i64_pque_ctx_create_in_arena(&arena, 10);
+        if (!que_p) {
+            assert(false);
+        }
+        assert((unsigned char *)que_p >= buf && (unsigned char *)que_p < buf + sizeof(buf));
+        assert(i64_pque_ctx_is_empty(que_p));
+
+        for (int64_t i = 0; i < 10; i++) {
+            i64_pque_ctx_push(que_p, i, (uint32_t)i);
+        }
+        assert(i64_pque_ctx_pop_max(que_p) == 9);
+
+        assert(i64_pque_ctx_create_in_arena(&arena, 1024) == NULL);
+    }
+    // 64-bit SIZE_TYPE
+    {
+        const uint64_t capacity = ((uint64_t)1 << 32) + 4096;
+        const size_t size = FPQUEUE_CALC_SIZEOF(u8_pque64, capacity);
+
+        assert(size == offsetof(struct u8_pque64, elements) + capacity * sizeof(struct u8_pque64_element));
+        assert(size > ((size_t)1 << 32));
+        assert(!FPQUEUE_CALC_SIZEOF_OVERFLOWS(u8_pque64, capacity));
+        assert(FPQUEUE_CALC_SIZEOF_OVERFLOWS(u8_pque64, UINT64_MAX));
+        assert(u8_pque64_create(UINT64_MAX) == NULL);
+
+        struct u8_pque64 *que_p = u8_pque64_create(10);
+        if (!que_p) {
+            assert(false);
+        }
+        for (uint8_t i = 0; i < 10; i++) {
+            u8_pque64_push(que_p, i, i);
+        }
+        assert(u8_pque64_pop_max(que_p) == 9);
+        u8_pque64_destroy(que_p);
+
+#ifdef __linux__
+        void *buf = map_large(size);
+        if (buf) {
+            que_p = u8_pque64_init(buf, capacity);
+
+            // the untouched (zeroed) elements form a valid heap of elements with priority 0
+            que_p->count = UINT32_MAX;
+            u8_pque64_push(que_p, 42, 1);
+            u8_pque64_push(que_p, 43, 2);
+            assert(que_p->count == (uint64_t)UINT32_MAX + 2);
+            assert(u8_pque64_get_max(que_p) == 43);
+            assert(u8_pque64_pop_max(que_p) == 43);
+            assert(u8_pque64_pop_max(que_p) == 42);
+            assert(que_p->elements[0].priority == 0);
+
+            munmap(buf, size);
+        }
+#endif
+    }
 }
@@ -43,6 +43,24 @@ void char_queue_example(void)
 
     assert(q->count == 0);
 
+    // bytes may be moved in bulk
+    char_queue_enqueue_n(q, "xyz", 3);
+    char buf[3];
+    char_queue_dequeue_n(q, buf, 2);
+    assert(buf[0] == 'x' && buf[1] == 'y');
+    assert(q->count == 1);
+
+    // or produced and consumed in place, e.g. with read() / writev()
+    struct char_queue_span spans[2];
+    char_queue_writable_spans(q, spans);
+    spans[0].values[0] = '!';
+    char_queue_commit_write(q, 1);
+
+    assert(char_queue_readable_spans(q, spans) == 1); // 2 if the values wrap around the end
+    assert(spans[0].count == 2 && spans[0].values[0] == 'z' && spans[0].values[1] == '!');
+    char_queue_consume(q, 2);
+    assert(q->count == 0);
+
     char_queue_destroy(q);
 }
 
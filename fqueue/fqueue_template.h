@@ -34,6 +34,24 @@ extern "C" {
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#ifdef ARENA
+#include <stdalign.h> // alignof
+#endif
+
+#ifdef OVERWRITE
+#include <stdatomic.h>
+#endif
+
+#ifdef MIRRORED
+#ifndef __linux__
+#error "MIRRORED is only supported on Linux."
+#endif
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 // macro definitions: {{{
 
@@ -79,7 +97,7 @@ extern "C" {
  * @warning Modifying the queue under the iteration may result in errors.
  *
  * @param[in] self              Queue pointer.
- * @param[in] index             Temporary indexing variable. Should be `uint32_t`.
+ * @param[in] index             Temporary indexing variable. Should be `SIZE_TYPE`.
  * @param[out] value            Current value. Should be `VALUE_TYPE`.
  */
 #ifndef FQUEUE_FOR_EACH
@@ -96,7 +114,7 @@ extern "C" {
  * @warning Modifying the queue under the iteration may result in errors.
  *
  * @param[in] self              Queue pointer.
- * @param[in] index             Temporary indexing variable. Should be `uint32_t`.
+ * @param[in] index             Temporary indexing variable. Should be `SIZE_TYPE`.
  * @param[out] value            Current value. Should be `VALUE_TYPE`.
  */
 #ifndef FQUEUE_FOR_EACH_REVERSE
@@ -118,7 +136,7 @@ extern "C" {
  */
 #ifndef FQUEUE_CALC_SIZEOF
 #define FQUEUE_CALC_SIZEOF(fqueue_name, capacity) \
-    (uint32_t)(offsetof(struct fqueue_name, values) + capacity * sizeof(((struct fqueue_name *)0)->values[0]))
+    (offsetof(struct fqueue_name, values) + (size_t)(capacity) * sizeof(((struct fqueue_name *)0)->values[0]))
 #endif
 
 /**
@@ -133,7 +151,8 @@ extern "C" {
  */
 #ifndef FQUEUE_CALC_SIZEOF_OVERFLOWS
 #define FQUEUE_CALC_SIZEOF_OVERFLOWS(fqueue_name, capacity) \
-    (capacity > (UINT32_MAX - offsetof(struct fqueue_name, values)) / sizeof(((struct fqueue_name *)0)->values[0]))
+    ((uintmax_t)0 + (capacity)                              \
+     > (SIZE_MAX - offsetof(struct fqueue_name, values)) / sizeof(((struct fqueue_name *)0)->values[0]))
 #endif
 
 /**
@@ -164,6 +183,118 @@ extern "C" {
 #error "Must define VALUE_TYPE."
 #endif
 
+/**
+ * @def SIZE_TYPE
+ * @brief Queue count, capacity and index type. Defaults to `uint32_t`.
+ *
+ * Define as `uint64_t` (or `size_t`) for queues of more than
+ * `UINT32_MAX / 2 + 1` values. Must be an unsigned integer type.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef SIZE_TYPE
+#define SIZE_TYPE uint32_t
+#endif
+
+/**
+ * @def ALLOCATOR(ctx, size)
+ * @brief Used by `create` and `create_with_context` to allocate the memory of
+ *        the queue. Defaults to malloc().
+ *
+ * Is undefined once header is included.
+ *
+ * @note The memory need not be zeroed. `init` initializes what is read.
+ *
+ * @param ctx The context pointer given to `create_with_context` (or NULL).
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the memory, or NULL if the allocation fails.
+ */
+#if defined(ALLOCATOR) != defined(DEALLOCATOR)
+#error "Must define both ALLOCATOR and DEALLOCATOR."
+#endif
+#ifndef ALLOCATOR
+#define ALLOCATOR(ctx, size) ((void)(ctx), malloc(size))
+#endif
+
+/**
+ * @def DEALLOCATOR(ctx, ptr, size)
+ * @brief Used by `destroy` and `destroy_with_context` to free the memory of
+ *        the queue. Defaults to free().
+ *
+ * Is undefined once header is included.
+ *
+ * @param ctx The context pointer given to `destroy_with_context` (or NULL).
+ * @param ptr The pointer returned by `ALLOCATOR`.
+ * @param size The number of bytes allocated.
+ */
+#ifndef DEALLOCATOR
+#define DEALLOCATOR(ctx, ptr, size) ((void)(ctx), (void)(size), free(ptr))
+#endif
+
+/**
+ * @def ARENA
+ * @brief The `NAME` of an arena defined with `arena_template.h`. Generates
+ *        `create_in_arena` if defined.
+ *
+ * The arena type and functions must be declared before including this header
+ * file.
+ *
+ * Is undefined once header is included.
+ */
+#ifdef ARENA
+#endif
+
+/**
+ * @def MIRRORED
+ * @brief Generates `create_mirrored`, `destroy_mirrored`, `readable_span` and
+ *        `writable_span` if defined. Linux only.
+ *
+ * A mirrored queue maps the same physical pages of the values twice, back to
+ * back, such that `values[i]` and `values[i + capacity]` are the same value.
+ * Any window of up to `capacity` values starting within the ring is thus
+ * contiguous in virtual memory, and the values of the queue (or its free
+ * slots) can be read (or written) as a single span without handling the
+ * wrap-around.
+ *
+ * The pages are from an anonymous file (`memfd_create`), mapped with `mmap`.
+ * The capacity is rounded up such that the values fill whole pages.
+ *
+ * Is undefined once header is included.
+ */
+#ifdef MIRRORED
+#endif
+
+/**
+ * @def OVERWRITE
+ * @brief Makes `enqueue` and `enqueue_n` overwrite the oldest values when the
+ *        queue is full, and generates `snapshot`, if defined.
+ *
+ * The queue then keeps the latest `capacity` values, e.g. as a trace or
+ * telemetry buffer. The thread owning the queue (the writer) uses it as usual,
+ * and any number of other threads (readers) may concurrently copy out the
+ * latest values with `snapshot`, without locks and without stopping the
+ * writer:
+ *      @li The writer claims the positions it is about to write in
+ *          `claimed_count`, then writes the values, then publishes them in
+ *          `write_count`.
+ *      @li A reader copies the latest published values, then re-reads
+ *          `claimed_count`. Copied values which the writer may have
+ *          overwritten in the meantime are discarded, like in a seqlock.
+ *
+ * Values written in place are claimed by `writable_spans` (or
+ * `writable_span`), which claims all free slots, and published by
+ * `commit_write`. They are not overwritten when the queue is full.
+ *
+ * @warning While readers take snapshots, values written in place must be
+ *          written between `writable_spans` and `commit_write`, and only into
+ *          the first `n` free slots. Snapshots are of the latest enqueued
+ *          values, and do not reflect `dequeue`, `consume` or `clear`.
+ *
+ * Is undefined once header is included.
+ */
+#ifdef OVERWRITE
+#endif
+
 /**
  * @def FUNCTION_LINKAGE
  * @brief Specify function linkage e.g. static inline
@@ -173,10 +304,16 @@ extern "C" {
 #endif
 
 /// @cond DO_NOT_DOCUMENT
-#define FQUEUE_TYPE     struct FQUEUE_NAME
-#define FQUEUE_INIT     JOIN(FQUEUE_NAME, init)
-#define FQUEUE_IS_EMPTY JOIN(FQUEUE_NAME, is_empty)
-#define FQUEUE_IS_FULL  JOIN(FQUEUE_NAME, is_full)
+#define FQUEUE_TYPE      struct FQUEUE_NAME
+#define FQUEUE_SPAN_TYPE struct JOIN(FQUEUE_NAME, span)
+#define FQUEUE_INIT      JOIN(FQUEUE_NAME, init)
+#define FQUEUE_IS_EMPTY  JOIN(FQUEUE_NAME, is_empty)
+#define FQUEUE_IS_FULL   JOIN(FQUEUE_NAME, is_full)
+#define FQUEUE_SIZE_MAX  ((SIZE_TYPE)-1)
+#define FQUEUE_ROUND_UP  JOIN(internal, JOIN(FQUEUE_NAME, round_up_pow2))
+#define FQUEUE_PAGE_SIZE JOIN(internal, JOIN(FQUEUE_NAME, page_size))
+#define FQUEUE_ADVANCE   JOIN(internal, JOIN(FQUEUE_NAME, advance))
+#define FQUEUE_CLAIM     JOIN(internal, JOIN(FQUEUE_NAME, claim_free))
 /// @endcond
 
 // }}}
@@ -193,11 +330,24 @@ extern "C" {
  * @brief Generated queue struct type for a `VALUE_TYPE`.
  */
 struct FQUEUE_NAME {
-    uint32_t begin_index; ///< Index used to track the front of the queue.
-    uint32_t end_index;   ///< Index used to track the back of the queue.
-    uint32_t count;       ///< Number of values.
-    uint32_t capacity;    ///< Maximum number of values allocated for.
-    VALUE_TYPE values[];  ///< Array of values.
+    SIZE_TYPE begin_index; ///< Index used to track the front of the queue.
+    SIZE_TYPE end_index;   ///< Index used to track the back of the queue.
+    SIZE_TYPE count;       ///< Number of values.
+    SIZE_TYPE capacity;    ///< Maximum number of values allocated for.
+#ifdef OVERWRITE
+    _Atomic(SIZE_TYPE) claimed_count; ///< Number of values enqueued or being enqueued. See `OVERWRITE`.
+    _Atomic(SIZE_TYPE) write_count;   ///< Number of values enqueued. See `OVERWRITE`.
+#endif
+    VALUE_TYPE values[]; ///< Array of values.
+};
+
+/**
+ * @brief Generated span struct type for a `VALUE_TYPE`. A contiguous region of
+ *        the ring storage.
+ */
+struct JOIN(FQUEUE_NAME, span) {
+    VALUE_TYPE *values; ///< Pointer to the first value of the region.
+    SIZE_TYPE count;    ///< Number of values in the region.
 };
 
 #endif
@@ -212,22 +362,39 @@ struct FQUEUE_NAME {
  * @param[in] self              Queue pointer
  * @param[in] pow2_capacity     Power of 2 capacity
  */
-FUNCTION_LINKAGE FQUEUE_TYPE *JOIN(FQUEUE_NAME, init)(FQUEUE_TYPE *self, const uint32_t pow2_capacity);
+FUNCTION_LINKAGE FQUEUE_TYPE *JOIN(FQUEUE_NAME, init)(FQUEUE_TYPE *self, const SIZE_TYPE pow2_capacity);
 
 /**
- * @brief Create an queue struct with a given capacity with malloc().
+ * @brief Create an queue struct with a given capacity with `ALLOCATOR`.
  *
  * @param[in] min_capacity      Maximum number of elements expected to be stored
  *
  * @return                      A pointer to the queue.
  * @retval NULL
- *   @li                        If malloc fails.
- *   @li                        If capacity is 0 or larger than UINT32_MAX / 2 + 1 or the equivalent size overflows.
+ *   @li                        If the allocation fails.
+ *   @li                        If capacity is 0 or larger than the maximum of `SIZE_TYPE` / 2 + 1 or the
+ *                              equivalent size overflows.
  */
-FUNCTION_LINKAGE FQUEUE_TYPE *JOIN(FQUEUE_NAME, create)(const uint32_t min_capacity);
+FUNCTION_LINKAGE FQUEUE_TYPE *JOIN(FQUEUE_NAME, create)(const SIZE_TYPE min_capacity);
 
 /**
- * @brief Destroy an queue struct and free the underlying memory with free().
+ * @brief Create a queue struct with a given capacity with `ALLOCATOR`, given
+ *        a context pointer.
+ *
+ * @param[in] min_capacity      Maximum number of elements expected to be stored
+ * @param[in] ctx               The context pointer passed to `ALLOCATOR`.
+ *
+ * @return                      A pointer to the queue.
+ * @retval NULL
+ *   @li                        If the allocation fails.
+ *   @li                        If capacity is 0 or larger than the maximum of `SIZE_TYPE` / 2 + 1 or the
+ *                              equivalent size overflows.
+ */
+FUNCTION_LINKAGE FQUEUE_TYPE *JOIN(FQUEUE_NAME, create_with_context)(const SIZE_TYPE min_capacity, void *ctx);
+
+/**
+ * @brief Destroy an queue struct and free the underlying memory with
+ *        `DEALLOCATOR`.
  *
  * @warning May not be called twice in a row on the same object.
  *
@@ -235,6 +402,92 @@ FUNCTION_LINKAGE FQUEUE_TYPE *JOIN(FQUEUE_NAME, create)(const uint32_t min_capac
  */
 FUNCTION_LINKAGE void JOIN(FQUEUE_NAME, destroy)(FQUEUE_TYPE *self);
 
+/**
+ * @brief Destroy a queue struct and free the underlying memory with
+ *        `DEALLOCATOR`, given a context pointer.
+ *
+ * @warning May not be called twice in a row on the same object.
+ *
+ * @param[in] self              The queue pointer.
+ * @param[in] ctx               The context pointer passed to `DEALLOCATOR`.
+ */
+FUNCTION_LINKAGE void JOIN(FQUEUE_NAME, destroy_with_context)(FQUEUE_TYPE *self, void *ctx);
+
+#ifdef ARENA
+
+/**
+ * @brief Create a queue struct with a given capacity in an arena.
+ *
+ * The queue is freed along with the arena memory, and must not be
+ * destroyed.
+ *
+ * @param[in] arena_ptr         The arena pointer.
+ * @param[in] min_capacity      Maximum number of elements expected to be stored
+ *
+ * @return                      A pointer to the queue.
+ * @retval NULL
+ *   @li                        If the arena is out of memory.
+ *   @li                        If capacity is 0 or larger than the maximum of `SIZE_TYPE` / 2 + 1 or the
+ *                              equivalent size overflows.
+ */
+FUNCTION_LINKAGE FQUEUE_TYPE *JOIN(FQUEUE_NAME, create_in_arena)(struct ARENA *arena_ptr, const SIZE_TYPE min_capacity);
+
+#endif
+
+#ifdef MIRRORED
+
+/**
+ * @brief Create a mirrored queue struct with a given capacity. See `MIRRORED`.
+ *
+ * @param[in] min_capacity      Maximum number of elements expected to be stored
+ *
+ * @return                      A pointer to the queue.
+ * @retval NULL
+ *   @li                        If the anonymous file could not be created or
+ *                              mapped.
+ *   @li                        If capacity is 0 or larger than the maximum of `SIZE_TYPE` / 2 + 1 or the
+ *                              equivalent size overflows.
+ */
+FUNCTION_LINKAGE FQUEUE_TYPE *JOIN(FQUEUE_NAME, create_mirrored)(const SIZE_TYPE min_capacity);
+
+/**
+ * @brief Destroy a mirrored queue struct and unmap the underlying memory.
+ *
+ * @warning May only be called on queues created with `create_mirrored`, and
+ *          not twice in a row on the same object.
+ *
+ * @param[in] self              The queue pointer.
+ */
+FUNCTION_LINKAGE void JOIN(FQUEUE_NAME, destroy_mirrored)(FQUEUE_TYPE *self);
+
+/**
+ * @brief Get the values of a mirrored queue, from front to back, as a single
+ *        span. For reading (or modifying) the values in place.
+ *
+ * @warning May only be called on queues created with `create_mirrored`.
+ *
+ * @param[in] self              The queue pointer.
+ *
+ * @return                      The span of `count` values.
+ */
+FUNCTION_LINKAGE FQUEUE_SPAN_TYPE JOIN(FQUEUE_NAME, readable_span)(FQUEUE_TYPE *self);
+
+/**
+ * @brief Get the free slots after the back of a mirrored queue as a single
+ *        span. For producing values in place.
+ *
+ * @warning May only be called on queues created with `create_mirrored`.
+ *
+ * @note With `OVERWRITE`, the free slots are claimed until `commit_write`.
+ *
+ * @param[in] self              The queue pointer.
+ *
+ * @return                      The span of `capacity - count` free slots.
+ */
+FUNCTION_LINKAGE FQUEUE_SPAN_TYPE JOIN(FQUEUE_NAME, writable_span)(FQUEUE_TYPE *self);
+
+#endif
+
 /**
  * @brief Return whether the queue is empty.
  *
@@ -264,7 +517,7 @@ FUNCTION_LINKAGE bool JOIN(FQUEUE_NAME, is_full)(const FQUEUE_TYPE *self);
  *
  * @return                      The value at `index`.
  */
-FUNCTION_LINKAGE VALUE_TYPE JOIN(FQUEUE_NAME, at)(const FQUEUE_TYPE *self, const uint32_t index);
+FUNCTION_LINKAGE VALUE_TYPE JOIN(FQUEUE_NAME, at)(const FQUEUE_TYPE *self, const SIZE_TYPE index);
 
 /**
  * @brief Get the value from the front of a non-empty queue.
@@ -296,6 +549,9 @@ FUNCTION_LINKAGE VALUE_TYPE JOIN(FQUEUE_NAME, peek)(const FQUEUE_TYPE *self);
 /**
  * @brief Enqueue a value at the back of a non-full queue.
  *
+ * With `OVERWRITE`, the queue may be full, and the front value is then
+ * dropped.
+ *
  * @param[in] self              The queue pointer.
  * @param[in] value             The value to enqueue.
  */
@@ -310,9 +566,93 @@ FUNCTION_LINKAGE bool JOIN(FQUEUE_NAME, enqueue)(FQUEUE_TYPE *self, const VALUE_
  */
 FUNCTION_LINKAGE VALUE_TYPE JOIN(FQUEUE_NAME, dequeue)(FQUEUE_TYPE *self);
 
+/**
+ * @brief Enqueue `n` values at the back of a queue with room for them.
+ *
+ * The values are copied in at most two contiguous segments, split at the end
+ * of the ring.
+ *
+ * With `OVERWRITE`, `n` is unbounded. The front values are dropped as needed,
+ * and only the last `capacity` values of `src` are kept.
+ *
+ * @param[in] self              The queue pointer.
+ * @param[in] src               The values to enqueue, from front to back.
+ * @param[in] n                 The number of values.
+ */
+FUNCTION_LINKAGE void JOIN(FQUEUE_NAME, enqueue_n)(FQUEUE_TYPE *restrict self, const VALUE_TYPE *restrict src,
+                                                   const SIZE_TYPE n);
+
+/**
+ * @brief Dequeue `n` values from the front of a queue with at least `n`
+ *        values.
+ *
+ * The values are copied out in at most two contiguous segments, split at the
+ * end of the ring.
+ *
+ * @param[in] self              The queue pointer.
+ * @param[out] dest             Set to the dequeued values, from front to back.
+ * @param[in] n                 The number of values.
+ */
+FUNCTION_LINKAGE void JOIN(FQUEUE_NAME, dequeue_n)(FQUEUE_TYPE *restrict self, VALUE_TYPE *restrict dest,
+                                                   const SIZE_TYPE n);
+
+/**
+ * @brief Get the values of the queue, from front to back, as up to two spans of
+ *        the ring storage. For reading (or modifying) the values in place.
+ *
+ * @note The second span is used when the values wrap around the end of the
+ *       ring. Unused spans have a count of 0.
+ *
+ * @param[in] self              The queue pointer.
+ * @param[out] spans            Set to the spans.
+ *
+ * @return                      The number of non-empty spans (0, 1 or 2).
+ */
+FUNCTION_LINKAGE SIZE_TYPE JOIN(FQUEUE_NAME, readable_spans)(FQUEUE_TYPE *self, FQUEUE_SPAN_TYPE spans[2]);
+
+/**
+ * @brief Get the free slots after the back of the queue as up to two spans of
+ *        the ring storage. For producing values in place.
+ *
+ * @note The second span is used when the free slots wrap around the end of the
+ *       ring. Unused spans have a count of 0.
+ *
+ * @note With `OVERWRITE`, the free slots are claimed until `commit_write`.
+ *
+ * @param[in] self              The queue pointer.
+ * @param[out] spans            Set to the spans.
+ *
+ * @return                      The number of non-empty spans (0, 1 or 2).
+ */
+FUNCTION_LINKAGE SIZE_TYPE JOIN(FQUEUE_NAME, writable_spans)(FQUEUE_TYPE *self, FQUEUE_SPAN_TYPE spans[2]);
+
+/**
+ * @brief Enqueue the first `n` values written in place into the writable
+ *        spans.
+ *
+ * With `OVERWRITE`, the values are published to `snapshot`.
+ *
+ * @param[in] self              The queue pointer.
+ * @param[in] n                 The number of values written. At most the
+ *                              number of free slots.
+ */
+FUNCTION_LINKAGE void JOIN(FQUEUE_NAME, commit_write)(FQUEUE_TYPE *self, const SIZE_TYPE n);
+
+/**
+ * @brief Dequeue the first `n` values, after they are read in place from the
+ *        readable spans.
+ *
+ * @param[in] self              The queue pointer.
+ * @param[in] n                 The number of values read. At most `count`.
+ */
+FUNCTION_LINKAGE void JOIN(FQUEUE_NAME, consume)(FQUEUE_TYPE *self, const SIZE_TYPE n);
+
 /**
  * @brief Clear the elements in the queue.
  *
+ * With `OVERWRITE`, the back of the queue is kept in place, such that later
+ * values are written where `snapshot` expects them.
+ *
  * @param[in] self              The queue pointer.
  */
 FUNCTION_LINKAGE void JOIN(FQUEUE_NAME, clear)(FQUEUE_TYPE *self);
@@ -325,6 +665,32 @@ FUNCTION_LINKAGE void JOIN(FQUEUE_NAME, clear)(FQUEUE_TYPE *self);
  */
 FUNCTION_LINKAGE void JOIN(FQUEUE_NAME, copy)(FQUEUE_TYPE *restrict dest_ptr, const FQUEUE_TYPE *restrict src_ptr);
 
+#ifdef OVERWRITE
+
+/**
+ * @brief Copy out up to `n` of the latest enqueued values, from oldest to
+ *        newest. May be called by any thread while the writer enqueues. See
+ *        `OVERWRITE`.
+ *
+ * Retries only if the writer overwrote all of the copied values meanwhile.
+ *
+ * @note The values are copied while the writer may overwrite them, and the
+ *       copies are validated afterwards, like in a seqlock. Thread sanitizers
+ *       report this as a data race.
+ *
+ * @param[in] self              The queue pointer.
+ * @param[out] dest             Destination with room for `n` values.
+ * @param[in] n                 The maximum number of values.
+ *
+ * @return                      The number of values copied. Less than `n` if
+ *                              fewer values were enqueued, or the writer was
+ *                              overwriting the oldest of them.
+ */
+FUNCTION_LINKAGE SIZE_TYPE JOIN(FQUEUE_NAME, snapshot)(const FQUEUE_TYPE *restrict self, VALUE_TYPE *restrict dest,
+                                                       const SIZE_TYPE n);
+
+#endif
+
 // }}}
 
 // function definitions: {{{
@@ -336,8 +702,41 @@ FUNCTION_LINKAGE void JOIN(FQUEUE_NAME, copy)(FQUEUE_TYPE *restrict dest_ptr, co
 #ifdef FUNCTION_DEFINITIONS
 
 #include "round_up_pow2_32.h" // round_up_pow2_32
+#include "round_up_pow2_64.h" // round_up_pow2_64
+
+/// @cond DO_NOT_DOCUMENT
+static inline SIZE_TYPE JOIN(internal, JOIN(FQUEUE_NAME, round_up_pow2))(const SIZE_TYPE x)
+{
+    if (sizeof(SIZE_TYPE) <= sizeof(uint32_t)) {
+        return (SIZE_TYPE)round_up_pow2_32((uint32_t)x);
+    }
+    return (SIZE_TYPE)round_up_pow2_64((uint64_t)x);
+}
 
-FUNCTION_LINKAGE FQUEUE_TYPE *JOIN(FQUEUE_NAME, init)(FQUEUE_TYPE *self, const uint32_t pow2_capacity)
+#ifdef OVERWRITE
+/* the counts run freely, but skip from the maximum of SIZE_TYPE to capacity, such that they stay at least capacity
+ * once capacity values are enqueued. the position of a count in the ring is unchanged by the skip */
+static inline SIZE_TYPE JOIN(internal, JOIN(FQUEUE_NAME, advance))(const FQUEUE_TYPE *self, const SIZE_TYPE count,
+                                                                   const SIZE_TYPE n)
+{
+    const SIZE_TYPE next_count = (SIZE_TYPE)(count + n);
+
+    return next_count < count ? (SIZE_TYPE)(next_count + self->capacity) : next_count;
+}
+
+/* claim the free slots before they are written in place. commit_write publishes the ones written */
+static inline void JOIN(internal, JOIN(FQUEUE_NAME, claim_free))(FQUEUE_TYPE *self)
+{
+    const SIZE_TYPE write_count = atomic_load_explicit(&self->write_count, memory_order_relaxed);
+    const SIZE_TYPE free_n = self->capacity - self->count;
+
+    atomic_store_explicit(&self->claimed_count, FQUEUE_ADVANCE(self, write_count, free_n), memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+#endif
+/// @endcond
+
+FUNCTION_LINKAGE FQUEUE_TYPE *JOIN(FQUEUE_NAME, init)(FQUEUE_TYPE *self, const SIZE_TYPE pow2_capacity)
 {
     assert(self);
     assert(IS_POW2(pow2_capacity));
@@ -345,25 +744,34 @@ FUNCTION_LINKAGE FQUEUE_TYPE *JOIN(FQUEUE_NAME, init)(FQUEUE_TYPE *self, const u
     self->begin_index = self->end_index = 0;
     self->count = 0;
     self->capacity = pow2_capacity;
+#ifdef OVERWRITE
+    atomic_init(&self->claimed_count, 0);
+    atomic_init(&self->write_count, 0);
+#endif
 
     return self;
 }
 
-FUNCTION_LINKAGE FQUEUE_TYPE *JOIN(FQUEUE_NAME, create)(const uint32_t min_capacity)
+FUNCTION_LINKAGE FQUEUE_TYPE *JOIN(FQUEUE_NAME, create)(const SIZE_TYPE min_capacity)
+{
+    return JOIN(FQUEUE_NAME, create_with_context)(min_capacity, NULL);
+}
+
+FUNCTION_LINKAGE FQUEUE_TYPE *JOIN(FQUEUE_NAME, create_with_context)(const SIZE_TYPE min_capacity, void *ctx)
 {
-    if (min_capacity == 0 || min_capacity > UINT32_MAX / 2 + 1) {
+    if (min_capacity == 0 || min_capacity > FQUEUE_SIZE_MAX / 2 + 1) {
         return NULL;
     }
 
-    const uint32_t capacity = round_up_pow2_32(min_capacity);
+    const SIZE_TYPE capacity = FQUEUE_ROUND_UP(min_capacity);
 
     if (FQUEUE_CALC_SIZEOF_OVERFLOWS(FQUEUE_NAME, capacity)) {
         return NULL;
     }
 
-    const uint32_t size = FQUEUE_CALC_SIZEOF(FQUEUE_NAME, capacity);
+    const size_t size = FQUEUE_CALC_SIZEOF(FQUEUE_NAME, capacity);
 
-    FQUEUE_TYPE *self = (FQUEUE_TYPE *)calloc(1, size);
+    FQUEUE_TYPE *self = (FQUEUE_TYPE *)ALLOCATOR(ctx, size);
 
     if (!self) {
         return NULL;
@@ -375,12 +783,165 @@ FUNCTION_LINKAGE FQUEUE_TYPE *JOIN(FQUEUE_NAME, create)(const uint32_t min_capac
 }
 
 FUNCTION_LINKAGE void JOIN(FQUEUE_NAME, destroy)(FQUEUE_TYPE *self)
+{
+    JOIN(FQUEUE_NAME, destroy_with_context)(self, NULL);
+}
+
+FUNCTION_LINKAGE void JOIN(FQUEUE_NAME, destroy_with_context)(FQUEUE_TYPE *self, void *ctx)
+{
+    assert(self != NULL);
+
+    DEALLOCATOR(ctx, self, FQUEUE_CALC_SIZEOF(FQUEUE_NAME, self->capacity));
+}
+
+#ifdef ARENA
+
+FUNCTION_LINKAGE FQUEUE_TYPE *JOIN(FQUEUE_NAME, create_in_arena)(struct ARENA *arena_ptr, const SIZE_TYPE min_capacity)
+{
+    assert(arena_ptr != NULL);
+
+    if (min_capacity == 0 || min_capacity > FQUEUE_SIZE_MAX / 2 + 1) {
+        return NULL;
+    }
+
+    const SIZE_TYPE capacity = FQUEUE_ROUND_UP(min_capacity);
+
+    if (FQUEUE_CALC_SIZEOF_OVERFLOWS(FQUEUE_NAME, capacity)) {
+        return NULL;
+    }
+
+    const size_t size = FQUEUE_CALC_SIZEOF(FQUEUE_NAME, capacity);
+
+    FQUEUE_TYPE *self =
+        (FQUEUE_TYPE *)JOIN(ARENA, allocate_aligned_uninitialized)(arena_ptr, alignof(FQUEUE_TYPE), size);
+
+    if (!self) {
+        return NULL;
+    }
+
+    FQUEUE_INIT(self, capacity);
+
+    return self;
+}
+
+#endif
+
+#ifdef MIRRORED
+
+/// @cond DO_NOT_DOCUMENT
+static inline size_t JOIN(internal, JOIN(FQUEUE_NAME, page_size))(void)
+{
+    const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+
+    /* the struct fields precede the values on the first page */
+    assert(offsetof(FQUEUE_TYPE, values) <= page_size);
+
+    return page_size;
+}
+/// @endcond
+
+FUNCTION_LINKAGE FQUEUE_TYPE *JOIN(FQUEUE_NAME, create_mirrored)(const SIZE_TYPE min_capacity)
+{
+    if (min_capacity == 0 || min_capacity > FQUEUE_SIZE_MAX / 2 + 1) {
+        return NULL;
+    }
+
+    const size_t page_size = FQUEUE_PAGE_SIZE();
+
+    /* the values must fill whole pages, i.e. (capacity * sizeof(VALUE_TYPE)) % page_size == 0 */
+    const size_t value_size_pow2_factor = sizeof(VALUE_TYPE) & (~sizeof(VALUE_TYPE) + 1);
+    const size_t min_pow2_capacity = value_size_pow2_factor < page_size ? page_size / value_size_pow2_factor : 1;
+
+    SIZE_TYPE capacity = FQUEUE_ROUND_UP(min_capacity);
+
+    if (capacity < min_pow2_capacity) {
+        if (min_pow2_capacity > FQUEUE_SIZE_MAX / 2 + 1) {
+            return NULL;
+        }
+        capacity = (SIZE_TYPE)min_pow2_capacity;
+    }
+
+    if (FQUEUE_CALC_SIZEOF_OVERFLOWS(FQUEUE_NAME, capacity)
+        || (size_t)capacity * sizeof(VALUE_TYPE) > (SIZE_MAX - page_size) / 2) {
+        return NULL;
+    }
+
+    /* layout: [page with the struct fields at the end][values][values again] */
+    const size_t values_size = (size_t)capacity * sizeof(VALUE_TYPE);
+    const size_t mapped_size = page_size + 2 * values_size;
+
+    const unsigned int mfd_cloexec = 1; /* MFD_CLOEXEC in <sys/mman.h>, which requires _GNU_SOURCE */
+    const int fd = (int)syscall(SYS_memfd_create, "fqueue", mfd_cloexec);
+
+    if (fd < 0) {
+        return NULL;
+    }
+    if (ftruncate(fd, (off_t)(page_size + values_size)) != 0) {
+        close(fd);
+        return NULL;
+    }
+
+    /* reserve the address range, and map the file over it twice */
+    unsigned char *base =
+        (unsigned char *)mmap(NULL, mapped_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    if (base == MAP_FAILED) {
+        close(fd);
+        return NULL;
+    }
+    if (mmap(base, page_size + values_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED
+        || mmap(base + page_size + values_size, values_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd,
+                (off_t)page_size)
+               == MAP_FAILED) {
+        munmap(base, mapped_size);
+        close(fd);
+        return NULL;
+    }
+
+    /* the mappings keep the file alive */
+    close(fd);
+
+    FQUEUE_TYPE *self = (FQUEUE_TYPE *)(base + page_size - offsetof(FQUEUE_TYPE, values));
+
+    FQUEUE_INIT(self, capacity);
+
+    return self;
+}
+
+FUNCTION_LINKAGE void JOIN(FQUEUE_NAME, destroy_mirrored)(FQUEUE_TYPE *self)
+{
+    assert(self != NULL);
+
+    const size_t page_size = FQUEUE_PAGE_SIZE();
+    const size_t values_size = (size_t)self->capacity * sizeof(VALUE_TYPE);
+
+    munmap((unsigned char *)self + offsetof(FQUEUE_TYPE, values) - page_size, page_size + 2 * values_size);
+}
+
+FUNCTION_LINKAGE FQUEUE_SPAN_TYPE JOIN(FQUEUE_NAME, readable_span)(FQUEUE_TYPE *self)
 {
     assert(self != NULL);
 
-    free(self);
+    FQUEUE_SPAN_TYPE span = {&self->values[self->begin_index], self->count};
+
+    return span;
 }
 
+FUNCTION_LINKAGE FQUEUE_SPAN_TYPE JOIN(FQUEUE_NAME, writable_span)(FQUEUE_TYPE *self)
+{
+    assert(self != NULL);
+
+#ifdef OVERWRITE
+    FQUEUE_CLAIM(self);
+#endif
+
+    FQUEUE_SPAN_TYPE span = {&self->values[self->end_index], self->capacity - self->count};
+
+    return span;
+}
+
+#endif
+
 FUNCTION_LINKAGE bool JOIN(FQUEUE_NAME, is_empty)(const FQUEUE_TYPE *self)
 {
     assert(self != NULL);
@@ -395,12 +956,12 @@ FUNCTION_LINKAGE bool JOIN(FQUEUE_NAME, is_full)(const FQUEUE_TYPE *self)
     return self->count == self->capacity;
 }
 
-FUNCTION_LINKAGE VALUE_TYPE JOIN(FQUEUE_NAME, at)(const FQUEUE_TYPE *self, const uint32_t index)
+FUNCTION_LINKAGE VALUE_TYPE JOIN(FQUEUE_NAME, at)(const FQUEUE_TYPE *self, const SIZE_TYPE index)
 {
     assert(self != NULL);
     assert(index < self->count);
 
-    const uint32_t index_mask = (self->capacity - 1);
+    const SIZE_TYPE index_mask = (self->capacity - 1);
 
     return self->values[(self->begin_index + index) & index_mask];
 }
@@ -418,7 +979,7 @@ FUNCTION_LINKAGE VALUE_TYPE JOIN(FQUEUE_NAME, get_back)(const FQUEUE_TYPE *self)
     assert(self != NULL);
     assert(!FQUEUE_IS_EMPTY(self));
 
-    const uint32_t index_mask = (self->capacity - 1);
+    const SIZE_TYPE index_mask = (self->capacity - 1);
 
     return self->values[(self->end_index - 1) & index_mask];
 }
@@ -431,15 +992,33 @@ FUNCTION_LINKAGE VALUE_TYPE JOIN(FQUEUE_NAME, peek)(const FQUEUE_TYPE *self)
 FUNCTION_LINKAGE bool JOIN(FQUEUE_NAME, enqueue)(FQUEUE_TYPE *self, const VALUE_TYPE value)
 {
     assert(self != NULL);
-    assert(!FQUEUE_IS_FULL(self));
 
-    const uint32_t index_mask = (self->capacity - 1);
+    const SIZE_TYPE index_mask = (self->capacity - 1);
+
+#ifdef OVERWRITE
+    if (FQUEUE_IS_FULL(self)) {
+        self->begin_index = (self->begin_index + 1) & index_mask;
+        self->count--;
+    }
+
+    const SIZE_TYPE write_count = atomic_load_explicit(&self->write_count, memory_order_relaxed);
+    const SIZE_TYPE next_write_count = FQUEUE_ADVANCE(self, write_count, 1);
+
+    atomic_store_explicit(&self->claimed_count, next_write_count, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+#else
+    assert(!FQUEUE_IS_FULL(self));
+#endif
 
     self->values[self->end_index] = value;
     self->end_index++;
     self->end_index &= index_mask;
     self->count++;
 
+#ifdef OVERWRITE
+    atomic_store_explicit(&self->write_count, next_write_count, memory_order_release);
+#endif
+
     return true;
 }
 
@@ -448,7 +1027,7 @@ FUNCTION_LINKAGE VALUE_TYPE JOIN(FQUEUE_NAME, dequeue)(FQUEUE_TYPE *self)
     assert(self != NULL);
     assert(!FQUEUE_IS_EMPTY(self));
 
-    const uint32_t index_mask = (self->capacity - 1);
+    const SIZE_TYPE index_mask = (self->capacity - 1);
 
     const VALUE_TYPE value = self->values[self->begin_index];
     self->begin_index++;
@@ -458,12 +1037,154 @@ FUNCTION_LINKAGE VALUE_TYPE JOIN(FQUEUE_NAME, dequeue)(FQUEUE_TYPE *self)
     return value;
 }
 
+FUNCTION_LINKAGE void JOIN(FQUEUE_NAME, enqueue_n)(FQUEUE_TYPE *restrict self, const VALUE_TYPE *restrict src,
+                                                   const SIZE_TYPE n)
+{
+    assert(self != NULL);
+    assert(src != NULL || n == 0);
+
+    if (n == 0) {
+        return;
+    }
+
+    const SIZE_TYPE index_mask = (self->capacity - 1);
+
+#ifdef OVERWRITE
+    if (n > self->capacity) {
+        JOIN(FQUEUE_NAME, enqueue_n)(self, &src[n - self->capacity], self->capacity);
+        return;
+    }
+    if (n > self->capacity - self->count) {
+        const SIZE_TYPE dropped_n = n - (self->capacity - self->count);
+
+        self->begin_index = (self->begin_index + dropped_n) & index_mask;
+        self->count -= dropped_n;
+    }
+
+    const SIZE_TYPE write_count = atomic_load_explicit(&self->write_count, memory_order_relaxed);
+    const SIZE_TYPE next_write_count = FQUEUE_ADVANCE(self, write_count, n);
+
+    atomic_store_explicit(&self->claimed_count, next_write_count, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+#else
+    assert(n <= self->capacity - self->count);
+#endif
+
+    const SIZE_TYPE until_end = self->capacity - self->end_index;
+    const SIZE_TYPE first_n = n < until_end ? n : until_end;
+
+    memcpy(&self->values[self->end_index], src, (size_t)first_n * sizeof(VALUE_TYPE));
+    memcpy(&self->values[0], &src[first_n], (size_t)(n - first_n) * sizeof(VALUE_TYPE));
+
+    self->end_index = (self->end_index + n) & index_mask;
+    self->count += n;
+
+#ifdef OVERWRITE
+    atomic_store_explicit(&self->write_count, next_write_count, memory_order_release);
+#endif
+}
+
+FUNCTION_LINKAGE void JOIN(FQUEUE_NAME, dequeue_n)(FQUEUE_TYPE *restrict self, VALUE_TYPE *restrict dest,
+                                                   const SIZE_TYPE n)
+{
+    assert(self != NULL);
+    assert(dest != NULL || n == 0);
+    assert(n <= self->count);
+
+    if (n == 0) {
+        return;
+    }
+
+    const SIZE_TYPE index_mask = (self->capacity - 1);
+    const SIZE_TYPE until_end = self->capacity - self->begin_index;
+    const SIZE_TYPE first_n = n < until_end ? n : until_end;
+
+    memcpy(dest, &self->values[self->begin_index], (size_t)first_n * sizeof(VALUE_TYPE));
+    memcpy(&dest[first_n], &self->values[0], (size_t)(n - first_n) * sizeof(VALUE_TYPE));
+
+    self->begin_index = (self->begin_index + n) & index_mask;
+    self->count -= n;
+}
+
+FUNCTION_LINKAGE SIZE_TYPE JOIN(FQUEUE_NAME, readable_spans)(FQUEUE_TYPE *self, FQUEUE_SPAN_TYPE spans[2])
+{
+    assert(self != NULL);
+    assert(spans != NULL);
+
+    const SIZE_TYPE until_end = self->capacity - self->begin_index;
+    const SIZE_TYPE first_n = self->count < until_end ? self->count : until_end;
+
+    spans[0].values = &self->values[self->begin_index];
+    spans[0].count = first_n;
+    spans[1].values = &self->values[0];
+    spans[1].count = self->count - first_n;
+
+    return (SIZE_TYPE)((spans[0].count != 0) + (spans[1].count != 0));
+}
+
+FUNCTION_LINKAGE SIZE_TYPE JOIN(FQUEUE_NAME, writable_spans)(FQUEUE_TYPE *self, FQUEUE_SPAN_TYPE spans[2])
+{
+    assert(self != NULL);
+    assert(spans != NULL);
+
+#ifdef OVERWRITE
+    FQUEUE_CLAIM(self);
+#endif
+
+    const SIZE_TYPE free_n = self->capacity - self->count;
+    const SIZE_TYPE until_end = self->capacity - self->end_index;
+    const SIZE_TYPE first_n = free_n < until_end ? free_n : until_end;
+
+    spans[0].values = &self->values[self->end_index];
+    spans[0].count = first_n;
+    spans[1].values = &self->values[0];
+    spans[1].count = free_n - first_n;
+
+    return (SIZE_TYPE)((spans[0].count != 0) + (spans[1].count != 0));
+}
+
+FUNCTION_LINKAGE void JOIN(FQUEUE_NAME, commit_write)(FQUEUE_TYPE *self, const SIZE_TYPE n)
+{
+    assert(self != NULL);
+    assert(n <= self->capacity - self->count);
+
+    const SIZE_TYPE index_mask = (self->capacity - 1);
+
+    self->end_index = (self->end_index + n) & index_mask;
+    self->count += n;
+
+#ifdef OVERWRITE
+    const SIZE_TYPE write_count = atomic_load_explicit(&self->write_count, memory_order_relaxed);
+    const SIZE_TYPE next_write_count = FQUEUE_ADVANCE(self, write_count, n);
+
+    /* the free slots after the first n were not written, so the claim shrinks to them */
+    atomic_store_explicit(&self->claimed_count, next_write_count, memory_order_relaxed);
+    atomic_store_explicit(&self->write_count, next_write_count, memory_order_release);
+#endif
+}
+
+FUNCTION_LINKAGE void JOIN(FQUEUE_NAME, consume)(FQUEUE_TYPE *self, const SIZE_TYPE n)
+{
+    assert(self != NULL);
+    assert(n <= self->count);
+
+    const SIZE_TYPE index_mask = (self->capacity - 1);
+
+    self->begin_index = (self->begin_index + n) & index_mask;
+    self->count -= n;
+}
+
 FUNCTION_LINKAGE void JOIN(FQUEUE_NAME, clear)(FQUEUE_TYPE *self)
 {
     assert(self != NULL);
 
     self->count = 0;
+#ifdef OVERWRITE
+    /* the back stays at write_count in the ring */
+    self->begin_index = self->end_index;
+#else
     self->begin_index = self->end_index = 0;
+#endif
 }
 
 FUNCTION_LINKAGE void JOIN(FQUEUE_NAME, copy)(FQUEUE_TYPE *restrict dest_ptr, const FQUEUE_TYPE *restrict src_ptr)
@@ -473,18 +1194,76 @@ FUNCTION_LINKAGE void JOIN(FQUEUE_NAME, copy)(FQUEUE_TYPE *restrict dest_ptr, co
     assert(src_ptr->count <= dest_ptr->capacity);
     assert(FQUEUE_IS_EMPTY(dest_ptr));
 
-    const uint32_t src_begin_index = src_ptr->begin_index;
-    const uint32_t src_index_mask = src_ptr->capacity - 1;
+    const SIZE_TYPE src_begin_index = src_ptr->begin_index;
+    const SIZE_TYPE src_index_mask = src_ptr->capacity - 1;
 
-    for (uint32_t i = 0; i < src_ptr->count; i++) {
+#ifdef OVERWRITE
+    /* enqueued, such that the values are claimed and published to snapshot */
+    for (SIZE_TYPE i = 0; i < src_ptr->count; i++) {
+        JOIN(FQUEUE_NAME, enqueue)(dest_ptr, src_ptr->values[(src_begin_index + i) & src_index_mask]);
+    }
+#else
+    for (SIZE_TYPE i = 0; i < src_ptr->count; i++) {
         dest_ptr->values[i] = src_ptr->values[(src_begin_index + i) & src_index_mask];
     }
 
     dest_ptr->count = src_ptr->count;
     dest_ptr->begin_index = 0;
     dest_ptr->end_index = src_ptr->count;
+#endif
 }
 
+#ifdef OVERWRITE
+
+FUNCTION_LINKAGE SIZE_TYPE JOIN(FQUEUE_NAME, snapshot)(const FQUEUE_TYPE *restrict self, VALUE_TYPE *restrict dest,
+                                                       const SIZE_TYPE n)
+{
+    assert(self != NULL);
+    assert(dest != NULL || n == 0);
+
+    const SIZE_TYPE capacity = self->capacity;
+    const SIZE_TYPE index_mask = capacity - 1;
+
+    for (;;) {
+        const SIZE_TYPE write_count = atomic_load_explicit(&self->write_count, memory_order_acquire);
+
+        SIZE_TYPE copy_n = n < capacity ? n : capacity;
+        copy_n = copy_n < write_count ? copy_n : write_count;
+
+        if (copy_n == 0) {
+            return 0;
+        }
+
+        const SIZE_TYPE begin_index = (SIZE_TYPE)(write_count - copy_n) & index_mask;
+        const SIZE_TYPE until_end = capacity - begin_index;
+        const SIZE_TYPE first_n = copy_n < until_end ? copy_n : until_end;
+
+        memcpy(dest, &self->values[begin_index], (size_t)first_n * sizeof(VALUE_TYPE));
+        memcpy(&dest[first_n], &self->values[0], (size_t)(copy_n - first_n) * sizeof(VALUE_TYPE));
+
+        /* any value copied while being overwritten was claimed before it was written */
+        atomic_thread_fence(memory_order_acquire);
+        const SIZE_TYPE claimed_count = atomic_load_explicit(&self->claimed_count, memory_order_relaxed);
+
+        /* the values claimed since overwrite as many of the oldest copied values */
+        const SIZE_TYPE claimed_since = (SIZE_TYPE)(claimed_count - write_count);
+
+        if (claimed_since >= capacity) {
+            continue;
+        }
+
+        const SIZE_TYPE valid_n = copy_n < capacity - claimed_since ? copy_n : capacity - claimed_since;
+
+        if (valid_n < copy_n) {
+            memmove(dest, &dest[copy_n - valid_n], (size_t)valid_n * sizeof(VALUE_TYPE));
+        }
+
+        return valid_n;
+    }
+}
+
+#endif
+
 #endif
 
 // }}}
@@ -493,16 +1272,27 @@ FUNCTION_LINKAGE void JOIN(FQUEUE_NAME, copy)(FQUEUE_TYPE *restrict dest_ptr, co
 
 #undef NAME
 #undef VALUE_TYPE
+#undef SIZE_TYPE
+#undef ALLOCATOR
+#undef DEALLOCATOR
+#undef ARENA
+#undef MIRRORED
+#undef OVERWRITE
 #undef FUNCTION_LINKAGE
 #undef FUNCTION_DEFINITIONS
 #undef TYPE_DEFINITIONS
 
 #undef FQUEUE_NAME
 #undef FQUEUE_TYPE
-#undef FQUEUE_CALC_SIZEOF
+#undef FQUEUE_SPAN_TYPE
 #undef FQUEUE_INIT
 #undef FQUEUE_IS_EMPTY
 #undef FQUEUE_IS_FULL
+#undef FQUEUE_SIZE_MAX
+#undef FQUEUE_ROUND_UP
+#undef FQUEUE_PAGE_SIZE
+#undef FQUEUE_ADVANCE
+#undef FQUEUE_CLAIM
 
 // }}}
 
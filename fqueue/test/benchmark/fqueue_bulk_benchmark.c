@@ -0,0 +1,135 @@
+// Compares moving bytes through a char queue one at a time with `enqueue` /
+// `dequeue` against `enqueue_n` / `dequeue_n`, in chunks of varying size such
+// that chunks regularly straddle the wrap-around. On Linux, also against
+// single-span copies in and out of a `MIRRORED` queue. Run with `make bench`.
+//
+// usage: ./a.out [number of MiB to move]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define NAME       char_queue
+#define VALUE_TYPE char
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fqueue_template.h"
+
+#ifdef __linux__
+#define NAME       char_mqueue
+#define VALUE_TYPE char
+#define MIRRORED
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fqueue_template.h"
+#endif
+
+#define CAPACITY       (64 * 1024)
+#define MAX_CHUNK_SIZE (4096)
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* chunk sizes of 1 to MAX_CHUNK_SIZE, not multiples of the capacity */
+static uint32_t chunk_size(const uint64_t i)
+{
+    return (uint32_t)(i * 2654435761U % MAX_CHUNK_SIZE) + 1;
+}
+
+int main(int argc, char **argv)
+{
+    const uint64_t total = (argc > 1 ? strtoull(argv[1], NULL, 10) : 256) * 1024 * 1024;
+
+    struct char_queue *q = char_queue_create(CAPACITY);
+    char *src = malloc(MAX_CHUNK_SIZE);
+    char *dest = malloc(MAX_CHUNK_SIZE);
+
+    if (!q || !src || !dest) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+    for (uint32_t i = 0; i < MAX_CHUNK_SIZE; i++) {
+        src[i] = (char)i;
+    }
+
+    printf("%.0f MiB through a queue of %d bytes\n", (double)total / (1024 * 1024), CAPACITY);
+
+    uint64_t checksum = 0;
+
+    /* one value at a time */
+    {
+        const double start = now_s();
+        uint64_t moved = 0;
+        for (uint64_t i = 0; moved < total; i++) {
+            const uint32_t n = chunk_size(i);
+            for (uint32_t j = 0; j < n; j++) {
+                char_queue_enqueue(q, src[j]);
+            }
+            for (uint32_t j = 0; j < n; j++) {
+                dest[j] = char_queue_dequeue(q);
+            }
+            checksum += (unsigned char)dest[n - 1];
+            moved += n;
+        }
+        const double elapsed = now_s() - start;
+        printf("enqueue / dequeue:     %8.2f GiB/s\n", (double)moved / elapsed / (1024 * 1024 * 1024));
+    }
+
+    /* in bulk */
+    {
+        const double start = now_s();
+        uint64_t moved = 0;
+        for (uint64_t i = 0; moved < total; i++) {
+            const uint32_t n = chunk_size(i);
+            char_queue_enqueue_n(q, src, n);
+            char_queue_dequeue_n(q, dest, n);
+            checksum += (unsigned char)dest[n - 1];
+            moved += n;
+        }
+        const double elapsed = now_s() - start;
+        printf("enqueue_n / dequeue_n: %8.2f GiB/s\n", (double)moved / elapsed / (1024 * 1024 * 1024));
+    }
+
+#ifdef __linux__
+    /* mirrored, without wrap-around handling */
+    {
+        struct char_mqueue *mq = char_mqueue_create_mirrored(CAPACITY);
+        if (!mq) {
+            fprintf(stderr, "mapping failed\n");
+            return 1;
+        }
+
+        const double start = now_s();
+        uint64_t moved = 0;
+        for (uint64_t i = 0; moved < total; i++) {
+            const uint32_t n = chunk_size(i);
+            memcpy(char_mqueue_writable_span(mq).values, src, n);
+            char_mqueue_commit_write(mq, n);
+            memcpy(dest, char_mqueue_readable_span(mq).values, n);
+            char_mqueue_consume(mq, n);
+            checksum += (unsigned char)dest[n - 1];
+            moved += n;
+        }
+        const double elapsed = now_s() - start;
+        printf("mirrored spans:        %8.2f GiB/s\n", (double)moved / elapsed / (1024 * 1024 * 1024));
+
+        char_mqueue_destroy_mirrored(mq);
+    }
+#endif
+
+    printf("(checksum %llu)\n", (unsigned long long)checksum);
+
+    free(dest);
+    free(src);
+    char_queue_destroy(q);
+
+    return 0;
+}
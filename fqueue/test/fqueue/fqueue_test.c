@@ -19,6 +19,8 @@
     Mutating operation types:
     - enqueue
     - dequeue
+    - enqueue_n / dequeue_n (n = 0, without and across the wrap-around)
+    - readable_spans / writable_spans + commit_write / consume (empty, full, without and across the wrap-around)
     - clear
 
     Memory operations [to also be tested with sanitizers]:
@@ -26,6 +28,25 @@
     - create
     - destroy
     - copy
+    - create_with_context + destroy_with_context (custom ALLOCATOR / DEALLOCATOR)
+    - create_in_arena
+
+    64-bit SIZE_TYPE:
+    - calc_sizeof / calc_sizeof_overflows beyond 4GiB
+    - enqueue / dequeue / at across index 2^32 and across the wrap-around (in reserved address space)
+
+    MIRRORED [Linux only]:
+    - create_mirrored (capacity rounded up to whole pages) + destroy_mirrored
+    - values[i] and values[i + capacity] alias
+    - readable_span / writable_span across the wrap-around
+
+    OVERWRITE:
+    - enqueue / enqueue_n on a full queue drop the front values
+    - enqueue_n of more than capacity values keeps the last capacity values
+    - snapshot (n = 0, fewer values enqueued than n, across the wrap-around of the counts)
+    - snapshot after writable_spans + commit_write, clear and copy
+    - snapshot while another thread enqueues: the values are the latest and consecutive
+    - snapshot while another thread mixes enqueue, writable_spans + commit_write, consume and clear
 */
 
 #define NAME       i64_que
@@ -119,6 +140,176 @@ static inline bool copy_values_and_check_ordered_values(const struct i64_que *qu
     return res;
 }
 
+#define NAME arena
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "arena_template.h"
+
+struct alloc_stats {
+    size_t allocated_size;
+    size_t freed_size;
+};
+
+static void *counting_alloc(struct alloc_stats *stats, const size_t size)
+{
+    if (stats) {
+        stats->allocated_size += size;
+    }
+    return malloc(size);
+}
+
+static void counting_free(struct alloc_stats *stats, void *ptr, const size_t size)
+{
+    if (stats) {
+        stats->freed_size += size;
+    }
+    free(ptr);
+}
+
+#define NAME       i64_que_ctx
+#define VALUE_TYPE int64_t
+#define ALLOCATOR(ctx, size)        counting_alloc((ctx), (size))
+#define DEALLOCATOR(ctx, ptr, size) counting_free((ctx), (ptr), (size))
+#define ARENA                       arena
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fqueue_template.h"
+
+#define NAME       u8_que64
+#define VALUE_TYPE uint8_t
+#define SIZE_TYPE  uint64_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fqueue_template.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+
+// reserve address space without backing it, such that only the touched pages use memory
+static void *map_large(const size_t size)
+{
+    void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return ptr == MAP_FAILED ? NULL : ptr;
+}
+
+#define NAME       u8_mque
+#define VALUE_TYPE uint8_t
+#define MIRRORED
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fqueue_template.h"
+
+struct vec3 {
+    uint32_t x, y, z;
+};
+
+#define NAME       vec3_mque
+#define VALUE_TYPE struct vec3
+#define MIRRORED
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fqueue_template.h"
+#endif
+
+#include <pthread.h>
+#include <sched.h>
+
+#define NAME       u64_oque
+#define VALUE_TYPE uint64_t
+#define OVERWRITE
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fqueue_template.h"
+
+#define OVERWRITE_VALUE_COUNT (1000000)
+
+static void *overwrite_writer(void *arg)
+{
+    struct u64_oque *que_p = arg;
+    uint64_t values[8];
+
+    for (uint64_t i = 0; i < OVERWRITE_VALUE_COUNT;) {
+        if (i % 16 == 0) {
+            for (uint64_t j = 0; j < 8; j++) {
+                values[j] = i + j;
+            }
+            u64_oque_enqueue_n(que_p, values, 8);
+            i += 8;
+        }
+        else {
+            u64_oque_enqueue(que_p, i++);
+        }
+    }
+    return NULL;
+}
+
+static void *overwrite_span_writer(void *arg)
+{
+    struct u64_oque *que_p = arg;
+    struct u64_oque_span spans[2];
+
+    for (uint64_t i = 0, round = 0; i < OVERWRITE_VALUE_COUNT; round++) {
+        if (round % 16 == 0) {
+            u64_oque_clear(que_p);
+        }
+        else if (que_p->count > que_p->capacity - 5) {
+            u64_oque_consume(que_p, 5);
+        }
+
+        // up to 5 values in place, across the end of the ring when the spans wrap around
+        u64_oque_writable_spans(que_p, spans);
+        uint64_t n = 0;
+        for (uint32_t k = 0; k < 2; k++) {
+            for (uint64_t j = 0; j < spans[k].count && n < 5 && i + n < OVERWRITE_VALUE_COUNT; j++) {
+                spans[k].values[j] = i + n++;
+            }
+        }
+        u64_oque_commit_write(que_p, (uint32_t)n);
+        i += n;
+
+        if (i < OVERWRITE_VALUE_COUNT) {
+            u64_oque_enqueue(que_p, i++);
+        }
+    }
+    return NULL;
+}
+
+static void overwrite_concurrent_test(void *(*writer)(void *))
+{
+    struct u64_oque *que_p = u64_oque_create(64);
+    if (!que_p) {
+        assert(false);
+    }
+    pthread_t thread;
+    assert(pthread_create(&thread, NULL, writer, que_p) == 0);
+
+    uint64_t dest[16];
+    uint64_t last_newest = 0;
+    for (;;) {
+        const uint32_t n = u64_oque_snapshot(que_p, dest, 16);
+        for (uint32_t i = 1; i < n; i++) {
+            assert(dest[i] == dest[i - 1] + 1);
+        }
+        if (n > 0) {
+            assert(dest[n - 1] >= last_newest);
+            last_newest = dest[n - 1];
+        }
+        if (last_newest == OVERWRITE_VALUE_COUNT - 1) {
+            break;
+        }
+        sched_yield();
+    }
+    assert(pthread_join(thread, NULL) == 0);
+
+    u64_oque_destroy(que_p);
+}
+
 int main(void)
 {
     // N = 0
@@ -365,4 +556,373 @@ int main(void)
 
         i64_que_destroy(que_p);
     }
+    // N = 16, enqueue_n / dequeue_n
+    {
+        struct i64_que *que_p = i64_que_create(16);
+        if (!que_p) {
+            assert(false);
+        }
+        const int64_t src[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+        int64_t dest[16] = {0};
+
+        i64_que_enqueue_n(que_p, src, 0);
+        i64_que_dequeue_n(que_p, dest, 0);
+        assert(check_count_invariance(que_p, 0, 0));
+
+        // without wrap-around
+        i64_que_enqueue_n(que_p, src, 12);
+        assert(check_count_invariance(que_p, 12, 0));
+        assert(check_front_back(que_p, 0, 11));
+        i64_que_dequeue_n(que_p, dest, 12);
+        assert(check_count_invariance(que_p, 12, 12));
+        assert(memcmp(dest, src, 12 * sizeof(int64_t)) == 0);
+
+        // across the wrap-around: begin_index = end_index = 12
+        i64_que_enqueue_n(que_p, src, 10);
+        assert(que_p->end_index == 6);
+        assert(check_count_invariance(que_p, 22, 12));
+        assert(check_front_back(que_p, 0, 9));
+        assert(check_ordered_values(que_p, 10, (int64_t[10]){0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+
+        i64_que_enqueue(que_p, 10);
+        i64_que_dequeue_n(que_p, dest, 7);
+        assert(que_p->begin_index == 3);
+        assert(memcmp(dest, src, 7 * sizeof(int64_t)) == 0);
+        assert(check_ordered_values(que_p, 4, (int64_t[4]){7, 8, 9, 10}));
+
+        // up to full
+        i64_que_enqueue_n(que_p, &src[4], 12);
+        assert(i64_que_is_full(que_p));
+        i64_que_dequeue_n(que_p, dest, 16);
+        assert(i64_que_is_empty(que_p));
+        assert(memcmp(dest, (int64_t[4]){7, 8, 9, 10}, 4 * sizeof(int64_t)) == 0);
+        assert(memcmp(&dest[4], &src[4], 12 * sizeof(int64_t)) == 0);
+
+        i64_que_destroy(que_p);
+    }
+    // N = 8, readable_spans / writable_spans + commit_write / consume
+    {
+        struct i64_que *que_p = i64_que_create(8);
+        if (!que_p) {
+            assert(false);
+        }
+        struct i64_que_span spans[2];
+
+        // empty
+        assert(i64_que_readable_spans(que_p, spans) == 0);
+        assert(spans[0].count == 0 && spans[1].count == 0);
+        assert(i64_que_writable_spans(que_p, spans) == 1);
+        assert(spans[0].values == &que_p->values[0] && spans[0].count == 8 && spans[1].count == 0);
+
+        // produce 6 values in place
+        for (int64_t i = 0; i < 6; i++) {
+            spans[0].values[i] = 420 + i;
+        }
+        i64_que_commit_write(que_p, 6);
+        assert(check_count_invariance(que_p, 6, 0));
+        assert(check_ordered_values(que_p, 6, (int64_t[6]){420, 421, 422, 423, 424, 425}));
+
+        // consume 5 values in place
+        assert(i64_que_readable_spans(que_p, spans) == 1);
+        assert(spans[0].values == &que_p->values[0] && spans[0].count == 6);
+        i64_que_consume(que_p, 5);
+        assert(check_count_invariance(que_p, 6, 5));
+        assert(i64_que_get_front(que_p) == 425);
+
+        // the free slots wrap around: 2 at the end, 5 at the start
+        assert(i64_que_writable_spans(que_p, spans) == 2);
+        assert(spans[0].values == &que_p->values[6] && spans[0].count == 2);
+        assert(spans[1].values == &que_p->values[0] && spans[1].count == 5);
+        spans[0].values[0] = 426;
+        spans[0].values[1] = 427;
+        spans[1].values[0] = 428;
+        i64_que_commit_write(que_p, 3);
+        assert(que_p->end_index == 1);
+
+        // the values wrap around: 3 at the end, 1 at the start
+        assert(i64_que_readable_spans(que_p, spans) == 2);
+        assert(spans[0].values == &que_p->values[5] && spans[0].count == 3);
+        assert(spans[1].values == &que_p->values[0] && spans[1].count == 1);
+        assert(spans[0].values[0] == 425 && spans[0].values[2] == 427 && spans[1].values[0] == 428);
+
+        // full
+        i64_que_commit_write(que_p, 4);
+        assert(i64_que_is_full(que_p));
+        assert(i64_que_writable_spans(que_p, spans) == 0);
+        assert(i64_que_readable_spans(que_p, spans) == 2);
+        assert(spans[0].count + spans[1].count == 8);
+
+        i64_que_consume(que_p, 8);
+        assert(i64_que_is_empty(que_p));
+        assert(que_p->begin_index == que_p->end_index);
+
+        i64_que_destroy(que_p);
+    }
+    // custom allocator
+    {
+        struct alloc_stats stats = {0, 0};
+
+        struct i64_que_ctx *que_p = i64_que_ctx_create_with_context(10, &stats);
+        if (!que_p) {
+            assert(false);
+        }
+        assert(stats.allocated_size == FQUEUE_CALC_SIZEOF(i64_que_ctx, que_p->capacity));
+
+        for (int64_t i = 0; i < 10; i++) {
+            i64_que_ctx_enqueue(que_p, i);
+        }
+        assert(i64_que_ctx_dequeue(que_p) == 0);
+
+        i64_que_ctx_destroy_with_context(que_p, &stats);
+        assert(stats.freed_size == stats.allocated_size);
+
+        que_p = i64_que_ctx_create(10);
+        if (!que_p) {
+            assert(false);
+        }
+        i64_que_ctx_destroy(que_p);
+    }
+    // arena, with leftover garbage in its memory: create_in_arena must not rely on it being zeroed
+    {
+        unsigned char buf[1024];
+        memset(buf, 0xa5, sizeof(buf));
+        struct arena arena;
+        arena_init(&arena, sizeof(buf), buf);
+
+        struct i64_que_ctx *que_p = i64_que_ctx_create_in_arena(&arena, 10);
+        if (!que_p) {
+            assert(false);
+        }
+        assert((unsigned char *)que_p >= buf && (unsigned char *)que_p < buf + sizeof(buf));
+        assert(i64_que_ctx_is_empty(que_p));
+
+        for (int64_t i = 0; i < 10; i++) {
+            i64_que_ctx_enqueue(que_p, i);
+        }
+        assert(i64_que_ctx_dequeue(que_p) == 0);
+
+        assert(i64_que_ctx_create_in_arena(&arena, 1024) == NULL);
+    }
+    // 64-bit SIZE_TYPE
+    {
+        const uint64_t capacity = (uint64_t)1 << 33;
+        const size_t size = FQUEUE_CALC_SIZEOF(u8_que64, capacity);
+
+        assert(size == offsetof(struct u8_que64, values) + capacity);
+        assert(!FQUEUE_CALC_SIZEOF_OVERFLOWS(u8_que64, capacity));
+        assert(FQUEUE_CALC_SIZEOF_OVERFLOWS(u8_que64, UINT64_MAX));
+        assert(u8_que64_create(UINT64_MAX / 2 + 2) == NULL);
+
+        struct u8_que64 *que_p = u8_que64_create(10);
+        if (!que_p) {
+            assert(false);
+        }
+        assert(que_p->capacity == 16);
+        for (uint8_t i = 0; i < 16; i++) {
+            u8_que64_enqueue(que_p, i);
+        }
+        assert(u8_que64_dequeue(que_p) == 0);
+        u8_que64_destroy(que_p);
+
+#ifdef __linux__
+        void *buf = map_large(size);
+        if (buf) {
+            que_p = u8_que64_init(buf, capacity);
+
+            // skip over the first UINT32_MAX - 1 slots without touching them
+            que_p->begin_index = que_p->end_index = UINT32_MAX - 1;
+            for (uint8_t i = 0; i < 4; i++) {
+                u8_que64_enqueue(que_p, i);
+            }
+            assert(que_p->end_index == ((uint64_t)1 << 32) + 2);
+            assert(u8_que64_at(que_p, 3) == 3 && u8_que64_get_back(que_p) == 3);
+            for (uint8_t i = 0; i < 4; i++) {
+                assert(u8_que64_dequeue(que_p) == i);
+            }
+
+            // wrap around at the end
+            que_p->begin_index = que_p->end_index = capacity - 2;
+            for (uint8_t i = 0; i < 4; i++) {
+                u8_que64_enqueue(que_p, i);
+            }
+            assert(que_p->end_index == 2 && que_p->values[1] == 3);
+            for (uint8_t i = 0; i < 4; i++) {
+                assert(u8_que64_dequeue(que_p) == i);
+            }
+
+            munmap(buf, size);
+        }
+#endif
+    }
+#ifdef __linux__
+    // MIRRORED
+    {
+        const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+
+        assert(u8_mque_create_mirrored(0) == NULL);
+
+        struct u8_mque *que_p = u8_mque_create_mirrored(1);
+        if (!que_p) {
+            assert(false);
+        }
+        const uint32_t capacity = que_p->capacity;
+        assert(capacity >= page_size && capacity % page_size == 0);
+
+        que_p->values[0] = 42;
+        assert(que_p->values[capacity] == 42);
+        que_p->values[capacity + 1] = 69;
+        assert(que_p->values[1] == 69);
+
+        // move the front close to the end of the ring
+        que_p->begin_index = que_p->end_index = capacity - 3;
+
+        const uint8_t src[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+        u8_mque_enqueue_n(que_p, src, 10);
+        assert(que_p->end_index == 7);
+
+        struct u8_mque_span span = u8_mque_readable_span(que_p);
+        assert(span.values == &que_p->values[capacity - 3] && span.count == 10);
+        assert(memcmp(span.values, src, 10) == 0);
+
+        span = u8_mque_writable_span(que_p);
+        assert(span.values == &que_p->values[7] && span.count == capacity - 10);
+        u8_mque_consume(que_p, 10);
+
+        // write across the wrap-around in place
+        que_p->begin_index = que_p->end_index = capacity - 1;
+        span = u8_mque_writable_span(que_p);
+        assert(span.count == capacity);
+        memcpy(span.values, src, 10);
+        u8_mque_commit_write(que_p, 10);
+        for (uint8_t i = 0; i < 10; i++) {
+            assert(u8_mque_dequeue(que_p) == i);
+        }
+
+        u8_mque_destroy_mirrored(que_p);
+
+        // a value size which is not a power of two
+        struct vec3_mque *vec_p = vec3_mque_create_mirrored(1);
+        if (!vec_p) {
+            assert(false);
+        }
+        assert((vec_p->capacity * sizeof(struct vec3)) % page_size == 0);
+
+        vec_p->begin_index = vec_p->end_index = vec_p->capacity - 1;
+        for (uint32_t i = 0; i < 3; i++) {
+            vec3_mque_enqueue(vec_p, (struct vec3){i, i, i});
+        }
+        struct vec3_mque_span vec_span = vec3_mque_readable_span(vec_p);
+        assert(vec_span.count == 3);
+        for (uint32_t i = 0; i < 3; i++) {
+            assert(vec_span.values[i].x == i && vec_span.values[i].z == i);
+        }
+
+        vec3_mque_destroy_mirrored(vec_p);
+    }
+#endif
+    // OVERWRITE
+    {
+        struct u64_oque *que_p = u64_oque_create(8);
+        if (!que_p) {
+            assert(false);
+        }
+        uint64_t dest[16];
+
+        assert(u64_oque_snapshot(que_p, dest, 16) == 0);
+
+        for (uint64_t i = 0; i < 3; i++) {
+            u64_oque_enqueue(que_p, i);
+        }
+        assert(u64_oque_snapshot(que_p, dest, 0) == 0);
+        assert(u64_oque_snapshot(que_p, dest, 16) == 3);
+        assert(dest[0] == 0 && dest[2] == 2);
+        assert(u64_oque_snapshot(que_p, dest, 2) == 2);
+        assert(dest[0] == 1 && dest[1] == 2);
+
+        // the front values are dropped
+        for (uint64_t i = 3; i < 20; i++) {
+            u64_oque_enqueue(que_p, i);
+        }
+        assert(u64_oque_is_full(que_p));
+        assert(u64_oque_get_front(que_p) == 12 && u64_oque_get_back(que_p) == 19);
+        assert(u64_oque_snapshot(que_p, dest, 16) == 8);
+        for (uint64_t i = 0; i < 8; i++) {
+            assert(dest[i] == 12 + i);
+        }
+
+        // snapshots are of the latest enqueued values, regardless of dequeues
+        assert(u64_oque_dequeue(que_p) == 12);
+        assert(u64_oque_snapshot(que_p, dest, 1) == 1 && dest[0] == 19);
+
+        const uint64_t src[20] = {100, 101, 102, 103, 104, 105, 106, 107, 108, 109,
+                                  110, 111, 112, 113, 114, 115, 116, 117, 118, 119};
+        u64_oque_enqueue_n(que_p, src, 3);
+        assert(que_p->count == 8 && u64_oque_get_front(que_p) == 15);
+        u64_oque_enqueue_n(que_p, src, 20);
+        assert(que_p->count == 8 && u64_oque_get_front(que_p) == 112);
+        assert(u64_oque_snapshot(que_p, dest, 8) == 8);
+        for (uint64_t i = 0; i < 8; i++) {
+            assert(u64_oque_dequeue(que_p) == 112 + i && dest[i] == 112 + i);
+        }
+
+        // values written in place are published to snapshot
+        struct u64_oque_span spans[2];
+        assert(u64_oque_writable_spans(que_p, spans) >= 1);
+        assert(spans[0].count + spans[1].count == 8);
+        for (uint64_t i = 0; i < 2; i++) {
+            *(i < spans[0].count ? &spans[0].values[i] : &spans[1].values[i - spans[0].count]) = 200 + i;
+        }
+        u64_oque_commit_write(que_p, 2);
+        assert(u64_oque_snapshot(que_p, dest, 3) == 3);
+        assert(dest[0] == 119 && dest[1] == 200 && dest[2] == 201);
+
+        // clear keeps the back in place, such that later values are where snapshot expects them
+        u64_oque_clear(que_p);
+        u64_oque_enqueue(que_p, 300);
+        assert(u64_oque_writable_spans(que_p, spans) == 2);
+        assert(spans[0].count + spans[1].count == 7);
+        for (uint64_t i = 0; i < 7; i++) {
+            *(i < spans[0].count ? &spans[0].values[i] : &spans[1].values[i - spans[0].count]) = 301 + i;
+        }
+        u64_oque_commit_write(que_p, 7);
+        assert(u64_oque_snapshot(que_p, dest, 8) == 8);
+        for (uint64_t i = 0; i < 8; i++) {
+            assert(dest[i] == 300 + i && u64_oque_at(que_p, (uint32_t)i) == 300 + i);
+        }
+
+        // copied values are published to snapshot
+        struct u64_oque *copy_p = u64_oque_create(8);
+        if (!copy_p) {
+            assert(false);
+        }
+        u64_oque_enqueue(copy_p, 1);
+        u64_oque_dequeue(copy_p);
+        u64_oque_copy(copy_p, que_p);
+        assert(u64_oque_is_full(copy_p));
+        assert(u64_oque_snapshot(copy_p, dest, 8) == 8);
+        for (uint64_t i = 0; i < 8; i++) {
+            assert(dest[i] == 300 + i && u64_oque_dequeue(copy_p) == 300 + i);
+        }
+        u64_oque_destroy(copy_p);
+
+        // counts about to wrap around
+        u64_oque_clear(que_p);
+        que_p->begin_index = que_p->end_index = (UINT32_MAX - 1) & 7;
+        atomic_store(&que_p->claimed_count, UINT32_MAX - 1);
+        atomic_store(&que_p->write_count, UINT32_MAX - 1);
+        for (uint64_t i = 0; i < 4; i++) {
+            u64_oque_enqueue(que_p, i);
+        }
+        assert(atomic_load(&que_p->write_count) == 2 + 8);
+        assert(u64_oque_snapshot(que_p, dest, 4) == 4);
+        for (uint64_t i = 0; i < 4; i++) {
+            assert(dest[i] == i);
+        }
+
+        u64_oque_destroy(que_p);
+
+        // a concurrent writer
+        overwrite_concurrent_test(overwrite_writer);
+        overwrite_concurrent_test(overwrite_span_writer);
+    }
 }
@@ -34,6 +34,11 @@ extern "C" {
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#ifdef ARENA
+#include <stdalign.h> // alignof
+#endif
 
 // macro definitions: {{{
 
@@ -68,7 +73,7 @@ extern "C" {
  * @warning Modifying the stack under the iteration may result in errors.
  *
  * @param[in] self              Stack pointer.
- * @param[in] index             Temporary indexing variable. Should be `uint32_t`.
+ * @param[in] index             Temporary indexing variable. Should be `SIZE_TYPE`.
  * @param[out] value            Current value. Should be `VALUE_TYPE`.
  */
 #ifndef FSTACK_FOR_EACH
@@ -83,7 +88,7 @@ extern "C" {
  * @warning Modifying the stack under the iteration may result in errors.
  *
  * @param[in] self              Stack pointer.
- * @param[in] index             Temporary indexing variable. Should be `uint32_t`.
+ * @param[in] index             Temporary indexing variable. Should be `SIZE_TYPE`.
  * @param[out] value            Current value. Should be `VALUE_TYPE`.
  */
 #ifndef FSTACK_FOR_EACH_REVERSE
@@ -103,7 +108,7 @@ extern "C" {
  */
 #ifndef FSTACK_CALC_SIZEOF
 #define FSTACK_CALC_SIZEOF(fstack_name, capacity) \
-    (uint32_t)(offsetof(struct fstack_name, values) + capacity * sizeof(((struct fstack_name *)0)->values[0]))
+    (offsetof(struct fstack_name, values) + (size_t)(capacity) * sizeof(((struct fstack_name *)0)->values[0]))
 #endif
 
 /**
@@ -118,7 +123,8 @@ extern "C" {
  */
 #ifndef FSTACK_CALC_SIZEOF_OVERFLOWS
 #define FSTACK_CALC_SIZEOF_OVERFLOWS(fstack_name, capacity) \
-    (capacity > (UINT32_MAX - offsetof(struct fstack_name, values)) / sizeof(((struct fstack_name *)0)->values[0]))
+    ((uintmax_t)0 + (capacity)                              \
+     > (SIZE_MAX - offsetof(struct fstack_name, values)) / sizeof(((struct fstack_name *)0)->values[0]))
 #endif
 
 /**
@@ -149,6 +155,67 @@ extern "C" {
 #error "Must define VALUE_TYPE."
 #endif
 
+/**
+ * @def SIZE_TYPE
+ * @brief Stack count, capacity and index type. Defaults to `uint32_t`.
+ *
+ * Define as `uint64_t` (or `size_t`) for stacks of more than `UINT32_MAX`
+ * values. Must be an unsigned integer type.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef SIZE_TYPE
+#define SIZE_TYPE uint32_t
+#endif
+
+/**
+ * @def ALLOCATOR(ctx, size)
+ * @brief Used by `create` and `create_with_context` to allocate the memory of
+ *        the stack. Defaults to malloc().
+ *
+ * Is undefined once header is included.
+ *
+ * @note The memory need not be zeroed. `init` initializes what is read.
+ *
+ * @param ctx The context pointer given to `create_with_context` (or NULL).
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the memory, or NULL if the allocation fails.
+ */
+#if defined(ALLOCATOR) != defined(DEALLOCATOR)
+#error "Must define both ALLOCATOR and DEALLOCATOR."
+#endif
+#ifndef ALLOCATOR
+#define ALLOCATOR(ctx, size) ((void)(ctx), malloc(size))
+#endif
+
+/**
+ * @def DEALLOCATOR(ctx, ptr, size)
+ * @brief Used by `destroy` and `destroy_with_context` to free the memory of
+ *        the stack. Defaults to free().
+ *
+ * Is undefined once header is included.
+ *
+ * @param ctx The context pointer given to `destroy_with_context` (or NULL).
+ * @param ptr The pointer returned by `ALLOCATOR`.
+ * @param size The number of bytes allocated.
+ */
+#ifndef DEALLOCATOR
+#define DEALLOCATOR(ctx, ptr, size) ((void)(ctx), (void)(size), free(ptr))
+#endif
+
+/**
+ * @def ARENA
+ * @brief The `NAME` of an arena defined with `arena_template.h`. Generates
+ *        `create_in_arena` if defined.
+ *
+ * The arena type and functions must be declared before including this header
+ * file.
+ *
+ * Is undefined once header is included.
+ */
+#ifdef ARENA
+#endif
+
 /**
  * @def FUNCTION_LINKAGE
  * @brief Specify function linkage e.g. static inline
@@ -178,8 +245,8 @@ extern "C" {
  * @brief Generated stack struct type for a given `VALUE_TYPE`.
  */
 struct FSTACK_NAME {
-    uint32_t count;      ///< number of values.
-    uint32_t capacity;   ///< maximum number of values allocated for.
+    SIZE_TYPE count;     ///< number of values.
+    SIZE_TYPE capacity;  ///< maximum number of values allocated for.
     VALUE_TYPE values[]; ///< array of values.
 };
 
@@ -195,22 +262,37 @@ struct FSTACK_NAME {
  * @param[in] self              Stack pointer
  * @param[in] capacity          Capacity
  */
-FUNCTION_LINKAGE FSTACK_TYPE *JOIN(FSTACK_NAME, init)(FSTACK_TYPE *self, const uint32_t capacity);
+FUNCTION_LINKAGE FSTACK_TYPE *JOIN(FSTACK_NAME, init)(FSTACK_TYPE *self, const SIZE_TYPE capacity);
 
 /**
- * @brief Create an stack struct with a given capacity with malloc().
+ * @brief Create an stack struct with a given capacity with `ALLOCATOR`.
  *
  * @param[in] capacity          Maximum number of elements.
  *
  * @return                      A pointer to the stack.
  * @retval NULL
  *   @li                        If capacity is 0 or the equivalent size overflows
- *   @li                        If malloc fails.
+ *   @li                        If the allocation fails.
  */
-FUNCTION_LINKAGE FSTACK_TYPE *JOIN(FSTACK_NAME, create)(const uint32_t capacity);
+FUNCTION_LINKAGE FSTACK_TYPE *JOIN(FSTACK_NAME, create)(const SIZE_TYPE capacity);
 
 /**
- * @brief Destroy an stack struct and free the underlying memory with free().
+ * @brief Create a stack struct with a given capacity with `ALLOCATOR`, given
+ *        a context pointer.
+ *
+ * @param[in] capacity          Maximum number of elements.
+ * @param[in] ctx               The context pointer passed to `ALLOCATOR`.
+ *
+ * @return                      A pointer to the stack.
+ * @retval NULL
+ *   @li                        If capacity is 0 or the equivalent size overflows
+ *   @li                        If the allocation fails.
+ */
+FUNCTION_LINKAGE FSTACK_TYPE *JOIN(FSTACK_NAME, create_with_context)(const SIZE_TYPE capacity, void *ctx);
+
+/**
+ * @brief Destroy an stack struct and free the underlying memory with
+ *        `DEALLOCATOR`.
  *
  * @warning May not be called twice in a row on the same object.
  *
@@ -218,6 +300,37 @@ FUNCTION_LINKAGE FSTACK_TYPE *JOIN(FSTACK_NAME, create)(const uint32_t capacity)
  */
 FUNCTION_LINKAGE void JOIN(FSTACK_NAME, destroy)(FSTACK_TYPE *self);
 
+/**
+ * @brief Destroy a stack struct and free the underlying memory with
+ *        `DEALLOCATOR`, given a context pointer.
+ *
+ * @warning May not be called twice in a row on the same object.
+ *
+ * @param[in] self              The stack pointer.
+ * @param[in] ctx               The context pointer passed to `DEALLOCATOR`.
+ */
+FUNCTION_LINKAGE void JOIN(FSTACK_NAME, destroy_with_context)(FSTACK_TYPE *self, void *ctx);
+
+#ifdef ARENA
+
+/**
+ * @brief Create a stack struct with a given capacity in an arena.
+ *
+ * The stack is freed along with the arena memory, and must not be
+ * destroyed.
+ *
+ * @param[in] arena_ptr         The arena pointer.
+ * @param[in] capacity          Maximum number of elements.
+ *
+ * @return                      A pointer to the stack.
+ * @retval NULL
+ *   @li                        If capacity is 0 or the equivalent size overflows
+ *   @li                        If the arena is out of memory.
+ */
+FUNCTION_LINKAGE FSTACK_TYPE *JOIN(FSTACK_NAME, create_in_arena)(struct ARENA *arena_ptr, const SIZE_TYPE capacity);
+
+#endif
+
 /**
  * @brief Return whether the stack is empty.
  *
@@ -247,7 +360,7 @@ FUNCTION_LINKAGE bool JOIN(FSTACK_NAME, is_full)(const FSTACK_TYPE *self);
  *
  * @return                      The value at `index`.
  */
-FUNCTION_LINKAGE VALUE_TYPE JOIN(FSTACK_NAME, at)(const FSTACK_TYPE *self, const uint32_t index);
+FUNCTION_LINKAGE VALUE_TYPE JOIN(FSTACK_NAME, at)(const FSTACK_TYPE *self, const SIZE_TYPE index);
 
 /**
  * @brief Get the value from the top of a non-empty stack.
@@ -293,6 +406,56 @@ FUNCTION_LINKAGE void JOIN(FSTACK_NAME, push)(FSTACK_TYPE *self, const VALUE_TYP
  */
 FUNCTION_LINKAGE VALUE_TYPE JOIN(FSTACK_NAME, pop)(FSTACK_TYPE *self);
 
+/**
+ * @brief Push `n` values onto a stack with room for them.
+ *
+ * The values are copied in as one contiguous segment. `src[n - 1]` becomes the
+ * top value.
+ *
+ * @param[in] self              The stack pointer.
+ * @param[in] src               The values to push, from bottom to top.
+ * @param[in] n                 The number of values.
+ */
+FUNCTION_LINKAGE void JOIN(FSTACK_NAME, push_n)(FSTACK_TYPE *restrict self, const VALUE_TYPE *restrict src,
+                                                const SIZE_TYPE n);
+
+/**
+ * @brief Pop `n` values away from a stack with at least `n` values.
+ *
+ * The values are copied out as one contiguous segment. `dest[n - 1]` is set to
+ * the former top value.
+ *
+ * @param[in] self              The stack pointer.
+ * @param[out] dest             Set to the popped values, from bottom to top.
+ * @param[in] n                 The number of values.
+ */
+FUNCTION_LINKAGE void JOIN(FSTACK_NAME, pop_n)(FSTACK_TYPE *restrict self, VALUE_TYPE *restrict dest,
+                                               const SIZE_TYPE n);
+
+/**
+ * @brief Get the top `n` values of a stack with at least `n` values, as a span
+ *        of the stack storage. For reading (or modifying) the values in place.
+ *
+ * @note The span is valid until the stack is modified with `push`, `push_n`,
+ *       `copy` or destroyed.
+ *
+ * @param[in] self              The stack pointer.
+ * @param[in] n                 The number of values.
+ *
+ * @return                      A pointer to the `n` values, from bottom to
+ *                              top. The top value is at index `n - 1`.
+ */
+FUNCTION_LINKAGE VALUE_TYPE *JOIN(FSTACK_NAME, peek_n)(FSTACK_TYPE *self, const SIZE_TYPE n);
+
+/**
+ * @brief Truncate the stack to a given count, popping away the values above
+ *        it in O(1).
+ *
+ * @param[in] self              The stack pointer.
+ * @param[in] count             The new count. At most the current count.
+ */
+FUNCTION_LINKAGE void JOIN(FSTACK_NAME, truncate)(FSTACK_TYPE *self, const SIZE_TYPE count);
+
 /**
  * @brief Clear the elements in the stack.
  *
@@ -318,7 +481,7 @@ FUNCTION_LINKAGE void JOIN(FSTACK_NAME, copy)(FSTACK_TYPE *restrict dest_ptr, co
  */
 #ifdef FUNCTION_DEFINITIONS
 
-FUNCTION_LINKAGE FSTACK_TYPE *JOIN(FSTACK_NAME, init)(FSTACK_TYPE *self, const uint32_t capacity)
+FUNCTION_LINKAGE FSTACK_TYPE *JOIN(FSTACK_NAME, init)(FSTACK_TYPE *self, const SIZE_TYPE capacity)
 {
     assert(self);
 
@@ -328,15 +491,20 @@ FUNCTION_LINKAGE FSTACK_TYPE *JOIN(FSTACK_NAME, init)(FSTACK_TYPE *self, const u
     return self;
 }
 
-FUNCTION_LINKAGE FSTACK_TYPE *JOIN(FSTACK_NAME, create)(const uint32_t capacity)
+FUNCTION_LINKAGE FSTACK_TYPE *JOIN(FSTACK_NAME, create)(const SIZE_TYPE capacity)
+{
+    return JOIN(FSTACK_NAME, create_with_context)(capacity, NULL);
+}
+
+FUNCTION_LINKAGE FSTACK_TYPE *JOIN(FSTACK_NAME, create_with_context)(const SIZE_TYPE capacity, void *ctx)
 {
     if (capacity == 0 || FSTACK_CALC_SIZEOF_OVERFLOWS(FSTACK_NAME, capacity)) {
         return NULL;
     }
 
-    const uint32_t size = FSTACK_CALC_SIZEOF(FSTACK_NAME, capacity);
+    const size_t size = FSTACK_CALC_SIZEOF(FSTACK_NAME, capacity);
 
-    FSTACK_TYPE *self = (FSTACK_TYPE *)calloc(1, size);
+    FSTACK_TYPE *self = (FSTACK_TYPE *)ALLOCATOR(ctx, size);
 
     if (!self) {
         return NULL;
@@ -348,12 +516,43 @@ FUNCTION_LINKAGE FSTACK_TYPE *JOIN(FSTACK_NAME, create)(const uint32_t capacity)
 }
 
 FUNCTION_LINKAGE void JOIN(FSTACK_NAME, destroy)(FSTACK_TYPE *self)
+{
+    JOIN(FSTACK_NAME, destroy_with_context)(self, NULL);
+}
+
+FUNCTION_LINKAGE void JOIN(FSTACK_NAME, destroy_with_context)(FSTACK_TYPE *self, void *ctx)
 {
     assert(self != NULL);
 
-    free(self);
+    DEALLOCATOR(ctx, self, FSTACK_CALC_SIZEOF(FSTACK_NAME, self->capacity));
+}
+
+#ifdef ARENA
+
+FUNCTION_LINKAGE FSTACK_TYPE *JOIN(FSTACK_NAME, create_in_arena)(struct ARENA *arena_ptr, const SIZE_TYPE capacity)
+{
+    assert(arena_ptr != NULL);
+
+    if (capacity == 0 || FSTACK_CALC_SIZEOF_OVERFLOWS(FSTACK_NAME, capacity)) {
+        return NULL;
+    }
+
+    const size_t size = FSTACK_CALC_SIZEOF(FSTACK_NAME, capacity);
+
+    FSTACK_TYPE *self =
+        (FSTACK_TYPE *)JOIN(ARENA, allocate_aligned_uninitialized)(arena_ptr, alignof(FSTACK_TYPE), size);
+
+    if (!self) {
+        return NULL;
+    }
+
+    FSTACK_INIT(self, capacity);
+
+    return self;
 }
 
+#endif
+
 FUNCTION_LINKAGE bool JOIN(FSTACK_NAME, is_empty)(const FSTACK_TYPE *self)
 {
     assert(self != NULL);
@@ -368,7 +567,7 @@ FUNCTION_LINKAGE bool JOIN(FSTACK_NAME, is_full)(const FSTACK_TYPE *self)
     return self->count == self->capacity;
 }
 
-FUNCTION_LINKAGE VALUE_TYPE JOIN(FSTACK_NAME, at)(const FSTACK_TYPE *self, const uint32_t index)
+FUNCTION_LINKAGE VALUE_TYPE JOIN(FSTACK_NAME, at)(const FSTACK_TYPE *self, const SIZE_TYPE index)
 {
     assert(self != NULL);
     assert(index < self->count);
@@ -413,6 +612,52 @@ FUNCTION_LINKAGE VALUE_TYPE JOIN(FSTACK_NAME, pop)(FSTACK_TYPE *self)
     return self->values[--self->count];
 }
 
+FUNCTION_LINKAGE void JOIN(FSTACK_NAME, push_n)(FSTACK_TYPE *restrict self, const VALUE_TYPE *restrict src,
+                                                const SIZE_TYPE n)
+{
+    assert(self != NULL);
+    assert(src != NULL || n == 0);
+    assert(n <= self->capacity - self->count);
+
+    if (n == 0) {
+        return;
+    }
+
+    memcpy(&self->values[self->count], src, (size_t)n * sizeof(VALUE_TYPE));
+    self->count += n;
+}
+
+FUNCTION_LINKAGE void JOIN(FSTACK_NAME, pop_n)(FSTACK_TYPE *restrict self, VALUE_TYPE *restrict dest,
+                                               const SIZE_TYPE n)
+{
+    assert(self != NULL);
+    assert(dest != NULL || n == 0);
+    assert(n <= self->count);
+
+    if (n == 0) {
+        return;
+    }
+
+    self->count -= n;
+    memcpy(dest, &self->values[self->count], (size_t)n * sizeof(VALUE_TYPE));
+}
+
+FUNCTION_LINKAGE VALUE_TYPE *JOIN(FSTACK_NAME, peek_n)(FSTACK_TYPE *self, const SIZE_TYPE n)
+{
+    assert(self != NULL);
+    assert(n <= self->count);
+
+    return &self->values[self->count - n];
+}
+
+FUNCTION_LINKAGE void JOIN(FSTACK_NAME, truncate)(FSTACK_TYPE *self, const SIZE_TYPE count)
+{
+    assert(self != NULL);
+    assert(count <= self->count);
+
+    self->count = count;
+}
+
 FUNCTION_LINKAGE void JOIN(FSTACK_NAME, clear)(FSTACK_TYPE *self)
 {
     assert(self != NULL);
@@ -426,9 +671,7 @@ FUNCTION_LINKAGE void JOIN(FSTACK_NAME, copy)(FSTACK_TYPE *restrict dest_ptr, co
     assert(src_ptr->count <= dest_ptr->capacity);
     assert(FSTACK_IS_EMPTY(dest_ptr));
 
-    for (uint32_t i = 0; i < src_ptr->count; i++) {
-        dest_ptr->values[i] = src_ptr->values[i];
-    }
+    memcpy(dest_ptr->values, src_ptr->values, (size_t)src_ptr->count * sizeof(VALUE_TYPE));
     dest_ptr->count = src_ptr->count;
 }
 
@@ -439,6 +682,10 @@ FUNCTION_LINKAGE void JOIN(FSTACK_NAME, copy)(FSTACK_TYPE *restrict dest_ptr, co
 // macro undefs: {{{
 #undef NAME
 #undef VALUE_TYPE
+#undef SIZE_TYPE
+#undef ALLOCATOR
+#undef DEALLOCATOR
+#undef ARENA
 #undef FUNCTION_LINKAGE
 #undef FUNCTION_DEFINITIONS
 #undef TYPE_DEFINITIONS
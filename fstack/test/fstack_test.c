@@ -20,12 +20,19 @@
     - push
     - pop
     - clear
+    - push_n / pop_n / peek_n / truncate (including n = 0 and n = count)
 
     Memory operations [to also be tested with sanitizers]:
     - init (this is indirectly tested for with `create`)
     - create
     - destroy
     - copy
+    - create_with_context + destroy_with_context (custom ALLOCATOR / DEALLOCATOR)
+    - create_in_arena
+
+    64-bit SIZE_TYPE:
+    - calc_sizeof / calc_sizeof_overflows beyond 4GiB
+    - push / pop / at with more than UINT32_MAX values (in reserved address space)
 */
 
 #define NAME       i64_stk
@@ -118,6 +125,62 @@ static inline bool copy_values_and_check_ordered_values(const struct i64_stk *st
     return res;
 }
 
+#define NAME arena
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "arena_template.h"
+
+struct alloc_stats {
+    size_t allocated_size;
+    size_t freed_size;
+};
+
+static void *counting_alloc(struct alloc_stats *stats, const size_t size)
+{
+    if (stats) {
+        stats->allocated_size += size;
+    }
+    return malloc(size);
+}
+
+static void counting_free(struct alloc_stats *stats, void *ptr, const size_t size)
+{
+    if (stats) {
+        stats->freed_size += size;
+    }
+    free(ptr);
+}
+
+#define NAME       i64_stk_ctx
+#define VALUE_TYPE int64_t
+#define ALLOCATOR(ctx, size)        counting_alloc((ctx), (size))
+#define DEALLOCATOR(ctx, ptr, size) counting_free((ctx), (ptr), (size))
+#define ARENA                       arena
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fstack_template.h"
+
+#define NAME       u8_stk64
+#define VALUE_TYPE uint8_t
+#define SIZE_TYPE  uint64_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fstack_template.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+
+// reserve address space without backing it, such that only the touched pages use memory
+static void *map_large(const size_t size)
+{
+    void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return ptr == MAP_FAILED ? NULL : ptr;
+}
+#endif
+
 int main(void)
 {
     // N = 0
@@ -362,4 +425,171 @@ int main(void)
 
         i64_stk_destroy(stk_p);
     }
+    // N = 10, push_n * 10 -> peek_n -> pop_n * 3 -> truncate(2) -> push_n * 8
+    {
+        struct i64_stk *stk_p = i64_stk_create(10);
+        if (!stk_p) {
+            assert(false);
+        }
+        const int64_t src[10] = {421, 422, 423, 424, 425, 426, 427, 428, 429, 430};
+
+        i64_stk_push_n(stk_p, src, 0);
+        assert(i64_stk_is_empty(stk_p));
+        assert(i64_stk_peek_n(stk_p, 0) == stk_p->values);
+
+        i64_stk_push_n(stk_p, src, 10);
+        assert(check_count_invariance(stk_p, 10, 0));
+        assert(check_empty_full(stk_p, 10, 0));
+        assert(check_top_bottom(stk_p, 430, 421));
+        assert(check_ordered_values(stk_p, 10, (int64_t[10]){430, 429, 428, 427, 426, 425, 424, 423, 422, 421}));
+
+        int64_t *span = i64_stk_peek_n(stk_p, 4);
+        assert(span == &stk_p->values[6]);
+        assert(span[0] == 427 && span[3] == 430);
+        span[3] = 440; // modified in place
+        assert(i64_stk_get_top(stk_p) == 440);
+        assert(i64_stk_peek_n(stk_p, 10) == stk_p->values);
+
+        int64_t dest[10] = {0};
+        i64_stk_pop_n(stk_p, dest, 3);
+        assert(dest[0] == 428 && dest[1] == 429 && dest[2] == 440);
+        assert(check_count_invariance(stk_p, 10, 3));
+        assert(check_top_bottom(stk_p, 427, 421));
+
+        i64_stk_pop_n(stk_p, dest, 0);
+        assert(stk_p->count == 7);
+
+        i64_stk_truncate(stk_p, 7);
+        assert(stk_p->count == 7);
+        i64_stk_truncate(stk_p, 2);
+        assert(check_count_invariance(stk_p, 2, 0));
+        assert(check_top_bottom(stk_p, 422, 421));
+
+        i64_stk_push_n(stk_p, &src[2], 8);
+        assert(i64_stk_is_full(stk_p));
+        assert(check_ordered_values(stk_p, 10, (int64_t[10]){430, 429, 428, 427, 426, 425, 424, 423, 422, 421}));
+
+        i64_stk_pop_n(stk_p, dest, 10);
+        assert(i64_stk_is_empty(stk_p));
+        for (size_t i = 0; i < 10; i++) {
+            assert(dest[i] == src[i]);
+        }
+
+        i64_stk_push_n(stk_p, src, 5);
+        i64_stk_truncate(stk_p, 0);
+        assert(i64_stk_is_empty(stk_p));
+
+        i64_stk_destroy(stk_p);
+    }
+    // N = 1e+6, push_n in batches -> pop_n in batches
+    {
+        struct i64_stk *stk_p = i64_stk_create(1e+6);
+        if (!stk_p) {
+            assert(false);
+        }
+        static int64_t batch[1000];
+        for (size_t i = 0; i < 1e+3; i++) {
+            for (size_t j = 0; j < 1e+3; j++) {
+                batch[j] = (int64_t)(i * 1000 + j);
+            }
+            i64_stk_push_n(stk_p, batch, 1000);
+        }
+        assert(check_count_invariance(stk_p, 1e+6, 0));
+        assert(check_top_bottom(stk_p, 1e+6 - 1, 0));
+
+        for (size_t i = 1e+3; i-- > 0;) {
+            i64_stk_pop_n(stk_p, batch, 1000);
+            for (size_t j = 0; j < 1e+3; j++) {
+                assert(batch[j] == (int64_t)(i * 1000 + j));
+            }
+        }
+        assert(i64_stk_is_empty(stk_p));
+
+        i64_stk_destroy(stk_p);
+    }
+    // custom allocator
+    {
+        struct alloc_stats stats = {0, 0};
+
+        struct i64_stk_ctx *stk_p = i64_stk_ctx_create_with_context(10, &stats);
+        if (!stk_p) {
+            assert(false);
+        }
+        assert(stats.allocated_size == FSTACK_CALC_SIZEOF(i64_stk_ctx, stk_p->capacity));
+
+        for (int64_t i = 0; i < 10; i++) {
+            i64_stk_ctx_push(stk_p, i);
+        }
+        assert(i64_stk_ctx_pop(stk_p) == 9);
+
+        i64_stk_ctx_destroy_with_context(stk_p, &stats);
+        assert(stats.freed_size == stats.allocated_size);
+
+        stk_p = i64_stk_ctx_create(10);
+        if (!stk_p) {
+            assert(false);
+        }
+        i64_stk_ctx_destroy(stk_p);
+    }
+    // arena, with leftover garbage in its memory: create_in_arena must not rely on it being zeroed
+    {
+        unsigned char buf[1024];
+        memset(buf, 0xa5, sizeof(buf));
+        struct arena arena;
+        arena_init(&arena, sizeof(buf), buf);
+
+        struct i64_stk_ctx *stk_p = i64_stk_ctx_create_in_arena(&arena, 10);
+        if (!stk_p) {
+            assert(false);
+        }
+        assert((unsigned char *)stk_p >= buf && (unsigned char *)stk_p < buf + sizeof(buf));
+        assert(i64_stk_ctx_is_empty(stk_p));
+
+        for (int64_t i = 0; i < 10; i++) {
+            i64_stk_ctx_push(stk_p, i);
+        }
+        assert(i64_stk_ctx_pop(stk_p) == 9);
+
+        assert(i64_stk_ctx_create_in_arena(&arena, 1024) == NULL);
+    }
+    // 64-bit SIZE_TYPE
+    {
+        const uint64_t capacity = ((uint64_t)1 << 32) + 4096;
+        const size_t size = FSTACK_CALC_SIZEOF(u8_stk64, capacity);
+
+        assert(size == offsetof(struct u8_stk64, values) + capacity);
+        assert(!FSTACK_CALC_SIZEOF_OVERFLOWS(u8_stk64, capacity));
+        assert(FSTACK_CALC_SIZEOF_OVERFLOWS(u8_stk64, UINT64_MAX));
+        assert(u8_stk64_create(UINT64_MAX) == NULL);
+
+        struct u8_stk64 *stk_p = u8_stk64_create(10);
+        if (!stk_p) {
+            assert(false);
+        }
+        for (uint8_t i = 0; i < 10; i++) {
+            u8_stk64_push(stk_p, i);
+        }
+        assert(u8_stk64_is_full(stk_p));
+        assert(u8_stk64_pop(stk_p) == 9);
+        u8_stk64_destroy(stk_p);
+
+#ifdef __linux__
+        void *buf = map_large(size);
+        if (buf) {
+            stk_p = u8_stk64_init(buf, capacity);
+
+            // skip over the first UINT32_MAX values without touching them
+            stk_p->count = UINT32_MAX;
+            u8_stk64_push(stk_p, 1);
+            u8_stk64_push(stk_p, 2);
+            assert(stk_p->count == (uint64_t)UINT32_MAX + 2);
+            assert(u8_stk64_at(stk_p, 0) == 2 && u8_stk64_at(stk_p, 1) == 1);
+            assert(stk_p->values[(uint64_t)1 << 32] == 2);
+            assert(u8_stk64_pop(stk_p) == 2);
+            assert(u8_stk64_get_top(stk_p) == 1);
+
+            munmap(buf, size);
+        }
+#endif
+    }
 }
@@ -0,0 +1,51 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "hugepage.h"
+#include "murmurhash.h"
+
+#define NAME               u64_ht
+#define KEY_TYPE           uint64_t
+#define VALUE_TYPE         uint64_t
+#define KEY_IS_EQUAL(a, b) ((a) == (b))
+#define HASH_FUNCTION(key) (murmur3_32((uint8_t *)&(key), sizeof(uint64_t), 0))
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fhashtable_template.h"
+
+static const char *kind_name(const enum hugepage_kind kind)
+{
+    switch (kind) {
+    case HUGEPAGE_KIND_HUGETLB:
+        return "reserved huge pages";
+    case HUGEPAGE_KIND_TRANSPARENT:
+        return "transparent huge pages";
+    default:
+        return "regular pages";
+    }
+}
+
+int main(void)
+{
+    const uint32_t capacity = 1U << 16;
+    const size_t size = FHASHTABLE_CALC_SIZEOF(u64_ht, capacity);
+
+    enum hugepage_kind kind;
+    void *buf = hugepage_alloc(size, HUGEPAGE_ANY_NODE, &kind);
+    if (!buf) {
+        assert(false);
+    }
+    printf("%zu bytes backed by %s\n", size, kind_name(kind));
+
+    struct u64_ht *ht = u64_ht_init(buf, capacity);
+
+    for (uint64_t i = 0; i < capacity / 2; i++) {
+        u64_ht_insert(ht, i, i * i);
+    }
+    assert(u64_ht_get_value(ht, 42, 0) == 42 * 42);
+
+    hugepage_free(ht, size);
+}
@@ -0,0 +1,237 @@
+/*  hugepage.h
+ *
+ *  Copyright (C) 2025 abxh
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *  See the file LICENSE included with this distribution for more
+ *  information. */
+
+/**
+ * @file hugepage.h
+ * @brief Huge page and NUMA node aware allocation of large buffers
+ *
+ * Large containers allocated with calloc() are backed by 4KiB pages, such that
+ * random access into them misses the TLB almost every time. Allocating them
+ * with `hugepage_alloc` instead and placing them with the `init` functions of
+ * the containers backs them with 2MiB pages where possible:
+ *
+ * @code{.c}
+ * const size_t size = FHASHTABLE_CALC_SIZEOF(my_ht, capacity);
+ * struct my_ht *ht = my_ht_init(hugepage_alloc(size, HUGEPAGE_ANY_NODE, NULL), capacity);
+ * ...
+ * hugepage_free(ht, size);
+ * @endcode
+ *
+ * Alternatively, let `create` and `destroy` of the containers use it:
+ *
+ * @code{.c}
+ * #define ALLOCATOR(ctx, size)        hugepage_alloc((size), HUGEPAGE_ANY_NODE, NULL)
+ * #define DEALLOCATOR(ctx, ptr, size) hugepage_free((ptr), (size))
+ * @endcode
+ *
+ * The following is tried in order:
+ *      @li a mapping from the reserved huge page pool (`MAP_HUGETLB`). See
+ *          `/proc/sys/vm/nr_hugepages`.
+ *      @li a 2MiB-aligned mapping advised to be backed by transparent huge
+ *          pages (`MADV_HUGEPAGE`). See
+ *          `/sys/kernel/mm/transparent_hugepage/enabled`.
+ *
+ * The memory is bound to the given NUMA node with `mbind` before it is first
+ * touched.
+ *
+ * The memory returned is zeroed, and pages are faulted in lazily.
+ *
+ * @note On other platforms than Linux, this falls back to aligned_alloc().
+ *
+ * Source(s) used:
+ *  @li https://www.kernel.org/doc/html/latest/admin-guide/mm/transhuge.html
+ *  @li https://www.kernel.org/doc/html/latest/admin-guide/mm/hugetlbpage.html
+ *  @li https://man7.org/linux/man-pages/man2/mbind.2.html
+ */
+
+/**
+ * @example hugepage_example.c
+ * Example of how `hugepage.h` header file is used in practice.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @def HUGEPAGE_SIZE
+ * @brief Size of a (transparent) huge page. Allocations are rounded up to a
+ *        multiple of this.
+ */
+#ifndef HUGEPAGE_SIZE
+#define HUGEPAGE_SIZE ((size_t)2 * 1024 * 1024)
+#endif
+
+/**
+ * @def HUGEPAGE_ANY_NODE
+ * @brief NUMA node argument to not bind the memory to any particular node.
+ */
+#ifndef HUGEPAGE_ANY_NODE
+#define HUGEPAGE_ANY_NODE (-1)
+#endif
+
+/**
+ * @brief Kind of pages backing a huge page allocation.
+ */
+enum hugepage_kind {
+    HUGEPAGE_KIND_HUGETLB,     ///< Pages from the reserved huge page pool.
+    HUGEPAGE_KIND_TRANSPARENT, ///< Pages advised to be transparent huge pages.
+    HUGEPAGE_KIND_FALLBACK,    ///< Regular pages from aligned_alloc().
+};
+
+/// @cond DO_NOT_DOCUMENT
+static inline size_t internal_hugepage_round_up(const size_t size)
+{
+    return (size + HUGEPAGE_SIZE - 1) & ~(HUGEPAGE_SIZE - 1);
+}
+
+#ifdef __linux__
+static inline bool internal_hugepage_bind(void *ptr, const size_t size, const int numa_node)
+{
+    if (numa_node < 0) {
+        return true;
+    }
+    if (numa_node >= (int)(sizeof(unsigned long) * 8)) {
+        return false;
+    }
+
+    const int mpol_bind = 2; /* MPOL_BIND in <numaif.h>, which is part of libnuma rather than libc */
+    const unsigned long nodemask = 1UL << numa_node;
+
+    return syscall(SYS_mbind, ptr, size, mpol_bind, &nodemask, sizeof(nodemask) * 8, 0) == 0;
+}
+#endif
+/// @endcond
+
+/**
+ * @brief Allocate a zeroed buffer backed by huge pages where possible.
+ *
+ * @param[in] size              Number of bytes. Rounded up to a multiple of
+ *                              `HUGEPAGE_SIZE`.
+ * @param[in] numa_node         NUMA node to bind the memory to, or
+ *                              `HUGEPAGE_ANY_NODE`.
+ * @param[out] kind_ptr         Set to the kind of pages used (or NULL if not of
+ *                              interest).
+ *
+ * @return                      A `HUGEPAGE_SIZE`-aligned pointer to the buffer.
+ * @retval NULL
+ *   @li                        If size is 0 or the rounded size overflows.
+ *   @li                        If the memory could not be mapped.
+ *   @li                        If the memory could not be bound to the NUMA
+ *                              node.
+ */
+static inline void *hugepage_alloc(const size_t size, const int numa_node, enum hugepage_kind *kind_ptr)
+{
+    if (size == 0 || size > SIZE_MAX - HUGEPAGE_SIZE) {
+        return NULL;
+    }
+
+    const size_t rounded_size = internal_hugepage_round_up(size);
+
+#ifdef __linux__
+    void *ptr = mmap(NULL, rounded_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+    if (ptr != MAP_FAILED) {
+        if (!internal_hugepage_bind(ptr, rounded_size, numa_node)) {
+            munmap(ptr, rounded_size);
+            return NULL;
+        }
+        if (kind_ptr) {
+            *kind_ptr = HUGEPAGE_KIND_HUGETLB;
+        }
+        return ptr;
+    }
+
+    /* over-allocate to align the mapping to a huge page boundary, and unmap the excess */
+    unsigned char *raw = (unsigned char *)mmap(NULL, rounded_size + HUGEPAGE_SIZE, PROT_READ | PROT_WRITE,
+                                               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return NULL;
+    }
+
+    const size_t head = internal_hugepage_round_up((uintptr_t)raw) - (uintptr_t)raw;
+
+    if (head != 0) {
+        munmap(raw, head);
+    }
+    munmap(raw + head + rounded_size, HUGEPAGE_SIZE - head);
+
+    ptr = raw + head;
+
+    if (!internal_hugepage_bind(ptr, rounded_size, numa_node)) {
+        munmap(ptr, rounded_size);
+        return NULL;
+    }
+
+    /* advisory only. fails harmlessly if transparent huge pages are disabled */
+    (void)madvise(ptr, rounded_size, MADV_HUGEPAGE);
+
+    if (kind_ptr) {
+        *kind_ptr = HUGEPAGE_KIND_TRANSPARENT;
+    }
+    return ptr;
+#else
+    if (numa_node >= 0) {
+        return NULL;
+    }
+
+    void *ptr = aligned_alloc(HUGEPAGE_SIZE, rounded_size);
+
+    if (!ptr) {
+        return NULL;
+    }
+    memset(ptr, 0, rounded_size);
+
+    if (kind_ptr) {
+        *kind_ptr = HUGEPAGE_KIND_FALLBACK;
+    }
+    return ptr;
+#endif
+}
+
+/**
+ * @brief Free a buffer allocated with `hugepage_alloc`.
+ *
+ * @param[in] ptr               The buffer pointer.
+ * @param[in] size              The size given to `hugepage_alloc`.
+ */
+static inline void hugepage_free(void *ptr, const size_t size)
+{
+    assert(ptr != NULL);
+
+#ifdef __linux__
+    munmap(ptr, internal_hugepage_round_up(size));
+#else
+    (void)(size);
+    free(ptr);
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+// vim: ft=c
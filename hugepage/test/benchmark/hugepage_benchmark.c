@@ -0,0 +1,147 @@
+// Compares lookups in a fhashtable larger than 1GiB backed by regular pages
+// (calloc) and by huge pages (hugepage_alloc). Run with `make bench`.
+//
+// usage: ./a.out [table size in MiB]
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "hugepage.h"
+#include "murmurhash.h"
+#include "round_up_pow2_32.h"
+
+#define NAME               u64_ht
+#define KEY_TYPE           uint64_t
+#define VALUE_TYPE         uint64_t
+#define KEY_IS_EQUAL(a, b) ((a) == (b))
+#define HASH_FUNCTION(key) (murmur3_32((uint8_t *)&(key), sizeof(uint64_t), 0))
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fhashtable_template.h"
+
+#define LOOKUP_COUNT (10 * 1000 * 1000)
+
+static uint64_t xorshift64(uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* returns -1 if the dTLB miss counter is unavailable (e.g. due to perf_event_paranoid) */
+static int dtlb_miss_counter_open(void)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                  | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static void run(const char *label, struct u64_ht *ht)
+{
+    const uint64_t hit_seed = 0x9e3779b97f4a7c15;
+    uint64_t state = hit_seed;
+
+    const double fill_start = now_s();
+    for (uint32_t i = 0; i < ht->capacity / 2; i++) {
+        u64_ht_update(ht, xorshift64(&state), i);
+    }
+    const double fill_end = now_s();
+
+    /* every other looked up key is contained */
+    uint64_t hit_state = hit_seed;
+    uint64_t miss_state = 0x2545f4914f6cdd1d;
+    uint64_t hit_count = 0;
+
+    const int fd = dtlb_miss_counter_open();
+    if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+
+    const double lookup_start = now_s();
+    for (uint32_t i = 0; i < LOOKUP_COUNT; i++) {
+        if (i % ht->capacity == 0) {
+            hit_state = hit_seed;
+        }
+        const uint64_t key = xorshift64(i % 2 == 0 ? &hit_state : &miss_state);
+        hit_count += u64_ht_contains_key(ht, key);
+    }
+    const double lookup_end = now_s();
+
+    uint64_t dtlb_misses = 0;
+    if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd, &dtlb_misses, sizeof(dtlb_misses)) != sizeof(dtlb_misses)) {
+            dtlb_misses = 0;
+        }
+        close(fd);
+    }
+
+    printf("%s:\n", label);
+    printf(" fill:    %.3f s\n", fill_end - fill_start);
+    printf(" lookup:  %.1f ns/op (%" PRIu64 " hits)\n", (lookup_end - lookup_start) * 1e9 / LOOKUP_COUNT, hit_count);
+    if (fd >= 0) {
+        printf(" dTLB load misses: %.3f /op\n", (double)dtlb_misses / LOOKUP_COUNT);
+    }
+    else {
+        printf(" dTLB load misses: n/a\n");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const size_t target_size = (argc > 1 ? strtoull(argv[1], NULL, 10) : 1024) * 1024 * 1024;
+    const uint32_t capacity = round_up_pow2_32((uint32_t)(target_size / sizeof(struct u64_ht_slot)));
+    const size_t size = FHASHTABLE_CALC_SIZEOF(u64_ht, capacity);
+
+    printf("table of %" PRIu32 " slots (%.2f GiB), %d lookups\n", capacity,
+           (double)size / (1024 * 1024 * 1024), LOOKUP_COUNT);
+
+    struct u64_ht *ht = u64_ht_create(capacity);
+    if (!ht) {
+        fprintf(stderr, "calloc failed\n");
+        return EXIT_FAILURE;
+    }
+    run("regular pages (calloc)", ht);
+    u64_ht_destroy(ht);
+
+    enum hugepage_kind kind;
+    void *buf = hugepage_alloc(size, HUGEPAGE_ANY_NODE, &kind);
+    if (!buf) {
+        fprintf(stderr, "hugepage_alloc failed\n");
+        return EXIT_FAILURE;
+    }
+    run(kind == HUGEPAGE_KIND_HUGETLB ? "huge pages (MAP_HUGETLB)" : "huge pages (MADV_HUGEPAGE)",
+        u64_ht_init(buf, capacity));
+    hugepage_free(buf, size);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,61 @@
+/*
+    Test cases:
+    - size := 0 is rejected
+    - size := 1, HUGEPAGE_SIZE, HUGEPAGE_SIZE + 1, 3 * HUGEPAGE_SIZE + 123:
+      - the buffer is aligned to HUGEPAGE_SIZE
+      - the buffer is zeroed
+      - the whole rounded up buffer is writable
+    - NUMA node binding:
+      - an invalid node is rejected
+      - node 0 is accepted where NUMA is supported
+*/
+
+#include "hugepage.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void alloc_test(const size_t size)
+{
+    enum hugepage_kind kind;
+    unsigned char *p = hugepage_alloc(size, HUGEPAGE_ANY_NODE, &kind);
+    assert(p != NULL);
+    assert((uintptr_t)p % HUGEPAGE_SIZE == 0);
+
+    for (size_t i = 0; i < size; i++) {
+        assert(p[i] == 0);
+    }
+
+    const size_t rounded_size = (size + HUGEPAGE_SIZE - 1) / HUGEPAGE_SIZE * HUGEPAGE_SIZE;
+    memset(p, 0xab, rounded_size);
+
+    hugepage_free(p, size);
+}
+
+static void numa_test(void)
+{
+    assert(hugepage_alloc(HUGEPAGE_SIZE, 1 << 20, NULL) == NULL);
+
+    /* binding fails on kernels without NUMA support */
+    unsigned char *p = hugepage_alloc(HUGEPAGE_SIZE, 0, NULL);
+    if (p != NULL) {
+        memset(p, 1, HUGEPAGE_SIZE);
+        hugepage_free(p, HUGEPAGE_SIZE);
+    }
+}
+
+int main(void)
+{
+    assert(hugepage_alloc(0, HUGEPAGE_ANY_NODE, NULL) == NULL);
+    assert(hugepage_alloc(SIZE_MAX, HUGEPAGE_ANY_NODE, NULL) == NULL);
+
+    alloc_test(1);
+    alloc_test(HUGEPAGE_SIZE);
+    alloc_test(HUGEPAGE_SIZE + 1);
+    alloc_test(3 * HUGEPAGE_SIZE + 123);
+
+    numa_test();
+}
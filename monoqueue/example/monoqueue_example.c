@@ -0,0 +1,45 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#define NAME                       int_window
+#define KEY_TYPE                   int
+#define KEY_IS_STRICTLY_LESS(a, b) ((a) < (b))
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "monoqueue_template.h"
+
+#define WINDOW_SIZE (3)
+
+int main(void)
+{
+    struct int_window *w = int_window_create(WINDOW_SIZE);
+    if (!w) {
+        assert(false);
+        return 1;
+    }
+
+    // rolling minimum and maximum of the last 3 values:
+    const int values[] = {1, 3, -1, -3, 5, 3, 6, 7};
+    for (uint64_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        int_window_push(w, values[i], i);
+        if (i + 1 >= WINDOW_SIZE) {
+            int_window_expire(w, i + 1 - WINDOW_SIZE); // keep positions i - 2 to i
+
+            printf("[%llu, %llu]: min %d, max %d\n", (unsigned long long)(i + 1 - WINDOW_SIZE), (unsigned long long)i,
+                   int_window_get_min(w).key, int_window_get_max(w).key);
+        }
+    }
+
+    // push a batch at positions 8 to 10, and keep positions 8 to 10:
+    const int batch[] = {2, 0, 4};
+    int_window_push_n(w, batch, 8, 3);
+    int_window_expire(w, 8);
+
+    assert(int_window_get_min(w).key == 0);
+    assert(int_window_get_min(w).position == 9);
+    assert(int_window_get_max(w).key == 4);
+
+    int_window_destroy(w);
+}
@@ -0,0 +1,635 @@
+/*  monoqueue_template.h
+ *
+ *  Copyright (C) 2025 abxh
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *  See the file LICENSE included with this distribution for more
+ *  information. */
+
+/**
+ * @file monoqueue_template.h
+ * @brief Fixed-size monotonic queue for sliding window minimum and maximum
+ *
+ * Keys are pushed with increasing positions (e.g. a stream index or a
+ * timestamp), and expired once their position falls out of the window. The
+ * minimum and maximum key of the window are available in O(1):
+ *      @li The queue keeps two rings like `fqueue_template.h`: one of keys
+ *          increasing from front to back, and one of keys decreasing from front
+ *          to back. The fronts are the minimum and maximum.
+ *      @li Pushing a key first pops the keys at the back of each ring which it
+ *          makes irrelevant: a key which is not less (or greater) than a newer
+ *          key will never be the minimum (or maximum) again.
+ *      @li Expiring pops the keys at the front of each ring which are older
+ *          than the window.
+ *
+ * Each key is pushed and popped at most once per ring, so the operations are
+ * amortized O(1) per key.
+ *
+ * The capacity must be at least the number of keys that can be in a window.
+ *
+ * Source(s) used:
+ *  @li https://cp-algorithms.com/data_structures/stack_queue_modification.html
+ */
+
+/**
+ * @example monoqueue_example.c
+ * Example of how `monoqueue_template.h` header file is used in practice.
+ */
+
+#ifdef __cplusplus
+#ifdef __GNUC__
+#define restrict __restrict__
+#else
+#define restrict
+#endif
+extern "C" {
+#endif
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// macro definitions: {{{
+
+/**
+ * @def PASTE(a,b)
+ * @brief Paste two tokens together.
+ */
+#ifndef PASTE
+#define PASTE(a, b) a##b
+#endif
+
+/**
+ * @def XPASTE(a,b)
+ * @brief First expand tokens, then paste them together.
+ */
+#ifndef XPASTE
+#define XPASTE(a, b) PASTE(a, b)
+#endif
+
+/**
+ * @def JOIN(a,b)
+ * @brief First expand tokens, then paste them together with a _ in between.
+ */
+#ifndef JOIN
+#define JOIN(a, b) XPASTE(a, XPASTE(_, b))
+#endif
+
+/**
+ * @brief Macro to check if a number is a power of two.
+ *
+ * @param[in] X             The number at hand.
+ *
+ * @return                  A boolean value indicating whether the number is a power of two.
+ */
+#ifndef IS_POW2
+#define IS_POW2(X) ((X) != 0 && ((X) & ((X) - 1)) == 0)
+#endif
+
+/**
+ * @def MONOQUEUE_CALC_SIZEOF(monoqueue_name, capacity)
+ *
+ * @brief Calculate the size of the queue struct. No overflow checks.
+ *
+ * @param[in] monoqueue_name    Defined queue NAME.
+ * @param[in] capacity          Capacity input.
+ *
+ * @return                      The equivalent size.
+ */
+#ifndef MONOQUEUE_CALC_SIZEOF
+#define MONOQUEUE_CALC_SIZEOF(monoqueue_name, capacity) \
+    (offsetof(struct monoqueue_name, entries)           \
+     + 2 * (size_t)(capacity) * sizeof(((struct monoqueue_name *)0)->entries[0]))
+#endif
+
+/**
+ * @def MONOQUEUE_CALC_SIZEOF_OVERFLOWS(monoqueue_name, capacity)
+ *
+ * @brief Check for a given capacity, if the equivalent size of the queue struct overflows.
+ *
+ * @param[in] monoqueue_name    Defined queue NAME.
+ * @param[in] capacity          Capacity input.
+ *
+ * @return                      Whether the equivalent size overflows.
+ */
+#ifndef MONOQUEUE_CALC_SIZEOF_OVERFLOWS
+#define MONOQUEUE_CALC_SIZEOF_OVERFLOWS(monoqueue_name, capacity) \
+    ((uintmax_t)0 + (capacity)                                    \
+     > (SIZE_MAX - offsetof(struct monoqueue_name, entries)) / 2 / sizeof(((struct monoqueue_name *)0)->entries[0]))
+#endif
+
+/**
+ * @def NAME
+ * @brief Prefix to queue type and operations. This must be manually defined
+ *        before including this header file.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef NAME
+#define NAME monoqueue
+#error "Must define NAME."
+#else
+#define MONOQUEUE_NAME NAME
+#endif
+
+/**
+ * @def KEY_TYPE
+ * @brief The key type. This must be manually defined before including this
+ *        header file.
+ *
+ * Is undefined once header is included.
+ */
+#ifndef KEY_TYPE
+#define FUNCTION_DEFINITIONS
+#define TYPE_DEFINITIONS
+#define KEY_TYPE int
+#error "Must define KEY_TYPE."
+#endif
+
+/**
+ * @def KEY_IS_STRICTLY_LESS(a, b)
+ * @brief Used to compare two keys. This must be manually defined before
+ *        including this header file.
+ *
+ * Is undefined once header is included.
+ *
+ * @retval true                 If key a is strictly less than b.
+ * @retval false                If key a is greater than or equal to b.
+ */
+#ifndef KEY_IS_STRICTLY_LESS
+#error "Must define KEY_IS_STRICTLY_LESS."
+#define KEY_IS_STRICTLY_LESS(a, b) ((a) < (b))
+#endif
+
+/**
+ * @def SIZE_TYPE
+ * @brief Queue count, capacity and index type. Defaults to `uint32_t`.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef SIZE_TYPE
+#define SIZE_TYPE uint32_t
+#endif
+
+/**
+ * @def ALLOCATOR(ctx, size)
+ * @brief Used by `create` and `create_with_context` to allocate the memory of
+ *        the queue. Defaults to malloc().
+ *
+ * Is undefined once header is included.
+ *
+ * @note The memory need not be zeroed. `init` initializes what is read.
+ *
+ * @param ctx The context pointer given to `create_with_context` (or NULL).
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the memory, or NULL if the allocation fails.
+ */
+#if defined(ALLOCATOR) != defined(DEALLOCATOR)
+#error "Must define both ALLOCATOR and DEALLOCATOR."
+#endif
+#ifndef ALLOCATOR
+#define ALLOCATOR(ctx, size) ((void)(ctx), malloc(size))
+#endif
+
+/**
+ * @def DEALLOCATOR(ctx, ptr, size)
+ * @brief Used by `destroy` and `destroy_with_context` to free the memory of
+ *        the queue. Defaults to free().
+ *
+ * Is undefined once header is included.
+ *
+ * @param ctx The context pointer given to `destroy_with_context` (or NULL).
+ * @param ptr The pointer returned by `ALLOCATOR`.
+ * @param size The number of bytes allocated.
+ */
+#ifndef DEALLOCATOR
+#define DEALLOCATOR(ctx, ptr, size) ((void)(ctx), (void)(size), free(ptr))
+#endif
+
+/**
+ * @def FUNCTION_LINKAGE
+ * @brief Specify function linkage e.g. static inline
+ */
+#ifndef FUNCTION_LINKAGE
+#define FUNCTION_LINKAGE
+#endif
+
+/// @cond DO_NOT_DOCUMENT
+#define MONOQUEUE_TYPE       struct MONOQUEUE_NAME
+#define MONOQUEUE_ENTRY_TYPE struct JOIN(MONOQUEUE_NAME, entry)
+#define MONOQUEUE_INIT       JOIN(MONOQUEUE_NAME, init)
+#define MONOQUEUE_IS_EMPTY   JOIN(MONOQUEUE_NAME, is_empty)
+#define MONOQUEUE_SIZE_MAX   ((SIZE_TYPE)-1)
+#define MONOQUEUE_ROUND_UP   JOIN(internal, JOIN(MONOQUEUE_NAME, round_up_pow2))
+#define MONOQUEUE_PUSH_N     JOIN(internal, JOIN(MONOQUEUE_NAME, push_n))
+
+#define MONOQUEUE_IS_LESS(a, b, is_max) ((is_max) ? KEY_IS_STRICTLY_LESS((b), (a)) : KEY_IS_STRICTLY_LESS((a), (b)))
+/// @endcond
+
+// }}}
+
+// type definitions: {{{
+
+/**
+ * @def TYPE_DEFINITIONS
+ * @brief Define the types
+ */
+#ifdef TYPE_DEFINITIONS
+
+/**
+ * @brief Generated entry struct type for a `KEY_TYPE`.
+ */
+struct JOIN(MONOQUEUE_NAME, entry) {
+    KEY_TYPE key;      ///< The key.
+    uint64_t position; ///< The position the key was pushed at.
+};
+
+/**
+ * @brief Generated queue struct type for a `KEY_TYPE`.
+ *
+ * The first `capacity` entries are the ring of the minimum (with keys
+ * increasing from the front), and the next `capacity` entries are the ring of
+ * the maximum (with keys decreasing from the front).
+ */
+struct MONOQUEUE_NAME {
+    SIZE_TYPE begin_index[2];       ///< Index of the front of the minimum and maximum ring.
+    SIZE_TYPE count[2];             ///< Number of entries in the minimum and maximum ring.
+    SIZE_TYPE capacity;             ///< Maximum number of entries per ring.
+    uint64_t next_position;         ///< The position after the last key pushed.
+    MONOQUEUE_ENTRY_TYPE entries[]; ///< Array of `2 * capacity` entries.
+};
+
+#endif
+
+// }}}
+
+// function declarations: {{{
+
+/**
+ * @brief Initialize a queue struct, given a (power-of-2) capacity.
+ *
+ * @param[in] self              Queue pointer
+ * @param[in] pow2_capacity     Power of 2 capacity
+ */
+FUNCTION_LINKAGE MONOQUEUE_TYPE *JOIN(MONOQUEUE_NAME, init)(MONOQUEUE_TYPE *self, const SIZE_TYPE pow2_capacity);
+
+/**
+ * @brief Create a queue struct with a given capacity with `ALLOCATOR`.
+ *
+ * @param[in] min_capacity      Maximum number of keys expected in a window
+ *
+ * @return                      A pointer to the queue.
+ * @retval NULL
+ *   @li                        If the allocation fails.
+ *   @li                        If capacity is 0 or larger than the maximum of `SIZE_TYPE` / 2 + 1 or the
+ *                              equivalent size overflows.
+ */
+FUNCTION_LINKAGE MONOQUEUE_TYPE *JOIN(MONOQUEUE_NAME, create)(const SIZE_TYPE min_capacity);
+
+/**
+ * @brief Create a queue struct with a given capacity with `ALLOCATOR`, given
+ *        a context pointer.
+ *
+ * @param[in] min_capacity      Maximum number of keys expected in a window
+ * @param[in] ctx               The context pointer passed to `ALLOCATOR`.
+ *
+ * @return                      A pointer to the queue, or NULL. See `create`.
+ */
+FUNCTION_LINKAGE MONOQUEUE_TYPE *JOIN(MONOQUEUE_NAME, create_with_context)(const SIZE_TYPE min_capacity, void *ctx);
+
+/**
+ * @brief Destroy a queue struct and free the underlying memory with
+ *        `DEALLOCATOR`.
+ *
+ * @param[in] self              The queue pointer.
+ */
+FUNCTION_LINKAGE void JOIN(MONOQUEUE_NAME, destroy)(MONOQUEUE_TYPE *self);
+
+/**
+ * @brief Destroy a queue struct and free the underlying memory with
+ *        `DEALLOCATOR`, given a context pointer.
+ *
+ * @param[in] self              The queue pointer.
+ * @param[in] ctx               The context pointer passed to `DEALLOCATOR`.
+ */
+FUNCTION_LINKAGE void JOIN(MONOQUEUE_NAME, destroy_with_context)(MONOQUEUE_TYPE *self, void *ctx);
+
+/**
+ * @brief Return whether the window is empty.
+ *
+ * @param[in] self              The queue pointer.
+ *
+ * @return                      Whether the window is empty.
+ */
+FUNCTION_LINKAGE bool JOIN(MONOQUEUE_NAME, is_empty)(const MONOQUEUE_TYPE *self);
+
+/**
+ * @brief Get the minimum key of a non-empty window. The newest of equal keys
+ *        is given.
+ *
+ * @param[in] self              The queue pointer.
+ *
+ * @return                      The entry of the minimum key.
+ */
+FUNCTION_LINKAGE MONOQUEUE_ENTRY_TYPE JOIN(MONOQUEUE_NAME, get_min)(const MONOQUEUE_TYPE *self);
+
+/**
+ * @brief Get the maximum key of a non-empty window. The newest of equal keys
+ *        is given.
+ *
+ * @param[in] self              The queue pointer.
+ *
+ * @return                      The entry of the maximum key.
+ */
+FUNCTION_LINKAGE MONOQUEUE_ENTRY_TYPE JOIN(MONOQUEUE_NAME, get_max)(const MONOQUEUE_TYPE *self);
+
+/**
+ * @brief Push a key to the window at a given position.
+ *
+ * @param[in] self              The queue pointer.
+ * @param[in] key               The key.
+ * @param[in] position          The position. Greater than the position of the
+ *                              last key pushed.
+ */
+FUNCTION_LINKAGE void JOIN(MONOQUEUE_NAME, push)(MONOQUEUE_TYPE *self, const KEY_TYPE key, const uint64_t position);
+
+/**
+ * @brief Push `n` keys to the window, at the positions `first_position` to
+ *        `first_position + n - 1`.
+ *
+ * The keys which survive the batch are found first by scanning the batch from
+ * the back, before the rings are touched. The scans only compare against the
+ * running minimum and maximum, which is cheaper than pushing one by one when
+ * the batch is large.
+ *
+ * @param[in] self              The queue pointer.
+ * @param[in] keys              The keys.
+ * @param[in] first_position    The position of the first key. Greater than
+ *                              the position of the last key pushed.
+ * @param[in] n                 The number of keys.
+ */
+FUNCTION_LINKAGE void JOIN(MONOQUEUE_NAME, push_n)(MONOQUEUE_TYPE *restrict self, const KEY_TYPE *restrict keys,
+                                                   const uint64_t first_position, const SIZE_TYPE n);
+
+/**
+ * @brief Expire the keys at positions before a given position.
+ *
+ * @param[in] self              The queue pointer.
+ * @param[in] min_position      The position of the oldest key of the window.
+ */
+FUNCTION_LINKAGE void JOIN(MONOQUEUE_NAME, expire)(MONOQUEUE_TYPE *self, const uint64_t min_position);
+
+/**
+ * @brief Clear the keys in the window.
+ *
+ * @param[in] self              The queue pointer.
+ */
+FUNCTION_LINKAGE void JOIN(MONOQUEUE_NAME, clear)(MONOQUEUE_TYPE *self);
+
+// }}}
+
+// function definitions: {{{
+
+/**
+ * @def FUNCTION_DEFINITIONS
+ * @brief Define the functions
+ */
+#ifdef FUNCTION_DEFINITIONS
+
+#include "round_up_pow2_32.h" // round_up_pow2_32
+#include "round_up_pow2_64.h" // round_up_pow2_64
+
+/// @cond DO_NOT_DOCUMENT
+static inline SIZE_TYPE JOIN(internal, JOIN(MONOQUEUE_NAME, round_up_pow2))(const SIZE_TYPE x)
+{
+    if (sizeof(SIZE_TYPE) <= sizeof(uint32_t)) {
+        return (SIZE_TYPE)round_up_pow2_32((uint32_t)x);
+    }
+    return (SIZE_TYPE)round_up_pow2_64((uint64_t)x);
+}
+
+/* pushes to the minimum ring (is_max = 0) or the maximum ring (is_max = 1) */
+static inline void JOIN(internal, JOIN(MONOQUEUE_NAME, push_n))(MONOQUEUE_TYPE *restrict self,
+                                                                const KEY_TYPE *restrict keys,
+                                                                const uint64_t first_position, const SIZE_TYPE n,
+                                                                const int is_max)
+{
+    MONOQUEUE_ENTRY_TYPE *ring = &self->entries[is_max ? self->capacity : 0];
+    const SIZE_TYPE index_mask = (self->capacity - 1);
+
+    /* a key survives the batch if it is less than every key after it. count the survivors */
+    SIZE_TYPE survivor_count = 1;
+    KEY_TYPE suffix_extreme = keys[n - 1];
+    for (SIZE_TYPE i = n - 1; i-- > 0;) {
+        if (MONOQUEUE_IS_LESS(keys[i], suffix_extreme, is_max)) {
+            suffix_extreme = keys[i];
+            survivor_count++;
+        }
+    }
+
+    /* the first survivor is the extreme of the batch. pop the keys in the ring which are not less than it */
+    SIZE_TYPE count = self->count[is_max];
+    while (count != 0
+           && !MONOQUEUE_IS_LESS(ring[(self->begin_index[is_max] + count - 1) & index_mask].key, suffix_extreme,
+                                 is_max)) {
+        count--;
+    }
+    assert((uintmax_t)0 + count + survivor_count <= self->capacity);
+
+    /* place the survivors from the back */
+    SIZE_TYPE index = count + survivor_count;
+    suffix_extreme = keys[n - 1];
+    for (SIZE_TYPE i = n; i-- > 0;) {
+        if (i == n - 1 || MONOQUEUE_IS_LESS(keys[i], suffix_extreme, is_max)) {
+            suffix_extreme = keys[i];
+            index--;
+            ring[(self->begin_index[is_max] + index) & index_mask].key = keys[i];
+            ring[(self->begin_index[is_max] + index) & index_mask].position = first_position + i;
+        }
+    }
+    self->count[is_max] = count + survivor_count;
+}
+/// @endcond
+
+FUNCTION_LINKAGE MONOQUEUE_TYPE *JOIN(MONOQUEUE_NAME, init)(MONOQUEUE_TYPE *self, const SIZE_TYPE pow2_capacity)
+{
+    assert(self);
+    assert(IS_POW2(pow2_capacity));
+
+    self->begin_index[0] = self->begin_index[1] = 0;
+    self->count[0] = self->count[1] = 0;
+    self->capacity = pow2_capacity;
+    self->next_position = 0;
+
+    return self;
+}
+
+FUNCTION_LINKAGE MONOQUEUE_TYPE *JOIN(MONOQUEUE_NAME, create)(const SIZE_TYPE min_capacity)
+{
+    return JOIN(MONOQUEUE_NAME, create_with_context)(min_capacity, NULL);
+}
+
+FUNCTION_LINKAGE MONOQUEUE_TYPE *JOIN(MONOQUEUE_NAME, create_with_context)(const SIZE_TYPE min_capacity, void *ctx)
+{
+    if (min_capacity == 0 || min_capacity > MONOQUEUE_SIZE_MAX / 2 + 1) {
+        return NULL;
+    }
+
+    const SIZE_TYPE capacity = MONOQUEUE_ROUND_UP(min_capacity);
+
+    if (MONOQUEUE_CALC_SIZEOF_OVERFLOWS(MONOQUEUE_NAME, capacity)) {
+        return NULL;
+    }
+
+    const size_t size = MONOQUEUE_CALC_SIZEOF(MONOQUEUE_NAME, capacity);
+
+    MONOQUEUE_TYPE *self = (MONOQUEUE_TYPE *)ALLOCATOR(ctx, size);
+
+    if (!self) {
+        return NULL;
+    }
+
+    MONOQUEUE_INIT(self, capacity);
+
+    return self;
+}
+
+FUNCTION_LINKAGE void JOIN(MONOQUEUE_NAME, destroy)(MONOQUEUE_TYPE *self)
+{
+    JOIN(MONOQUEUE_NAME, destroy_with_context)(self, NULL);
+}
+
+FUNCTION_LINKAGE void JOIN(MONOQUEUE_NAME, destroy_with_context)(MONOQUEUE_TYPE *self, void *ctx)
+{
+    assert(self != NULL);
+
+    DEALLOCATOR(ctx, self, MONOQUEUE_CALC_SIZEOF(MONOQUEUE_NAME, self->capacity));
+}
+
+FUNCTION_LINKAGE bool JOIN(MONOQUEUE_NAME, is_empty)(const MONOQUEUE_TYPE *self)
+{
+    assert(self != NULL);
+
+    return self->count[0] == 0;
+}
+
+FUNCTION_LINKAGE MONOQUEUE_ENTRY_TYPE JOIN(MONOQUEUE_NAME, get_min)(const MONOQUEUE_TYPE *self)
+{
+    assert(self != NULL);
+    assert(!MONOQUEUE_IS_EMPTY(self));
+
+    return self->entries[self->begin_index[0]];
+}
+
+FUNCTION_LINKAGE MONOQUEUE_ENTRY_TYPE JOIN(MONOQUEUE_NAME, get_max)(const MONOQUEUE_TYPE *self)
+{
+    assert(self != NULL);
+    assert(!MONOQUEUE_IS_EMPTY(self));
+
+    return self->entries[self->capacity + self->begin_index[1]];
+}
+
+FUNCTION_LINKAGE void JOIN(MONOQUEUE_NAME, push)(MONOQUEUE_TYPE *self, const KEY_TYPE key, const uint64_t position)
+{
+    assert(self != NULL);
+    assert(position >= self->next_position || MONOQUEUE_IS_EMPTY(self));
+
+    const SIZE_TYPE index_mask = (self->capacity - 1);
+
+    for (int is_max = 0; is_max <= 1; is_max++) {
+        MONOQUEUE_ENTRY_TYPE *ring = &self->entries[is_max ? self->capacity : 0];
+
+        SIZE_TYPE count = self->count[is_max];
+        while (count != 0
+               && !MONOQUEUE_IS_LESS(ring[(self->begin_index[is_max] + count - 1) & index_mask].key, key, is_max)) {
+            count--;
+        }
+        assert(count < self->capacity);
+
+        ring[(self->begin_index[is_max] + count) & index_mask].key = key;
+        ring[(self->begin_index[is_max] + count) & index_mask].position = position;
+        self->count[is_max] = count + 1;
+    }
+
+    self->next_position = position + 1;
+}
+
+FUNCTION_LINKAGE void JOIN(MONOQUEUE_NAME, push_n)(MONOQUEUE_TYPE *restrict self, const KEY_TYPE *restrict keys,
+                                                   const uint64_t first_position, const SIZE_TYPE n)
+{
+    assert(self != NULL);
+    assert(keys != NULL || n == 0);
+    assert(first_position >= self->next_position || MONOQUEUE_IS_EMPTY(self));
+
+    if (n == 0) {
+        return;
+    }
+
+    MONOQUEUE_PUSH_N(self, keys, first_position, n, 0);
+    MONOQUEUE_PUSH_N(self, keys, first_position, n, 1);
+
+    self->next_position = first_position + n;
+}
+
+FUNCTION_LINKAGE void JOIN(MONOQUEUE_NAME, expire)(MONOQUEUE_TYPE *self, const uint64_t min_position)
+{
+    assert(self != NULL);
+
+    const SIZE_TYPE index_mask = (self->capacity - 1);
+
+    for (int is_max = 0; is_max <= 1; is_max++) {
+        const MONOQUEUE_ENTRY_TYPE *ring = &self->entries[is_max ? self->capacity : 0];
+
+        while (self->count[is_max] != 0 && ring[self->begin_index[is_max]].position < min_position) {
+            self->begin_index[is_max] = (self->begin_index[is_max] + 1) & index_mask;
+            self->count[is_max]--;
+        }
+    }
+}
+
+FUNCTION_LINKAGE void JOIN(MONOQUEUE_NAME, clear)(MONOQUEUE_TYPE *self)
+{
+    assert(self != NULL);
+
+    self->begin_index[0] = self->begin_index[1] = 0;
+    self->count[0] = self->count[1] = 0;
+}
+
+#endif
+
+// }}}
+
+// macro undefs: {{{
+
+#undef NAME
+#undef KEY_TYPE
+#undef KEY_IS_STRICTLY_LESS
+#undef SIZE_TYPE
+#undef ALLOCATOR
+#undef DEALLOCATOR
+#undef FUNCTION_LINKAGE
+#undef FUNCTION_DEFINITIONS
+#undef TYPE_DEFINITIONS
+
+#undef MONOQUEUE_NAME
+#undef MONOQUEUE_TYPE
+#undef MONOQUEUE_ENTRY_TYPE
+#undef MONOQUEUE_INIT
+#undef MONOQUEUE_IS_EMPTY
+#undef MONOQUEUE_SIZE_MAX
+#undef MONOQUEUE_ROUND_UP
+#undef MONOQUEUE_PUSH_N
+#undef MONOQUEUE_IS_LESS
+
+// }}}
+
+#ifdef __cplusplus
+}
+#endif
+
+// vim: ft=c fdm=marker
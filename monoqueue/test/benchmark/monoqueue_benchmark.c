@@ -0,0 +1,124 @@
+// Compares computing the rolling minimum and maximum of a stream of random
+// doubles by rescanning the window, against the monotonic queue with `push`
+// one value at a time, and with `push_n` in batches, for windows of 16 to 4096
+// values. The stream arrives in batches, and the minimum and maximum are read
+// once per batch. Run with `make bench`.
+//
+// usage: ./a.out [number of values in millions]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define NAME                       f64_window
+#define KEY_TYPE                   double
+#define KEY_IS_STRICTLY_LESS(a, b) ((a) < (b))
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "monoqueue_template.h"
+
+#define MAX_WINDOW_SIZE (4096)
+#define BATCH_SIZE      (64)
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static double run_rescan(const double *values, const uint64_t count, const uint64_t window_size, double *sum_ptr)
+{
+    const double start = now_s();
+
+    for (uint64_t i = BATCH_SIZE - 1; i < count; i += BATCH_SIZE) {
+        if (i + 1 < window_size) {
+            continue;
+        }
+        double min = values[i], max = values[i];
+        for (uint64_t j = i + 1 - window_size; j < i; j++) {
+            min = values[j] < min ? values[j] : min;
+            max = values[j] > max ? values[j] : max;
+        }
+        *sum_ptr += max - min;
+    }
+
+    return now_s() - start;
+}
+
+static double run_push(struct f64_window *w, const double *values, const uint64_t count, const uint64_t window_size,
+                       double *sum_ptr)
+{
+    f64_window_clear(w);
+    const double start = now_s();
+
+    for (uint64_t i = 0; i + BATCH_SIZE <= count; i += BATCH_SIZE) {
+        for (uint64_t j = i; j < i + BATCH_SIZE; j++) {
+            f64_window_push(w, values[j], j);
+        }
+        if (i + BATCH_SIZE >= window_size) {
+            f64_window_expire(w, i + BATCH_SIZE - window_size);
+            *sum_ptr += f64_window_get_max(w).key - f64_window_get_min(w).key;
+        }
+    }
+
+    return now_s() - start;
+}
+
+static double run_push_n(struct f64_window *w, const double *values, const uint64_t count, const uint64_t window_size,
+                         double *sum_ptr)
+{
+    f64_window_clear(w);
+    const double start = now_s();
+
+    for (uint64_t i = 0; i + BATCH_SIZE <= count; i += BATCH_SIZE) {
+        f64_window_push_n(w, &values[i], i, BATCH_SIZE);
+        if (i + BATCH_SIZE >= window_size) {
+            f64_window_expire(w, i + BATCH_SIZE - window_size);
+            *sum_ptr += f64_window_get_max(w).key - f64_window_get_min(w).key;
+        }
+    }
+
+    return now_s() - start;
+}
+
+int main(int argc, char **argv)
+{
+    const uint64_t count = (argc > 1 ? strtoull(argv[1], NULL, 10) : 16) * 1000000 / BATCH_SIZE * BATCH_SIZE;
+
+    double *values = malloc(count * sizeof(double));
+    struct f64_window *w = f64_window_create(MAX_WINDOW_SIZE + BATCH_SIZE);
+    if (!values || !w) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+
+    srand(42);
+    for (uint64_t i = 0; i < count; i++) {
+        values[i] = (double)rand() / RAND_MAX;
+    }
+
+    printf("%llu random values, batches of %d\n", (unsigned long long)count, BATCH_SIZE);
+    printf("window   rescan Mvalues/s   push Mvalues/s   push_n Mvalues/s\n");
+
+    double checksum = 0.0;
+
+    for (uint64_t window_size = 16; window_size <= MAX_WINDOW_SIZE; window_size *= 4) {
+        const double rescan_elapsed = run_rescan(values, count, window_size, &checksum);
+        const double push_elapsed = run_push(w, values, count, window_size, &checksum);
+        const double push_n_elapsed = run_push_n(w, values, count, window_size, &checksum);
+
+        printf("%6llu   %16.2f   %14.2f   %16.2f\n", (unsigned long long)window_size,
+               (double)count / rescan_elapsed * 1e-6, (double)count / push_elapsed * 1e-6,
+               (double)count / push_n_elapsed * 1e-6);
+    }
+
+    printf("(checksum %f)\n", checksum);
+
+    f64_window_destroy(w);
+    free(values);
+
+    return 0;
+}
@@ -0,0 +1,195 @@
+/*
+    Test cases:
+    - Create:
+      - The capacity is rounded up to a power of 2
+      - A capacity of 0 is rejected
+    - Single keys:
+      - get_min / get_max after each push, against rescanning the window
+      - expire drops the keys before the position only
+      - Equal keys: the newest is given
+      - Positions with gaps (timestamps)
+      - clear
+    - Batches:
+      - push_n gives the same rings as pushing one by one, for random batch
+        sizes (including 0 and 1) and increasing, decreasing and random keys
+    - Custom KEY_IS_STRICTLY_LESS (struct keys)
+*/
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NAME                       i32_mono
+#define KEY_TYPE                   int32_t
+#define KEY_IS_STRICTLY_LESS(a, b) ((a) < (b))
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "monoqueue_template.h"
+
+struct price {
+    uint32_t cents;
+    uint32_t id;
+};
+
+#define NAME                       price_mono
+#define KEY_TYPE                   struct price
+#define KEY_IS_STRICTLY_LESS(a, b) ((a).cents < (b).cents)
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "monoqueue_template.h"
+
+#define WINDOW_SIZE (37)
+#define KEY_COUNT   (20000)
+
+static void create_test(void)
+{
+    assert(i32_mono_create(0) == NULL);
+
+    struct i32_mono *q = i32_mono_create(WINDOW_SIZE);
+    assert(q != NULL);
+    assert(q->capacity == 64);
+    assert(i32_mono_is_empty(q));
+    i32_mono_destroy(q);
+}
+
+static void rescan(const int32_t *keys, const uint64_t begin, const uint64_t end, int32_t *min_ptr, int32_t *max_ptr)
+{
+    *min_ptr = *max_ptr = keys[begin];
+    for (uint64_t i = begin + 1; i < end; i++) {
+        *min_ptr = keys[i] < *min_ptr ? keys[i] : *min_ptr;
+        *max_ptr = keys[i] > *max_ptr ? keys[i] : *max_ptr;
+    }
+}
+
+static void single_keys_test(void)
+{
+    struct i32_mono *q = i32_mono_create(WINDOW_SIZE);
+    assert(q != NULL);
+
+    int32_t *keys = malloc(KEY_COUNT * sizeof(int32_t));
+    assert(keys != NULL);
+
+    srand(42);
+    for (uint64_t i = 0; i < KEY_COUNT; i++) {
+        keys[i] = rand() % 1000 - 500;
+
+        i32_mono_push(q, keys[i], i);
+        const uint64_t begin = i + 1 >= WINDOW_SIZE ? i + 1 - WINDOW_SIZE : 0;
+        i32_mono_expire(q, begin);
+
+        int32_t min, max;
+        rescan(keys, begin, i + 1, &min, &max);
+        assert(i32_mono_get_min(q).key == min);
+        assert(i32_mono_get_max(q).key == max);
+        assert(i32_mono_get_min(q).position >= begin && i32_mono_get_max(q).position >= begin);
+    }
+
+    /* expire everything */
+    i32_mono_expire(q, KEY_COUNT);
+    assert(i32_mono_is_empty(q));
+
+    /* equal keys: the newest is kept, such that it stays in the window longer */
+    i32_mono_push(q, 5, 100);
+    i32_mono_push(q, 5, 101);
+    assert(i32_mono_get_min(q).position == 101);
+    assert(i32_mono_get_max(q).position == 101);
+    assert(q->count[0] == 1 && q->count[1] == 1);
+
+    /* timestamps with gaps */
+    i32_mono_push(q, 1, 200);
+    i32_mono_push(q, 9, 300);
+    i32_mono_push(q, 4, 400);
+    assert(i32_mono_get_min(q).key == 1 && i32_mono_get_max(q).key == 9);
+    i32_mono_expire(q, 201);
+    assert(i32_mono_get_min(q).key == 4 && i32_mono_get_max(q).key == 9);
+    i32_mono_expire(q, 301);
+    assert(i32_mono_get_min(q).key == 4 && i32_mono_get_max(q).key == 4);
+    i32_mono_expire(q, 400);
+    assert(!i32_mono_is_empty(q));
+
+    i32_mono_clear(q);
+    assert(i32_mono_is_empty(q));
+
+    free(keys);
+    i32_mono_destroy(q);
+}
+
+static void assert_same_rings(const struct i32_mono *a, const struct i32_mono *b)
+{
+    const uint32_t mask = a->capacity - 1;
+    for (uint32_t r = 0; r < 2; r++) {
+        assert(a->count[r] == b->count[r]);
+        for (uint32_t i = 0; i < a->count[r]; i++) {
+            const struct i32_mono_entry ea = a->entries[r * a->capacity + ((a->begin_index[r] + i) & mask)];
+            const struct i32_mono_entry eb = b->entries[r * b->capacity + ((b->begin_index[r] + i) & mask)];
+            assert(ea.key == eb.key && ea.position == eb.position);
+        }
+    }
+}
+
+static void batch_test(void)
+{
+    struct i32_mono *single = i32_mono_create(WINDOW_SIZE);
+    struct i32_mono *batch = i32_mono_create(WINDOW_SIZE);
+    int32_t *keys = malloc(KEY_COUNT * sizeof(int32_t));
+    assert(single != NULL && batch != NULL && keys != NULL);
+
+    srand(43);
+    for (int pattern = 0; pattern < 3; pattern++) {
+        for (uint64_t i = 0; i < KEY_COUNT; i++) {
+            keys[i] = pattern == 0 ? (int32_t)i : pattern == 1 ? -(int32_t)i : rand() % 100;
+        }
+        i32_mono_clear(single);
+        i32_mono_clear(batch);
+
+        uint64_t position = 0;
+        while (position < KEY_COUNT) {
+            uint32_t n = (uint32_t)rand() % (WINDOW_SIZE / 2);
+            n = position + n > KEY_COUNT ? (uint32_t)(KEY_COUNT - position) : n;
+
+            for (uint32_t i = 0; i < n; i++) {
+                i32_mono_push(single, keys[position + i], position + i);
+            }
+            i32_mono_push_n(batch, &keys[position], position, n);
+            position += n;
+
+            const uint64_t begin = position >= WINDOW_SIZE / 2 ? position - WINDOW_SIZE / 2 : 0;
+            i32_mono_expire(single, begin);
+            i32_mono_expire(batch, begin);
+
+            assert_same_rings(single, batch);
+        }
+    }
+
+    free(keys);
+    i32_mono_destroy(batch);
+    i32_mono_destroy(single);
+}
+
+static void custom_key_test(void)
+{
+    struct price_mono *q = price_mono_create(4);
+    assert(q != NULL);
+
+    const struct price prices[] = {{300, 0}, {100, 1}, {200, 2}, {100, 3}};
+    price_mono_push_n(q, prices, 0, 4);
+
+    assert(price_mono_get_min(q).key.id == 3);
+    assert(price_mono_get_max(q).key.id == 0);
+    price_mono_expire(q, 1);
+    assert(price_mono_get_max(q).key.id == 2);
+
+    price_mono_destroy(q);
+}
+
+int main(void)
+{
+    create_test();
+    single_keys_test();
+    batch_test();
+    custom_key_test();
+}
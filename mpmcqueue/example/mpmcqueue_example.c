@@ -0,0 +1,76 @@
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#define NAME       int_mpmc
+#define VALUE_TYPE int
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "mpmcqueue_template.h"
+
+#define PRODUCER_COUNT (3)
+#define CONSUMER_COUNT (2)
+#define MESSAGE_COUNT  (600) // per producer. divisible by the consumer count
+
+static struct int_mpmc *q;
+
+static void *producer(void *arg)
+{
+    (void)arg;
+    for (int i = 1; i <= MESSAGE_COUNT; i++) {
+        while (!int_mpmc_try_enqueue(q, i)) {
+            sched_yield(); // full. let the consumers catch up
+        }
+    }
+    return NULL;
+}
+
+static void *consumer(void *arg)
+{
+    long *sum = arg;
+    for (int i = 0; i < PRODUCER_COUNT * MESSAGE_COUNT / CONSUMER_COUNT; i++) {
+        int value;
+        while (!int_mpmc_try_dequeue(q, &value)) {
+            sched_yield(); // empty. let the producers catch up
+        }
+        *sum += value;
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    q = int_mpmc_create(16);
+    if (!q) {
+        assert(false);
+    }
+
+    pthread_t producers[PRODUCER_COUNT], consumers[CONSUMER_COUNT];
+    long sums[CONSUMER_COUNT] = {0};
+
+    for (int i = 0; i < PRODUCER_COUNT; i++) {
+        pthread_create(&producers[i], NULL, producer, NULL);
+    }
+    for (int i = 0; i < CONSUMER_COUNT; i++) {
+        pthread_create(&consumers[i], NULL, consumer, &sums[i]);
+    }
+
+    for (int i = 0; i < PRODUCER_COUNT; i++) {
+        pthread_join(producers[i], NULL);
+    }
+    long sum = 0;
+    for (int i = 0; i < CONSUMER_COUNT; i++) {
+        pthread_join(consumers[i], NULL);
+        sum += sums[i];
+    }
+
+    /* every value is received exactly once, by one of the consumers */
+    assert(sum == PRODUCER_COUNT * (long)MESSAGE_COUNT * (MESSAGE_COUNT + 1) / 2);
+    assert(int_mpmc_count(q) == 0);
+    printf("sum: %ld\n", sum);
+
+    int_mpmc_destroy(q);
+}
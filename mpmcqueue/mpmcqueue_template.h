@@ -0,0 +1,512 @@
+/*  mpmcqueue_template.h
+ *
+ *  Copyright (C) 2025 abxh
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *  See the file LICENSE included with this distribution for more
+ *  information. */
+
+/**
+ * @file mpmcqueue_template.h
+ * @brief Fixed-size multi-producer/multi-consumer lock-free queue based on
+ *        ring buffer
+ *
+ * Any number of threads may enqueue and dequeue concurrently without locks.
+ *
+ * The power-of-two ring of `fqueue_template.h` is kept, but each cell carries a
+ * sequence number telling whose turn it is:
+ *      @li A cell at position `pos` is free to be written when its sequence is
+ *          `pos`. The producer claims `pos` by a compare-and-swap on
+ *          `enqueue_index`, writes the value, and publishes it by setting the
+ *          sequence to `pos + 1`.
+ *      @li The cell is ready to be read when its sequence is `pos + 1`. The
+ *          consumer claims `pos` by a compare-and-swap on `dequeue_index`,
+ *          reads the value, and frees the cell for the next round by setting
+ *          the sequence to `pos + capacity`.
+ *
+ * Producers and consumers thus only contend on their own index, and never on a
+ * shared `count`. `enqueue_index` and `dequeue_index` are placed on separate
+ * cache lines.
+ *
+ * @note A producer which is preempted between claiming and publishing a cell
+ *       holds up consumers of that cell, so the queue is lock-free, but not
+ *       wait-free.
+ *
+ * Source(s) used:
+ *  @li https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+ */
+
+/**
+ * @example mpmcqueue_example.c
+ * Example of how `mpmcqueue_template.h` header file is used in practice.
+ */
+
+#ifdef __cplusplus
+#ifdef __GNUC__
+#define restrict __restrict__
+#else
+#define restrict
+#endif
+extern "C" {
+#endif
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// macro definitions: {{{
+
+/**
+ * @def PASTE(a,b)
+ * @brief Paste two tokens together.
+ */
+#ifndef PASTE
+#define PASTE(a, b) a##b
+#endif
+
+/**
+ * @def XPASTE(a,b)
+ * @brief First expand tokens, then paste them together.
+ */
+#ifndef XPASTE
+#define XPASTE(a, b) PASTE(a, b)
+#endif
+
+/**
+ * @def JOIN(a,b)
+ * @brief First expand tokens, then paste them together with a _ in between.
+ */
+#ifndef JOIN
+#define JOIN(a, b) XPASTE(a, XPASTE(_, b))
+#endif
+
+/**
+ * @brief Macro to check if a number is a power of two.
+ *
+ * @param[in] X             The number at hand.
+ *
+ * @return                  A boolean value indicating whether the number is a power of two.
+ */
+#ifndef IS_POW2
+#define IS_POW2(X) ((X) != 0 && ((X) & ((X) - 1)) == 0)
+#endif
+
+/**
+ * @def MPMCQUEUE_CACHE_LINE_SIZE
+ * @brief Alignment used to keep the producer and consumer indices apart.
+ *        Equal to a typical cache line size.
+ */
+#ifndef MPMCQUEUE_CACHE_LINE_SIZE
+#define MPMCQUEUE_CACHE_LINE_SIZE (64)
+#endif
+
+/**
+ * @def MPMCQUEUE_CALC_SIZEOF(mpmcqueue_name, capacity)
+ *
+ * @brief Calculate the size of the queue struct. No overflow checks.
+ *
+ * @param[in] mpmcqueue_name    Defined queue NAME.
+ * @param[in] capacity          Capacity input.
+ *
+ * @return                      The equivalent size.
+ */
+#ifndef MPMCQUEUE_CALC_SIZEOF
+#define MPMCQUEUE_CALC_SIZEOF(mpmcqueue_name, capacity) \
+    (offsetof(struct mpmcqueue_name, cells) + (size_t)(capacity) * sizeof(((struct mpmcqueue_name *)0)->cells[0]))
+#endif
+
+/**
+ * @def MPMCQUEUE_CALC_SIZEOF_OVERFLOWS(mpmcqueue_name, capacity)
+ *
+ * @brief Check for a given capacity, if the equivalent size of the queue struct
+ *        overflows. Leaves room for rounding the size up to a multiple of
+ *        `MPMCQUEUE_CACHE_LINE_SIZE`.
+ *
+ * @param[in] mpmcqueue_name    Defined queue NAME.
+ * @param[in] capacity          Capacity input.
+ *
+ * @return                      Whether the equivalent size overflows.
+ */
+#ifndef MPMCQUEUE_CALC_SIZEOF_OVERFLOWS
+#define MPMCQUEUE_CALC_SIZEOF_OVERFLOWS(mpmcqueue_name, capacity)                      \
+    ((uintmax_t)0 + (capacity)                                                         \
+     > (SIZE_MAX - MPMCQUEUE_CACHE_LINE_SIZE - offsetof(struct mpmcqueue_name, cells)) \
+           / sizeof(((struct mpmcqueue_name *)0)->cells[0]))
+#endif
+
+/// @cond DO_NOT_DOCUMENT
+#ifndef MPMCQUEUE_ALIGNAS
+#ifdef __cplusplus
+#define MPMCQUEUE_ALIGNAS(x) alignas(x)
+#else
+#define MPMCQUEUE_ALIGNAS(x) _Alignas(x)
+#endif
+#endif
+/// @endcond
+
+/**
+ * @def NAME
+ * @brief Prefix to queue type and operations. This must be manually defined
+ *        before including this header file.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef NAME
+#define NAME mpmcqueue
+#error "Must define NAME."
+#else
+#define MPMCQUEUE_NAME NAME
+#endif
+
+/**
+ * @def VALUE_TYPE
+ * @brief Queue value type. This must be manually defined before including this
+ *        header file.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef VALUE_TYPE
+#define VALUE_TYPE int
+#define FUNCTION_DEFINITIONS
+#define TYPE_DEFINITIONS
+#error "Must define VALUE_TYPE."
+#endif
+
+/**
+ * @def SIZE_TYPE
+ * @brief Queue capacity, index and sequence number type. Defaults to
+ *        `uint32_t`.
+ *
+ * Define as `uint64_t` (or `size_t`) for queues of more than
+ * `UINT32_MAX / 2 + 1` values. Must be an unsigned integer type which is
+ * lock-free as an atomic.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef SIZE_TYPE
+#define SIZE_TYPE uint32_t
+#endif
+
+/**
+ * @def FUNCTION_LINKAGE
+ * @brief Specify function linkage e.g. static inline
+ */
+#ifndef FUNCTION_LINKAGE
+#define FUNCTION_LINKAGE
+#endif
+
+/// @cond DO_NOT_DOCUMENT
+#define MPMCQUEUE_TYPE      struct MPMCQUEUE_NAME
+#define MPMCQUEUE_CELL_TYPE struct JOIN(MPMCQUEUE_NAME, cell)
+#define MPMCQUEUE_INIT      JOIN(MPMCQUEUE_NAME, init)
+#define MPMCQUEUE_SIZE_MAX  ((SIZE_TYPE)-1)
+#define MPMCQUEUE_ROUND_UP  JOIN(internal, JOIN(MPMCQUEUE_NAME, round_up_pow2))
+/// @endcond
+
+// }}}
+
+// type definitions: {{{
+
+/**
+ * @def TYPE_DEFINITIONS
+ * @brief Define the types
+ */
+#ifdef TYPE_DEFINITIONS
+
+/**
+ * @brief Generated queue cell struct type for a `VALUE_TYPE`.
+ */
+struct JOIN(MPMCQUEUE_NAME, cell) {
+    _Atomic(SIZE_TYPE) sequence; ///< Position the cell is next written (or read, minus 1) at.
+    VALUE_TYPE value;            ///< The value.
+};
+
+/**
+ * @brief Generated queue struct type for a `VALUE_TYPE`.
+ */
+struct MPMCQUEUE_NAME {
+    MPMCQUEUE_ALIGNAS(MPMCQUEUE_CACHE_LINE_SIZE)
+    _Atomic(SIZE_TYPE) enqueue_index; ///< Position of the next cell to be written. Shared by the producers.
+
+    MPMCQUEUE_ALIGNAS(MPMCQUEUE_CACHE_LINE_SIZE)
+    _Atomic(SIZE_TYPE) dequeue_index; ///< Position of the next cell to be read. Shared by the consumers.
+
+    MPMCQUEUE_ALIGNAS(MPMCQUEUE_CACHE_LINE_SIZE)
+    SIZE_TYPE capacity; ///< Maximum number of values allocated for.
+
+    MPMCQUEUE_ALIGNAS(MPMCQUEUE_CACHE_LINE_SIZE)
+    MPMCQUEUE_CELL_TYPE cells[]; ///< Array of cells. Aligned to the size of a cache line.
+};
+
+#endif
+
+// }}}
+
+// function declarations: {{{
+
+/**
+ * @brief Initialize a queue struct, given a (power-of-2) capacity.
+ *
+ * @note The memory should be aligned to `MPMCQUEUE_CACHE_LINE_SIZE`.
+ *
+ * @param[in] self              Queue pointer
+ * @param[in] pow2_capacity     Power of 2 capacity. At least 2, as with a
+ *                              single cell the sequence number of a written
+ *                              cell (`pos + 1`) is the same as that of the
+ *                              free cell for the next position.
+ *
+ * @return                      The queue pointer.
+ */
+FUNCTION_LINKAGE MPMCQUEUE_TYPE *JOIN(MPMCQUEUE_NAME, init)(MPMCQUEUE_TYPE *self, const SIZE_TYPE pow2_capacity);
+
+/**
+ * @brief Create a queue struct with a given capacity with aligned_alloc().
+ *
+ * @param[in] min_capacity      Maximum number of elements expected to be stored.
+ *                              Rounded up to a power of 2, and to at least 2.
+ *
+ * @return                      A pointer to the queue.
+ * @retval NULL
+ *   @li                        If aligned_alloc fails.
+ *   @li                        If capacity is 0 or larger than the maximum of `SIZE_TYPE` / 2 + 1 or the
+ *                              equivalent size overflows.
+ */
+FUNCTION_LINKAGE MPMCQUEUE_TYPE *JOIN(MPMCQUEUE_NAME, create)(const SIZE_TYPE min_capacity);
+
+/**
+ * @brief Destroy a queue struct and free the underlying memory.
+ *
+ * @warning May not be called twice in a row on the same object, or while
+ *          other threads still use the queue.
+ *
+ * @param[in] self              The queue pointer.
+ */
+FUNCTION_LINKAGE void JOIN(MPMCQUEUE_NAME, destroy)(MPMCQUEUE_TYPE *self);
+
+/**
+ * @brief Return the number of values in the queue.
+ *
+ * @note A snapshot. The queue may have changed by the time the result is used.
+ *       Values being written or read at the moment are counted as well.
+ *
+ * @param[in] self              The queue pointer.
+ *
+ * @return                      The number of values, at most `capacity`.
+ */
+FUNCTION_LINKAGE SIZE_TYPE JOIN(MPMCQUEUE_NAME, count)(MPMCQUEUE_TYPE *self);
+
+/**
+ * @brief Enqueue a value at the back of the queue, if it is not full.
+ *
+ * @param[in] self              The queue pointer.
+ * @param[in] value             The value to enqueue.
+ *
+ * @return                      Whether the value was enqueued.
+ */
+FUNCTION_LINKAGE bool JOIN(MPMCQUEUE_NAME, try_enqueue)(MPMCQUEUE_TYPE *self, const VALUE_TYPE value);
+
+/**
+ * @brief Dequeue a value from the front of the queue, if it is not empty.
+ *
+ * @note May also fail if the front value is claimed, but not yet written, by a
+ *       producer.
+ *
+ * @param[in] self              The queue pointer.
+ * @param[out] value_ptr        Set to the front value, if any.
+ *
+ * @return                      Whether a value was dequeued.
+ */
+FUNCTION_LINKAGE bool JOIN(MPMCQUEUE_NAME, try_dequeue)(MPMCQUEUE_TYPE *restrict self, VALUE_TYPE *restrict value_ptr);
+
+// }}}
+
+// function definitions: {{{
+
+/**
+ * @def FUNCTION_DEFINITIONS
+ * @brief Define the functions
+ */
+#ifdef FUNCTION_DEFINITIONS
+
+#include "round_up_pow2_32.h" // round_up_pow2_32
+#include "round_up_pow2_64.h" // round_up_pow2_64
+
+/// @cond DO_NOT_DOCUMENT
+static inline SIZE_TYPE JOIN(internal, JOIN(MPMCQUEUE_NAME, round_up_pow2))(const SIZE_TYPE x)
+{
+    if (sizeof(SIZE_TYPE) <= sizeof(uint32_t)) {
+        return (SIZE_TYPE)round_up_pow2_32((uint32_t)x);
+    }
+    return (SIZE_TYPE)round_up_pow2_64((uint64_t)x);
+}
+/// @endcond
+
+FUNCTION_LINKAGE MPMCQUEUE_TYPE *JOIN(MPMCQUEUE_NAME, init)(MPMCQUEUE_TYPE *self, const SIZE_TYPE pow2_capacity)
+{
+    assert(self);
+    assert(IS_POW2(pow2_capacity));
+    assert(pow2_capacity >= 2);
+
+    atomic_init(&self->enqueue_index, 0);
+    atomic_init(&self->dequeue_index, 0);
+    self->capacity = pow2_capacity;
+
+    for (SIZE_TYPE i = 0; i < pow2_capacity; i++) {
+        atomic_init(&self->cells[i].sequence, i);
+    }
+
+    return self;
+}
+
+FUNCTION_LINKAGE MPMCQUEUE_TYPE *JOIN(MPMCQUEUE_NAME, create)(const SIZE_TYPE min_capacity)
+{
+    if (min_capacity == 0 || min_capacity > MPMCQUEUE_SIZE_MAX / 2 + 1) {
+        return NULL;
+    }
+
+    const SIZE_TYPE capacity = MPMCQUEUE_ROUND_UP(min_capacity < 2 ? 2 : min_capacity);
+
+    if (MPMCQUEUE_CALC_SIZEOF_OVERFLOWS(MPMCQUEUE_NAME, capacity)) {
+        return NULL;
+    }
+
+    /* aligned_alloc requires the size to be a multiple of the alignment */
+    const size_t size = (MPMCQUEUE_CALC_SIZEOF(MPMCQUEUE_NAME, capacity) + MPMCQUEUE_CACHE_LINE_SIZE - 1)
+                        & ~(size_t)(MPMCQUEUE_CACHE_LINE_SIZE - 1);
+
+    MPMCQUEUE_TYPE *self = (MPMCQUEUE_TYPE *)aligned_alloc(MPMCQUEUE_CACHE_LINE_SIZE, size);
+
+    if (!self) {
+        return NULL;
+    }
+
+    MPMCQUEUE_INIT(self, capacity);
+
+    return self;
+}
+
+FUNCTION_LINKAGE void JOIN(MPMCQUEUE_NAME, destroy)(MPMCQUEUE_TYPE *self)
+{
+    assert(self != NULL);
+
+    free(self);
+}
+
+FUNCTION_LINKAGE SIZE_TYPE JOIN(MPMCQUEUE_NAME, count)(MPMCQUEUE_TYPE *self)
+{
+    assert(self != NULL);
+
+    /* dequeue_index is read first, such that enqueue_index is never seen behind it */
+    const SIZE_TYPE dequeue_index = atomic_load_explicit(&self->dequeue_index, memory_order_acquire);
+    const SIZE_TYPE enqueue_index = atomic_load_explicit(&self->enqueue_index, memory_order_acquire);
+    const SIZE_TYPE count = (SIZE_TYPE)(enqueue_index - dequeue_index);
+
+    return count < self->capacity ? count : self->capacity;
+}
+
+FUNCTION_LINKAGE bool JOIN(MPMCQUEUE_NAME, try_enqueue)(MPMCQUEUE_TYPE *self, const VALUE_TYPE value)
+{
+    assert(self != NULL);
+
+    const SIZE_TYPE index_mask = self->capacity - 1;
+
+    SIZE_TYPE pos = atomic_load_explicit(&self->enqueue_index, memory_order_relaxed);
+    MPMCQUEUE_CELL_TYPE *cell;
+
+    for (;;) {
+        cell = &self->cells[pos & index_mask];
+
+        /* the difference is interpreted as signed: behind means full, ahead means pos is stale */
+        const SIZE_TYPE diff = (SIZE_TYPE)(atomic_load_explicit(&cell->sequence, memory_order_acquire) - pos);
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&self->enqueue_index, &pos, (SIZE_TYPE)(pos + 1),
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff > MPMCQUEUE_SIZE_MAX / 2) {
+            return false;
+        }
+        else {
+            pos = atomic_load_explicit(&self->enqueue_index, memory_order_relaxed);
+        }
+    }
+
+    cell->value = value;
+
+    atomic_store_explicit(&cell->sequence, (SIZE_TYPE)(pos + 1), memory_order_release);
+
+    return true;
+}
+
+FUNCTION_LINKAGE bool JOIN(MPMCQUEUE_NAME, try_dequeue)(MPMCQUEUE_TYPE *restrict self, VALUE_TYPE *restrict value_ptr)
+{
+    assert(self != NULL);
+    assert(value_ptr != NULL);
+
+    const SIZE_TYPE index_mask = self->capacity - 1;
+
+    SIZE_TYPE pos = atomic_load_explicit(&self->dequeue_index, memory_order_relaxed);
+    MPMCQUEUE_CELL_TYPE *cell;
+
+    for (;;) {
+        cell = &self->cells[pos & index_mask];
+
+        /* the difference is interpreted as signed: behind means empty, ahead means pos is stale */
+        const SIZE_TYPE diff = (SIZE_TYPE)(atomic_load_explicit(&cell->sequence, memory_order_acquire) - (pos + 1));
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&self->dequeue_index, &pos, (SIZE_TYPE)(pos + 1),
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff > MPMCQUEUE_SIZE_MAX / 2) {
+            return false;
+        }
+        else {
+            pos = atomic_load_explicit(&self->dequeue_index, memory_order_relaxed);
+        }
+    }
+
+    *value_ptr = cell->value;
+
+    atomic_store_explicit(&cell->sequence, (SIZE_TYPE)(pos + self->capacity), memory_order_release);
+
+    return true;
+}
+
+#endif
+
+// }}}
+
+// macro undefs: {{{
+
+#undef NAME
+#undef VALUE_TYPE
+#undef SIZE_TYPE
+#undef FUNCTION_LINKAGE
+#undef FUNCTION_DEFINITIONS
+#undef TYPE_DEFINITIONS
+
+#undef MPMCQUEUE_NAME
+#undef MPMCQUEUE_TYPE
+#undef MPMCQUEUE_CELL_TYPE
+#undef MPMCQUEUE_INIT
+#undef MPMCQUEUE_SIZE_MAX
+#undef MPMCQUEUE_ROUND_UP
+
+// }}}
+
+#ifdef __cplusplus
+}
+#endif
+
+// vim: ft=c fdm=marker
@@ -0,0 +1,200 @@
+// Compares the lock-free MPMC queue with an fqueue guarded by a mutex, for 1
+// to 64 threads. Each thread repeatedly enqueues a value and then dequeues a
+// value, such that every thread is both a producer and a consumer, and the
+// total number of operations is the same for every thread count.
+// Run with `make bench`.
+//
+// usage: ./a.out [number of enqueue-dequeue pairs]
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define NAME       u64_mpmc
+#define VALUE_TYPE uint64_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "mpmcqueue_template.h"
+
+#define NAME       u64_fqueue
+#define VALUE_TYPE uint64_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fqueue_template.h"
+
+#define CAPACITY         (1024)
+#define MAX_THREAD_COUNT (64)
+
+/* spin for a while before giving up the core, such that oversubscribed cores still make progress */
+#define SPIN_LIMIT (1024)
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static inline void backoff(uint32_t *spins)
+{
+    if (++*spins == SPIN_LIMIT) {
+        *spins = 0;
+        sched_yield();
+    }
+}
+
+// fqueue under a mutex: {{{
+
+struct locked_fqueue {
+    pthread_mutex_t mutex;
+    struct u64_fqueue *q;
+};
+
+static bool locked_try_enqueue(struct locked_fqueue *self, const uint64_t value)
+{
+    pthread_mutex_lock(&self->mutex);
+    const bool ok = !u64_fqueue_is_full(self->q) && u64_fqueue_enqueue(self->q, value);
+    pthread_mutex_unlock(&self->mutex);
+    return ok;
+}
+
+static bool locked_try_dequeue(struct locked_fqueue *self, uint64_t *value_ptr)
+{
+    pthread_mutex_lock(&self->mutex);
+    const bool ok = !u64_fqueue_is_empty(self->q);
+    if (ok) {
+        *value_ptr = u64_fqueue_dequeue(self->q);
+    }
+    pthread_mutex_unlock(&self->mutex);
+    return ok;
+}
+
+// }}}
+
+static struct u64_mpmc *mpmc;
+static struct locked_fqueue locked = {PTHREAD_MUTEX_INITIALIZER, NULL};
+
+static pthread_barrier_t start_barrier;
+
+struct worker_args {
+    uint64_t pair_count;
+    uint64_t sum;
+    double start, end;
+};
+
+static void *mpmc_worker(void *arg)
+{
+    struct worker_args *args = arg;
+    uint64_t sum = 0;
+
+    pthread_barrier_wait(&start_barrier);
+    args->start = now_s();
+
+    for (uint64_t i = 0; i < args->pair_count; i++) {
+        uint64_t value;
+        uint32_t spins = 0;
+        while (!u64_mpmc_try_enqueue(mpmc, i)) {
+            backoff(&spins);
+        }
+        while (!u64_mpmc_try_dequeue(mpmc, &value)) {
+            backoff(&spins);
+        }
+        sum += value;
+    }
+
+    args->end = now_s();
+    args->sum = sum;
+    return NULL;
+}
+
+static void *locked_worker(void *arg)
+{
+    struct worker_args *args = arg;
+    uint64_t sum = 0;
+
+    pthread_barrier_wait(&start_barrier);
+    args->start = now_s();
+
+    for (uint64_t i = 0; i < args->pair_count; i++) {
+        uint64_t value;
+        uint32_t spins = 0;
+        while (!locked_try_enqueue(&locked, i)) {
+            backoff(&spins);
+        }
+        while (!locked_try_dequeue(&locked, &value)) {
+            backoff(&spins);
+        }
+        sum += value;
+    }
+
+    args->end = now_s();
+    args->sum = sum;
+    return NULL;
+}
+
+/* returns the time from the first thread starting to the last thread finishing */
+static double run(void *(*worker)(void *), const uint32_t thread_count, const uint64_t pair_count, uint64_t *sum_ptr)
+{
+    pthread_t threads[MAX_THREAD_COUNT];
+    struct worker_args args[MAX_THREAD_COUNT];
+
+    pthread_barrier_init(&start_barrier, NULL, thread_count);
+
+    for (uint32_t i = 0; i < thread_count; i++) {
+        args[i].pair_count = pair_count / thread_count;
+        pthread_create(&threads[i], NULL, worker, &args[i]);
+    }
+
+    double start = 0.0, end = 0.0;
+    for (uint32_t i = 0; i < thread_count; i++) {
+        pthread_join(threads[i], NULL);
+        *sum_ptr += args[i].sum;
+        start = (i == 0 || args[i].start < start) ? args[i].start : start;
+        end = args[i].end > end ? args[i].end : end;
+    }
+
+    pthread_barrier_destroy(&start_barrier);
+
+    return end - start;
+}
+
+int main(int argc, char **argv)
+{
+    const uint64_t pair_count = argc > 1 ? strtoull(argv[1], NULL, 10) : 1000000;
+
+    mpmc = u64_mpmc_create(CAPACITY);
+    locked.q = u64_fqueue_create(CAPACITY);
+
+    if (!mpmc || !locked.q) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+
+    printf("%llu enqueue-dequeue pairs, capacity %d\n", (unsigned long long)pair_count, CAPACITY);
+    printf("threads   mpmc Mpairs/s   mutex Mpairs/s\n");
+
+    uint64_t checksum = 0;
+
+    for (uint32_t thread_count = 1; thread_count <= MAX_THREAD_COUNT; thread_count *= 2) {
+        const uint64_t total = pair_count / thread_count * thread_count;
+
+        const double mpmc_elapsed = run(mpmc_worker, thread_count, pair_count, &checksum);
+        const double locked_elapsed = run(locked_worker, thread_count, pair_count, &checksum);
+
+        printf("%7u   %14.2f   %14.2f\n", thread_count, (double)total / mpmc_elapsed * 1e-6,
+               (double)total / locked_elapsed * 1e-6);
+    }
+
+    printf("(checksum %llu)\n", (unsigned long long)checksum);
+
+    u64_fqueue_destroy(locked.q);
+    u64_mpmc_destroy(mpmc);
+
+    return 0;
+}
@@ -0,0 +1,207 @@
+/*
+    Test cases:
+    - Creation:
+      - Zero / overly large capacities are rejected
+      - Capacity is rounded up to a power of two, and to at least 2
+      - Enqueue index, dequeue index and cells are on separate cache lines
+    - Single thread:
+      - try_enqueue fails exactly when full, try_dequeue exactly when empty
+      - FIFO order across many wrap-arounds of the ring
+      - count
+      - Wrap-around of the positions and sequence numbers at the maximum of SIZE_TYPE
+    - Multiple threads (4 producers, 4 consumers):
+      - Every value is received exactly once
+      - Values of a producer are received in order by each consumer
+*/
+
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define NAME       u32_mpmc
+#define VALUE_TYPE uint32_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "mpmcqueue_template.h"
+
+#define THREAD_COUNT      (4)
+#define VALUES_PER_THREAD (100000)
+#define PRODUCER_SHIFT    (24)
+
+static void creation_test(void)
+{
+    assert(u32_mpmc_create(0) == NULL);
+    assert(u32_mpmc_create(UINT32_MAX / 2 + 2) == NULL);
+
+    struct u32_mpmc *q = u32_mpmc_create(5);
+    assert(q != NULL);
+    assert(q->capacity == 8);
+    assert((uintptr_t)q % MPMCQUEUE_CACHE_LINE_SIZE == 0);
+    assert(u32_mpmc_count(q) == 0);
+    u32_mpmc_destroy(q);
+
+    /* a capacity of 1 is rounded up to 2, such that a written cell is not mistaken as free */
+    q = u32_mpmc_create(1);
+    assert(q != NULL);
+    assert(q->capacity == 2);
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < 10; i++) {
+        assert(u32_mpmc_try_enqueue(q, 2 * i));
+        assert(u32_mpmc_try_enqueue(q, 2 * i + 1));
+        assert(!u32_mpmc_try_enqueue(q, 0));
+        assert(u32_mpmc_count(q) == 2);
+        assert(u32_mpmc_try_dequeue(q, &value) && value == 2 * i);
+        assert(u32_mpmc_try_dequeue(q, &value) && value == 2 * i + 1);
+        assert(!u32_mpmc_try_dequeue(q, &value));
+    }
+    u32_mpmc_destroy(q);
+
+    assert(offsetof(struct u32_mpmc, dequeue_index) - offsetof(struct u32_mpmc, enqueue_index)
+           >= MPMCQUEUE_CACHE_LINE_SIZE);
+    assert(offsetof(struct u32_mpmc, cells) - offsetof(struct u32_mpmc, dequeue_index) >= MPMCQUEUE_CACHE_LINE_SIZE);
+    assert(offsetof(struct u32_mpmc, cells) % MPMCQUEUE_CACHE_LINE_SIZE == 0);
+}
+
+static void single_thread_test(void)
+{
+    struct u32_mpmc *q = u32_mpmc_create(4);
+    assert(q != NULL);
+
+    uint32_t value = 0;
+    assert(!u32_mpmc_try_dequeue(q, &value));
+
+    uint32_t next_in = 0, next_out = 0;
+    for (uint32_t round = 0; round < 100; round++) {
+        /* fill up, with a varying starting position in the ring */
+        while (u32_mpmc_try_enqueue(q, next_in)) {
+            next_in++;
+        }
+        assert(u32_mpmc_count(q) == 4);
+
+        const uint32_t n = round % 4 + 1;
+        for (uint32_t i = 0; i < n; i++) {
+            assert(u32_mpmc_try_dequeue(q, &value) && value == next_out);
+            next_out++;
+        }
+        assert(u32_mpmc_count(q) == 4 - n);
+    }
+
+    while (u32_mpmc_try_dequeue(q, &value)) {
+        assert(value == next_out++);
+    }
+    assert(next_out == next_in);
+    assert(u32_mpmc_count(q) == 0);
+
+    u32_mpmc_destroy(q);
+}
+
+static void index_wrap_around_test(void)
+{
+    struct u32_mpmc *q = u32_mpmc_create(4);
+    assert(q != NULL);
+
+    /* an empty queue whose positions are about to wrap around */
+    const uint32_t start = UINT32_MAX - 1;
+    atomic_store(&q->enqueue_index, start);
+    atomic_store(&q->dequeue_index, start);
+    for (uint32_t i = 0; i < 4; i++) {
+        const uint32_t pos = start + i;
+        atomic_store(&q->cells[pos & 3].sequence, pos);
+    }
+
+    for (uint32_t round = 0; round < 3; round++) {
+        for (uint32_t i = 0; i < 4; i++) {
+            assert(u32_mpmc_try_enqueue(q, i));
+        }
+        assert(!u32_mpmc_try_enqueue(q, 4));
+        assert(u32_mpmc_count(q) == 4);
+
+        uint32_t value;
+        for (uint32_t i = 0; i < 4; i++) {
+            assert(u32_mpmc_try_dequeue(q, &value) && value == i);
+        }
+        assert(!u32_mpmc_try_dequeue(q, &value));
+    }
+    assert(atomic_load(&q->enqueue_index) == 10);
+
+    u32_mpmc_destroy(q);
+}
+
+static struct u32_mpmc *shared_queue;
+static uint8_t *seen;
+
+static void *producer(void *arg)
+{
+    const uint32_t id = (uint32_t)(uintptr_t)arg;
+
+    for (uint32_t i = 0; i < VALUES_PER_THREAD; i++) {
+        while (!u32_mpmc_try_enqueue(shared_queue, id << PRODUCER_SHIFT | i)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *consumer(void *arg)
+{
+    (void)arg;
+
+    uint32_t last[THREAD_COUNT];
+    bool has_last[THREAD_COUNT] = {false};
+
+    for (uint32_t i = 0; i < VALUES_PER_THREAD; i++) {
+        uint32_t value;
+        while (!u32_mpmc_try_dequeue(shared_queue, &value)) {
+            sched_yield();
+        }
+
+        const uint32_t id = value >> PRODUCER_SHIFT;
+        const uint32_t index = value & ((1U << PRODUCER_SHIFT) - 1);
+        assert(id < THREAD_COUNT && index < VALUES_PER_THREAD);
+        assert(!has_last[id] || last[id] < index);
+        last[id] = index;
+        has_last[id] = true;
+
+        seen[id * VALUES_PER_THREAD + index]++;
+    }
+    return NULL;
+}
+
+static void multiple_threads_test(void)
+{
+    shared_queue = u32_mpmc_create(64);
+    seen = calloc(THREAD_COUNT * VALUES_PER_THREAD, sizeof(uint8_t));
+    assert(shared_queue != NULL && seen != NULL);
+
+    pthread_t producers[THREAD_COUNT], consumers[THREAD_COUNT];
+    for (uint32_t i = 0; i < THREAD_COUNT; i++) {
+        assert(pthread_create(&producers[i], NULL, producer, (void *)(uintptr_t)i) == 0);
+        assert(pthread_create(&consumers[i], NULL, consumer, NULL) == 0);
+    }
+    for (uint32_t i = 0; i < THREAD_COUNT; i++) {
+        assert(pthread_join(producers[i], NULL) == 0);
+        assert(pthread_join(consumers[i], NULL) == 0);
+    }
+
+    /* seen is written by disjoint consumers per value, and read after the joins */
+    for (uint32_t i = 0; i < THREAD_COUNT * VALUES_PER_THREAD; i++) {
+        assert(seen[i] == 1);
+    }
+    assert(u32_mpmc_count(shared_queue) == 0);
+
+    free(seen);
+    u32_mpmc_destroy(shared_queue);
+}
+
+int main(void)
+{
+    creation_test();
+    single_thread_test();
+    index_wrap_around_test();
+    multiple_threads_test();
+}
@@ -0,0 +1,50 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define NAME       byte_queue
+#define VALUE_TYPE unsigned char
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fqueue_template.h"
+
+#define NAME  log_records
+#define QUEUE byte_queue
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "recordqueue_template.h"
+
+#define MAX_MESSAGE_LEN (64)
+
+int main(void)
+{
+    struct byte_queue *q = byte_queue_create(256);
+    if (!q) {
+        return 1;
+    }
+
+    // format messages of varying length straight into the ring:
+    for (int i = 0; i < 3; i++) {
+        char *msg = log_records_reserve(q, MAX_MESSAGE_LEN);
+        assert(msg != NULL);
+
+        const int len = snprintf(msg, MAX_MESSAGE_LEN, "message %d%.*s", i, i * 10, "..............................");
+        log_records_commit(q, (uint32_t)len);
+    }
+
+    // no room for a record taking up more than the capacity:
+    assert(RECORDQUEUE_CALC_RECORD_SIZE(256) > q->capacity);
+    assert(log_records_reserve(q, 256) == NULL);
+
+    // read them in place, in order:
+    uint32_t len;
+    const char *msg;
+    while ((msg = log_records_peek(q, &len)) != NULL) {
+        printf("%.*s\n", (int)len, msg);
+        log_records_release(q);
+    }
+    assert(byte_queue_is_empty(q));
+
+    byte_queue_destroy(q);
+}
@@ -0,0 +1,363 @@
+/*  recordqueue_template.h
+ *
+ *  Copyright (C) 2025 abxh
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *  See the file LICENSE included with this distribution for more
+ *  information. */
+
+/**
+ * @file recordqueue_template.h
+ * @brief Queue of variable-length records on top of a byte ring
+ *
+ * Operates on a queue of bytes defined with `fqueue_template.h`, and stores
+ * records of any length in it contiguously, without allocating per record:
+ *      @li Each record is a length header of `RECORDQUEUE_HEADER_SIZE` bytes
+ *          followed by the payload, padded to `RECORDQUEUE_ALIGNMENT` bytes.
+ *      @li A record is never split at the end of the ring. When it does not
+ *          fit before the end, the bytes until the end are filled with a
+ *          padding record, which the consumer skips.
+ *
+ * The producer writes a record in place with `reserve` followed by `commit`,
+ * and the consumer reads it in place with `peek` followed by `release`:
+ *
+ * @code{.c}
+ * char *msg = my_records_reserve(q, max_len);
+ * if (msg) {
+ *     my_records_commit(q, (uint32_t)snprintf(msg, max_len, "..."));
+ * }
+ * ...
+ * uint32_t len;
+ * const char *msg = my_records_peek(q, &len);
+ * if (msg) {
+ *     fwrite(msg, 1, len, stdout);
+ *     my_records_release(q);
+ * }
+ * @endcode
+ *
+ * The byte queue is expected to be only accessed through these operations,
+ * while it holds records. Like the byte queue, it is not thread-safe.
+ */
+
+/**
+ * @example recordqueue_example.c
+ * Example of how `recordqueue_template.h` header file is used in practice.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// macro definitions: {{{
+
+/**
+ * @def PASTE(a,b)
+ * @brief Paste two tokens together.
+ */
+#ifndef PASTE
+#define PASTE(a, b) a##b
+#endif
+
+/**
+ * @def XPASTE(a,b)
+ * @brief First expand tokens, then paste them together.
+ */
+#ifndef XPASTE
+#define XPASTE(a, b) PASTE(a, b)
+#endif
+
+/**
+ * @def JOIN(a,b)
+ * @brief First expand tokens, then paste them together with a _ in between.
+ */
+#ifndef JOIN
+#define JOIN(a, b) XPASTE(a, XPASTE(_, b))
+#endif
+
+/**
+ * @def RECORDQUEUE_ALIGNMENT
+ * @brief Alignment of the records in the ring, relative to the start of the
+ *        ring storage. A power of 2 of at least `sizeof(uint32_t)`.
+ */
+#ifndef RECORDQUEUE_ALIGNMENT
+#define RECORDQUEUE_ALIGNMENT (8)
+#endif
+
+/**
+ * @def RECORDQUEUE_HEADER_SIZE
+ * @brief Number of bytes before each payload, holding its length. Equal to
+ *        the alignment, such that payloads are aligned as well.
+ */
+#define RECORDQUEUE_HEADER_SIZE (RECORDQUEUE_ALIGNMENT)
+
+/**
+ * @def RECORDQUEUE_PADDING
+ * @brief Length stored in the header of padding records.
+ */
+#define RECORDQUEUE_PADDING (UINT32_MAX)
+
+/**
+ * @def RECORDQUEUE_CALC_RECORD_SIZE(len)
+ * @brief Calculate the number of bytes taken up in the ring by a record.
+ *
+ * @param[in] len               The payload length in bytes.
+ *
+ * @return                      The record size as `uint64_t`.
+ */
+#define RECORDQUEUE_CALC_RECORD_SIZE(len) \
+    ((uint64_t)RECORDQUEUE_HEADER_SIZE    \
+     + (((uint64_t)(len) + RECORDQUEUE_ALIGNMENT - 1) & ~((uint64_t)RECORDQUEUE_ALIGNMENT - 1)))
+
+/**
+ * @def NAME
+ * @brief Prefix to record queue operations. This must be manually defined
+ *        before including this header file.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef NAME
+#define NAME recordqueue
+#error "Must define NAME."
+#else
+#define RECORDQUEUE_NAME NAME
+#endif
+
+/**
+ * @def QUEUE
+ * @brief The `NAME` of the byte queue defined with `fqueue_template.h`, with
+ *        a `VALUE_TYPE` of `unsigned char` (or another 1-byte type). This must
+ *        be manually defined before including this header file.
+ *
+ * The queue type and functions must be declared before including this header
+ * file.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef QUEUE
+#define QUEUE queue
+#error "Must define QUEUE."
+#endif
+
+/**
+ * @def SIZE_TYPE
+ * @brief The `SIZE_TYPE` of the byte queue.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef SIZE_TYPE
+#define SIZE_TYPE uint32_t
+#endif
+
+/**
+ * @def FUNCTION_LINKAGE
+ * @brief Specify function linkage e.g. static inline
+ */
+#ifndef FUNCTION_LINKAGE
+#define FUNCTION_LINKAGE
+#endif
+
+/// @cond DO_NOT_DOCUMENT
+#define RECORDQUEUE_QUEUE_TYPE     struct QUEUE
+#define RECORDQUEUE_SPAN_TYPE      struct JOIN(QUEUE, span)
+#define RECORDQUEUE_LOAD_LEN       JOIN(internal, JOIN(RECORDQUEUE_NAME, load_len))
+#define RECORDQUEUE_STORE_LEN      JOIN(internal, JOIN(RECORDQUEUE_NAME, store_len))
+#define RECORDQUEUE_WRITABLE_SPANS JOIN(QUEUE, writable_spans)
+#define RECORDQUEUE_READABLE_SPANS JOIN(QUEUE, readable_spans)
+/// @endcond
+
+// }}}
+
+// function declarations: {{{
+
+/**
+ * @brief Reserve room for a record at the back of the queue, and get its
+ *        payload to write in place. Is followed by `commit`.
+ *
+ * @note When the queue is empty, it starts over at the start of the ring, such
+ *       that any record of at most `capacity` bytes (see
+ *       `RECORDQUEUE_CALC_RECORD_SIZE`) fits.
+ *
+ * @param[in] queue_ptr         The byte queue pointer.
+ * @param[in] len               The maximum payload length in bytes.
+ *
+ * @return                      Pointer to the payload, or NULL if there is not
+ *                              enough room.
+ */
+FUNCTION_LINKAGE void *JOIN(RECORDQUEUE_NAME, reserve)(RECORDQUEUE_QUEUE_TYPE *queue_ptr, const uint32_t len);
+
+/**
+ * @brief Enqueue the record written into the payload returned by `reserve`.
+ *
+ * @param[in] queue_ptr         The byte queue pointer.
+ * @param[in] len               The payload length in bytes. At most the length
+ *                              reserved.
+ */
+FUNCTION_LINKAGE void JOIN(RECORDQUEUE_NAME, commit)(RECORDQUEUE_QUEUE_TYPE *queue_ptr, const uint32_t len);
+
+/**
+ * @brief Get the payload of the record at the front of the queue, to read in
+ *        place. Is followed by `release`.
+ *
+ * @note Dequeues the padding records in front of it.
+ *
+ * @param[in] queue_ptr         The byte queue pointer.
+ * @param[out] len_ptr          Set to the payload length in bytes.
+ *
+ * @return                      Pointer to the payload, or NULL if there are no
+ *                              records.
+ */
+FUNCTION_LINKAGE void *JOIN(RECORDQUEUE_NAME, peek)(RECORDQUEUE_QUEUE_TYPE *queue_ptr, uint32_t *len_ptr);
+
+/**
+ * @brief Dequeue the record returned by `peek`.
+ *
+ * @param[in] queue_ptr         The byte queue pointer.
+ */
+FUNCTION_LINKAGE void JOIN(RECORDQUEUE_NAME, release)(RECORDQUEUE_QUEUE_TYPE *queue_ptr);
+
+// }}}
+
+// function definitions: {{{
+
+/**
+ * @def FUNCTION_DEFINITIONS
+ * @brief Define the functions
+ */
+#ifdef FUNCTION_DEFINITIONS
+
+/// @cond DO_NOT_DOCUMENT
+static inline uint32_t JOIN(internal, JOIN(RECORDQUEUE_NAME, load_len))(const void *record_ptr)
+{
+    uint32_t len;
+    memcpy(&len, record_ptr, sizeof(len));
+    return len;
+}
+
+static inline void JOIN(internal, JOIN(RECORDQUEUE_NAME, store_len))(void *record_ptr, const uint32_t len)
+{
+    memcpy(record_ptr, &len, sizeof(len));
+}
+/// @endcond
+
+FUNCTION_LINKAGE void *JOIN(RECORDQUEUE_NAME, reserve)(RECORDQUEUE_QUEUE_TYPE *queue_ptr, const uint32_t len)
+{
+    assert(queue_ptr != NULL);
+    assert(sizeof(queue_ptr->values[0]) == 1);
+    assert(queue_ptr->capacity % RECORDQUEUE_ALIGNMENT == 0);
+    assert(len != RECORDQUEUE_PADDING);
+
+    const uint64_t record_size = RECORDQUEUE_CALC_RECORD_SIZE(len);
+    if (record_size > queue_ptr->capacity) {
+        return NULL;
+    }
+    if (queue_ptr->count == 0) {
+        queue_ptr->begin_index = queue_ptr->end_index = 0;
+    }
+
+    RECORDQUEUE_SPAN_TYPE spans[2];
+    RECORDQUEUE_WRITABLE_SPANS(queue_ptr, spans);
+
+    if (spans[0].count >= record_size) {
+        return (unsigned char *)spans[0].values + RECORDQUEUE_HEADER_SIZE;
+    }
+    if (spans[1].count < record_size) {
+        return NULL;
+    }
+
+    /* the free bytes wrap around the end of the ring: pad until the end, which is a multiple of the alignment away */
+    RECORDQUEUE_STORE_LEN(spans[0].values, RECORDQUEUE_PADDING);
+    JOIN(QUEUE, commit_write)(queue_ptr, spans[0].count);
+
+    return (unsigned char *)spans[1].values + RECORDQUEUE_HEADER_SIZE;
+}
+
+FUNCTION_LINKAGE void JOIN(RECORDQUEUE_NAME, commit)(RECORDQUEUE_QUEUE_TYPE *queue_ptr, const uint32_t len)
+{
+    assert(queue_ptr != NULL);
+    assert(len != RECORDQUEUE_PADDING);
+
+    const uint64_t record_size = RECORDQUEUE_CALC_RECORD_SIZE(len);
+
+    RECORDQUEUE_SPAN_TYPE spans[2];
+    RECORDQUEUE_WRITABLE_SPANS(queue_ptr, spans);
+
+    assert(spans[0].count >= record_size);
+
+    RECORDQUEUE_STORE_LEN(spans[0].values, len);
+    JOIN(QUEUE, commit_write)(queue_ptr, (SIZE_TYPE)record_size);
+}
+
+FUNCTION_LINKAGE void *JOIN(RECORDQUEUE_NAME, peek)(RECORDQUEUE_QUEUE_TYPE *queue_ptr, uint32_t *len_ptr)
+{
+    assert(queue_ptr != NULL);
+    assert(len_ptr != NULL);
+
+    RECORDQUEUE_SPAN_TYPE spans[2];
+
+    while (queue_ptr->count != 0) {
+        /* records do not wrap, so the front record is within the first span */
+        RECORDQUEUE_READABLE_SPANS(queue_ptr, spans);
+
+        const uint32_t len = RECORDQUEUE_LOAD_LEN(spans[0].values);
+        if (len != RECORDQUEUE_PADDING) {
+            assert(RECORDQUEUE_CALC_RECORD_SIZE(len) <= spans[0].count);
+
+            *len_ptr = len;
+            return (unsigned char *)spans[0].values + RECORDQUEUE_HEADER_SIZE;
+        }
+        JOIN(QUEUE, consume)(queue_ptr, spans[0].count);
+    }
+    return NULL;
+}
+
+FUNCTION_LINKAGE void JOIN(RECORDQUEUE_NAME, release)(RECORDQUEUE_QUEUE_TYPE *queue_ptr)
+{
+    assert(queue_ptr != NULL);
+    assert(queue_ptr->count != 0);
+
+    RECORDQUEUE_SPAN_TYPE spans[2];
+    RECORDQUEUE_READABLE_SPANS(queue_ptr, spans);
+
+    const uint32_t len = RECORDQUEUE_LOAD_LEN(spans[0].values);
+    assert(len != RECORDQUEUE_PADDING);
+
+    JOIN(QUEUE, consume)(queue_ptr, (SIZE_TYPE)RECORDQUEUE_CALC_RECORD_SIZE(len));
+}
+
+#endif
+
+// }}}
+
+// macro undefs: {{{
+
+#undef NAME
+#undef QUEUE
+#undef SIZE_TYPE
+#undef FUNCTION_LINKAGE
+#undef FUNCTION_DEFINITIONS
+#undef TYPE_DEFINITIONS
+
+#undef RECORDQUEUE_NAME
+#undef RECORDQUEUE_QUEUE_TYPE
+#undef RECORDQUEUE_SPAN_TYPE
+#undef RECORDQUEUE_LOAD_LEN
+#undef RECORDQUEUE_STORE_LEN
+#undef RECORDQUEUE_WRITABLE_SPANS
+#undef RECORDQUEUE_READABLE_SPANS
+
+// }}}
+
+#ifdef __cplusplus
+}
+#endif
+
+// vim: ft=c fdm=marker
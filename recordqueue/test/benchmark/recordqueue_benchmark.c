@@ -0,0 +1,137 @@
+// Compares passing variable-length messages through a record queue against
+// allocating each message with malloc() and passing pointers to it through a
+// queue. Messages of 16 to 256 bytes are produced in bursts, and then consumed.
+// Run with `make bench`.
+//
+// usage: ./a.out [number of messages in millions]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define NAME       byte_queue
+#define VALUE_TYPE unsigned char
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fqueue_template.h"
+
+#define NAME  records
+#define QUEUE byte_queue
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "recordqueue_template.h"
+
+struct message {
+    uint32_t len;
+    unsigned char payload[];
+};
+typedef struct message *message_ptr;
+
+#define NAME       ptr_queue
+#define VALUE_TYPE message_ptr
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fqueue_template.h"
+
+#define BURST_SIZE      (256)
+#define MIN_MESSAGE_LEN (16)
+#define MAX_MESSAGE_LEN (256)
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint32_t message_len(const uint64_t i)
+{
+    return (uint32_t)(i * 2654435761U % (MAX_MESSAGE_LEN - MIN_MESSAGE_LEN + 1)) + MIN_MESSAGE_LEN;
+}
+
+static uint64_t consume(const unsigned char *payload, const uint32_t len)
+{
+    return (uint64_t)payload[0] + payload[len - 1] + len;
+}
+
+static double run_records(struct byte_queue *q, const uint64_t message_count, uint64_t *sum_ptr)
+{
+    const double start = now_s();
+
+    for (uint64_t i = 0; i < message_count; i += BURST_SIZE) {
+        for (uint64_t j = i; j < i + BURST_SIZE; j++) {
+            const uint32_t len = message_len(j);
+            unsigned char *payload = records_reserve(q, len);
+            memset(payload, (int)j, len);
+            records_commit(q, len);
+        }
+        uint32_t len;
+        const unsigned char *payload;
+        while ((payload = records_peek(q, &len)) != NULL) {
+            *sum_ptr += consume(payload, len);
+            records_release(q);
+        }
+    }
+
+    return now_s() - start;
+}
+
+static double run_malloc(struct ptr_queue *q, const uint64_t message_count, uint64_t *sum_ptr)
+{
+    const double start = now_s();
+
+    for (uint64_t i = 0; i < message_count; i += BURST_SIZE) {
+        for (uint64_t j = i; j < i + BURST_SIZE; j++) {
+            const uint32_t len = message_len(j);
+            struct message *msg = malloc(sizeof(struct message) + len);
+            msg->len = len;
+            memset(msg->payload, (int)j, len);
+            ptr_queue_enqueue(q, msg);
+        }
+        while (!ptr_queue_is_empty(q)) {
+            struct message *msg = ptr_queue_dequeue(q);
+            *sum_ptr += consume(msg->payload, msg->len);
+            free(msg);
+        }
+    }
+
+    return now_s() - start;
+}
+
+int main(int argc, char **argv)
+{
+    const uint64_t message_count =
+        (argc > 1 ? strtoull(argv[1], NULL, 10) : 16) * 1000000 / BURST_SIZE * BURST_SIZE;
+
+    struct byte_queue *bytes = byte_queue_create((uint32_t)RECORDQUEUE_CALC_RECORD_SIZE(MAX_MESSAGE_LEN) * BURST_SIZE);
+    struct ptr_queue *ptrs = ptr_queue_create(BURST_SIZE);
+
+    if (!bytes || !ptrs) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+
+    uint64_t records_sum = 0, malloc_sum = 0;
+    const double records_elapsed = run_records(bytes, message_count, &records_sum);
+    const double malloc_elapsed = run_malloc(ptrs, message_count, &malloc_sum);
+
+    if (records_sum != malloc_sum) {
+        fprintf(stderr, "checksum mismatch\n");
+        return 1;
+    }
+
+    printf("%llu messages of %d to %d bytes, in bursts of %d\n", (unsigned long long)message_count, MIN_MESSAGE_LEN,
+           MAX_MESSAGE_LEN, BURST_SIZE);
+    printf("record queue:       %7.2f Mmsg/s\n", (double)message_count / records_elapsed * 1e-6);
+    printf("malloc + pointers:  %7.2f Mmsg/s\n", (double)message_count / malloc_elapsed * 1e-6);
+    printf("(checksum %llu)\n", (unsigned long long)records_sum);
+
+    ptr_queue_destroy(ptrs);
+    byte_queue_destroy(bytes);
+
+    return 0;
+}
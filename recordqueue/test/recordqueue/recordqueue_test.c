@@ -0,0 +1,203 @@
+/*
+    Test cases:
+    - Record size:
+      - The header and padded payload are counted
+    - Single record:
+      - peek returns NULL when empty
+      - reserve returns NULL when the record is larger than the capacity
+      - A record can be committed shorter than reserved
+      - The payload is aligned, and read back in place
+    - Wrap-around:
+      - A record not fitting before the end of the ring is placed at the start,
+        after a padding record which peek skips
+      - reserve returns NULL when the free bytes are too fragmented
+      - An empty queue starts over at the start of the ring
+    - Random:
+      - Records of random length are received in order, with their contents
+*/
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NAME       byte_queue
+#define VALUE_TYPE unsigned char
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fqueue_template.h"
+
+#define NAME  records
+#define QUEUE byte_queue
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "recordqueue_template.h"
+
+#define RANDOM_RECORD_COUNT (100000)
+#define MAX_RANDOM_LEN      (300)
+
+static void push(struct byte_queue *q, const uint32_t len, const unsigned char fill)
+{
+    unsigned char *payload = records_reserve(q, len);
+    assert(payload != NULL);
+    memset(payload, fill, len);
+    records_commit(q, len);
+}
+
+static void pop(struct byte_queue *q, const uint32_t expected_len, const unsigned char expected_fill)
+{
+    uint32_t len = 0;
+    const unsigned char *payload = records_peek(q, &len);
+    assert(payload != NULL);
+    assert(len == expected_len);
+    for (uint32_t i = 0; i < len; i++) {
+        assert(payload[i] == expected_fill);
+    }
+    records_release(q);
+}
+
+static void record_size_test(void)
+{
+    assert(RECORDQUEUE_CALC_RECORD_SIZE(0) == RECORDQUEUE_HEADER_SIZE);
+    assert(RECORDQUEUE_CALC_RECORD_SIZE(1) == RECORDQUEUE_HEADER_SIZE + RECORDQUEUE_ALIGNMENT);
+    assert(RECORDQUEUE_CALC_RECORD_SIZE(RECORDQUEUE_ALIGNMENT) == RECORDQUEUE_HEADER_SIZE + RECORDQUEUE_ALIGNMENT);
+    assert(RECORDQUEUE_CALC_RECORD_SIZE(UINT32_MAX - 1) > UINT32_MAX);
+}
+
+static void single_record_test(void)
+{
+    struct byte_queue *q = byte_queue_create(64);
+    assert(q != NULL);
+
+    uint32_t len = 0;
+    assert(records_peek(q, &len) == NULL);
+    assert(records_reserve(q, 64) == NULL);
+    assert(records_reserve(q, UINT32_MAX - 1) == NULL);
+
+    unsigned char *payload = records_reserve(q, 64 - RECORDQUEUE_HEADER_SIZE);
+    assert(payload == &q->values[RECORDQUEUE_HEADER_SIZE]);
+    assert((uintptr_t)payload % RECORDQUEUE_ALIGNMENT == 0);
+    memcpy(payload, "hello", 5);
+    records_commit(q, 5);
+    assert(q->count == RECORDQUEUE_CALC_RECORD_SIZE(5));
+
+    const unsigned char *read = records_peek(q, &len);
+    assert(read == payload && len == 5);
+    assert(memcmp(read, "hello", 5) == 0);
+    assert(records_peek(q, &len) == read); // peek does not dequeue
+    records_release(q);
+    assert(byte_queue_is_empty(q));
+    assert(records_peek(q, &len) == NULL);
+
+    /* empty payloads are records as well */
+    push(q, 0, 0);
+    pop(q, 0, 0);
+
+    byte_queue_destroy(q);
+}
+
+static void wrap_around_test(void)
+{
+    struct byte_queue *q = byte_queue_create(64);
+    assert(q != NULL);
+
+    /* 3 records of 16 bytes, then dequeue the first: 16 bytes free at the start, 16 at the end */
+    push(q, 8, 'a');
+    push(q, 8, 'b');
+    push(q, 8, 'c');
+    pop(q, 8, 'a');
+    assert(q->end_index == 48 && q->count == 32);
+
+    /* a 24 byte record does not fit at either side */
+    assert(records_reserve(q, 16) == NULL);
+    assert(q->count == 32);
+
+    /* a 16 byte record fits at the end, another one at the start */
+    push(q, 8, 'd');
+    assert(q->end_index == 0);
+    push(q, 1, 'e');
+    assert(byte_queue_is_full(q));
+    assert(records_reserve(q, 0) == NULL);
+
+    pop(q, 8, 'b');
+    pop(q, 8, 'c');
+    pop(q, 8, 'd');
+    pop(q, 1, 'e');
+    assert(byte_queue_is_empty(q));
+
+    /* 8 bytes left at the end: a 16 byte record is placed at the start, after a padding record */
+    push(q, 8, 'f');
+    push(q, 24, 'g');
+    push(q, 0, 'h');
+    pop(q, 8, 'f');
+    assert(q->end_index == 56);
+    unsigned char *payload = records_reserve(q, 8);
+    assert(payload == &q->values[RECORDQUEUE_HEADER_SIZE]);
+    memset(payload, 'i', 8);
+    records_commit(q, 8);
+    assert(q->end_index == 16 && byte_queue_is_full(q));
+
+    pop(q, 24, 'g');
+    pop(q, 0, 'h');
+    assert(q->begin_index == 56);
+    pop(q, 8, 'i'); // skips the padding record
+    assert(byte_queue_is_empty(q));
+
+    /* empty: starts over at the start, such that a record of the full capacity fits */
+    assert(q->begin_index == 16);
+    push(q, 64 - RECORDQUEUE_HEADER_SIZE, 'j');
+    assert(q->begin_index == 0 && byte_queue_is_full(q));
+    pop(q, 64 - RECORDQUEUE_HEADER_SIZE, 'j');
+
+    byte_queue_destroy(q);
+}
+
+static void random_test(void)
+{
+    struct byte_queue *q = byte_queue_create(4096);
+    assert(q != NULL);
+
+    srand(42);
+    uint32_t pushed = 0, popped = 0;
+    while (popped < RANDOM_RECORD_COUNT) {
+        if (pushed < RANDOM_RECORD_COUNT && rand() % 2 == 0) {
+            const uint32_t len = (uint32_t)rand() % MAX_RANDOM_LEN;
+            unsigned char *payload = records_reserve(q, len);
+            if (payload == NULL) {
+                continue;
+            }
+            for (uint32_t i = 0; i < len; i++) {
+                payload[i] = (unsigned char)(pushed + i);
+            }
+            records_commit(q, len);
+            pushed++;
+        }
+        else {
+            uint32_t len;
+            const unsigned char *payload = records_peek(q, &len);
+            if (payload == NULL) {
+                assert(popped == pushed);
+                continue;
+            }
+            assert((uintptr_t)(payload - q->values) % RECORDQUEUE_ALIGNMENT == 0);
+            for (uint32_t i = 0; i < len; i++) {
+                assert(payload[i] == (unsigned char)(popped + i));
+            }
+            records_release(q);
+            popped++;
+        }
+    }
+    assert(byte_queue_is_empty(q));
+
+    byte_queue_destroy(q);
+}
+
+int main(void)
+{
+    record_size_test();
+    single_record_test();
+    wrap_around_test();
+    random_test();
+}
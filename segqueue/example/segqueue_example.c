@@ -0,0 +1,45 @@
+#include <assert.h>
+#include <stdbool.h>
+
+#define NAME           int_queue
+#define VALUE_TYPE     int
+#define CHUNK_CAPACITY 64
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "segqueue_template.h"
+
+int main(void)
+{
+    // keep up to 4 unlinked chunks around for the next burst:
+    struct int_queue *q = int_queue_create(4);
+    if (!q) {
+        assert(false);
+        return 1;
+    }
+
+    // a burst: no values are moved while the queue grows
+    for (int i = 0; i < 1000; i++) {
+        if (!int_queue_enqueue(q, i)) {
+            assert(false);
+        }
+    }
+    assert(q->count == 1000);
+    assert(q->chunk_count == 16); // 1000 values in chunks of 64
+
+    assert(int_queue_get_front(q) == 0);
+    assert(int_queue_get_back(q) == 999);
+
+    while (!int_queue_is_empty(q)) {
+        int_queue_dequeue(q);
+    }
+
+    // the last chunk stays linked, 4 chunks are kept, and the others are freed:
+    assert(q->chunk_count == 1);
+    assert(q->free_chunk_count == 4);
+
+    int_queue_shrink(q); // free the kept chunks as well
+    assert(q->free_chunk_count == 0);
+
+    int_queue_destroy(q);
+}
@@ -0,0 +1,555 @@
+/*  segqueue_template.h
+ *
+ *  Copyright (C) 2025 abxh
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *  See the file LICENSE included with this distribution for more
+ *  information. */
+
+/**
+ * @file segqueue_template.h
+ * @brief Unbounded queue based on a linked list of fixed-size chunks
+ *
+ * The values are stored in chunks of `CHUNK_CAPACITY` values each, linked
+ * from the front to the back of the queue:
+ *      @li Enqueuing to a full back chunk links a new chunk after it. The
+ *          values already in the queue are never moved, such that the
+ *          worst-case cost of an enqueue is a single allocation, unlike
+ *          growing a contiguous ring (see `deque_template.h`).
+ *      @li Dequeuing the last value of the front chunk unlinks it.
+ *
+ * Unlinked chunks are kept in a free list for reuse, up to a given number of
+ * chunks. The chunks beyond it are freed, such that the memory taken by a
+ * burst is returned after the burst.
+ */
+
+/**
+ * @example segqueue_example.c
+ * Example of how `segqueue_template.h` header file is used in practice.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// macro definitions: {{{
+
+/**
+ * @def PASTE(a,b)
+ * @brief Paste two tokens together.
+ */
+#ifndef PASTE
+#define PASTE(a, b) a##b
+#endif
+
+/**
+ * @def XPASTE(a,b)
+ * @brief First expand tokens, then paste them together.
+ */
+#ifndef XPASTE
+#define XPASTE(a, b) PASTE(a, b)
+#endif
+
+/**
+ * @def JOIN(a,b)
+ * @brief First expand tokens, then paste them together with a _ in between.
+ */
+#ifndef JOIN
+#define JOIN(a, b) XPASTE(a, XPASTE(_, b))
+#endif
+
+/**
+ * @def SEGQUEUE_CALC_CHUNK_SIZEOF(segqueue_name)
+ *
+ * @brief Calculate the size of a chunk struct.
+ *
+ * @param[in] segqueue_name     Defined queue NAME.
+ *
+ * @return                      The equivalent size.
+ */
+#ifndef SEGQUEUE_CALC_CHUNK_SIZEOF
+#define SEGQUEUE_CALC_CHUNK_SIZEOF(segqueue_name)        \
+    (offsetof(struct JOIN(segqueue_name, chunk), values) \
+     + sizeof(((struct JOIN(segqueue_name, chunk) *)0)->values[0]) * JOIN(segqueue_name, chunk_capacity))
+#endif
+
+/**
+ * @def NAME
+ * @brief Prefix to queue type and operations. This must be manually defined
+ *        before including this header file.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef NAME
+#define NAME segqueue
+#error "Must define NAME."
+#else
+#define SEGQUEUE_NAME NAME
+#endif
+
+/**
+ * @def VALUE_TYPE
+ * @brief Queue value type. This must be manually defined before including this
+ *        header file.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef VALUE_TYPE
+#define VALUE_TYPE int
+#define FUNCTION_DEFINITIONS
+#define TYPE_DEFINITIONS
+#error "Must define VALUE_TYPE."
+#endif
+
+/**
+ * @def SIZE_TYPE
+ * @brief Queue count and index type. Defaults to `uint32_t`.
+ *
+ * Define as `uint64_t` (or `size_t`) for queues of more than `UINT32_MAX`
+ * values. Must be an unsigned integer type.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef SIZE_TYPE
+#define SIZE_TYPE uint32_t
+#endif
+
+/**
+ * @def CHUNK_CAPACITY
+ * @brief Number of values per chunk. Defaults to 256.
+ *
+ * Larger chunks take fewer allocations and less link overhead, but more
+ * memory is held by a nearly empty queue.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef CHUNK_CAPACITY
+#define CHUNK_CAPACITY 256
+#endif
+
+/**
+ * @def ALLOCATOR(ctx, size)
+ * @brief Used to allocate the memory of the queue struct and its chunks.
+ *        Defaults to malloc().
+ *
+ * Is undefined once header is included.
+ *
+ * @note The memory need not be zeroed.
+ *
+ * @param ctx The context pointer given to `create_with_context` (or NULL).
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the memory, or NULL if the allocation fails.
+ */
+#if defined(ALLOCATOR) != defined(DEALLOCATOR)
+#error "Must define both ALLOCATOR and DEALLOCATOR."
+#endif
+#ifndef ALLOCATOR
+#define ALLOCATOR(ctx, size) ((void)(ctx), malloc(size))
+#endif
+
+/**
+ * @def DEALLOCATOR(ctx, ptr, size)
+ * @brief Used to free the memory of the queue struct and its chunks. Defaults
+ *        to free().
+ *
+ * Is undefined once header is included.
+ *
+ * @param ctx The context pointer given to `create_with_context` (or NULL).
+ * @param ptr The pointer returned by `ALLOCATOR`.
+ * @param size The number of bytes allocated.
+ */
+#ifndef DEALLOCATOR
+#define DEALLOCATOR(ctx, ptr, size) ((void)(ctx), (void)(size), free(ptr))
+#endif
+
+/**
+ * @def FUNCTION_LINKAGE
+ * @brief Specify function linkage e.g. static inline
+ */
+#ifndef FUNCTION_LINKAGE
+#define FUNCTION_LINKAGE
+#endif
+
+/// @cond DO_NOT_DOCUMENT
+#define SEGQUEUE_TYPE          struct SEGQUEUE_NAME
+#define SEGQUEUE_SIZE_MAX      ((SIZE_TYPE)-1)
+#define SEGQUEUE_CHUNK_TYPE    struct JOIN(SEGQUEUE_NAME, chunk)
+#define SEGQUEUE_CHUNK_SIZEOF  SEGQUEUE_CALC_CHUNK_SIZEOF(SEGQUEUE_NAME)
+#define SEGQUEUE_IS_EMPTY      JOIN(SEGQUEUE_NAME, is_empty)
+#define SEGQUEUE_ACQUIRE_CHUNK JOIN(internal, JOIN(SEGQUEUE_NAME, acquire_chunk))
+#define SEGQUEUE_RELEASE_CHUNK JOIN(internal, JOIN(SEGQUEUE_NAME, release_chunk))
+/// @endcond
+
+// }}}
+
+// type definitions: {{{
+
+/**
+ * @def TYPE_DEFINITIONS
+ * @brief Define the types
+ */
+#ifdef TYPE_DEFINITIONS
+
+/**
+ * @brief Number of values per chunk. See `CHUNK_CAPACITY`.
+ */
+enum { JOIN(SEGQUEUE_NAME, chunk_capacity) = CHUNK_CAPACITY };
+
+/**
+ * @brief Generated chunk struct type for a `VALUE_TYPE`.
+ */
+struct JOIN(SEGQUEUE_NAME, chunk) {
+    SEGQUEUE_CHUNK_TYPE *next; ///< Next chunk towards the back, or in the free list.
+    SIZE_TYPE begin_index;     ///< Index of the first value in the chunk.
+    SIZE_TYPE end_index;       ///< Index after the last value in the chunk.
+    VALUE_TYPE values[];       ///< Array of `CHUNK_CAPACITY` values.
+};
+
+/**
+ * @brief Generated queue struct type for a `VALUE_TYPE`.
+ */
+struct SEGQUEUE_NAME {
+    SEGQUEUE_CHUNK_TYPE *front_chunk; ///< Chunk holding the front value, or NULL if there are no chunks.
+    SEGQUEUE_CHUNK_TYPE *back_chunk;  ///< Chunk holding the back value, or NULL if there are no chunks.
+    SEGQUEUE_CHUNK_TYPE *free_chunks; ///< Free list of unlinked chunks.
+    SIZE_TYPE count;                  ///< Number of values.
+    SIZE_TYPE chunk_count;            ///< Number of chunks linked.
+    SIZE_TYPE free_chunk_count;       ///< Number of chunks in the free list.
+    SIZE_TYPE max_free_chunk_count;   ///< Maximum number of chunks kept in the free list.
+    void *ctx;                        ///< Context pointer passed to `ALLOCATOR` and `DEALLOCATOR`.
+};
+
+#endif
+
+// }}}
+
+// function declarations: {{{
+
+/**
+ * @brief Create an empty queue struct with `ALLOCATOR`.
+ *
+ * @param[in] max_free_chunk_count  Maximum number of unlinked chunks kept for
+ *                                  reuse. The chunk holding the values of a
+ *                                  (nearly) empty queue is not counted.
+ *
+ * @return                      A pointer to the queue, or NULL if the
+ *                              allocation fails.
+ */
+FUNCTION_LINKAGE SEGQUEUE_TYPE *JOIN(SEGQUEUE_NAME, create)(const SIZE_TYPE max_free_chunk_count);
+
+/**
+ * @brief Create an empty queue struct with `ALLOCATOR`, given a context
+ *        pointer. The context pointer is passed to `ALLOCATOR` and
+ *        `DEALLOCATOR` whenever the queue allocates or frees memory.
+ *
+ * @param[in] max_free_chunk_count  See `create`.
+ * @param[in] ctx                   The context pointer.
+ *
+ * @return                      A pointer to the queue, or NULL. See `create`.
+ */
+FUNCTION_LINKAGE SEGQUEUE_TYPE *JOIN(SEGQUEUE_NAME, create_with_context)(const SIZE_TYPE max_free_chunk_count,
+                                                                        void *ctx);
+
+/**
+ * @brief Destroy a queue struct and all its chunks with `DEALLOCATOR`.
+ *
+ * @param[in] self              The queue pointer.
+ */
+FUNCTION_LINKAGE void JOIN(SEGQUEUE_NAME, destroy)(SEGQUEUE_TYPE *self);
+
+/**
+ * @brief Return whether the queue is empty.
+ *
+ * @param[in] self              The queue pointer.
+ *
+ * @return                      Whether the queue is empty.
+ */
+FUNCTION_LINKAGE bool JOIN(SEGQUEUE_NAME, is_empty)(const SEGQUEUE_TYPE *self);
+
+/**
+ * @brief Get the value from the front of a non-empty queue.
+ *
+ * @param[in] self              The queue pointer.
+ *
+ * @return                      The front value.
+ */
+FUNCTION_LINKAGE VALUE_TYPE JOIN(SEGQUEUE_NAME, get_front)(const SEGQUEUE_TYPE *self);
+
+/**
+ * @brief Get the value from the back of a non-empty queue.
+ *
+ * @param[in] self              The queue pointer.
+ *
+ * @return                      The back value.
+ */
+FUNCTION_LINKAGE VALUE_TYPE JOIN(SEGQUEUE_NAME, get_back)(const SEGQUEUE_TYPE *self);
+
+/**
+ * @brief Enqueue a value, linking a chunk (from the free list if possible)
+ *        when the back chunk is full.
+ *
+ * @param[in] self              The queue pointer.
+ * @param[in] value             The value.
+ *
+ * @return                      Whether the value was enqueued. False if the
+ *                              count would overflow `SIZE_TYPE`, or if a chunk
+ *                              was needed and the allocation failed.
+ */
+FUNCTION_LINKAGE bool JOIN(SEGQUEUE_NAME, enqueue)(SEGQUEUE_TYPE *self, const VALUE_TYPE value);
+
+/**
+ * @brief Dequeue a value from a non-empty queue, unlinking the front chunk
+ *        when it is emptied.
+ *
+ * @param[in] self              The queue pointer.
+ *
+ * @return                      The front value.
+ */
+FUNCTION_LINKAGE VALUE_TYPE JOIN(SEGQUEUE_NAME, dequeue)(SEGQUEUE_TYPE *self);
+
+/**
+ * @brief Clear the values in the queue, unlinking all chunks.
+ *
+ * @param[in] self              The queue pointer.
+ */
+FUNCTION_LINKAGE void JOIN(SEGQUEUE_NAME, clear)(SEGQUEUE_TYPE *self);
+
+/**
+ * @brief Free the chunks in the free list.
+ *
+ * @param[in] self              The queue pointer.
+ */
+FUNCTION_LINKAGE void JOIN(SEGQUEUE_NAME, shrink)(SEGQUEUE_TYPE *self);
+
+// }}}
+
+// function definitions: {{{
+
+/**
+ * @def FUNCTION_DEFINITIONS
+ * @brief Define the functions
+ */
+#ifdef FUNCTION_DEFINITIONS
+
+/// @cond DO_NOT_DOCUMENT
+static inline SEGQUEUE_CHUNK_TYPE *JOIN(internal, JOIN(SEGQUEUE_NAME, acquire_chunk))(SEGQUEUE_TYPE *self)
+{
+    SEGQUEUE_CHUNK_TYPE *chunk = self->free_chunks;
+
+    if (chunk) {
+        self->free_chunks = chunk->next;
+        self->free_chunk_count--;
+    }
+    else {
+        chunk = (SEGQUEUE_CHUNK_TYPE *)ALLOCATOR(self->ctx, SEGQUEUE_CHUNK_SIZEOF);
+        if (!chunk) {
+            return NULL;
+        }
+    }
+
+    chunk->next = NULL;
+    chunk->begin_index = chunk->end_index = 0;
+
+    return chunk;
+}
+
+static inline void JOIN(internal, JOIN(SEGQUEUE_NAME, release_chunk))(SEGQUEUE_TYPE *self, SEGQUEUE_CHUNK_TYPE *chunk)
+{
+    if (self->free_chunk_count < self->max_free_chunk_count) {
+        chunk->next = self->free_chunks;
+        self->free_chunks = chunk;
+        self->free_chunk_count++;
+    }
+    else {
+        DEALLOCATOR(self->ctx, chunk, SEGQUEUE_CHUNK_SIZEOF);
+    }
+}
+/// @endcond
+
+FUNCTION_LINKAGE SEGQUEUE_TYPE *JOIN(SEGQUEUE_NAME, create)(const SIZE_TYPE max_free_chunk_count)
+{
+    return JOIN(SEGQUEUE_NAME, create_with_context)(max_free_chunk_count, NULL);
+}
+
+FUNCTION_LINKAGE SEGQUEUE_TYPE *JOIN(SEGQUEUE_NAME, create_with_context)(const SIZE_TYPE max_free_chunk_count,
+                                                                        void *ctx)
+{
+    SEGQUEUE_TYPE *self = (SEGQUEUE_TYPE *)ALLOCATOR(ctx, sizeof(SEGQUEUE_TYPE));
+
+    if (!self) {
+        return NULL;
+    }
+
+    self->front_chunk = self->back_chunk = self->free_chunks = NULL;
+    self->count = 0;
+    self->chunk_count = 0;
+    self->free_chunk_count = 0;
+    self->max_free_chunk_count = max_free_chunk_count;
+    self->ctx = ctx;
+
+    return self;
+}
+
+FUNCTION_LINKAGE void JOIN(SEGQUEUE_NAME, destroy)(SEGQUEUE_TYPE *self)
+{
+    assert(self != NULL);
+
+    JOIN(SEGQUEUE_NAME, clear)(self);
+    JOIN(SEGQUEUE_NAME, shrink)(self);
+
+    DEALLOCATOR(self->ctx, self, sizeof(SEGQUEUE_TYPE));
+}
+
+FUNCTION_LINKAGE bool JOIN(SEGQUEUE_NAME, is_empty)(const SEGQUEUE_TYPE *self)
+{
+    assert(self != NULL);
+
+    return self->count == 0;
+}
+
+FUNCTION_LINKAGE VALUE_TYPE JOIN(SEGQUEUE_NAME, get_front)(const SEGQUEUE_TYPE *self)
+{
+    assert(self != NULL);
+    assert(!SEGQUEUE_IS_EMPTY(self));
+
+    return self->front_chunk->values[self->front_chunk->begin_index];
+}
+
+FUNCTION_LINKAGE VALUE_TYPE JOIN(SEGQUEUE_NAME, get_back)(const SEGQUEUE_TYPE *self)
+{
+    assert(self != NULL);
+    assert(!SEGQUEUE_IS_EMPTY(self));
+
+    return self->back_chunk->values[self->back_chunk->end_index - 1];
+}
+
+FUNCTION_LINKAGE bool JOIN(SEGQUEUE_NAME, enqueue)(SEGQUEUE_TYPE *self, const VALUE_TYPE value)
+{
+    assert(self != NULL);
+
+    if (self->count == SEGQUEUE_SIZE_MAX) {
+        return false;
+    }
+
+    SEGQUEUE_CHUNK_TYPE *back_chunk = self->back_chunk;
+
+    if (!back_chunk || back_chunk->end_index == CHUNK_CAPACITY) {
+        SEGQUEUE_CHUNK_TYPE *chunk = SEGQUEUE_ACQUIRE_CHUNK(self);
+        if (!chunk) {
+            return false;
+        }
+        if (back_chunk) {
+            back_chunk->next = chunk;
+        }
+        else {
+            self->front_chunk = chunk;
+        }
+        self->back_chunk = back_chunk = chunk;
+        self->chunk_count++;
+    }
+
+    back_chunk->values[back_chunk->end_index++] = value;
+    self->count++;
+
+    return true;
+}
+
+FUNCTION_LINKAGE VALUE_TYPE JOIN(SEGQUEUE_NAME, dequeue)(SEGQUEUE_TYPE *self)
+{
+    assert(self != NULL);
+    assert(!SEGQUEUE_IS_EMPTY(self));
+
+    SEGQUEUE_CHUNK_TYPE *front_chunk = self->front_chunk;
+
+    const VALUE_TYPE value = front_chunk->values[front_chunk->begin_index++];
+    self->count--;
+
+    if (front_chunk->begin_index == front_chunk->end_index) {
+        if (front_chunk == self->back_chunk) {
+            /* keep the last chunk linked, such that alternating enqueue and dequeue does not relink chunks */
+            front_chunk->begin_index = front_chunk->end_index = 0;
+        }
+        else {
+            self->front_chunk = front_chunk->next;
+            self->chunk_count--;
+            SEGQUEUE_RELEASE_CHUNK(self, front_chunk);
+        }
+    }
+
+    return value;
+}
+
+FUNCTION_LINKAGE void JOIN(SEGQUEUE_NAME, clear)(SEGQUEUE_TYPE *self)
+{
+    assert(self != NULL);
+
+    SEGQUEUE_CHUNK_TYPE *chunk = self->front_chunk;
+
+    while (chunk) {
+        SEGQUEUE_CHUNK_TYPE *next_chunk = chunk->next;
+        SEGQUEUE_RELEASE_CHUNK(self, chunk);
+        chunk = next_chunk;
+    }
+
+    self->front_chunk = self->back_chunk = NULL;
+    self->count = 0;
+    self->chunk_count = 0;
+}
+
+FUNCTION_LINKAGE void JOIN(SEGQUEUE_NAME, shrink)(SEGQUEUE_TYPE *self)
+{
+    assert(self != NULL);
+
+    SEGQUEUE_CHUNK_TYPE *chunk = self->free_chunks;
+
+    while (chunk) {
+        SEGQUEUE_CHUNK_TYPE *next_chunk = chunk->next;
+        DEALLOCATOR(self->ctx, chunk, SEGQUEUE_CHUNK_SIZEOF);
+        chunk = next_chunk;
+    }
+
+    self->free_chunks = NULL;
+    self->free_chunk_count = 0;
+}
+
+#endif
+
+// }}}
+
+// macro undefs: {{{
+
+#undef NAME
+#undef VALUE_TYPE
+#undef SIZE_TYPE
+#undef CHUNK_CAPACITY
+#undef ALLOCATOR
+#undef DEALLOCATOR
+#undef FUNCTION_LINKAGE
+#undef FUNCTION_DEFINITIONS
+#undef TYPE_DEFINITIONS
+
+#undef SEGQUEUE_NAME
+#undef SEGQUEUE_TYPE
+#undef SEGQUEUE_SIZE_MAX
+#undef SEGQUEUE_CHUNK_TYPE
+#undef SEGQUEUE_CHUNK_SIZEOF
+#undef SEGQUEUE_IS_EMPTY
+#undef SEGQUEUE_ACQUIRE_CHUNK
+#undef SEGQUEUE_RELEASE_CHUNK
+
+// }}}
+
+#ifdef __cplusplus
+}
+#endif
+
+// vim: ft=c fdm=marker
@@ -0,0 +1,142 @@
+// Compares the segmented queue with the growable deque (pushing to the back
+// and popping from the front) under bursts: each round enqueues a burst of
+// values into an (almost) empty queue, then dequeues them all. Reports the
+// throughput, the worst latency of a single enqueue (growing the deque copies
+// every value), and the memory held after the bursts. Run with `make bench`.
+//
+// usage: ./a.out [largest burst size in millions]
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define NAME           u64_segq
+#define VALUE_TYPE     uint64_t
+#define CHUNK_CAPACITY 1024
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "segqueue_template.h"
+
+#define NAME       u64_deque
+#define VALUE_TYPE uint64_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "deque_template.h"
+
+#define MAX_FREE_CHUNK_COUNT (16)
+#define ROUND_COUNT          (4)
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+struct result {
+    double elapsed;
+    double max_enqueue_latency;
+    size_t held_size;
+    uint64_t sum;
+};
+
+/* without timing each enqueue, the elapsed time is measured. with it, the worst latency */
+static struct result run_segq(const uint64_t burst_size, const bool time_enqueues)
+{
+    struct result res = {0.0, 0.0, 0, 0};
+    struct u64_segq *q = u64_segq_create(MAX_FREE_CHUNK_COUNT);
+    if (!q) {
+        exit(1);
+    }
+
+    const double start = now_s();
+    for (uint32_t round = 0; round < ROUND_COUNT; round++) {
+        for (uint64_t i = 0; i < burst_size; i++) {
+            const double before = time_enqueues ? now_s() : 0.0;
+            if (!u64_segq_enqueue(q, i)) {
+                exit(1);
+            }
+            if (time_enqueues) {
+                const double latency = now_s() - before;
+                res.max_enqueue_latency = latency > res.max_enqueue_latency ? latency : res.max_enqueue_latency;
+            }
+        }
+        while (!u64_segq_is_empty(q)) {
+            res.sum += u64_segq_dequeue(q);
+        }
+    }
+    res.elapsed = now_s() - start;
+    res.held_size = (size_t)(q->chunk_count + q->free_chunk_count) * SEGQUEUE_CALC_CHUNK_SIZEOF(u64_segq);
+
+    u64_segq_destroy(q);
+    return res;
+}
+
+static struct result run_deque(const uint64_t burst_size, const bool time_enqueues)
+{
+    struct result res = {0.0, 0.0, 0, 0};
+    struct u64_deque *q = u64_deque_create(u64_segq_chunk_capacity);
+    if (!q) {
+        exit(1);
+    }
+
+    const double start = now_s();
+    for (uint32_t round = 0; round < ROUND_COUNT; round++) {
+        for (uint64_t i = 0; i < burst_size; i++) {
+            const double before = time_enqueues ? now_s() : 0.0;
+            if (!u64_deque_push_back(q, i)) {
+                exit(1);
+            }
+            if (time_enqueues) {
+                const double latency = now_s() - before;
+                res.max_enqueue_latency = latency > res.max_enqueue_latency ? latency : res.max_enqueue_latency;
+            }
+        }
+        while (!u64_deque_is_empty(q)) {
+            res.sum += u64_deque_pop_front(q);
+        }
+    }
+    res.elapsed = now_s() - start;
+    res.held_size = (size_t)q->capacity * sizeof(uint64_t);
+
+    u64_deque_destroy(q);
+    return res;
+}
+
+int main(int argc, char **argv)
+{
+    const uint64_t max_burst_size = (argc > 1 ? strtoull(argv[1], NULL, 10) : 8) * 1000000;
+
+    printf("%d rounds per burst size, chunks of %d values, up to %d free chunks kept\n", ROUND_COUNT,
+           u64_segq_chunk_capacity, MAX_FREE_CHUNK_COUNT);
+    printf("burst size   Mvalues/s       max enqueue us    held after KiB\n");
+    printf("             segq    deque   segq     deque    segq     deque\n");
+
+    uint64_t checksum = 0;
+
+    for (uint64_t burst_size = 1000; burst_size <= max_burst_size; burst_size *= 10) {
+        const struct result segq = run_segq(burst_size, false);
+        const struct result deque = run_deque(burst_size, false);
+        const double segq_latency = run_segq(burst_size, true).max_enqueue_latency;
+        const double deque_latency = run_deque(burst_size, true).max_enqueue_latency;
+
+        if (segq.sum != deque.sum) {
+            fprintf(stderr, "checksum mismatch\n");
+            return 1;
+        }
+        checksum += segq.sum;
+
+        const double value_count = (double)burst_size * ROUND_COUNT;
+        printf("%10llu   %6.1f  %6.1f   %7.1f  %7.1f  %7zu  %7zu\n", (unsigned long long)burst_size,
+               value_count / segq.elapsed * 1e-6, value_count / deque.elapsed * 1e-6, segq_latency * 1e6,
+               deque_latency * 1e6, segq.held_size / 1024, deque.held_size / 1024);
+    }
+
+    printf("(checksum %llu)\n", (unsigned long long)checksum);
+
+    return 0;
+}
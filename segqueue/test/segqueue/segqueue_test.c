@@ -0,0 +1,253 @@
+/*
+    Test cases:
+    - Create:
+      - An empty queue holds no chunks
+    - Single chunk:
+      - enqueue / dequeue / get_front / get_back within a chunk
+      - Alternating enqueue and dequeue keeps the last chunk linked
+    - Multiple chunks:
+      - Values are dequeued in order across chunk boundaries
+      - The chunk count follows the number of values
+      - Values are never moved: their addresses are stable
+    - Free list:
+      - Unlinked chunks are reused before allocating new ones
+      - Chunks beyond max_free_chunk_count are freed after a burst
+      - clear unlinks all chunks, and shrink frees the free list
+      - A failed allocation leaves the queue unchanged
+      - Every allocation is freed by destroy
+    - Overflow:
+      - enqueue fails once the count reaches the SIZE_TYPE maximum
+*/
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+struct alloc_stats {
+    size_t allocation_count;
+    size_t free_count;
+    size_t allocation_limit;
+};
+
+static void *counting_alloc(struct alloc_stats *stats, const size_t size)
+{
+    if (stats->allocation_count - stats->free_count == stats->allocation_limit) {
+        return NULL;
+    }
+    stats->allocation_count++;
+    return malloc(size);
+}
+
+static void counting_free(struct alloc_stats *stats, void *ptr, const size_t size)
+{
+    (void)size;
+    stats->free_count++;
+    free(ptr);
+}
+
+#define NAME                        u32_segq
+#define VALUE_TYPE                  uint32_t
+#define CHUNK_CAPACITY              4
+#define ALLOCATOR(ctx, size)        counting_alloc((ctx), (size))
+#define DEALLOCATOR(ctx, ptr, size) counting_free((ctx), (ptr), (size))
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "segqueue_template.h"
+
+#define NAME       u64_segq
+#define VALUE_TYPE uint64_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "segqueue_template.h"
+
+#define NAME           u8_segq
+#define VALUE_TYPE     uint8_t
+#define SIZE_TYPE      uint8_t
+#define CHUNK_CAPACITY 16
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "segqueue_template.h"
+
+#define BURST_SIZE (100000)
+
+static size_t live_allocations(const struct alloc_stats *stats)
+{
+    return stats->allocation_count - stats->free_count;
+}
+
+static void create_test(void)
+{
+    struct alloc_stats stats = {0, 0, SIZE_MAX};
+
+    struct u32_segq *q = u32_segq_create_with_context(2, &stats);
+    assert(q != NULL);
+    assert(u32_segq_is_empty(q));
+    assert(q->count == 0 && q->chunk_count == 0 && q->free_chunk_count == 0);
+    assert(q->front_chunk == NULL && q->back_chunk == NULL);
+    assert(live_allocations(&stats) == 1);
+    assert(SEGQUEUE_CALC_CHUNK_SIZEOF(u32_segq) == sizeof(struct u32_segq_chunk) + 4 * sizeof(uint32_t));
+
+    u32_segq_destroy(q);
+    assert(live_allocations(&stats) == 0);
+}
+
+static void single_chunk_test(void)
+{
+    struct alloc_stats stats = {0, 0, SIZE_MAX};
+
+    struct u32_segq *q = u32_segq_create_with_context(0, &stats);
+    assert(q != NULL);
+
+    assert(u32_segq_enqueue(q, 1));
+    assert(u32_segq_enqueue(q, 2));
+    assert(q->count == 2 && q->chunk_count == 1);
+    assert(u32_segq_get_front(q) == 1);
+    assert(u32_segq_get_back(q) == 2);
+    assert(u32_segq_dequeue(q) == 1);
+    assert(u32_segq_dequeue(q) == 2);
+    assert(u32_segq_is_empty(q));
+
+    /* the last chunk stays linked, and is reused from its start */
+    const size_t allocation_count = stats.allocation_count;
+    for (uint32_t i = 0; i < 100; i++) {
+        assert(u32_segq_enqueue(q, i));
+        assert(u32_segq_get_back(q) == i);
+        assert(u32_segq_dequeue(q) == i);
+    }
+    assert(q->chunk_count == 1);
+    assert(q->front_chunk->begin_index == 0);
+    assert(stats.allocation_count == allocation_count);
+
+    u32_segq_destroy(q);
+    assert(live_allocations(&stats) == 0);
+}
+
+static void multiple_chunks_test(void)
+{
+    struct u64_segq *q = u64_segq_create(0);
+    assert(q != NULL);
+
+    for (uint64_t i = 0; i < BURST_SIZE; i++) {
+        assert(u64_segq_enqueue(q, i));
+    }
+    assert(q->count == BURST_SIZE);
+    assert(q->chunk_count == (BURST_SIZE + u64_segq_chunk_capacity - 1) / u64_segq_chunk_capacity);
+
+    for (uint64_t i = 0; i < BURST_SIZE; i++) {
+        assert(u64_segq_enqueue(q, BURST_SIZE + i));
+        assert(u64_segq_dequeue(q) == i);
+    }
+
+    for (uint64_t i = 0; i < BURST_SIZE; i++) {
+        assert(u64_segq_get_front(q) == BURST_SIZE + i);
+        assert(u64_segq_dequeue(q) == BURST_SIZE + i);
+    }
+    assert(u64_segq_is_empty(q));
+    assert(q->chunk_count == 1);
+
+    u64_segq_destroy(q);
+}
+
+static void address_test(void)
+{
+    struct u64_segq *q = u64_segq_create(0);
+    assert(q != NULL);
+
+    assert(u64_segq_enqueue(q, 42));
+    const uint64_t *value_ptr = &q->front_chunk->values[q->front_chunk->begin_index];
+    for (uint64_t i = 0; i < BURST_SIZE; i++) {
+        assert(u64_segq_enqueue(q, i));
+    }
+    assert(value_ptr == &q->front_chunk->values[q->front_chunk->begin_index] && *value_ptr == 42);
+
+    u64_segq_destroy(q);
+}
+
+static void free_list_test(void)
+{
+    struct alloc_stats stats = {0, 0, SIZE_MAX};
+
+    struct u32_segq *q = u32_segq_create_with_context(2, &stats);
+    assert(q != NULL);
+
+    /* a burst of 10 chunks: 2 are kept, and the 8 others are freed */
+    for (uint32_t i = 0; i < 40; i++) {
+        assert(u32_segq_enqueue(q, i));
+    }
+    assert(q->chunk_count == 10);
+    assert(live_allocations(&stats) == 1 + 10);
+
+    for (uint32_t i = 0; i < 40; i++) {
+        assert(u32_segq_dequeue(q) == i);
+    }
+    assert(q->chunk_count == 1 && q->free_chunk_count == 2);
+    assert(live_allocations(&stats) == 1 + 1 + 2);
+
+    /* the kept chunks are reused */
+    const size_t allocation_count = stats.allocation_count;
+    for (uint32_t i = 0; i < 12; i++) {
+        assert(u32_segq_enqueue(q, i));
+    }
+    assert(q->chunk_count == 3 && q->free_chunk_count == 0);
+    assert(stats.allocation_count == allocation_count);
+
+    /* a failed allocation leaves the queue unchanged */
+    stats.allocation_limit = live_allocations(&stats);
+    assert(!u32_segq_enqueue(q, 12));
+    assert(q->count == 12 && q->chunk_count == 3);
+    assert(u32_segq_get_back(q) == 11);
+    stats.allocation_limit = SIZE_MAX;
+
+    u32_segq_clear(q);
+    assert(u32_segq_is_empty(q) && q->chunk_count == 0);
+    assert(q->free_chunk_count == 2);
+    assert(live_allocations(&stats) == 1 + 2);
+
+    u32_segq_shrink(q);
+    assert(q->free_chunk_count == 0 && q->free_chunks == NULL);
+    assert(live_allocations(&stats) == 1);
+
+    assert(u32_segq_enqueue(q, 7));
+    assert(u32_segq_dequeue(q) == 7);
+
+    u32_segq_destroy(q);
+    assert(live_allocations(&stats) == 0);
+}
+
+static void overflow_test(void)
+{
+    struct u8_segq *q = u8_segq_create(1);
+    assert(q != NULL);
+
+    for (uint32_t i = 0; i < UINT8_MAX; i++) {
+        assert(u8_segq_enqueue(q, (uint8_t)i));
+    }
+    assert(q->count == UINT8_MAX);
+
+    // one more value would wrap the count to 0
+    const uint8_t chunk_count = q->chunk_count;
+    assert(!u8_segq_enqueue(q, 0));
+    assert(q->count == UINT8_MAX && q->chunk_count == chunk_count);
+    assert(u8_segq_get_back(q) == UINT8_MAX - 1);
+
+    assert(u8_segq_dequeue(q) == 0);
+    assert(u8_segq_enqueue(q, 7));
+    assert(q->count == UINT8_MAX);
+    assert(u8_segq_get_back(q) == 7);
+
+    u8_segq_destroy(q);
+}
+
+int main(void)
+{
+    create_test();
+    single_chunk_test();
+    multiple_chunks_test();
+    address_test();
+    free_list_test();
+    overflow_test();
+}
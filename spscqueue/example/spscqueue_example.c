@@ -0,0 +1,58 @@
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#define NAME       int_spsc
+#define VALUE_TYPE int
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "spscqueue_template.h"
+
+#define MESSAGE_COUNT (1000)
+
+/* the only thread enqueuing */
+static void *producer(void *arg)
+{
+    struct int_spsc *q = arg;
+
+    for (int i = 1; i <= MESSAGE_COUNT; i++) {
+        while (!int_spsc_try_enqueue(q, i)) {
+            sched_yield(); // full. let the consumer catch up
+        }
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    struct int_spsc *q = int_spsc_create(16);
+    if (!q) {
+        assert(false);
+    }
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, producer, q) != 0) {
+        assert(false);
+    }
+
+    /* the main thread is the only thread dequeuing */
+    long sum = 0;
+    for (int i = 1; i <= MESSAGE_COUNT; i++) {
+        int value;
+        while (!int_spsc_try_dequeue(q, &value)) {
+            sched_yield(); // empty. let the producer catch up
+        }
+        assert(value == i); // values arrive in order
+        sum += value;
+    }
+
+    pthread_join(thread, NULL);
+
+    assert(int_spsc_is_empty(q));
+    printf("sum: %ld\n", sum);
+
+    int_spsc_destroy(q);
+}
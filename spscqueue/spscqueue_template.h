@@ -0,0 +1,804 @@
+/*  spscqueue_template.h
+ *
+ *  Copyright (C) 2025 abxh
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *  See the file LICENSE included with this distribution for more
+ *  information. */
+
+/**
+ * @file spscqueue_template.h
+ * @brief Fixed-size single-producer/single-consumer lock-free queue based on
+ *        ring buffer
+ *
+ * One thread may enqueue and one (other) thread may dequeue concurrently
+ * without locks. Both operations are wait-free.
+ *
+ * Compared to `fqueue_template.h`:
+ *      @li `begin_index` and `end_index` are atomic and run freely (they are
+ *          masked with `capacity - 1` on access), so no shared `count` field
+ *          is needed. The number of values is `end_index - begin_index`.
+ *      @li `begin_index` and `end_index` are placed on separate cache lines,
+ *          such that the producer and consumer do not write to the same line.
+ *      @li The producer keeps a cached copy of `begin_index`, and the consumer
+ *          a cached copy of `end_index`. The opposite index is only re-read
+ *          when the queue appears full (or empty) by the cached copy.
+ *      @li Values are published with release stores and observed with acquire
+ *          loads.
+ *
+ * Source(s) used:
+ *  @li https://rigtorp.se/ringbuffer/
+ *  @li https://www.1024cores.net/home/lock-free-algorithms/queues
+ */
+
+/**
+ * @example spscqueue_example.c
+ * Example of how `spscqueue_template.h` header file is used in practice.
+ */
+
+#ifdef __cplusplus
+#ifdef __GNUC__
+#define restrict __restrict__
+#else
+#define restrict
+#endif
+extern "C" {
+#endif
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef SHARED
+#if !defined(__unix__) && !defined(__APPLE__)
+#error "SHARED is only supported on POSIX systems."
+#endif
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// macro definitions: {{{
+
+/**
+ * @def PASTE(a,b)
+ * @brief Paste two tokens together.
+ */
+#ifndef PASTE
+#define PASTE(a, b) a##b
+#endif
+
+/**
+ * @def XPASTE(a,b)
+ * @brief First expand tokens, then paste them together.
+ */
+#ifndef XPASTE
+#define XPASTE(a, b) PASTE(a, b)
+#endif
+
+/**
+ * @def JOIN(a,b)
+ * @brief First expand tokens, then paste them together with a _ in between.
+ */
+#ifndef JOIN
+#define JOIN(a, b) XPASTE(a, XPASTE(_, b))
+#endif
+
+/**
+ * @brief Macro to check if a number is a power of two.
+ *
+ * @param[in] X             The number at hand.
+ *
+ * @return                  A boolean value indicating whether the number is a power of two.
+ */
+#ifndef IS_POW2
+#define IS_POW2(X) ((X) != 0 && ((X) & ((X) - 1)) == 0)
+#endif
+
+/**
+ * @def SPSCQUEUE_CACHE_LINE_SIZE
+ * @brief Alignment used to keep the producer and consumer fields apart.
+ *        Equal to a typical cache line size.
+ */
+#ifndef SPSCQUEUE_CACHE_LINE_SIZE
+#define SPSCQUEUE_CACHE_LINE_SIZE (64)
+#endif
+
+/**
+ * @def SPSCQUEUE_CALC_SIZEOF(spscqueue_name, capacity)
+ *
+ * @brief Calculate the size of the queue struct. No overflow checks.
+ *
+ * @param[in] spscqueue_name    Defined queue NAME.
+ * @param[in] capacity          Capacity input.
+ *
+ * @return                      The equivalent size.
+ */
+#ifndef SPSCQUEUE_CALC_SIZEOF
+#define SPSCQUEUE_CALC_SIZEOF(spscqueue_name, capacity) \
+    (offsetof(struct spscqueue_name, values) + (size_t)(capacity) * sizeof(((struct spscqueue_name *)0)->values[0]))
+#endif
+
+/**
+ * @def SPSCQUEUE_CALC_SIZEOF_OVERFLOWS(spscqueue_name, capacity)
+ *
+ * @brief Check for a given capacity, if the equivalent size of the queue struct
+ *        overflows. Leaves room for rounding the size up to a multiple of
+ *        `SPSCQUEUE_CACHE_LINE_SIZE`.
+ *
+ * @param[in] spscqueue_name    Defined queue NAME.
+ * @param[in] capacity          Capacity input.
+ *
+ * @return                      Whether the equivalent size overflows.
+ */
+#ifndef SPSCQUEUE_CALC_SIZEOF_OVERFLOWS
+#define SPSCQUEUE_CALC_SIZEOF_OVERFLOWS(spscqueue_name, capacity)                       \
+    ((uintmax_t)0 + (capacity)                                                          \
+     > (SIZE_MAX - SPSCQUEUE_CACHE_LINE_SIZE - offsetof(struct spscqueue_name, values)) \
+           / sizeof(((struct spscqueue_name *)0)->values[0]))
+#endif
+
+/**
+ * @def SPSCQUEUE_CALC_SHARED_OFFSET(spscqueue_name)
+ *
+ * @brief Calculate the offset of the queue struct in its shared memory segment,
+ *        after the header. See `SHARED`.
+ *
+ * @param[in] spscqueue_name    Defined queue NAME.
+ *
+ * @return                      The offset in bytes.
+ */
+#ifndef SPSCQUEUE_CALC_SHARED_OFFSET
+#define SPSCQUEUE_CALC_SHARED_OFFSET(spscqueue_name)                                      \
+    ((sizeof(struct JOIN(spscqueue_name, shared_header)) + SPSCQUEUE_CACHE_LINE_SIZE - 1) \
+     & ~(size_t)(SPSCQUEUE_CACHE_LINE_SIZE - 1))
+#endif
+
+/**
+ * @def SPSCQUEUE_SHARED_MAGIC
+ * @brief Magic number at the start of a shared memory segment of a queue. See
+ *        `SHARED`.
+ */
+#ifndef SPSCQUEUE_SHARED_MAGIC
+#define SPSCQUEUE_SHARED_MAGIC (0x5350534351554555ULL) // "SPSCQUEU"
+#endif
+
+/**
+ * @def SPSCQUEUE_SHARED_VERSION
+ * @brief Version of the layout of a shared memory segment of a queue. Bumped
+ *        whenever the layout changes. See `SHARED`.
+ */
+#ifndef SPSCQUEUE_SHARED_VERSION
+#define SPSCQUEUE_SHARED_VERSION (1)
+#endif
+
+/// @cond DO_NOT_DOCUMENT
+#ifndef SPSCQUEUE_ALIGNAS
+#ifdef __cplusplus
+#define SPSCQUEUE_ALIGNAS(x) alignas(x)
+#else
+#define SPSCQUEUE_ALIGNAS(x) _Alignas(x)
+#endif
+#endif
+/// @endcond
+
+/**
+ * @def NAME
+ * @brief Prefix to queue type and operations. This must be manually defined
+ *        before including this header file.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef NAME
+#define NAME spscqueue
+#error "Must define NAME."
+#else
+#define SPSCQUEUE_NAME NAME
+#endif
+
+/**
+ * @def VALUE_TYPE
+ * @brief Queue value type. This must be manually defined before including this
+ *        header file.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef VALUE_TYPE
+#define VALUE_TYPE int
+#define FUNCTION_DEFINITIONS
+#define TYPE_DEFINITIONS
+#error "Must define VALUE_TYPE."
+#endif
+
+/**
+ * @def SIZE_TYPE
+ * @brief Queue capacity and index type. Defaults to `uint32_t`.
+ *
+ * Define as `uint64_t` (or `size_t`) for queues of more than
+ * `UINT32_MAX / 2 + 1` values. Must be an unsigned integer type which is
+ * lock-free as an atomic.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef SIZE_TYPE
+#define SIZE_TYPE uint32_t
+#endif
+
+/**
+ * @def SHARED
+ * @brief Generates `create_shared`, `attach_shared`, `detach_shared` and
+ *        `unlink_shared` if defined. POSIX only.
+ *
+ * A shared queue lives in a named POSIX shared memory segment (`shm_open`),
+ * such that a producer and a consumer in different processes can use it. The
+ * segment is:
+ *      @li A header, with a magic number, a layout version and the sizes of
+ *          the types, which are validated when attaching.
+ *      @li The queue struct, at the next cache line.
+ *
+ * The queue struct holds no pointers, so each process may map the segment at
+ * a different address. The indices are lock-free atomics, which are
+ * address-free and thus work across processes.
+ *
+ * Is undefined once header is included.
+ */
+#ifdef SHARED
+#endif
+
+/**
+ * @def FUNCTION_LINKAGE
+ * @brief Specify function linkage e.g. static inline
+ */
+#ifndef FUNCTION_LINKAGE
+#define FUNCTION_LINKAGE
+#endif
+
+/// @cond DO_NOT_DOCUMENT
+#define SPSCQUEUE_TYPE     struct SPSCQUEUE_NAME
+#define SPSCQUEUE_INIT     JOIN(SPSCQUEUE_NAME, init)
+#define SPSCQUEUE_SIZE_MAX ((SIZE_TYPE)-1)
+#define SPSCQUEUE_ROUND_UP JOIN(internal, JOIN(SPSCQUEUE_NAME, round_up_pow2))
+
+#define SPSCQUEUE_SHARED_HEADER_TYPE struct JOIN(SPSCQUEUE_NAME, shared_header)
+#define SPSCQUEUE_SHARED_OFFSET      SPSCQUEUE_CALC_SHARED_OFFSET(SPSCQUEUE_NAME)
+/// @endcond
+
+// }}}
+
+// type definitions: {{{
+
+/**
+ * @def TYPE_DEFINITIONS
+ * @brief Define the types
+ */
+#ifdef TYPE_DEFINITIONS
+
+/**
+ * @brief Generated queue struct type for a `VALUE_TYPE`.
+ */
+struct SPSCQUEUE_NAME {
+    SPSCQUEUE_ALIGNAS(SPSCQUEUE_CACHE_LINE_SIZE)
+    _Atomic(SIZE_TYPE) end_index; ///< Index one past the back of the queue. Written by the producer.
+    SIZE_TYPE cached_begin_index; ///< Last `begin_index` seen by the producer.
+
+    SPSCQUEUE_ALIGNAS(SPSCQUEUE_CACHE_LINE_SIZE)
+    _Atomic(SIZE_TYPE) begin_index; ///< Index of the front of the queue. Written by the consumer.
+    SIZE_TYPE cached_end_index;     ///< Last `end_index` seen by the consumer.
+
+    SPSCQUEUE_ALIGNAS(SPSCQUEUE_CACHE_LINE_SIZE)
+    SIZE_TYPE capacity; ///< Maximum number of values allocated for.
+
+    SPSCQUEUE_ALIGNAS(SPSCQUEUE_CACHE_LINE_SIZE)
+    VALUE_TYPE values[]; ///< Array of values. Aligned to the size of a cache line.
+};
+
+#ifdef SHARED
+
+/**
+ * @brief Header of the shared memory segment of a queue. See `SHARED`.
+ */
+struct JOIN(SPSCQUEUE_NAME, shared_header) {
+    _Atomic(uint64_t) magic;  ///< `SPSCQUEUE_SHARED_MAGIC`, stored once the queue is initialized.
+    uint32_t version;         ///< `SPSCQUEUE_SHARED_VERSION` of the creator.
+    uint32_t value_size;      ///< `sizeof(VALUE_TYPE)` of the creator.
+    uint32_t size_type_size;  ///< `sizeof(SIZE_TYPE)` of the creator.
+    uint32_t cache_line_size; ///< `SPSCQUEUE_CACHE_LINE_SIZE` of the creator.
+    uint64_t segment_size;    ///< Size of the segment in bytes.
+};
+
+#endif
+
+#endif
+
+// }}}
+
+// function declarations: {{{
+
+/**
+ * @brief Initialize a queue struct, given a (power-of-2) capacity.
+ *
+ * @note The memory should be aligned to `SPSCQUEUE_CACHE_LINE_SIZE`.
+ *
+ * @param[in] self              Queue pointer
+ * @param[in] pow2_capacity     Power of 2 capacity
+ *
+ * @return                      The queue pointer.
+ */
+FUNCTION_LINKAGE SPSCQUEUE_TYPE *JOIN(SPSCQUEUE_NAME, init)(SPSCQUEUE_TYPE *self, const SIZE_TYPE pow2_capacity);
+
+/**
+ * @brief Create a queue struct with a given capacity with aligned_alloc().
+ *
+ * @param[in] min_capacity      Maximum number of elements expected to be stored
+ *
+ * @return                      A pointer to the queue.
+ * @retval NULL
+ *   @li                        If aligned_alloc fails.
+ *   @li                        If capacity is 0 or larger than the maximum of `SIZE_TYPE` / 2 + 1 or the
+ *                              equivalent size overflows.
+ */
+FUNCTION_LINKAGE SPSCQUEUE_TYPE *JOIN(SPSCQUEUE_NAME, create)(const SIZE_TYPE min_capacity);
+
+/**
+ * @brief Destroy a queue struct and free the underlying memory.
+ *
+ * @warning May not be called twice in a row on the same object, or while
+ *          either thread still uses the queue.
+ *
+ * @param[in] self              The queue pointer.
+ */
+FUNCTION_LINKAGE void JOIN(SPSCQUEUE_NAME, destroy)(SPSCQUEUE_TYPE *self);
+
+/**
+ * @brief Return whether the queue is empty.
+ *
+ * @note Exact when called by the consumer. Otherwise the queue may have
+ *       changed by the time the result is used.
+ *
+ * @param[in] self              The queue pointer.
+ *
+ * @return                      Whether the queue is empty.
+ */
+FUNCTION_LINKAGE bool JOIN(SPSCQUEUE_NAME, is_empty)(SPSCQUEUE_TYPE *self);
+
+/**
+ * @brief Return whether the queue is full.
+ *
+ * @note Exact when called by the producer. Otherwise the queue may have
+ *       changed by the time the result is used.
+ *
+ * @param[in] self              The queue pointer.
+ *
+ * @return                      Whether the queue is full.
+ */
+FUNCTION_LINKAGE bool JOIN(SPSCQUEUE_NAME, is_full)(SPSCQUEUE_TYPE *self);
+
+/**
+ * @brief Return the number of values in the queue.
+ *
+ * @note A snapshot. The queue may have changed by the time the result is used.
+ *
+ * @param[in] self              The queue pointer.
+ *
+ * @return                      The number of values, at most `capacity`.
+ */
+FUNCTION_LINKAGE SIZE_TYPE JOIN(SPSCQUEUE_NAME, count)(SPSCQUEUE_TYPE *self);
+
+/**
+ * @brief Enqueue a value at the back of the queue, if it is not full. May
+ *        only be called by the producer.
+ *
+ * @param[in] self              The queue pointer.
+ * @param[in] value             The value to enqueue.
+ *
+ * @return                      Whether the value was enqueued.
+ */
+FUNCTION_LINKAGE bool JOIN(SPSCQUEUE_NAME, try_enqueue)(SPSCQUEUE_TYPE *self, const VALUE_TYPE value);
+
+/**
+ * @brief Dequeue a value from the front of the queue, if it is not empty. May
+ *        only be called by the consumer.
+ *
+ * @param[in] self              The queue pointer.
+ * @param[out] value_ptr        Set to the front value, if any.
+ *
+ * @return                      Whether a value was dequeued.
+ */
+FUNCTION_LINKAGE bool JOIN(SPSCQUEUE_NAME, try_dequeue)(SPSCQUEUE_TYPE *restrict self, VALUE_TYPE *restrict value_ptr);
+
+/**
+ * @brief Get the front value of the queue without dequeuing it, if it is not
+ *        empty. May only be called by the consumer.
+ *
+ * @param[in] self              The queue pointer.
+ * @param[out] value_ptr        Set to the front value, if any.
+ *
+ * @return                      Whether the queue had a front value.
+ */
+FUNCTION_LINKAGE bool JOIN(SPSCQUEUE_NAME, try_peek)(SPSCQUEUE_TYPE *restrict self, VALUE_TYPE *restrict value_ptr);
+
+#ifdef SHARED
+
+/**
+ * @brief Create a queue struct with a given capacity in a new named shared
+ *        memory segment. See `SHARED`.
+ *
+ * @param[in] name              Name of the segment, e.g. "/ticks". Starts with
+ *                              a slash.
+ * @param[in] min_capacity      Maximum number of elements expected to be stored
+ *
+ * @return                      A pointer to the queue.
+ * @retval NULL
+ *   @li                        If a segment with the name exists already, or
+ *                              it could not be created or mapped.
+ *   @li                        If capacity is 0 or larger than the maximum of `SIZE_TYPE` / 2 + 1 or the
+ *                              equivalent size overflows.
+ */
+FUNCTION_LINKAGE SPSCQUEUE_TYPE *JOIN(SPSCQUEUE_NAME, create_shared)(const char *name, const SIZE_TYPE min_capacity);
+
+/**
+ * @brief Attach to a queue struct in an existing named shared memory segment,
+ *        created by `create_shared` (in any process).
+ *
+ * @param[in] name              Name of the segment.
+ *
+ * @return                      A pointer to the queue.
+ * @retval NULL
+ *   @li                        If the segment does not exist or could not be
+ *                              mapped.
+ *   @li                        If the segment is not (yet) a fully initialized
+ *                              queue of the same `VALUE_TYPE`, `SIZE_TYPE` and
+ *                              layout version.
+ */
+FUNCTION_LINKAGE SPSCQUEUE_TYPE *JOIN(SPSCQUEUE_NAME, attach_shared)(const char *name);
+
+/**
+ * @brief Unmap a queue struct created by `create_shared` or `attach_shared`.
+ *        The segment itself remains until it is unlinked and unmapped by
+ *        every process.
+ *
+ * @warning May not be called twice in a row on the same object.
+ *
+ * @param[in] self              The queue pointer.
+ */
+FUNCTION_LINKAGE void JOIN(SPSCQUEUE_NAME, detach_shared)(SPSCQUEUE_TYPE *self);
+
+/**
+ * @brief Remove the name of a shared memory segment. Queues attached already
+ *        remain usable.
+ *
+ * @param[in] name              Name of the segment.
+ *
+ * @return                      Whether the name was removed.
+ */
+FUNCTION_LINKAGE bool JOIN(SPSCQUEUE_NAME, unlink_shared)(const char *name);
+
+#endif
+
+// }}}
+
+// function definitions: {{{
+
+/**
+ * @def FUNCTION_DEFINITIONS
+ * @brief Define the functions
+ */
+#ifdef FUNCTION_DEFINITIONS
+
+#include "round_up_pow2_32.h" // round_up_pow2_32
+#include "round_up_pow2_64.h" // round_up_pow2_64
+
+/// @cond DO_NOT_DOCUMENT
+static inline SIZE_TYPE JOIN(internal, JOIN(SPSCQUEUE_NAME, round_up_pow2))(const SIZE_TYPE x)
+{
+    if (sizeof(SIZE_TYPE) <= sizeof(uint32_t)) {
+        return (SIZE_TYPE)round_up_pow2_32((uint32_t)x);
+    }
+    return (SIZE_TYPE)round_up_pow2_64((uint64_t)x);
+}
+/// @endcond
+
+FUNCTION_LINKAGE SPSCQUEUE_TYPE *JOIN(SPSCQUEUE_NAME, init)(SPSCQUEUE_TYPE *self, const SIZE_TYPE pow2_capacity)
+{
+    assert(self);
+    assert(IS_POW2(pow2_capacity));
+
+    atomic_init(&self->begin_index, 0);
+    atomic_init(&self->end_index, 0);
+    self->cached_begin_index = self->cached_end_index = 0;
+    self->capacity = pow2_capacity;
+
+    return self;
+}
+
+FUNCTION_LINKAGE SPSCQUEUE_TYPE *JOIN(SPSCQUEUE_NAME, create)(const SIZE_TYPE min_capacity)
+{
+    if (min_capacity == 0 || min_capacity > SPSCQUEUE_SIZE_MAX / 2 + 1) {
+        return NULL;
+    }
+
+    const SIZE_TYPE capacity = SPSCQUEUE_ROUND_UP(min_capacity);
+
+    if (SPSCQUEUE_CALC_SIZEOF_OVERFLOWS(SPSCQUEUE_NAME, capacity)) {
+        return NULL;
+    }
+
+    /* aligned_alloc requires the size to be a multiple of the alignment */
+    const size_t size = (SPSCQUEUE_CALC_SIZEOF(SPSCQUEUE_NAME, capacity) + SPSCQUEUE_CACHE_LINE_SIZE - 1)
+                        & ~(size_t)(SPSCQUEUE_CACHE_LINE_SIZE - 1);
+
+    SPSCQUEUE_TYPE *self = (SPSCQUEUE_TYPE *)aligned_alloc(SPSCQUEUE_CACHE_LINE_SIZE, size);
+
+    if (!self) {
+        return NULL;
+    }
+
+    SPSCQUEUE_INIT(self, capacity);
+
+    return self;
+}
+
+FUNCTION_LINKAGE void JOIN(SPSCQUEUE_NAME, destroy)(SPSCQUEUE_TYPE *self)
+{
+    assert(self != NULL);
+
+    free(self);
+}
+
+FUNCTION_LINKAGE bool JOIN(SPSCQUEUE_NAME, is_empty)(SPSCQUEUE_TYPE *self)
+{
+    assert(self != NULL);
+
+    const SIZE_TYPE begin_index = atomic_load_explicit(&self->begin_index, memory_order_relaxed);
+
+    return atomic_load_explicit(&self->end_index, memory_order_acquire) == begin_index;
+}
+
+FUNCTION_LINKAGE bool JOIN(SPSCQUEUE_NAME, is_full)(SPSCQUEUE_TYPE *self)
+{
+    assert(self != NULL);
+
+    const SIZE_TYPE end_index = atomic_load_explicit(&self->end_index, memory_order_relaxed);
+
+    return (SIZE_TYPE)(end_index - atomic_load_explicit(&self->begin_index, memory_order_acquire)) == self->capacity;
+}
+
+FUNCTION_LINKAGE SIZE_TYPE JOIN(SPSCQUEUE_NAME, count)(SPSCQUEUE_TYPE *self)
+{
+    assert(self != NULL);
+
+    /* begin_index is read first, such that end_index is never seen behind it */
+    const SIZE_TYPE begin_index = atomic_load_explicit(&self->begin_index, memory_order_acquire);
+    const SIZE_TYPE count = (SIZE_TYPE)(atomic_load_explicit(&self->end_index, memory_order_acquire) - begin_index);
+
+    return count < self->capacity ? count : self->capacity;
+}
+
+FUNCTION_LINKAGE bool JOIN(SPSCQUEUE_NAME, try_enqueue)(SPSCQUEUE_TYPE *self, const VALUE_TYPE value)
+{
+    assert(self != NULL);
+
+    const SIZE_TYPE end_index = atomic_load_explicit(&self->end_index, memory_order_relaxed);
+
+    if ((SIZE_TYPE)(end_index - self->cached_begin_index) == self->capacity) {
+        self->cached_begin_index = atomic_load_explicit(&self->begin_index, memory_order_acquire);
+
+        if ((SIZE_TYPE)(end_index - self->cached_begin_index) == self->capacity) {
+            return false;
+        }
+    }
+
+    self->values[end_index & (self->capacity - 1)] = value;
+
+    atomic_store_explicit(&self->end_index, (SIZE_TYPE)(end_index + 1), memory_order_release);
+
+    return true;
+}
+
+FUNCTION_LINKAGE bool JOIN(SPSCQUEUE_NAME, try_dequeue)(SPSCQUEUE_TYPE *restrict self, VALUE_TYPE *restrict value_ptr)
+{
+    assert(self != NULL);
+    assert(value_ptr != NULL);
+
+    const SIZE_TYPE begin_index = atomic_load_explicit(&self->begin_index, memory_order_relaxed);
+
+    if (begin_index == self->cached_end_index) {
+        self->cached_end_index = atomic_load_explicit(&self->end_index, memory_order_acquire);
+
+        if (begin_index == self->cached_end_index) {
+            return false;
+        }
+    }
+
+    *value_ptr = self->values[begin_index & (self->capacity - 1)];
+
+    atomic_store_explicit(&self->begin_index, (SIZE_TYPE)(begin_index + 1), memory_order_release);
+
+    return true;
+}
+
+FUNCTION_LINKAGE bool JOIN(SPSCQUEUE_NAME, try_peek)(SPSCQUEUE_TYPE *restrict self, VALUE_TYPE *restrict value_ptr)
+{
+    assert(self != NULL);
+    assert(value_ptr != NULL);
+
+    const SIZE_TYPE begin_index = atomic_load_explicit(&self->begin_index, memory_order_relaxed);
+
+    if (begin_index == self->cached_end_index) {
+        self->cached_end_index = atomic_load_explicit(&self->end_index, memory_order_acquire);
+
+        if (begin_index == self->cached_end_index) {
+            return false;
+        }
+    }
+
+    *value_ptr = self->values[begin_index & (self->capacity - 1)];
+
+    return true;
+}
+
+#ifdef SHARED
+
+FUNCTION_LINKAGE SPSCQUEUE_TYPE *JOIN(SPSCQUEUE_NAME, create_shared)(const char *name, const SIZE_TYPE min_capacity)
+{
+    assert(name != NULL);
+
+    if (min_capacity == 0 || min_capacity > SPSCQUEUE_SIZE_MAX / 2 + 1) {
+        return NULL;
+    }
+
+    const SIZE_TYPE capacity = SPSCQUEUE_ROUND_UP(min_capacity);
+
+    if (SPSCQUEUE_CALC_SIZEOF_OVERFLOWS(SPSCQUEUE_NAME, capacity)
+        || SPSCQUEUE_CALC_SIZEOF(SPSCQUEUE_NAME, capacity) > SIZE_MAX - SPSCQUEUE_SHARED_OFFSET) {
+        return NULL;
+    }
+
+    const size_t segment_size = SPSCQUEUE_SHARED_OFFSET + SPSCQUEUE_CALC_SIZEOF(SPSCQUEUE_NAME, capacity);
+
+    const int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+
+    if (fd < 0) {
+        return NULL;
+    }
+    if (ftruncate(fd, (off_t)segment_size) != 0) {
+        close(fd);
+        shm_unlink(name);
+        return NULL;
+    }
+
+    unsigned char *base = (unsigned char *)mmap(NULL, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    /* the mapping keeps the segment alive */
+    close(fd);
+
+    if (base == MAP_FAILED) {
+        shm_unlink(name);
+        return NULL;
+    }
+
+    SPSCQUEUE_SHARED_HEADER_TYPE *header = (SPSCQUEUE_SHARED_HEADER_TYPE *)base;
+    SPSCQUEUE_TYPE *self = (SPSCQUEUE_TYPE *)(base + SPSCQUEUE_SHARED_OFFSET);
+
+    /* the indices must not rely on a lock local to the process */
+    if (!atomic_is_lock_free(&header->magic) || !atomic_is_lock_free(&self->end_index)) {
+        munmap(base, segment_size);
+        shm_unlink(name);
+        return NULL;
+    }
+
+    SPSCQUEUE_INIT(self, capacity);
+
+    header->version = SPSCQUEUE_SHARED_VERSION;
+    header->value_size = (uint32_t)sizeof(VALUE_TYPE);
+    header->size_type_size = (uint32_t)sizeof(SIZE_TYPE);
+    header->cache_line_size = SPSCQUEUE_CACHE_LINE_SIZE;
+    header->segment_size = (uint64_t)segment_size;
+
+    /* publish the initialized queue to attaching processes */
+    atomic_store_explicit(&header->magic, SPSCQUEUE_SHARED_MAGIC, memory_order_release);
+
+    return self;
+}
+
+FUNCTION_LINKAGE SPSCQUEUE_TYPE *JOIN(SPSCQUEUE_NAME, attach_shared)(const char *name)
+{
+    assert(name != NULL);
+
+    const int fd = shm_open(name, O_RDWR, 0);
+
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uintmax_t)st.st_size < SPSCQUEUE_SHARED_OFFSET + offsetof(SPSCQUEUE_TYPE, values)
+        || (uintmax_t)st.st_size > SIZE_MAX) {
+        close(fd);
+        return NULL;
+    }
+
+    const size_t segment_size = (size_t)st.st_size;
+
+    unsigned char *base = (unsigned char *)mmap(NULL, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    close(fd);
+
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+
+    SPSCQUEUE_SHARED_HEADER_TYPE *header = (SPSCQUEUE_SHARED_HEADER_TYPE *)base;
+    SPSCQUEUE_TYPE *self = (SPSCQUEUE_TYPE *)(base + SPSCQUEUE_SHARED_OFFSET);
+
+    const bool valid = atomic_load_explicit(&header->magic, memory_order_acquire) == SPSCQUEUE_SHARED_MAGIC
+                       && header->version == SPSCQUEUE_SHARED_VERSION
+                       && header->value_size == sizeof(VALUE_TYPE) && header->size_type_size == sizeof(SIZE_TYPE)
+                       && header->cache_line_size == SPSCQUEUE_CACHE_LINE_SIZE
+                       && header->segment_size == (uint64_t)segment_size && IS_POW2(self->capacity)
+                       && !SPSCQUEUE_CALC_SIZEOF_OVERFLOWS(SPSCQUEUE_NAME, self->capacity)
+                       && SPSCQUEUE_SHARED_OFFSET + SPSCQUEUE_CALC_SIZEOF(SPSCQUEUE_NAME, self->capacity)
+                              <= segment_size;
+
+    if (!valid) {
+        munmap(base, segment_size);
+        return NULL;
+    }
+
+    return self;
+}
+
+FUNCTION_LINKAGE void JOIN(SPSCQUEUE_NAME, detach_shared)(SPSCQUEUE_TYPE *self)
+{
+    assert(self != NULL);
+
+    unsigned char *base = (unsigned char *)self - SPSCQUEUE_SHARED_OFFSET;
+
+    munmap(base, (size_t)((SPSCQUEUE_SHARED_HEADER_TYPE *)base)->segment_size);
+}
+
+FUNCTION_LINKAGE bool JOIN(SPSCQUEUE_NAME, unlink_shared)(const char *name)
+{
+    assert(name != NULL);
+
+    return shm_unlink(name) == 0;
+}
+
+#endif
+
+#endif
+
+// }}}
+
+// macro undefs: {{{
+
+#undef NAME
+#undef VALUE_TYPE
+#undef SIZE_TYPE
+#undef FUNCTION_LINKAGE
+#undef FUNCTION_DEFINITIONS
+#undef TYPE_DEFINITIONS
+#undef SHARED
+
+#undef SPSCQUEUE_NAME
+#undef SPSCQUEUE_TYPE
+#undef SPSCQUEUE_INIT
+#undef SPSCQUEUE_SIZE_MAX
+#undef SPSCQUEUE_ROUND_UP
+#undef SPSCQUEUE_SHARED_HEADER_TYPE
+#undef SPSCQUEUE_SHARED_OFFSET
+
+// }}}
+
+#ifdef __cplusplus
+}
+#endif
+
+// vim: ft=c fdm=marker
@@ -0,0 +1,254 @@
+// Compares the lock-free SPSC queue with an fqueue guarded by a mutex, passing
+// uint64_t values between two threads:
+//  - ping-pong: a value is sent back and forth through two queues, measuring
+//    the round-trip latency.
+//  - throughput: one thread enqueues as fast as it can and the other dequeues.
+// Run with `make bench`. Pin the process to two cores for stable numbers, e.g.
+// `taskset -c 2,3 ./a.out 10000000`.
+//
+// usage: ./a.out [number of values]
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define NAME       u64_spsc
+#define VALUE_TYPE uint64_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "spscqueue_template.h"
+
+#define NAME       u64_fqueue
+#define VALUE_TYPE uint64_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fqueue_template.h"
+
+#define CAPACITY (1024)
+
+/* spin for a while before giving up the core, such that a single core machine still makes progress */
+#define SPIN_LIMIT (1024)
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static inline void backoff(uint32_t *spins)
+{
+    if (++*spins == SPIN_LIMIT) {
+        *spins = 0;
+        sched_yield();
+    }
+}
+
+// fqueue under a mutex: {{{
+
+struct locked_fqueue {
+    pthread_mutex_t mutex;
+    struct u64_fqueue *q;
+};
+
+static bool locked_try_enqueue(struct locked_fqueue *self, const uint64_t value)
+{
+    pthread_mutex_lock(&self->mutex);
+    const bool ok = !u64_fqueue_is_full(self->q) && u64_fqueue_enqueue(self->q, value);
+    pthread_mutex_unlock(&self->mutex);
+    return ok;
+}
+
+static bool locked_try_dequeue(struct locked_fqueue *self, uint64_t *value_ptr)
+{
+    pthread_mutex_lock(&self->mutex);
+    const bool ok = !u64_fqueue_is_empty(self->q);
+    if (ok) {
+        *value_ptr = u64_fqueue_dequeue(self->q);
+    }
+    pthread_mutex_unlock(&self->mutex);
+    return ok;
+}
+
+// }}}
+
+static uint64_t value_count;
+
+struct spsc_pair {
+    struct u64_spsc *ping, *pong;
+};
+
+struct locked_pair {
+    struct locked_fqueue *ping, *pong;
+};
+
+static void *spsc_echo(void *arg)
+{
+    struct spsc_pair *p = arg;
+    for (uint64_t i = 0; i < value_count; i++) {
+        uint64_t value;
+        uint32_t spins = 0;
+        while (!u64_spsc_try_dequeue(p->ping, &value)) {
+            backoff(&spins);
+        }
+        while (!u64_spsc_try_enqueue(p->pong, value + 1)) {
+            backoff(&spins);
+        }
+    }
+    return NULL;
+}
+
+static void *locked_echo(void *arg)
+{
+    struct locked_pair *p = arg;
+    for (uint64_t i = 0; i < value_count; i++) {
+        uint64_t value;
+        uint32_t spins = 0;
+        while (!locked_try_dequeue(p->ping, &value)) {
+            backoff(&spins);
+        }
+        while (!locked_try_enqueue(p->pong, value + 1)) {
+            backoff(&spins);
+        }
+    }
+    return NULL;
+}
+
+static void *spsc_produce(void *arg)
+{
+    struct u64_spsc *q = arg;
+    uint32_t spins = 0;
+    for (uint64_t i = 0; i < value_count; i++) {
+        while (!u64_spsc_try_enqueue(q, i)) {
+            backoff(&spins);
+        }
+    }
+    return NULL;
+}
+
+static void *locked_produce(void *arg)
+{
+    struct locked_fqueue *q = arg;
+    uint32_t spins = 0;
+    for (uint64_t i = 0; i < value_count; i++) {
+        while (!locked_try_enqueue(q, i)) {
+            backoff(&spins);
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    value_count = argc > 1 ? strtoull(argv[1], NULL, 10) : 1000000;
+
+    struct u64_spsc *spsc_ping = u64_spsc_create(CAPACITY);
+    struct u64_spsc *spsc_pong = u64_spsc_create(CAPACITY);
+    struct locked_fqueue locked_ping = {PTHREAD_MUTEX_INITIALIZER, u64_fqueue_create(CAPACITY)};
+    struct locked_fqueue locked_pong = {PTHREAD_MUTEX_INITIALIZER, u64_fqueue_create(CAPACITY)};
+
+    if (!spsc_ping || !spsc_pong || !locked_ping.q || !locked_pong.q) {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+
+    printf("%llu values, capacity %d\n", (unsigned long long)value_count, CAPACITY);
+
+    uint64_t checksum = 0;
+    pthread_t thread;
+
+    /* ping-pong */
+    {
+        struct spsc_pair p = {spsc_ping, spsc_pong};
+        pthread_create(&thread, NULL, spsc_echo, &p);
+
+        const double start = now_s();
+        uint64_t value = 0;
+        for (uint64_t i = 0; i < value_count; i++) {
+            uint32_t spins = 0;
+            while (!u64_spsc_try_enqueue(spsc_ping, value)) {
+                backoff(&spins);
+            }
+            while (!u64_spsc_try_dequeue(spsc_pong, &value)) {
+                backoff(&spins);
+            }
+        }
+        const double elapsed = now_s() - start;
+
+        pthread_join(thread, NULL);
+        checksum += value;
+        printf("ping-pong   spsc:   %8.1f ns round trip\n", elapsed * 1e9 / (double)value_count);
+    }
+    {
+        struct locked_pair p = {&locked_ping, &locked_pong};
+        pthread_create(&thread, NULL, locked_echo, &p);
+
+        const double start = now_s();
+        uint64_t value = 0;
+        for (uint64_t i = 0; i < value_count; i++) {
+            uint32_t spins = 0;
+            while (!locked_try_enqueue(&locked_ping, value)) {
+                backoff(&spins);
+            }
+            while (!locked_try_dequeue(&locked_pong, &value)) {
+                backoff(&spins);
+            }
+        }
+        const double elapsed = now_s() - start;
+
+        pthread_join(thread, NULL);
+        checksum += value;
+        printf("ping-pong   mutex:  %8.1f ns round trip\n", elapsed * 1e9 / (double)value_count);
+    }
+
+    /* throughput */
+    {
+        pthread_create(&thread, NULL, spsc_produce, spsc_ping);
+
+        const double start = now_s();
+        uint32_t spins = 0;
+        for (uint64_t i = 0; i < value_count; i++) {
+            uint64_t value;
+            while (!u64_spsc_try_dequeue(spsc_ping, &value)) {
+                backoff(&spins);
+            }
+            checksum += value;
+        }
+        const double elapsed = now_s() - start;
+
+        pthread_join(thread, NULL);
+        printf("throughput  spsc:   %8.2f Mvalues/s\n", (double)value_count / elapsed * 1e-6);
+    }
+    {
+        pthread_create(&thread, NULL, locked_produce, &locked_ping);
+
+        const double start = now_s();
+        uint32_t spins = 0;
+        for (uint64_t i = 0; i < value_count; i++) {
+            uint64_t value;
+            while (!locked_try_dequeue(&locked_ping, &value)) {
+                backoff(&spins);
+            }
+            checksum += value;
+        }
+        const double elapsed = now_s() - start;
+
+        pthread_join(thread, NULL);
+        printf("throughput  mutex:  %8.2f Mvalues/s\n", (double)value_count / elapsed * 1e-6);
+    }
+
+    printf("(checksum %llu)\n", (unsigned long long)checksum);
+
+    u64_fqueue_destroy(locked_pong.q);
+    u64_fqueue_destroy(locked_ping.q);
+    u64_spsc_destroy(spsc_pong);
+    u64_spsc_destroy(spsc_ping);
+
+    return 0;
+}
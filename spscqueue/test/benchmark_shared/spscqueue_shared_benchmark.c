@@ -0,0 +1,262 @@
+// Compares passing 32-byte ticks through SPSC queues between two threads of a
+// process, and between two processes through shared memory segments:
+//  - ping-pong: a tick is sent back and forth through two queues, measuring
+//    the round-trip latency.
+//  - throughput: one side enqueues as fast as it can and the other dequeues.
+// Run with `make bench`. Pin the processes to two cores for stable numbers,
+// e.g. `taskset -c 2,3 ./a.out 10000000`.
+//
+// usage: ./a.out [number of ticks]
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+struct tick {
+    uint64_t timestamp_ns;
+    uint64_t instrument_id;
+    double price;
+    double quantity;
+};
+
+#define NAME       tick_spsc
+#define VALUE_TYPE struct tick
+#define SHARED
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "spscqueue_template.h"
+
+#define CAPACITY (1024)
+
+/* spin for a while before giving up the core, such that a single core machine still makes progress */
+#define SPIN_LIMIT (1024)
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static inline void backoff(uint32_t *spins)
+{
+    if (++*spins == SPIN_LIMIT) {
+        *spins = 0;
+        sched_yield();
+    }
+}
+
+static uint64_t tick_count;
+
+struct queue_pair {
+    struct tick_spsc *ping, *pong;
+};
+
+/* the other side: echoes ticks in ping-pong, or consumes them in throughput. returns a checksum */
+static uint64_t echo(struct tick_spsc *ping, struct tick_spsc *pong)
+{
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < tick_count; i++) {
+        struct tick t;
+        uint32_t spins = 0;
+        while (!tick_spsc_try_dequeue(ping, &t)) {
+            backoff(&spins);
+        }
+        t.instrument_id++;
+        while (!tick_spsc_try_enqueue(pong, t)) {
+            backoff(&spins);
+        }
+        sum += t.instrument_id;
+    }
+    return sum;
+}
+
+static uint64_t consume(struct tick_spsc *q)
+{
+    uint64_t sum = 0;
+    uint32_t spins = 0;
+    for (uint64_t i = 0; i < tick_count; i++) {
+        struct tick t;
+        while (!tick_spsc_try_dequeue(q, &t)) {
+            backoff(&spins);
+        }
+        sum += t.instrument_id;
+    }
+    return sum;
+}
+
+/* returns the time per round trip */
+static double ping_pong(struct tick_spsc *ping, struct tick_spsc *pong)
+{
+    struct tick t = {0, 0, 100.0, 1.0};
+
+    const double start = now_s();
+    for (uint64_t i = 0; i < tick_count; i++) {
+        uint32_t spins = 0;
+        t.timestamp_ns = i;
+        while (!tick_spsc_try_enqueue(ping, t)) {
+            backoff(&spins);
+        }
+        while (!tick_spsc_try_dequeue(pong, &t)) {
+            backoff(&spins);
+        }
+    }
+    return (now_s() - start) / (double)tick_count;
+}
+
+/* returns the time until the last tick is enqueued. the consumer is joined afterwards */
+static double produce(struct tick_spsc *q)
+{
+    uint32_t spins = 0;
+
+    const double start = now_s();
+    for (uint64_t i = 0; i < tick_count; i++) {
+        const struct tick t = {i, i, 100.0, 1.0};
+        while (!tick_spsc_try_enqueue(q, t)) {
+            backoff(&spins);
+        }
+    }
+    return now_s() - start;
+}
+
+// threads: {{{
+
+static void *echo_thread(void *arg)
+{
+    struct queue_pair *p = arg;
+    echo(p->ping, p->pong);
+    return NULL;
+}
+
+static void *consume_thread(void *arg)
+{
+    consume(arg);
+    return NULL;
+}
+
+static void run_threads(double *round_trip_ptr, double *elapsed_ptr)
+{
+    struct tick_spsc *ping = tick_spsc_create(CAPACITY);
+    struct tick_spsc *pong = tick_spsc_create(CAPACITY);
+    if (!ping || !pong) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+
+    pthread_t thread;
+    struct queue_pair p = {ping, pong};
+
+    pthread_create(&thread, NULL, echo_thread, &p);
+    *round_trip_ptr = ping_pong(ping, pong);
+    pthread_join(thread, NULL);
+
+    pthread_create(&thread, NULL, consume_thread, ping);
+    const double start = now_s();
+    produce(ping);
+    pthread_join(thread, NULL);
+    *elapsed_ptr = now_s() - start;
+
+    tick_spsc_destroy(pong);
+    tick_spsc_destroy(ping);
+}
+
+// }}}
+
+// processes: {{{
+
+static pid_t spawn(const char *ping_name, const char *pong_name)
+{
+    const pid_t pid = fork();
+
+    if (pid != 0) {
+        return pid;
+    }
+
+    struct tick_spsc *ping = tick_spsc_attach_shared(ping_name);
+    struct tick_spsc *pong = tick_spsc_attach_shared(pong_name);
+    if (!ping || !pong) {
+        _exit(1);
+    }
+    echo(ping, pong);
+    consume(ping);
+
+    tick_spsc_detach_shared(pong);
+    tick_spsc_detach_shared(ping);
+    _exit(0);
+}
+
+static void run_processes(double *round_trip_ptr, double *elapsed_ptr)
+{
+    char ping_name[64], pong_name[64];
+    snprintf(ping_name, sizeof(ping_name), "/spscqueue_bench_ping_%ld", (long)getpid());
+    snprintf(pong_name, sizeof(pong_name), "/spscqueue_bench_pong_%ld", (long)getpid());
+
+    struct tick_spsc *ping = tick_spsc_create_shared(ping_name, CAPACITY);
+    struct tick_spsc *pong = tick_spsc_create_shared(pong_name, CAPACITY);
+    if (!ping || !pong) {
+        fprintf(stderr, "shared memory segments could not be created\n");
+        exit(1);
+    }
+
+    const pid_t pid = spawn(ping_name, pong_name);
+    if (pid < 0) {
+        fprintf(stderr, "fork failed\n");
+        exit(1);
+    }
+
+    /* the echo process has mapped the segments once it echoes */
+    *round_trip_ptr = ping_pong(ping, pong);
+
+    /* the consumer is done once the queue is empty, after the last tick */
+    const double start = now_s();
+    produce(ping);
+    uint32_t spins = 0;
+    while (!tick_spsc_is_empty(ping)) {
+        backoff(&spins);
+    }
+    *elapsed_ptr = now_s() - start;
+
+    int status;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "consumer process failed\n");
+        exit(1);
+    }
+
+    tick_spsc_unlink_shared(pong_name);
+    tick_spsc_unlink_shared(ping_name);
+    tick_spsc_detach_shared(pong);
+    tick_spsc_detach_shared(ping);
+}
+
+// }}}
+
+int main(int argc, char **argv)
+{
+    tick_count = argc > 1 ? strtoull(argv[1], NULL, 10) : 1000000;
+    if (tick_count == 0) {
+        return 1;
+    }
+
+    printf("%llu ticks of %zu bytes, capacity %d\n", (unsigned long long)tick_count, sizeof(struct tick), CAPACITY);
+
+    double thread_round_trip, thread_elapsed;
+    double process_round_trip, process_elapsed;
+
+    run_threads(&thread_round_trip, &thread_elapsed);
+    run_processes(&process_round_trip, &process_elapsed);
+
+    printf("ping-pong    threads:   %8.1f ns round trip\n", thread_round_trip * 1e9);
+    printf("ping-pong    processes: %8.1f ns round trip\n", process_round_trip * 1e9);
+    printf("throughput   threads:   %8.2f Mticks/s\n", (double)tick_count / thread_elapsed * 1e-6);
+    printf("throughput   processes: %8.2f Mticks/s\n", (double)tick_count / process_elapsed * 1e-6);
+
+    return 0;
+}
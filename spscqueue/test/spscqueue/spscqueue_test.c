@@ -0,0 +1,268 @@
+/*
+    Test cases:
+    - Creation:
+      - Zero / overly large capacities are rejected
+      - Capacity is rounded up to a power of two
+      - Producer, consumer and values are on separate cache lines
+    - Single thread:
+      - try_enqueue fails exactly when full, try_dequeue / try_peek exactly when empty
+      - FIFO order across many wrap-arounds of the ring
+      - count / is_empty / is_full
+      - Wrap-around of the free-running indices at the maximum of SIZE_TYPE
+    - Two threads:
+      - Every value is received exactly once and in order, with a small capacity
+    - Shared memory:
+      - Creating an existing name fails, attaching a missing name fails
+      - Values enqueued through one mapping are dequeued through another
+      - Attaching fails for another VALUE_TYPE, or before the magic number is stored
+      - Every value is received exactly once and in order by another process
+*/
+
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define NAME       u32_spsc
+#define VALUE_TYPE uint32_t
+#define SHARED
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "spscqueue_template.h"
+
+#define NAME       u64_spsc
+#define VALUE_TYPE uint64_t
+#define SHARED
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "spscqueue_template.h"
+
+#define N (1000000)
+
+static void creation_test(void)
+{
+    assert(u32_spsc_create(0) == NULL);
+    assert(u32_spsc_create(UINT32_MAX / 2 + 2) == NULL);
+
+    struct u32_spsc *q = u32_spsc_create(5);
+    assert(q != NULL);
+    assert(q->capacity == 8);
+    assert((uintptr_t)q % SPSCQUEUE_CACHE_LINE_SIZE == 0);
+    assert(u32_spsc_count(q) == 0);
+    u32_spsc_destroy(q);
+
+    assert(offsetof(struct u32_spsc, begin_index) - offsetof(struct u32_spsc, end_index) >= SPSCQUEUE_CACHE_LINE_SIZE);
+    assert(offsetof(struct u32_spsc, capacity) - offsetof(struct u32_spsc, begin_index) >= SPSCQUEUE_CACHE_LINE_SIZE);
+    assert(offsetof(struct u32_spsc, values) % SPSCQUEUE_CACHE_LINE_SIZE == 0);
+}
+
+static void single_thread_test(void)
+{
+    struct u32_spsc *q = u32_spsc_create(4);
+    assert(q != NULL);
+
+    uint32_t value = 0;
+    assert(u32_spsc_is_empty(q));
+    assert(!u32_spsc_try_dequeue(q, &value));
+    assert(!u32_spsc_try_peek(q, &value));
+
+    uint32_t next_in = 0, next_out = 0;
+    for (uint32_t round = 0; round < 100; round++) {
+        /* fill up, with a varying starting position in the ring */
+        while (u32_spsc_try_enqueue(q, next_in)) {
+            next_in++;
+        }
+        assert(u32_spsc_is_full(q));
+        assert(u32_spsc_count(q) == 4);
+
+        const uint32_t n = round % 4 + 1;
+        for (uint32_t i = 0; i < n; i++) {
+            assert(u32_spsc_try_peek(q, &value) && value == next_out);
+            assert(u32_spsc_try_dequeue(q, &value) && value == next_out);
+            next_out++;
+        }
+        assert(!u32_spsc_is_full(q));
+        assert(u32_spsc_count(q) == 4 - n);
+    }
+
+    while (u32_spsc_try_dequeue(q, &value)) {
+        assert(value == next_out++);
+    }
+    assert(next_out == next_in);
+    assert(u32_spsc_is_empty(q));
+
+    u32_spsc_destroy(q);
+}
+
+static void index_wrap_around_test(void)
+{
+    struct u32_spsc *q = u32_spsc_create(4);
+    assert(q != NULL);
+
+    /* an empty queue whose indices are about to wrap around */
+    atomic_store(&q->begin_index, UINT32_MAX - 1);
+    atomic_store(&q->end_index, UINT32_MAX - 1);
+    q->cached_begin_index = q->cached_end_index = UINT32_MAX - 1;
+
+    for (uint32_t i = 0; i < 4; i++) {
+        assert(u32_spsc_try_enqueue(q, i));
+    }
+    assert(!u32_spsc_try_enqueue(q, 4));
+    assert(u32_spsc_count(q) == 4);
+    assert(atomic_load(&q->end_index) == 2);
+
+    uint32_t value;
+    for (uint32_t i = 0; i < 4; i++) {
+        assert(u32_spsc_try_dequeue(q, &value) && value == i);
+    }
+    assert(u32_spsc_is_empty(q));
+    assert(!u32_spsc_try_dequeue(q, &value));
+
+    u32_spsc_destroy(q);
+}
+
+static void *producer(void *arg)
+{
+    struct u32_spsc *q = arg;
+
+    for (uint32_t i = 0; i < N; i++) {
+        while (!u32_spsc_try_enqueue(q, i)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void two_threads_test(void)
+{
+    struct u32_spsc *q = u32_spsc_create(64);
+    assert(q != NULL);
+
+    pthread_t thread;
+    assert(pthread_create(&thread, NULL, producer, q) == 0);
+
+    for (uint32_t i = 0; i < N; i++) {
+        uint32_t value;
+        while (!u32_spsc_try_dequeue(q, &value)) {
+            sched_yield();
+        }
+        assert(value == i);
+    }
+
+    assert(pthread_join(thread, NULL) == 0);
+    assert(u32_spsc_is_empty(q));
+
+    u32_spsc_destroy(q);
+}
+
+static void shared_test(void)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "/spscqueue_test_%ld", (long)getpid());
+
+    assert(u32_spsc_attach_shared(name) == NULL);
+
+    struct u32_spsc *a = u32_spsc_create_shared(name, 5);
+    assert(a != NULL);
+    assert(a->capacity == 8);
+    assert((uintptr_t)a % SPSCQUEUE_CACHE_LINE_SIZE == 0);
+    assert(u32_spsc_create_shared(name, 5) == NULL);
+
+    struct u32_spsc *b = u32_spsc_attach_shared(name);
+    assert(b != NULL && b != a);
+    assert(b->capacity == 8);
+
+    for (uint32_t i = 0; i < 8; i++) {
+        assert(u32_spsc_try_enqueue(a, i));
+    }
+    assert(!u32_spsc_try_enqueue(a, 8));
+    for (uint32_t i = 0; i < 8; i++) {
+        uint32_t value;
+        assert(u32_spsc_try_dequeue(b, &value) && value == i);
+    }
+    assert(u32_spsc_is_empty(a));
+
+    /* another value type */
+    assert(u64_spsc_attach_shared(name) == NULL);
+
+    /* not (yet) initialized */
+    struct u32_spsc_shared_header *header =
+        (struct u32_spsc_shared_header *)((unsigned char *)a - SPSCQUEUE_CALC_SHARED_OFFSET(u32_spsc));
+    atomic_store(&header->magic, 0);
+    assert(u32_spsc_attach_shared(name) == NULL);
+    atomic_store(&header->magic, SPSCQUEUE_SHARED_MAGIC);
+
+    assert(u32_spsc_unlink_shared(name));
+    assert(!u32_spsc_unlink_shared(name));
+    assert(u32_spsc_attach_shared(name) == NULL);
+
+    /* still usable after the name is removed */
+    assert(u32_spsc_try_enqueue(a, 42));
+    uint32_t value;
+    assert(u32_spsc_try_dequeue(b, &value) && value == 42);
+
+    u32_spsc_detach_shared(b);
+    u32_spsc_detach_shared(a);
+}
+
+static void two_processes_test(void)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "/spscqueue_test_%ld", (long)getpid());
+
+    struct u32_spsc *q = u32_spsc_create_shared(name, 64);
+    assert(q != NULL);
+
+    const pid_t pid = fork();
+    assert(pid >= 0);
+
+    if (pid == 0) {
+        struct u32_spsc *child_q = u32_spsc_attach_shared(name);
+        if (child_q == NULL) {
+            _exit(1);
+        }
+        for (uint32_t i = 0; i < N; i++) {
+            uint32_t value;
+            while (!u32_spsc_try_dequeue(child_q, &value)) {
+                sched_yield();
+            }
+            if (value != i) {
+                _exit(1);
+            }
+        }
+        u32_spsc_detach_shared(child_q);
+        _exit(0);
+    }
+
+    for (uint32_t i = 0; i < N; i++) {
+        while (!u32_spsc_try_enqueue(q, i)) {
+            sched_yield();
+        }
+    }
+
+    int status;
+    assert(waitpid(pid, &status, 0) == pid);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    assert(u32_spsc_is_empty(q));
+
+    assert(u32_spsc_unlink_shared(name));
+    u32_spsc_detach_shared(q);
+}
+
+int main(void)
+{
+    creation_test();
+    single_thread_test();
+    index_wrap_around_test();
+    two_threads_test();
+    shared_test();
+    two_processes_test();
+}
@@ -0,0 +1,50 @@
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "threadpool.h"
+
+#define WORKER_COUNT (4)
+#define VALUE_COUNT  (100000)
+
+static uint64_t values[VALUE_COUNT];
+static _Atomic(uint64_t) sum;
+
+static void fill(struct threadpool_worker *worker, size_t begin, size_t end, void *arg)
+{
+    (void)worker;
+    (void)arg;
+    for (size_t i = begin; i < end; i++) {
+        values[i] = i + 1;
+    }
+}
+
+static void add_up(struct threadpool_worker *worker, size_t begin, size_t end, void *arg)
+{
+    (void)worker;
+    (void)arg;
+    uint64_t partial_sum = 0;
+    for (size_t i = begin; i < end; i++) {
+        partial_sum += values[i];
+    }
+    atomic_fetch_add(&sum, partial_sum); // once per range of at most 1024 values
+}
+
+int main(void)
+{
+    struct threadpool *pool = threadpool_create(WORKER_COUNT, 64);
+    if (!pool) {
+        assert(false);
+    }
+
+    /* called from outside the pool, so no worker is given. returns when all ranges are done */
+    threadpool_parallel_for(pool, NULL, 0, VALUE_COUNT, 1024, fill, NULL);
+    threadpool_parallel_for(pool, NULL, 0, VALUE_COUNT, 1024, add_up, NULL);
+
+    assert(atomic_load(&sum) == (uint64_t)VALUE_COUNT * (VALUE_COUNT + 1) / 2);
+    printf("sum: %llu\n", (unsigned long long)atomic_load(&sum));
+
+    threadpool_destroy(pool); // the workers sleep until then
+}
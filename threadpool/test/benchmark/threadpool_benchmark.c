@@ -0,0 +1,226 @@
+// Scaling benchmark of the thread pool, for 1 to 8 workers:
+//  - fork-join: fib(n), spawning both halves and waiting on a latch until
+//    n <= CUTOFF.
+//  - sharded fhashtable build: random keys, partitioned by hash into
+//    SHARD_COUNT shards beforehand, are inserted into one fhashtable per
+//    shard, with a parallel for over the shards.
+// Reports the speedup over running the same work serially. Run on a multicore
+// machine to see the scaling.
+// Run with `make bench`.
+//
+// usage: ./a.out [n] [number of keys]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "murmurhash.h"
+#include "threadpool.h"
+
+#define NAME               u32_ht
+#define KEY_TYPE           uint32_t
+#define VALUE_TYPE         uint32_t
+#define KEY_IS_EQUAL(a, b) ((a) == (b))
+#define HASH_FUNCTION(key) (murmur3_32((uint8_t *)&(key), sizeof(uint32_t), 0))
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fhashtable_template.h"
+
+#define CUTOFF           (12)
+#define MAX_WORKER_COUNT (8)
+#define SHARD_COUNT      (64)
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// fork-join: {{{
+
+struct fib_job {
+    int n;
+    uint64_t result;
+    struct threadpool_latch *done;
+};
+
+static uint64_t fib_serial(const int n)
+{
+    return n < 2 ? (uint64_t)n : fib_serial(n - 1) + fib_serial(n - 2);
+}
+
+static void fib_task(struct threadpool_worker *worker, void *arg)
+{
+    struct fib_job *job = arg;
+
+    if (job->n <= CUTOFF) {
+        job->result = fib_serial(job->n);
+    }
+    else {
+        struct threadpool_latch latch;
+        threadpool_latch_init(&latch, 2);
+
+        struct fib_job children[2] = {{job->n - 1, 0, &latch}, {job->n - 2, 0, &latch}};
+        struct threadpool_task tasks[2] = {{fib_task, &children[0]}, {fib_task, &children[1]}};
+
+        threadpool_spawn(worker, &tasks[1]);
+        threadpool_spawn(worker, &tasks[0]);
+        threadpool_wait(worker, &latch);
+
+        job->result = children[0].result + children[1].result;
+    }
+    threadpool_latch_count_down(job->done);
+}
+
+static double fib_parallel(struct threadpool *pool, const int n, uint64_t *result_ptr)
+{
+    const double start = now_s();
+
+    struct threadpool_latch latch;
+    threadpool_latch_init(&latch, 1);
+    struct fib_job root = {n, 0, &latch};
+    struct threadpool_task task = {fib_task, &root};
+
+    if (!threadpool_submit(pool, &task)) {
+        fprintf(stderr, "injection queue full\n");
+        exit(EXIT_FAILURE);
+    }
+    threadpool_wait(NULL, &latch);
+
+    *result_ptr = root.result;
+    return now_s() - start;
+}
+
+// }}}
+
+// sharded fhashtable build: {{{
+
+struct shards {
+    uint32_t *keys;                       // grouped by shard
+    uint32_t offsets[SHARD_COUNT + 1];    // keys of shard i are in [offsets[i], offsets[i + 1])
+    struct u32_ht *tables[SHARD_COUNT];
+};
+
+static inline uint32_t shard_of(const uint32_t key)
+{
+    return (uint32_t)(((uint64_t)key * 0x9E3779B1U) >> 26) % SHARD_COUNT;
+}
+
+static void shards_init(struct shards *s, const uint32_t key_count)
+{
+    uint32_t *keys = malloc(key_count * sizeof(uint32_t));
+    s->keys = malloc(key_count * sizeof(uint32_t));
+    if (!keys || !s->keys) {
+        fprintf(stderr, "out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    uint32_t state = 2463534242U;
+    uint32_t counts[SHARD_COUNT] = {0};
+    for (uint32_t i = 0; i < key_count; i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        keys[i] = state;
+        counts[shard_of(state)]++;
+    }
+
+    s->offsets[0] = 0;
+    for (uint32_t i = 0; i < SHARD_COUNT; i++) {
+        s->offsets[i + 1] = s->offsets[i] + counts[i];
+        counts[i] = s->offsets[i];
+    }
+    for (uint32_t i = 0; i < key_count; i++) {
+        s->keys[counts[shard_of(keys[i])]++] = keys[i];
+    }
+    free(keys);
+}
+
+static void build_shards(struct threadpool_worker *worker, size_t begin, size_t end, void *arg)
+{
+    (void)worker;
+    struct shards *s = arg;
+
+    for (size_t shard = begin; shard < end; shard++) {
+        const uint32_t count = s->offsets[shard + 1] - s->offsets[shard];
+        struct u32_ht *ht = u32_ht_create(count > 0 ? count : 1);
+        if (!ht) {
+            fprintf(stderr, "out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+        for (uint32_t i = s->offsets[shard]; i < s->offsets[shard + 1]; i++) {
+            u32_ht_update(ht, s->keys[i], i);
+        }
+        s->tables[shard] = ht;
+    }
+}
+
+static uint32_t shards_count_and_free(struct shards *s)
+{
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < SHARD_COUNT; i++) {
+        count += s->tables[i]->count;
+        u32_ht_destroy(s->tables[i]);
+        s->tables[i] = NULL;
+    }
+    return count;
+}
+
+// }}}
+
+int main(int argc, char **argv)
+{
+    const int n = argc > 1 ? atoi(argv[1]) : 32;
+    const long key_count = argc > 2 ? atol(argv[2]) : 1000000;
+    if (n <= CUTOFF || n > 60 || key_count <= 0 || key_count > INT32_MAX) {
+        fprintf(stderr, "n must be in (%d, 60], and the number of keys in (0, %d]\n", CUTOFF, INT32_MAX);
+        return EXIT_FAILURE;
+    }
+
+    double start = now_s();
+    const uint64_t fib_expected = fib_serial(n);
+    const double fib_serial_s = now_s() - start;
+
+    static struct shards s;
+    shards_init(&s, (uint32_t)key_count);
+
+    start = now_s();
+    build_shards(NULL, 0, SHARD_COUNT, &s);
+    const double build_serial_s = now_s() - start;
+    const uint32_t build_expected = shards_count_and_free(&s);
+
+    printf("fib(%d), cutoff %d, serial: %.3f s\n", n, CUTOFF, fib_serial_s);
+    printf("fhashtable build of %ld keys in %d shards, serial: %.3f s\n", key_count, SHARD_COUNT, build_serial_s);
+    printf("%8s %25s %25s\n", "workers", "fib s (speedup)", "build s (speedup)");
+
+    for (uint32_t worker_count = 1; worker_count <= MAX_WORKER_COUNT; worker_count *= 2) {
+        struct threadpool *pool = threadpool_create(worker_count, 64);
+        if (!pool) {
+            fprintf(stderr, "failed to create the pool\n");
+            return EXIT_FAILURE;
+        }
+
+        uint64_t fib_result;
+        const double fib_s = fib_parallel(pool, n, &fib_result);
+
+        start = now_s();
+        threadpool_parallel_for(pool, NULL, 0, SHARD_COUNT, 1, build_shards, &s);
+        const double build_s = now_s() - start;
+        const uint32_t build_result = shards_count_and_free(&s);
+
+        threadpool_destroy(pool);
+
+        if (fib_result != fib_expected || build_result != build_expected) {
+            fprintf(stderr, "wrong result with %u workers\n", worker_count);
+            return EXIT_FAILURE;
+        }
+
+        printf("%8u %17.3f (%5.2fx) %17.3f (%5.2fx)\n", worker_count, fib_s, fib_serial_s / fib_s, build_s,
+               build_serial_s / build_s);
+    }
+
+    free(s.keys);
+}
@@ -0,0 +1,296 @@
+/*
+    Test cases:
+    - Creation:
+      - Zero workers / zero injection capacity are rejected
+      - Creating and destroying an idle pool
+    - Submit:
+      - Every submitted task runs exactly once, and the outside thread wakes up when the latch reaches zero
+      - Submitting to a full injection queue fails
+    - Fork-join:
+      - Recursive fib, spawning and waiting within tasks
+    - Parallel for:
+      - Every index is covered exactly once, for various ranges and grain sizes
+      - Empty ranges
+      - Nested in a task
+    - Sleeping:
+      - Idle workers go to sleep, and are woken by new work
+*/
+
+#include <assert.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "threadpool.h"
+
+#define WORKER_COUNT (4)
+
+static void sleep_ms(const long ms)
+{
+    const struct timespec ts = {ms / 1000, (ms % 1000) * 1000000};
+    nanosleep(&ts, NULL);
+}
+
+static void creation_test(void)
+{
+    assert(threadpool_create(0, 16) == NULL);
+    assert(threadpool_create(4, 0) == NULL);
+
+    struct threadpool *pool = threadpool_create(WORKER_COUNT, 16);
+    assert(pool != NULL);
+    assert(pool->worker_count == WORKER_COUNT);
+    assert((uintptr_t)pool % THREADPOOL_CACHE_LINE_SIZE == 0);
+    assert(sizeof(struct threadpool_worker) % THREADPOOL_CACHE_LINE_SIZE == 0);
+    threadpool_destroy(pool);
+}
+
+// submit: {{{
+
+struct counted_job {
+    _Atomic(uint32_t) *run_count_ptr;
+    struct threadpool_latch *latch;
+};
+
+static void counted_task(struct threadpool_worker *worker, void *arg)
+{
+    assert(worker != NULL);
+    struct counted_job *job = arg;
+
+    atomic_fetch_add(job->run_count_ptr, 1);
+    threadpool_latch_count_down(job->latch);
+}
+
+static void submit_test(void)
+{
+    enum { TASK_COUNT = 1000 };
+
+    struct threadpool *pool = threadpool_create(WORKER_COUNT, 64);
+    assert(pool != NULL);
+
+    static _Atomic(uint32_t) run_counts[TASK_COUNT];
+    static struct counted_job jobs[TASK_COUNT];
+    static struct threadpool_task tasks[TASK_COUNT];
+    struct threadpool_latch latch;
+    threadpool_latch_init(&latch, TASK_COUNT);
+
+    for (uint32_t i = 0; i < TASK_COUNT; i++) {
+        atomic_init(&run_counts[i], 0);
+        jobs[i] = (struct counted_job){&run_counts[i], &latch};
+        tasks[i] = (struct threadpool_task){counted_task, &jobs[i]};
+
+        while (!threadpool_submit(pool, &tasks[i])) {
+            sched_yield();
+        }
+    }
+    threadpool_wait(NULL, &latch);
+
+    for (uint32_t i = 0; i < TASK_COUNT; i++) {
+        assert(atomic_load(&run_counts[i]) == 1);
+    }
+    threadpool_destroy(pool);
+}
+
+static void blocked_task(struct threadpool_worker *worker, void *arg)
+{
+    (void)worker;
+    _Atomic(bool) *release_ptr = arg;
+
+    while (!atomic_load(release_ptr)) {
+        sched_yield();
+    }
+}
+
+static void full_injection_queue_test(void)
+{
+    struct threadpool *pool = threadpool_create(1, 2);
+    assert(pool != NULL);
+
+    /* keep the only worker busy, such that the injection queue fills up */
+    _Atomic(bool) release = false;
+    struct threadpool_task blocker = {blocked_task, &release};
+    assert(threadpool_submit(pool, &blocker));
+    while (internal_threadpool_queue_count(pool->injection_queue) != 0) {
+        sched_yield();
+    }
+
+    _Atomic(uint32_t) run_count = 0;
+    struct threadpool_latch latch;
+    threadpool_latch_init(&latch, 2);
+    struct counted_job job = {&run_count, &latch};
+    struct threadpool_task tasks[3] = {{counted_task, &job}, {counted_task, &job}, {counted_task, &job}};
+
+    assert(threadpool_submit(pool, &tasks[0]));
+    assert(threadpool_submit(pool, &tasks[1]));
+    assert(!threadpool_submit(pool, &tasks[2]));
+
+    atomic_store(&release, true);
+    threadpool_wait(NULL, &latch);
+    assert(atomic_load(&run_count) == 2);
+
+    threadpool_destroy(pool);
+}
+
+// }}}
+
+// fork-join: {{{
+
+struct fib_job {
+    int n;
+    uint64_t result;
+    struct threadpool_latch *done;
+};
+
+static void fib_task(struct threadpool_worker *worker, void *arg)
+{
+    struct fib_job *job = arg;
+
+    if (job->n < 2) {
+        job->result = (uint64_t)job->n;
+    }
+    else {
+        struct threadpool_latch latch;
+        threadpool_latch_init(&latch, 2);
+
+        struct fib_job children[2] = {{job->n - 1, 0, &latch}, {job->n - 2, 0, &latch}};
+        struct threadpool_task tasks[2] = {{fib_task, &children[0]}, {fib_task, &children[1]}};
+
+        threadpool_spawn(worker, &tasks[0]);
+        threadpool_spawn(worker, &tasks[1]);
+        threadpool_wait(worker, &latch);
+
+        job->result = children[0].result + children[1].result;
+    }
+    threadpool_latch_count_down(job->done);
+}
+
+static void fork_join_test(void)
+{
+    struct threadpool *pool = threadpool_create(WORKER_COUNT, 16);
+    assert(pool != NULL);
+
+    struct threadpool_latch latch;
+    threadpool_latch_init(&latch, 1);
+    struct fib_job root = {20, 0, &latch};
+    struct threadpool_task task = {fib_task, &root};
+
+    assert(threadpool_submit(pool, &task));
+    threadpool_wait(NULL, &latch);
+    assert(root.result == 6765);
+
+    threadpool_destroy(pool);
+}
+
+// }}}
+
+// parallel for: {{{
+
+struct cover_job {
+    _Atomic(uint8_t) *seen;
+    size_t grain;
+};
+
+static void cover_range(struct threadpool_worker *worker, size_t begin, size_t end, void *arg)
+{
+    (void)worker;
+    struct cover_job *job = arg;
+
+    assert(begin < end && end - begin <= job->grain);
+    for (size_t i = begin; i < end; i++) {
+        atomic_fetch_add(&job->seen[i], 1);
+    }
+}
+
+static void check_cover(struct threadpool *pool, struct threadpool_worker *worker, const size_t begin,
+                        const size_t end, const size_t grain)
+{
+    _Atomic(uint8_t) *seen = calloc(end + 1, sizeof(_Atomic(uint8_t)));
+    assert(seen != NULL);
+
+    struct cover_job job = {seen, grain};
+    threadpool_parallel_for(pool, worker, begin, end, grain, cover_range, &job);
+
+    for (size_t i = 0; i <= end; i++) {
+        assert(atomic_load(&seen[i]) == (i >= begin && i < end ? 1 : 0));
+    }
+    free(seen);
+}
+
+static void nested_task(struct threadpool_worker *worker, void *arg)
+{
+    struct threadpool_latch *latch = arg;
+
+    check_cover(worker->pool, worker, 3, 5000, 7);
+    threadpool_latch_count_down(latch);
+}
+
+static void parallel_for_test(void)
+{
+    struct threadpool *pool = threadpool_create(WORKER_COUNT, 16);
+    assert(pool != NULL);
+
+    const size_t grains[] = {1, 2, 3, 64, 1000, 100000};
+    const size_t ends[] = {1, 2, 3, 10, 1000, 12345};
+
+    for (size_t i = 0; i < sizeof(grains) / sizeof(grains[0]); i++) {
+        for (size_t j = 0; j < sizeof(ends) / sizeof(ends[0]); j++) {
+            check_cover(pool, NULL, 0, ends[j], grains[i]);
+            check_cover(pool, NULL, ends[j] / 2, ends[j], grains[i]);
+        }
+    }
+
+    /* empty ranges: fn is not called */
+    check_cover(pool, NULL, 5, 5, 1);
+    check_cover(pool, NULL, 6, 5, 1);
+
+    struct threadpool_latch latch;
+    threadpool_latch_init(&latch, 2);
+    struct threadpool_task tasks[2] = {{nested_task, &latch}, {nested_task, &latch}};
+    assert(threadpool_submit(pool, &tasks[0]));
+    assert(threadpool_submit(pool, &tasks[1]));
+    threadpool_wait(NULL, &latch);
+
+    threadpool_destroy(pool);
+}
+
+// }}}
+
+static void sleeping_test(void)
+{
+    struct threadpool *pool = threadpool_create(WORKER_COUNT, 16);
+    assert(pool != NULL);
+
+    for (uint32_t round = 0; round < 3; round++) {
+        /* idle workers end up sleeping */
+        for (uint32_t i = 0; i < 1000 && atomic_load(&pool->sleeping_count) != WORKER_COUNT; i++) {
+            sleep_ms(1);
+        }
+        assert(atomic_load(&pool->sleeping_count) == WORKER_COUNT);
+
+        /* and are woken by new work */
+        _Atomic(uint32_t) run_count = 0;
+        struct threadpool_latch latch;
+        threadpool_latch_init(&latch, 1);
+        struct counted_job job = {&run_count, &latch};
+        struct threadpool_task task = {counted_task, &job};
+
+        assert(threadpool_submit(pool, &task));
+        threadpool_wait(NULL, &latch);
+        assert(atomic_load(&run_count) == 1);
+    }
+
+    threadpool_destroy(pool);
+}
+
+int main(void)
+{
+    creation_test();
+    submit_test();
+    full_injection_queue_test();
+    fork_join_test();
+    parallel_for_test();
+    sleeping_test();
+}
@@ -0,0 +1,654 @@
+/*  threadpool.h
+ *
+ *  Copyright (C) 2025 abxh
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *  See the file LICENSE included with this distribution for more
+ *  information. */
+
+/**
+ * @file threadpool.h
+ * @brief Work-stealing thread pool for fork-join parallelism
+ *
+ * A fixed number of worker threads run tasks. Each worker has a deque defined
+ * with `wsdeque_template.h`:
+ *      @li Tasks spawned by a task are pushed to the deque of its worker, and
+ *          run by that worker in LIFO order.
+ *      @li Idle workers steal the oldest tasks from the deques of others.
+ *      @li Tasks submitted from outside the pool go through a global injection
+ *          queue defined with `mpmcqueue_template.h`.
+ *
+ * Workers which find no work for a while register as sleeping, and sleep on a
+ * futex word (see `futex.h`). Spawning or submitting a task only issues a
+ * wake-up system call when a worker is registered as sleeping.
+ *
+ * Tasks are joined with a `struct threadpool_latch` counting the unfinished
+ * tasks. A worker waiting on a latch runs other tasks in the meantime, while
+ * an outside thread sleeps until the count reaches zero.
+ *
+ * @code{.c}
+ * static void child(struct threadpool_worker *worker, void *arg)
+ * {
+ *     struct job *job = arg;
+ *     ...
+ *     threadpool_latch_count_down(&job->parent->latch);
+ * }
+ *
+ * static void parent(struct threadpool_worker *worker, void *arg)
+ * {
+ *     struct job *self = arg;
+ *     struct job jobs[2] = {...};
+ *     struct threadpool_task tasks[2] = {{child, &jobs[0]}, {child, &jobs[1]}};
+ *
+ *     threadpool_latch_init(&self->latch, 2);
+ *     threadpool_spawn(worker, &tasks[0]);
+ *     threadpool_spawn(worker, &tasks[1]);
+ *     threadpool_wait(worker, &self->latch); // the tasks live on this stack frame until here
+ * }
+ * @endcode
+ *
+ * `threadpool_parallel_for` splits an index range into tasks of a given grain
+ * size in this way.
+ *
+ * @note Requires `-I` paths to the `wsdeque`, `mpmcqueue` and `blockingqueue`
+ *       (for `futex.h`) directories, and `-pthread`.
+ *
+ * Source(s) used:
+ *  @li R. D. Blumofe and C. E. Leiserson. Scheduling Multithreaded
+ *      Computations by Work Stealing. J. ACM 46(5), 1999.
+ */
+
+/**
+ * @example threadpool_example.c
+ * Example of how `threadpool.h` header file is used in practice.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <assert.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "futex.h" // futex_wait, futex_wake, futex_cpu_relax
+
+/**
+ * @def THREADPOOL_SPIN_LIMIT
+ * @brief Number of failed attempts to find work before a worker sleeps.
+ */
+#ifndef THREADPOOL_SPIN_LIMIT
+#define THREADPOOL_SPIN_LIMIT (256)
+#endif
+
+/**
+ * @def THREADPOOL_YIELD_INTERVAL
+ * @brief Number of failed attempts between yielding the processor while
+ *        spinning.
+ */
+#ifndef THREADPOOL_YIELD_INTERVAL
+#define THREADPOOL_YIELD_INTERVAL (32)
+#endif
+
+/**
+ * @def THREADPOOL_CACHE_LINE_SIZE
+ * @brief Alignment used to keep the workers and the sleeping state apart.
+ *        Equal to a typical cache line size.
+ */
+#ifndef THREADPOOL_CACHE_LINE_SIZE
+#define THREADPOOL_CACHE_LINE_SIZE (64)
+#endif
+
+/// @cond DO_NOT_DOCUMENT
+#ifndef THREADPOOL_ALIGNAS
+#ifdef __cplusplus
+#define THREADPOOL_ALIGNAS(x) alignas(x)
+#else
+#define THREADPOOL_ALIGNAS(x) _Alignas(x)
+#endif
+#endif
+/// @endcond
+
+struct threadpool_worker;
+
+/**
+ * @brief A task: a function and its argument.
+ *
+ * The task struct is owned by the caller, and must live until the task has
+ * started running.
+ */
+struct threadpool_task {
+    void (*fn)(struct threadpool_worker *worker, void *arg); ///< The function, given the running worker.
+    void *arg;                                               ///< The argument.
+};
+
+/// @cond DO_NOT_DOCUMENT
+typedef struct threadpool_task *internal_threadpool_task_ptr;
+
+#define NAME       internal_threadpool_deque
+#define VALUE_TYPE internal_threadpool_task_ptr
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "wsdeque_template.h"
+
+#define NAME       internal_threadpool_queue
+#define VALUE_TYPE internal_threadpool_task_ptr
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "mpmcqueue_template.h"
+/// @endcond
+
+/**
+ * @def THREADPOOL_LATCH_SLEEPING
+ * @brief Bit of the latch count set when an outside thread sleeps on it.
+ */
+#define THREADPOOL_LATCH_SLEEPING (UINT32_C(1) << 31)
+
+/**
+ * @brief Countdown of unfinished tasks to wait on.
+ *
+ * The latch is not touched after the count reaches zero, apart from a wake-up
+ * system call on its address, such that it may live on the stack frame of the
+ * waiting task.
+ */
+struct threadpool_latch {
+    _Atomic(uint32_t) count; ///< Number of unfinished tasks, and `THREADPOOL_LATCH_SLEEPING`. Also the futex word.
+};
+
+/**
+ * @brief A worker thread of the pool.
+ */
+struct threadpool_worker {
+    THREADPOOL_ALIGNAS(THREADPOOL_CACHE_LINE_SIZE)
+    struct threadpool *pool;                 ///< The pool the worker belongs to.
+    struct internal_threadpool_deque *deque; ///< Tasks spawned by this worker.
+    uint32_t index;                          ///< Index of the worker in the pool.
+    uint32_t rng_state;                      ///< State for choosing a victim to steal from.
+    pthread_t thread;                        ///< The thread.
+};
+
+/**
+ * @brief The thread pool.
+ */
+struct threadpool {
+    uint32_t worker_count;                             ///< Number of workers.
+    struct threadpool_worker *workers;                 ///< Array of workers.
+    struct internal_threadpool_queue *injection_queue; ///< Tasks submitted from outside the pool.
+
+    THREADPOOL_ALIGNAS(THREADPOOL_CACHE_LINE_SIZE)
+    _Atomic(uint32_t) work_word;      ///< Futex word idle workers sleep on. Changed to wake them.
+    _Atomic(uint32_t) sleeping_count; ///< Number of workers registered as sleeping.
+    _Atomic(bool) stopping;           ///< Set on destroy.
+};
+
+/// @cond DO_NOT_DOCUMENT
+static inline void internal_threadpool_notify(struct threadpool *pool)
+{
+    /* pairs with the fence of a worker going to sleep: either it sees the new task, or the sleeping count is seen
+     * here */
+    atomic_thread_fence(memory_order_seq_cst);
+
+    if (atomic_load_explicit(&pool->sleeping_count, memory_order_relaxed) != 0) {
+        atomic_fetch_add_explicit(&pool->work_word, 1, memory_order_release);
+        futex_wake(&pool->work_word, 1);
+    }
+}
+
+static inline uint32_t internal_threadpool_xorshift32(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+/* own deque first, then the injection queue, then the other deques starting at a random one */
+static inline struct threadpool_task *internal_threadpool_find_task(struct threadpool_worker *worker)
+{
+    struct threadpool *pool = worker->pool;
+    struct threadpool_task *task;
+
+    if (internal_threadpool_deque_pop(worker->deque, &task)) {
+        return task;
+    }
+    if (internal_threadpool_queue_try_dequeue(pool->injection_queue, &task)) {
+        return task;
+    }
+
+    const uint32_t start = internal_threadpool_xorshift32(&worker->rng_state) % pool->worker_count;
+
+    for (uint32_t i = 0; i < pool->worker_count; i++) {
+        const uint32_t victim = (start + i) % pool->worker_count;
+
+        if (victim != worker->index && internal_threadpool_deque_steal(pool->workers[victim].deque, &task)) {
+            return task;
+        }
+    }
+    return NULL;
+}
+
+static inline void internal_threadpool_backoff(const uint32_t retry_index)
+{
+    if ((retry_index + 1) % THREADPOOL_YIELD_INTERVAL == 0) {
+        sched_yield();
+    }
+    else {
+        futex_cpu_relax();
+    }
+}
+
+static inline void *internal_threadpool_worker_main(void *arg)
+{
+    struct threadpool_worker *worker = (struct threadpool_worker *)arg;
+    struct threadpool *pool = worker->pool;
+    uint32_t retry_index = 0;
+
+    while (!atomic_load_explicit(&pool->stopping, memory_order_acquire)) {
+        struct threadpool_task *task = internal_threadpool_find_task(worker);
+
+        if (task) {
+            task->fn(worker, task->arg);
+            retry_index = 0;
+            continue;
+        }
+        if (retry_index < THREADPOOL_SPIN_LIMIT) {
+            internal_threadpool_backoff(retry_index++);
+            continue;
+        }
+
+        /* read before re-checking for work, such that a wake-up in between is not missed */
+        const uint32_t word = atomic_load_explicit(&pool->work_word, memory_order_acquire);
+
+        atomic_fetch_add_explicit(&pool->sleeping_count, 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+
+        task = internal_threadpool_find_task(worker);
+
+        if (!task && !atomic_load_explicit(&pool->stopping, memory_order_acquire)) {
+            futex_wait(&pool->work_word, word, NULL);
+        }
+        atomic_fetch_sub_explicit(&pool->sleeping_count, 1, memory_order_relaxed);
+
+        if (task) {
+            task->fn(worker, task->arg);
+        }
+        retry_index = 0;
+    }
+    return NULL;
+}
+/// @endcond
+
+/// @cond DO_NOT_DOCUMENT
+/* stop and join the started workers, then free everything */
+static inline void internal_threadpool_free(struct threadpool *pool, const uint32_t started_count)
+{
+    atomic_store_explicit(&pool->stopping, true, memory_order_release);
+    atomic_fetch_add_explicit(&pool->work_word, 1, memory_order_release);
+    futex_wake(&pool->work_word, INT_MAX);
+
+    for (uint32_t i = 0; i < started_count; i++) {
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+    for (uint32_t i = 0; i < pool->worker_count; i++) {
+        if (pool->workers[i].deque) {
+            internal_threadpool_deque_destroy(pool->workers[i].deque);
+        }
+    }
+    if (pool->injection_queue) {
+        internal_threadpool_queue_destroy(pool->injection_queue);
+    }
+    free(pool->workers);
+    free(pool);
+}
+/// @endcond
+
+/**
+ * @brief Create a thread pool, and start its workers.
+ *
+ * @param[in] worker_count          Number of worker threads. Typically the number of cores.
+ * @param[in] injection_capacity    Capacity of the injection queue, for tasks submitted from outside the pool.
+ *
+ * @return                          A pointer to the thread pool.
+ * @retval NULL
+ *   @li                            If worker_count or injection_capacity is 0.
+ *   @li                            If memory allocation or creating a thread fails.
+ */
+static inline struct threadpool *threadpool_create(const uint32_t worker_count, const uint32_t injection_capacity)
+{
+    if (worker_count == 0 || injection_capacity == 0
+        || (uintmax_t)0 + worker_count > SIZE_MAX / sizeof(struct threadpool_worker)) {
+        return NULL;
+    }
+
+    /* aligned_alloc requires the size to be a multiple of the alignment, which the struct sizes are */
+    struct threadpool *pool = (struct threadpool *)aligned_alloc(THREADPOOL_CACHE_LINE_SIZE, sizeof(struct threadpool));
+    struct threadpool_worker *workers = (struct threadpool_worker *)aligned_alloc(
+        THREADPOOL_CACHE_LINE_SIZE, (size_t)worker_count * sizeof(struct threadpool_worker));
+
+    if (!pool || !workers) {
+        free(pool);
+        free(workers);
+        return NULL;
+    }
+
+    pool->worker_count = worker_count;
+    pool->workers = workers;
+    pool->injection_queue = internal_threadpool_queue_create(injection_capacity);
+    atomic_init(&pool->work_word, 0);
+    atomic_init(&pool->sleeping_count, 0);
+    atomic_init(&pool->stopping, false);
+
+    /* the deques are created before any worker starts, as workers steal from each other */
+    bool ok = pool->injection_queue != NULL;
+    for (uint32_t i = 0; i < worker_count; i++) {
+        workers[i].pool = pool;
+        workers[i].deque = internal_threadpool_deque_create(64);
+        workers[i].index = i;
+        workers[i].rng_state = i * 2654435761U + 1;
+        ok = ok && workers[i].deque != NULL;
+    }
+
+    if (!ok) {
+        internal_threadpool_free(pool, 0);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < worker_count; i++) {
+        if (pthread_create(&workers[i].thread, NULL, internal_threadpool_worker_main, &workers[i]) != 0) {
+            internal_threadpool_free(pool, i);
+            return NULL;
+        }
+    }
+
+    return pool;
+}
+
+/**
+ * @brief Destroy a thread pool. Wakes and joins the workers.
+ *
+ * @warning Tasks not yet started are not run. Wait for the tasks to finish
+ *          before destroying the pool.
+ *
+ * @param[in] pool              The thread pool pointer.
+ */
+static inline void threadpool_destroy(struct threadpool *pool)
+{
+    assert(pool != NULL);
+
+    internal_threadpool_free(pool, pool->worker_count);
+}
+
+/**
+ * @brief Submit a task from outside the pool, through the injection queue.
+ *
+ * May be called by any thread.
+ *
+ * @param[in] pool              The thread pool pointer.
+ * @param[in] task              The task to run.
+ *
+ * @return                      Whether the task was submitted.
+ * @retval false                If the injection queue is full.
+ */
+static inline bool threadpool_submit(struct threadpool *pool, struct threadpool_task *task)
+{
+    assert(pool != NULL);
+    assert(task != NULL);
+
+    if (!internal_threadpool_queue_try_enqueue(pool->injection_queue, task)) {
+        return false;
+    }
+    internal_threadpool_notify(pool);
+
+    return true;
+}
+
+/**
+ * @brief Spawn a task from within a running task, onto the deque of its
+ *        worker.
+ *
+ * If the deque cannot grow, the task is run right away instead.
+ *
+ * @param[in] worker            The worker running the calling task.
+ * @param[in] task              The task to run.
+ */
+static inline void threadpool_spawn(struct threadpool_worker *worker, struct threadpool_task *task)
+{
+    assert(worker != NULL);
+    assert(task != NULL);
+
+    if (!internal_threadpool_deque_push(worker->deque, task)) {
+        task->fn(worker, task->arg);
+        return;
+    }
+    internal_threadpool_notify(worker->pool);
+}
+
+/**
+ * @brief Initialize a latch with the number of tasks to wait for.
+ *
+ * @param[in] latch             The latch pointer.
+ * @param[in] count             Number of tasks.
+ */
+static inline void threadpool_latch_init(struct threadpool_latch *latch, const uint32_t count)
+{
+    assert(latch != NULL);
+
+    assert(count < THREADPOOL_LATCH_SLEEPING);
+
+    atomic_init(&latch->count, count);
+}
+
+/**
+ * @brief Add to the number of tasks to wait for. Must be called before
+ *        the count can reach zero.
+ *
+ * @param[in] latch             The latch pointer.
+ * @param[in] count             Number of tasks to add.
+ */
+static inline void threadpool_latch_add(struct threadpool_latch *latch, const uint32_t count)
+{
+    assert(latch != NULL);
+
+    atomic_fetch_add_explicit(&latch->count, count, memory_order_relaxed);
+}
+
+/**
+ * @brief Mark a task as finished. Typically the last thing a task does.
+ *
+ * @param[in] latch             The latch pointer.
+ */
+static inline void threadpool_latch_count_down(struct threadpool_latch *latch)
+{
+    assert(latch != NULL);
+
+    /* the waiter may return as soon as the count reaches zero, so the latch is only used for its address after */
+    if (atomic_fetch_sub_explicit(&latch->count, 1, memory_order_acq_rel) == (THREADPOOL_LATCH_SLEEPING | 1)) {
+        futex_wake(&latch->count, INT_MAX);
+    }
+}
+
+/**
+ * @brief Wait until the count of a latch reaches zero.
+ *
+ * A worker runs other tasks in the meantime. An outside thread spins for a
+ * while, then sleeps.
+ *
+ * @param[in] worker            The worker running the calling task, or NULL when called from outside the pool.
+ * @param[in] latch             The latch pointer.
+ */
+static inline void threadpool_wait(struct threadpool_worker *worker, struct threadpool_latch *latch)
+{
+    assert(latch != NULL);
+
+    uint32_t retry_index = 0;
+
+    if (worker) {
+        while ((atomic_load_explicit(&latch->count, memory_order_acquire) & ~THREADPOOL_LATCH_SLEEPING) != 0) {
+            struct threadpool_task *task = internal_threadpool_find_task(worker);
+            if (task) {
+                task->fn(worker, task->arg);
+                retry_index = 0;
+            }
+            else {
+                internal_threadpool_backoff(retry_index++);
+            }
+        }
+        return;
+    }
+
+    for (; retry_index < THREADPOOL_SPIN_LIMIT; retry_index++) {
+        if (atomic_load_explicit(&latch->count, memory_order_acquire) == 0) {
+            return;
+        }
+        internal_threadpool_backoff(retry_index);
+    }
+
+    uint32_t count = atomic_fetch_or_explicit(&latch->count, THREADPOOL_LATCH_SLEEPING, memory_order_acq_rel);
+
+    while ((count & ~THREADPOOL_LATCH_SLEEPING) != 0) {
+        futex_wait(&latch->count, count | THREADPOOL_LATCH_SLEEPING, NULL);
+        count = atomic_load_explicit(&latch->count, memory_order_acquire);
+    }
+}
+
+// parallel for: {{{
+
+/// @cond DO_NOT_DOCUMENT
+struct internal_threadpool_range;
+
+struct internal_threadpool_for {
+    void (*fn)(struct threadpool_worker *worker, size_t begin, size_t end, void *arg);
+    void *arg;
+    size_t grain;
+    struct internal_threadpool_range *ranges;
+    _Atomic(size_t) range_count;
+    struct threadpool_latch latch;
+};
+
+struct internal_threadpool_range {
+    struct threadpool_task task;
+    struct internal_threadpool_for *loop;
+    size_t begin;
+    size_t end;
+};
+
+/* spawn the upper halves, and run the remaining lower part */
+static inline void internal_threadpool_run_range(struct threadpool_worker *worker, void *arg)
+{
+    struct internal_threadpool_range *range = (struct internal_threadpool_range *)arg;
+    struct internal_threadpool_for *loop = range->loop;
+
+    size_t begin = range->begin;
+    const size_t end = range->end;
+    size_t mid_end = end;
+
+    while (mid_end - begin > loop->grain) {
+        const size_t mid = begin + (mid_end - begin) / 2;
+
+        struct internal_threadpool_range *upper =
+            &loop->ranges[atomic_fetch_add_explicit(&loop->range_count, 1, memory_order_relaxed)];
+        upper->task.fn = internal_threadpool_run_range;
+        upper->task.arg = upper;
+        upper->loop = loop;
+        upper->begin = mid;
+        upper->end = mid_end;
+
+        threadpool_latch_add(&loop->latch, 1);
+        threadpool_spawn(worker, &upper->task);
+
+        mid_end = mid;
+    }
+    loop->fn(worker, begin, mid_end, loop->arg);
+
+    threadpool_latch_count_down(&loop->latch);
+}
+/// @endcond
+
+/**
+ * @brief Call `fn` on disjoint subranges covering [begin, end), in parallel,
+ *        and wait for all of them.
+ *
+ * The range is halved recursively until the subranges hold at most `grain`
+ * indices. May be called from outside the pool or from within a task.
+ *
+ * @note If the bookkeeping for the subranges cannot be allocated, or the
+ *       injection queue is full, `fn` is called on the whole range by the
+ *       calling thread, with the given worker.
+ *
+ * @param[in] pool              The thread pool pointer.
+ * @param[in] worker            The worker running the calling task, or NULL when called from outside the pool.
+ * @param[in] begin             Start of the range.
+ * @param[in] end               End of the range (exclusive).
+ * @param[in] grain             Maximum number of indices per call. At least 1.
+ * @param[in] fn                The function to call, given the running worker.
+ * @param[in] arg               Argument passed to the function.
+ */
+static inline void threadpool_parallel_for(struct threadpool *pool, struct threadpool_worker *worker,
+                                           const size_t begin, const size_t end, const size_t grain,
+                                           void (*fn)(struct threadpool_worker *, size_t, size_t, void *), void *arg)
+{
+    assert(pool != NULL);
+    assert(grain >= 1);
+    assert(fn != NULL);
+
+    if (end <= begin) {
+        return;
+    }
+
+    /* one range per leaf. halving a range of more than grain indices leaves at least (grain + 1) / 2 in each half */
+    const size_t max_range_count = (end - begin) / ((grain + 1) / 2) + 1;
+
+    struct internal_threadpool_for loop = {.fn = fn, .arg = arg, .grain = grain};
+    loop.ranges =
+        (struct internal_threadpool_range *)malloc(max_range_count * sizeof(struct internal_threadpool_range));
+
+    if (!loop.ranges) {
+        fn(worker, begin, end, arg);
+        return;
+    }
+
+    atomic_init(&loop.range_count, 1);
+    threadpool_latch_init(&loop.latch, 1);
+
+    struct internal_threadpool_range *root = &loop.ranges[0];
+    root->task.fn = internal_threadpool_run_range;
+    root->task.arg = root;
+    root->loop = &loop;
+    root->begin = begin;
+    root->end = end;
+
+    if (worker) {
+        internal_threadpool_run_range(worker, root);
+    }
+    else if (!threadpool_submit(pool, &root->task)) {
+        free(loop.ranges);
+        fn(worker, begin, end, arg);
+        return;
+    }
+
+    threadpool_wait(worker, &loop.latch);
+
+    free(loop.ranges);
+}
+
+// }}}
+
+#ifdef __cplusplus
+}
+#endif
+
+// vim: ft=c fdm=marker
@@ -0,0 +1,79 @@
+#include <assert.h>
+#include <stdio.h>
+
+#define NAME       int_vstack
+#define VALUE_TYPE int
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "vstack_template.h"
+
+#define NAME            small_int_vstack
+#define VALUE_TYPE      int
+#define INLINE_CAPACITY 8
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "vstack_template.h"
+
+#define NODE_COUNT (7)
+
+// depth-first traversal of a small graph. the stack rarely holds more than 8 nodes, so it stays inside the struct
+static void print_depth_first(const int adjacency[NODE_COUNT][3], const int adjacency_count[NODE_COUNT])
+{
+    struct small_int_vstack s;
+    small_int_vstack_init(&s);
+
+    int visited[NODE_COUNT] = {0};
+
+    small_int_vstack_push(&s, 0);
+    while (!small_int_vstack_is_empty(&s)) {
+        const int node = small_int_vstack_pop(&s);
+        if (visited[node]) {
+            continue;
+        }
+        visited[node] = 1;
+        printf("%d ", node);
+
+        small_int_vstack_push_n(&s, adjacency[node], (uint32_t)adjacency_count[node]);
+    }
+    printf("\n");
+
+    assert(s.values == s.inline_values);
+    small_int_vstack_deinit(&s); // not needed while inline, but frees the array otherwise
+}
+
+int main(void)
+{
+    struct int_vstack s;
+    int_vstack_init(&s); // empty, and not allocated yet
+
+    for (int i = 0; i < 5; i++) {
+        int_vstack_push(&s, i); // grows to a capacity of 1, 2, 4 and 8
+    }
+    assert(s.capacity == 8);
+
+    assert(int_vstack_get_top(&s) == 4);
+    assert(int_vstack_get_bottom(&s) == 0);
+    assert(int_vstack_at(&s, 1) == 3);
+
+    uint32_t index;
+    int value;
+    VSTACK_FOR_EACH_REVERSE(&s, index, value)
+    {
+        assert(value == (int)index);
+    }
+
+    int_vstack_push_n(&s, (const int[3]){5, 6, 7}, 3);
+    int_vstack_truncate(&s, 2);
+    assert(int_vstack_pop(&s) == 1);
+
+    int_vstack_shrink_to_fit(&s);
+    assert(s.capacity == 1);
+
+    int_vstack_deinit(&s);
+
+    const int adjacency[NODE_COUNT][3] = {{2, 1}, {4, 3}, {6, 5}, {0}, {1}, {2}, {2}};
+    const int adjacency_count[NODE_COUNT] = {2, 2, 2, 1, 1, 1, 1};
+    print_depth_first(adjacency, adjacency_count); // 0 1 3 4 2 5 6
+}
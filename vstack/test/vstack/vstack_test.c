@@ -0,0 +1,378 @@
+/*
+    Test cases:
+    - Init / create:
+      - init does not allocate, and the capacity is INLINE_CAPACITY (or 0)
+      - create reserves the exact capacity
+      - A failed allocation in create frees the struct
+    - Operations:
+      - push / pop / push_n / pop_n / truncate / get_top / get_bottom / at
+        against an array model, with random operations
+      - peek_n modifies in place
+      - VSTACK_FOR_EACH / VSTACK_FOR_EACH_REVERSE iterate from top to bottom and
+        from bottom to top
+      - clear keeps the capacity
+    - Growth:
+      - The capacity doubles, and push_n grows at most once
+      - reserve grows to the exact capacity, and keeps a larger capacity
+      - shrink_to_fit frees the unused memory, and frees the array when empty
+      - A failed allocation leaves the stack unchanged
+      - Every allocation is freed
+      - push / push_n fail when the count would overflow SIZE_TYPE
+    - Inline capacity:
+      - Short stacks never allocate
+      - The values are moved to an allocated array when the inline buffer is
+        full, and back inside the struct with shrink_to_fit
+*/
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+struct alloc_stats {
+    size_t allocated_size;
+    size_t freed_size;
+    size_t allocation_count;
+    size_t fail_above_size;
+};
+
+static void *counting_alloc(struct alloc_stats *stats, const size_t size)
+{
+    if (size > stats->fail_above_size) {
+        return NULL;
+    }
+    stats->allocated_size += size;
+    stats->allocation_count++;
+    return malloc(size);
+}
+
+static void counting_free(struct alloc_stats *stats, void *ptr, const size_t size)
+{
+    stats->freed_size += size;
+    free(ptr);
+}
+
+#define NAME       i32_vstk
+#define VALUE_TYPE int32_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "vstack_template.h"
+
+#define NAME                        i32_vstk_ctx
+#define VALUE_TYPE                  int32_t
+#define ALLOCATOR(ctx, size)        counting_alloc((ctx), (size))
+#define DEALLOCATOR(ctx, ptr, size) counting_free((ctx), (ptr), (size))
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "vstack_template.h"
+
+#define NAME                        i32_vstk_inline
+#define VALUE_TYPE                  int32_t
+#define INLINE_CAPACITY             4
+#define ALLOCATOR(ctx, size)        counting_alloc((ctx), (size))
+#define DEALLOCATOR(ctx, ptr, size) counting_free((ctx), (ptr), (size))
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "vstack_template.h"
+
+#define NAME       u8_vstk8
+#define VALUE_TYPE uint8_t
+#define SIZE_TYPE  uint8_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "vstack_template.h"
+
+#define RANDOM_OPERATION_COUNT (100000)
+#define MAX_BATCH_SIZE         (16)
+
+static void init_create_test(void)
+{
+    struct alloc_stats stats = {0, 0, 0, SIZE_MAX};
+
+    struct i32_vstk_ctx s;
+    i32_vstk_ctx_init_with_context(&s, &stats);
+    assert(s.count == 0 && s.capacity == 0 && s.values == NULL && s.ctx == &stats);
+    assert(i32_vstk_ctx_is_empty(&s));
+    i32_vstk_ctx_deinit(&s);
+    assert(stats.allocation_count == 0);
+
+    struct i32_vstk_inline s_inline;
+    i32_vstk_inline_init_with_context(&s_inline, &stats);
+    assert(s_inline.capacity == 4 && s_inline.values == s_inline.inline_values);
+    i32_vstk_inline_deinit(&s_inline);
+    assert(stats.allocation_count == 0);
+
+    struct i32_vstk_ctx *s_ptr = i32_vstk_ctx_create_with_context(5, &stats);
+    assert(s_ptr != NULL);
+    assert(s_ptr->capacity == 5 && s_ptr->count == 0);
+    assert(stats.allocated_size == sizeof(struct i32_vstk_ctx) + 5 * sizeof(int32_t));
+    i32_vstk_ctx_destroy(s_ptr);
+    assert(stats.allocated_size == stats.freed_size);
+
+    s_ptr = i32_vstk_ctx_create_with_context(0, &stats);
+    assert(s_ptr != NULL && s_ptr->capacity == 0);
+    i32_vstk_ctx_destroy(s_ptr);
+    assert(stats.allocated_size == stats.freed_size);
+
+    /* failing to allocate the array frees the struct */
+    stats.fail_above_size = sizeof(struct i32_vstk_ctx);
+    assert(i32_vstk_ctx_create_with_context(1024, &stats) == NULL);
+    assert(stats.allocated_size == stats.freed_size);
+
+    struct i32_vstk *s_default = i32_vstk_create(10);
+    assert(s_default != NULL && s_default->capacity == 10);
+    i32_vstk_destroy(s_default);
+}
+
+static void operations_test(void)
+{
+    struct i32_vstk s;
+    i32_vstk_init(&s);
+
+    int32_t *model = malloc(RANDOM_OPERATION_COUNT * MAX_BATCH_SIZE * sizeof(int32_t));
+    assert(model != NULL);
+    uint32_t model_count = 0;
+
+    int32_t batch[MAX_BATCH_SIZE];
+
+    srand(42);
+    for (int32_t i = 0; i < RANDOM_OPERATION_COUNT; i++) {
+        const uint32_t n = (uint32_t)rand() % MAX_BATCH_SIZE;
+
+        switch (rand() % 6) {
+        case 0:
+        case 1:
+            assert(i32_vstk_push(&s, i));
+            model[model_count++] = i;
+            break;
+        case 2:
+            for (uint32_t j = 0; j < n; j++) {
+                batch[j] = i + (int32_t)j;
+                model[model_count++] = batch[j];
+            }
+            assert(i32_vstk_push_n(&s, batch, n));
+            break;
+        case 3:
+            if (model_count != 0) {
+                assert(i32_vstk_pop(&s) == model[--model_count]);
+            }
+            break;
+        case 4:
+            if (n <= model_count) {
+                i32_vstk_pop_n(&s, batch, n);
+                model_count -= n;
+                for (uint32_t j = 0; j < n; j++) {
+                    assert(batch[j] == model[model_count + j]);
+                }
+            }
+            break;
+        case 5:
+            if (n <= model_count && rand() % 8 == 0) {
+                i32_vstk_truncate(&s, model_count - n);
+                model_count -= n;
+            }
+            break;
+        }
+        assert(s.count == model_count);
+        assert(s.capacity >= s.count);
+        if (s.count != 0) {
+            assert(i32_vstk_get_top(&s) == model[model_count - 1]);
+            assert(i32_vstk_get_bottom(&s) == model[0]);
+            const uint32_t index = (uint32_t)rand() % s.count;
+            assert(i32_vstk_at(&s, index) == model[model_count - 1 - index]);
+        }
+    }
+    assert(s.count > 2);
+
+    uint32_t index;
+    int32_t value;
+    VSTACK_FOR_EACH(&s, index, value)
+    {
+        assert(value == model[index - 1]);
+    }
+    assert(index == 0);
+    VSTACK_FOR_EACH_REVERSE(&s, index, value)
+    {
+        assert(value == model[index]);
+    }
+    assert(index == s.count);
+
+    int32_t *span = i32_vstk_peek_n(&s, 2);
+    assert(span[0] == model[model_count - 2] && span[1] == model[model_count - 1]);
+    span[1] = -1;
+    assert(i32_vstk_get_top(&s) == -1);
+
+    const uint32_t capacity = s.capacity;
+    i32_vstk_clear(&s);
+    assert(i32_vstk_is_empty(&s));
+    assert(s.capacity == capacity);
+
+    free(model);
+    i32_vstk_deinit(&s);
+}
+
+static void growth_test(void)
+{
+    struct alloc_stats stats = {0, 0, 0, SIZE_MAX};
+
+    struct i32_vstk_ctx s;
+    i32_vstk_ctx_init_with_context(&s, &stats);
+
+    /* doubling */
+    const uint32_t expected_capacities[] = {1, 2, 4, 4, 8, 8, 8, 8, 16};
+    for (int32_t i = 0; i < 9; i++) {
+        assert(i32_vstk_ctx_push(&s, i));
+        assert(s.capacity == expected_capacities[i]);
+    }
+    assert(stats.allocation_count == 5);
+
+    /* push_n grows once, to at least the count needed */
+    const int32_t src[40] = {0};
+    assert(i32_vstk_ctx_push_n(&s, src, 7));
+    assert(s.count == 16 && s.capacity == 16 && stats.allocation_count == 5);
+    assert(i32_vstk_ctx_push_n(&s, src, 1));
+    assert(s.capacity == 32 && stats.allocation_count == 6);
+    assert(i32_vstk_ctx_push_n(&s, src, 40));
+    assert(s.count == 57 && s.capacity == 64 && stats.allocation_count == 7);
+    assert(i32_vstk_ctx_push_n(&s, src, 40));
+    assert(s.count == 97 && s.capacity == 128 && stats.allocation_count == 8);
+    for (int32_t i = 0; i < 9; i++) {
+        assert(s.values[i] == i);
+    }
+
+    /* reserve */
+    assert(i32_vstk_ctx_reserve(&s, 100));
+    assert(s.capacity == 128);
+    assert(i32_vstk_ctx_reserve(&s, 200));
+    assert(s.capacity == 200);
+
+    /* shrink_to_fit */
+    assert(i32_vstk_ctx_shrink_to_fit(&s));
+    assert(s.count == 97 && s.capacity == 97);
+    const size_t allocation_count = stats.allocation_count;
+    assert(i32_vstk_ctx_shrink_to_fit(&s));
+    assert(stats.allocation_count == allocation_count);
+    for (int32_t i = 0; i < 9; i++) {
+        assert(s.values[i] == i);
+    }
+
+    /* failing to grow or shrink leaves the stack unchanged */
+    stats.fail_above_size = 95 * sizeof(int32_t);
+    assert(!i32_vstk_ctx_push(&s, 97));
+    assert(!i32_vstk_ctx_push_n(&s, src, 2));
+    assert(!i32_vstk_ctx_reserve(&s, 98));
+    assert(s.count == 97 && s.capacity == 97);
+    i32_vstk_ctx_pop(&s);
+    assert(!i32_vstk_ctx_shrink_to_fit(&s));
+    assert(s.count == 96 && s.capacity == 97);
+    i32_vstk_ctx_pop(&s);
+    assert(i32_vstk_ctx_shrink_to_fit(&s));
+    assert(s.count == 95 && s.capacity == 95);
+    assert(i32_vstk_ctx_get_bottom(&s) == 0);
+    stats.fail_above_size = SIZE_MAX;
+
+    /* shrinking an empty stack frees the array */
+    i32_vstk_ctx_clear(&s);
+    assert(i32_vstk_ctx_shrink_to_fit(&s));
+    assert(s.capacity == 0 && s.values == NULL);
+    assert(stats.allocated_size == stats.freed_size);
+    assert(i32_vstk_ctx_push(&s, 1));
+    assert(s.capacity == 1);
+
+    i32_vstk_ctx_deinit(&s);
+    assert(stats.allocated_size == stats.freed_size);
+
+    /* count overflow */
+    struct u8_vstk8 s8;
+    u8_vstk8_init(&s8);
+    for (uint32_t i = 0; i < UINT8_MAX; i++) {
+        assert(u8_vstk8_push(&s8, (uint8_t)i));
+    }
+    assert(s8.count == UINT8_MAX && s8.capacity == UINT8_MAX);
+    assert(!u8_vstk8_push(&s8, 0));
+    u8_vstk8_truncate(&s8, 250);
+    assert(!u8_vstk8_push_n(&s8, (const uint8_t[6]){0}, 6));
+    assert(u8_vstk8_push_n(&s8, (const uint8_t[5]){0}, 5));
+    assert(s8.count == UINT8_MAX);
+    assert(u8_vstk8_get_bottom(&s8) == 0 && u8_vstk8_at(&s8, 5) == 249);
+    u8_vstk8_deinit(&s8);
+}
+
+static void inline_capacity_test(void)
+{
+    struct alloc_stats stats = {0, 0, 0, SIZE_MAX};
+
+    struct i32_vstk_inline s;
+    i32_vstk_inline_init_with_context(&s, &stats);
+
+    /* short stacks never allocate */
+    for (uint32_t round = 0; round < 3; round++) {
+        for (int32_t i = 0; i < 4; i++) {
+            assert(i32_vstk_inline_push(&s, i));
+        }
+        assert(i32_vstk_inline_reserve(&s, 4));
+        assert(i32_vstk_inline_shrink_to_fit(&s));
+        assert(i32_vstk_inline_pop(&s) == 3);
+        i32_vstk_inline_clear(&s);
+    }
+    assert(stats.allocation_count == 0);
+    assert(s.values == s.inline_values && s.capacity == 4);
+
+    /* moved to an allocated array when full */
+    assert(i32_vstk_inline_push_n(&s, (const int32_t[4]){0, 1, 2, 3}, 4));
+    assert(i32_vstk_inline_push(&s, 4));
+    assert(s.values != s.inline_values && s.capacity == 8);
+    assert(stats.allocation_count == 1 && stats.allocated_size == 8 * sizeof(int32_t));
+    for (int32_t i = 5; i < 20; i++) {
+        assert(i32_vstk_inline_push(&s, i));
+    }
+    assert(s.capacity == 32);
+
+    int32_t value;
+    uint32_t index;
+    VSTACK_FOR_EACH_REVERSE(&s, index, value)
+    {
+        assert(value == (int32_t)index);
+    }
+
+    /* and moved back inside the struct when they fit */
+    i32_vstk_inline_truncate(&s, 6);
+    assert(i32_vstk_inline_shrink_to_fit(&s));
+    assert(s.values != s.inline_values && s.capacity == 6);
+    i32_vstk_inline_pop(&s);
+    i32_vstk_inline_pop(&s);
+    assert(i32_vstk_inline_shrink_to_fit(&s));
+    assert(s.values == s.inline_values && s.capacity == 4);
+    assert(stats.allocated_size == stats.freed_size);
+    for (int32_t i = 0; i < 4; i++) {
+        assert(s.values[i] == i);
+    }
+
+    /* reserve beyond the inline capacity allocates the exact capacity */
+    assert(i32_vstk_inline_reserve(&s, 5));
+    assert(s.values != s.inline_values && s.capacity == 5);
+    assert(i32_vstk_inline_get_top(&s) == 3);
+    i32_vstk_inline_deinit(&s);
+    assert(stats.allocated_size == stats.freed_size);
+
+    /* created inline stacks allocate only the struct until they grow */
+    const size_t allocation_count = stats.allocation_count;
+    struct i32_vstk_inline *s_ptr = i32_vstk_inline_create_with_context(3, &stats);
+    assert(s_ptr != NULL);
+    assert(s_ptr->values == s_ptr->inline_values && s_ptr->capacity == 4);
+    assert(stats.allocation_count == allocation_count + 1);
+    i32_vstk_inline_destroy(s_ptr);
+    assert(stats.allocated_size == stats.freed_size);
+}
+
+int main(void)
+{
+    init_create_test();
+    operations_test();
+    growth_test();
+    inline_capacity_test();
+}
@@ -0,0 +1,758 @@
+/*  vstack_template.h
+ *
+ *  Copyright (C) 2025 abxh
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *  See the file LICENSE included with this distribution for more
+ *  information. */
+
+/**
+ * @file vstack_template.h
+ * @brief Growable array-based stack (vector)
+ *
+ * Like `fstack_template.h`, but the values are stored in a separately
+ * allocated array, which grows when full:
+ *      @li The capacity is doubled, such that pushing is amortized O(1).
+ *      @li The values are moved into the new array with a single `memcpy`.
+ *
+ * With `INLINE_CAPACITY`, the first values are stored in a buffer inside the
+ * stack struct, such that short stacks never allocate.
+ *
+ * Pointers to values are valid until the stack grows or shrinks.
+ */
+
+/**
+ * @example vstack_example.c
+ * Example of how `vstack_template.h` header file is used in practice.
+ */
+
+#ifdef __cplusplus
+#ifdef __GNUC__
+#define restrict __restrict__
+#else
+#define restrict
+#endif
+extern "C" {
+#endif
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// macro definitions: {{{
+
+/**
+ * @def PASTE(a,b)
+ * @brief Paste two tokens together.
+ */
+#ifndef PASTE
+#define PASTE(a, b) a##b
+#endif
+
+/**
+ * @def XPASTE(a,b)
+ * @brief First expand tokens, then paste them together.
+ */
+#ifndef XPASTE
+#define XPASTE(a, b) PASTE(a, b)
+#endif
+
+/**
+ * @def JOIN(a,b)
+ * @brief First expand tokens, then paste them together with a _ in between.
+ */
+#ifndef JOIN
+#define JOIN(a, b) XPASTE(a, XPASTE(_, b))
+#endif
+
+/**
+ * @def VSTACK_FOR_EACH(self, index, value)
+ * @brief Iterate over the values in the stack from the top to bottom.
+ *
+ * @warning Modifying the stack under the iteration may result in errors.
+ *
+ * @param[in] self              Stack pointer.
+ * @param[in] index             Temporary indexing variable. Should be `SIZE_TYPE`.
+ * @param[out] value            Current value. Should be `VALUE_TYPE`.
+ */
+#ifndef VSTACK_FOR_EACH
+#define VSTACK_FOR_EACH(self, index, value) \
+    for ((index) = (self)->count; (index) > 0 && ((value) = (self)->values[(index) - 1], true); (index)--)
+#endif
+
+/**
+ * @def VSTACK_FOR_EACH_REVERSE(self, index, value)
+ * @brief Iterate over the values in the stack from the bottom to top.
+ *
+ * @warning Modifying the stack under the iteration may result in errors.
+ *
+ * @param[in] self              Stack pointer.
+ * @param[in] index             Temporary indexing variable. Should be `SIZE_TYPE`.
+ * @param[out] value            Current value. Should be `VALUE_TYPE`.
+ */
+#ifndef VSTACK_FOR_EACH_REVERSE
+#define VSTACK_FOR_EACH_REVERSE(self, index, value) \
+    for ((index) = 0; (index) < (self)->count && ((value) = (self)->values[(index)], true); (index)++)
+#endif
+
+/**
+ * @def NAME
+ * @brief Prefix to stack type and operations. This must be manually defined
+ *        before including this header file.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef NAME
+#define NAME vstack
+#error "Must define NAME."
+#else
+#define VSTACK_NAME NAME
+#endif
+
+/**
+ * @def VALUE_TYPE
+ * @brief Stack value type. This must be manually defined before including this
+ *        header file.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef VALUE_TYPE
+#define VALUE_TYPE int
+#define FUNCTION_DEFINITIONS
+#define TYPE_DEFINITIONS
+#error "Must define VALUE_TYPE."
+#endif
+
+/**
+ * @def SIZE_TYPE
+ * @brief Stack count and capacity type. Defaults to `uint32_t`.
+ *
+ * Define as `uint64_t` (or `size_t`) for stacks of more than `UINT32_MAX`
+ * values. Must be an unsigned integer type.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef SIZE_TYPE
+#define SIZE_TYPE uint32_t
+#endif
+
+/**
+ * @def INLINE_CAPACITY
+ * @brief Number of values stored inside the stack struct, before the values
+ *        are moved to an allocated array. Disabled by default.
+ *
+ * Must be a positive integer constant. The values are moved back inside the
+ * struct with `shrink_to_fit`, when they fit.
+ *
+ * @warning While the values are stored inside the struct, the `values` member
+ *          points into the struct itself. So the struct must not be copied or
+ *          moved by value.
+ *
+ * Is undefined after header is included.
+ */
+#ifdef INLINE_CAPACITY
+#endif
+
+/**
+ * @def ALLOCATOR(ctx, size)
+ * @brief Used to allocate the memory of the stack struct (with `create`) and
+ *        its array of values. Defaults to malloc().
+ *
+ * Is undefined once header is included.
+ *
+ * @note The memory need not be zeroed.
+ *
+ * @param ctx The context pointer given to `init_with_context` or
+ *            `create_with_context` (or NULL).
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the memory, or NULL if the allocation fails.
+ */
+#if defined(ALLOCATOR) != defined(DEALLOCATOR)
+#error "Must define both ALLOCATOR and DEALLOCATOR."
+#endif
+#ifndef ALLOCATOR
+#define ALLOCATOR(ctx, size) ((void)(ctx), malloc(size))
+#endif
+
+/**
+ * @def DEALLOCATOR(ctx, ptr, size)
+ * @brief Used to free the memory of the stack struct and its array of values.
+ *        Defaults to free().
+ *
+ * Is undefined once header is included.
+ *
+ * @param ctx The context pointer given to `init_with_context` or
+ *            `create_with_context` (or NULL).
+ * @param ptr The pointer returned by `ALLOCATOR`.
+ * @param size The number of bytes allocated.
+ */
+#ifndef DEALLOCATOR
+#define DEALLOCATOR(ctx, ptr, size) ((void)(ctx), (void)(size), free(ptr))
+#endif
+
+/**
+ * @def FUNCTION_LINKAGE
+ * @brief Specify function linkage e.g. static inline
+ */
+#ifndef FUNCTION_LINKAGE
+#define FUNCTION_LINKAGE
+#endif
+
+/// @cond DO_NOT_DOCUMENT
+#define VSTACK_TYPE     struct VSTACK_NAME
+#define VSTACK_IS_EMPTY JOIN(VSTACK_NAME, is_empty)
+#define VSTACK_INIT     JOIN(VSTACK_NAME, init_with_context)
+#define VSTACK_DEINIT   JOIN(VSTACK_NAME, deinit)
+#define VSTACK_RESERVE  JOIN(VSTACK_NAME, reserve)
+#define VSTACK_SIZE_MAX ((SIZE_TYPE)-1)
+#define VSTACK_MOVE     JOIN(internal, JOIN(VSTACK_NAME, move_values))
+#define VSTACK_GROW     JOIN(internal, JOIN(VSTACK_NAME, grow))
+#ifdef INLINE_CAPACITY
+#define VSTACK_INLINE_CAPACITY     ((SIZE_TYPE)(INLINE_CAPACITY))
+#define VSTACK_INLINE_VALUES(self) ((self)->inline_values)
+#else
+#define VSTACK_INLINE_CAPACITY     ((SIZE_TYPE)0)
+#define VSTACK_INLINE_VALUES(self) ((VALUE_TYPE *)NULL)
+#endif
+#define VSTACK_IS_ALLOCATED(self) ((self)->values != VSTACK_INLINE_VALUES(self))
+/// @endcond
+
+// }}}
+
+// type definitions: {{{
+
+/**
+ * @def TYPE_DEFINITIONS
+ * @brief Define the types
+ */
+#ifdef TYPE_DEFINITIONS
+
+/**
+ * @brief Generated stack struct type for a `VALUE_TYPE`.
+ */
+struct VSTACK_NAME {
+    SIZE_TYPE count;    ///< Number of values.
+    SIZE_TYPE capacity; ///< Number of values allocated for.
+    void *ctx;          ///< Context pointer passed to `ALLOCATOR` and `DEALLOCATOR`.
+    VALUE_TYPE *values; ///< Array of values, from bottom to top.
+#ifdef INLINE_CAPACITY
+    VALUE_TYPE inline_values[INLINE_CAPACITY]; ///< Values stored inside the struct.
+#endif
+};
+
+#endif
+
+// }}}
+
+// function declarations: {{{
+
+/**
+ * @brief Initialize an empty stack struct. Does not allocate.
+ *
+ * The capacity is `INLINE_CAPACITY`, or 0 if it is not defined.
+ *
+ * @param[in] self              The stack pointer.
+ *
+ * @return                      The stack pointer.
+ */
+FUNCTION_LINKAGE VSTACK_TYPE *JOIN(VSTACK_NAME, init)(VSTACK_TYPE *self);
+
+/**
+ * @brief Initialize an empty stack struct, given a context pointer. The
+ *        context pointer is passed to `ALLOCATOR` and `DEALLOCATOR` whenever
+ *        the stack allocates or frees memory. Does not allocate.
+ *
+ * @param[in] self              The stack pointer.
+ * @param[in] ctx               The context pointer.
+ *
+ * @return                      The stack pointer.
+ */
+FUNCTION_LINKAGE VSTACK_TYPE *JOIN(VSTACK_NAME, init_with_context)(VSTACK_TYPE *self, void *ctx);
+
+/**
+ * @brief Free the array of values of a stack struct initialized with `init`,
+ *        if allocated.
+ *
+ * The stack must be initialized again before further use.
+ *
+ * @param[in] self              The stack pointer.
+ */
+FUNCTION_LINKAGE void JOIN(VSTACK_NAME, deinit)(VSTACK_TYPE *self);
+
+/**
+ * @brief Create a stack struct with `ALLOCATOR`, with room for at least a
+ *        given number of values.
+ *
+ * @param[in] min_capacity      Minimum capacity.
+ *
+ * @return                      A pointer to the stack.
+ * @retval NULL
+ *   @li                        If the equivalent size overflows.
+ *   @li                        If the allocation fails.
+ */
+FUNCTION_LINKAGE VSTACK_TYPE *JOIN(VSTACK_NAME, create)(const SIZE_TYPE min_capacity);
+
+/**
+ * @brief Create a stack struct with `ALLOCATOR`, given a context pointer. See
+ *        `init_with_context`.
+ *
+ * @param[in] min_capacity      Minimum capacity.
+ * @param[in] ctx               The context pointer.
+ *
+ * @return                      A pointer to the stack, or NULL. See `create`.
+ */
+FUNCTION_LINKAGE VSTACK_TYPE *JOIN(VSTACK_NAME, create_with_context)(const SIZE_TYPE min_capacity, void *ctx);
+
+/**
+ * @brief Destroy a stack struct made with `create` and its array of values
+ *        with `DEALLOCATOR`.
+ *
+ * @param[in] self              The stack pointer.
+ */
+FUNCTION_LINKAGE void JOIN(VSTACK_NAME, destroy)(VSTACK_TYPE *self);
+
+/**
+ * @brief Grow the array of values, if needed, such that it has room for at
+ *        least a given number of values.
+ *
+ * @param[in] self              The stack pointer.
+ * @param[in] min_capacity      Minimum capacity. The capacity is set to
+ *                              exactly this, when growing.
+ *
+ * @return                      Whether there is room. False if the allocation
+ *                              fails or the size overflows, in which case the
+ *                              stack is unchanged.
+ */
+FUNCTION_LINKAGE bool JOIN(VSTACK_NAME, reserve)(VSTACK_TYPE *self, const SIZE_TYPE min_capacity);
+
+/**
+ * @brief Shrink the array of values to the count, freeing the unused memory.
+ *
+ * With `INLINE_CAPACITY`, the values are moved back inside the struct when
+ * they fit.
+ *
+ * @param[in] self              The stack pointer.
+ *
+ * @return                      Whether the stack was shrunk (or was already
+ *                              as small as it gets). False if the allocation
+ *                              fails, in which case the stack is unchanged.
+ */
+FUNCTION_LINKAGE bool JOIN(VSTACK_NAME, shrink_to_fit)(VSTACK_TYPE *self);
+
+/**
+ * @brief Return whether the stack is empty.
+ *
+ * @param[in] self              The stack pointer.
+ *
+ * @return                      Whether the stack is empty.
+ */
+FUNCTION_LINKAGE bool JOIN(VSTACK_NAME, is_empty)(const VSTACK_TYPE *self);
+
+/**
+ * @brief Get the value at index.
+ *
+ * @note Index starts from the top as `0` and is counted upward to `count - 1`
+ *       as bottom.
+ *
+ * @param[in] self              The stack pointer.
+ * @param[in] index             The index to retrieve to value from.
+ *
+ * @return                      The value at `index`.
+ */
+FUNCTION_LINKAGE VALUE_TYPE JOIN(VSTACK_NAME, at)(const VSTACK_TYPE *self, const SIZE_TYPE index);
+
+/**
+ * @brief Get the value from the top of a non-empty stack.
+ *
+ * @param[in] self              The stack pointer.
+ *
+ * @return                      The top value.
+ */
+FUNCTION_LINKAGE VALUE_TYPE JOIN(VSTACK_NAME, get_top)(const VSTACK_TYPE *self);
+
+/**
+ * @brief Get the value from the bottom of a non-empty stack.
+ *
+ * @param[in] self              The stack pointer.
+ *
+ * @return                      The bottom value.
+ */
+FUNCTION_LINKAGE VALUE_TYPE JOIN(VSTACK_NAME, get_bottom)(const VSTACK_TYPE *self);
+
+/**
+ * @brief Push a value onto the stack, growing it when full.
+ *
+ * @param[in] self              The stack pointer.
+ * @param[in] value             The value.
+ *
+ * @return                      Whether the value was pushed. False if the
+ *                              stack was full and could not grow.
+ */
+FUNCTION_LINKAGE bool JOIN(VSTACK_NAME, push)(VSTACK_TYPE *self, const VALUE_TYPE value);
+
+/**
+ * @brief Pop a value away from a non-empty stack.
+ *
+ * @param[in] self              The stack pointer.
+ *
+ * @return                      The top value.
+ */
+FUNCTION_LINKAGE VALUE_TYPE JOIN(VSTACK_NAME, pop)(VSTACK_TYPE *self);
+
+/**
+ * @brief Push `n` values onto the stack, growing it at most once.
+ *
+ * The values are copied in as one contiguous segment. `src[n - 1]` becomes the
+ * top value.
+ *
+ * @param[in] self              The stack pointer.
+ * @param[in] src               The values to push, from bottom to top.
+ * @param[in] n                 The number of values.
+ *
+ * @return                      Whether the values were pushed. False if the
+ *                              stack could not grow, in which case it is
+ *                              unchanged.
+ */
+FUNCTION_LINKAGE bool JOIN(VSTACK_NAME, push_n)(VSTACK_TYPE *restrict self, const VALUE_TYPE *restrict src,
+                                                const SIZE_TYPE n);
+
+/**
+ * @brief Pop `n` values away from a stack with at least `n` values.
+ *
+ * The values are copied out as one contiguous segment. `dest[n - 1]` is set to
+ * the former top value.
+ *
+ * @param[in] self              The stack pointer.
+ * @param[out] dest             Set to the popped values, from bottom to top.
+ * @param[in] n                 The number of values.
+ */
+FUNCTION_LINKAGE void JOIN(VSTACK_NAME, pop_n)(VSTACK_TYPE *restrict self, VALUE_TYPE *restrict dest,
+                                               const SIZE_TYPE n);
+
+/**
+ * @brief Get the top `n` values of a stack with at least `n` values, as a span
+ *        of the stack storage. For reading (or modifying) the values in place.
+ *
+ * @param[in] self              The stack pointer.
+ * @param[in] n                 The number of values.
+ *
+ * @return                      A pointer to the `n` values, from bottom to
+ *                              top. The top value is at index `n - 1`.
+ */
+FUNCTION_LINKAGE VALUE_TYPE *JOIN(VSTACK_NAME, peek_n)(VSTACK_TYPE *self, const SIZE_TYPE n);
+
+/**
+ * @brief Truncate the stack to a given count, popping away the values above
+ *        it in O(1). The capacity is kept.
+ *
+ * @param[in] self              The stack pointer.
+ * @param[in] count             The new count. At most the current count.
+ */
+FUNCTION_LINKAGE void JOIN(VSTACK_NAME, truncate)(VSTACK_TYPE *self, const SIZE_TYPE count);
+
+/**
+ * @brief Clear the values in the stack. The capacity is kept.
+ *
+ * @param[in] self              The stack pointer.
+ */
+FUNCTION_LINKAGE void JOIN(VSTACK_NAME, clear)(VSTACK_TYPE *self);
+
+// }}}
+
+// function definitions: {{{
+
+/**
+ * @def FUNCTION_DEFINITIONS
+ * @brief Define the functions
+ */
+#ifdef FUNCTION_DEFINITIONS
+
+/// @cond DO_NOT_DOCUMENT
+/* move the values into an array of a new capacity, or back inside the struct when they fit */
+static inline bool JOIN(internal, JOIN(VSTACK_NAME, move_values))(VSTACK_TYPE *self, const SIZE_TYPE new_capacity)
+{
+    assert(new_capacity >= self->count);
+
+    VALUE_TYPE *new_values = VSTACK_INLINE_VALUES(self);
+    SIZE_TYPE capacity = VSTACK_INLINE_CAPACITY;
+
+    if (new_capacity > VSTACK_INLINE_CAPACITY) {
+        if ((uintmax_t)0 + new_capacity > SIZE_MAX / sizeof(VALUE_TYPE)) {
+            return false;
+        }
+
+        new_values = (VALUE_TYPE *)ALLOCATOR(self->ctx, (size_t)new_capacity * sizeof(VALUE_TYPE));
+
+        if (!new_values) {
+            return false;
+        }
+        capacity = new_capacity;
+    }
+
+    if (self->count > 0) {
+        memcpy(new_values, self->values, (size_t)self->count * sizeof(VALUE_TYPE));
+    }
+    if (VSTACK_IS_ALLOCATED(self)) {
+        DEALLOCATOR(self->ctx, self->values, (size_t)self->capacity * sizeof(VALUE_TYPE));
+    }
+
+    self->values = new_values;
+    self->capacity = capacity;
+
+    return true;
+}
+
+/* grow geometrically, to at least min_capacity */
+static inline bool JOIN(internal, JOIN(VSTACK_NAME, grow))(VSTACK_TYPE *self, const SIZE_TYPE min_capacity)
+{
+    assert(min_capacity > self->capacity);
+
+    SIZE_TYPE new_capacity = self->capacity > VSTACK_SIZE_MAX / 2 ? VSTACK_SIZE_MAX : self->capacity * 2;
+
+    if (new_capacity < min_capacity) {
+        new_capacity = min_capacity;
+    }
+
+    return VSTACK_MOVE(self, new_capacity);
+}
+/// @endcond
+
+FUNCTION_LINKAGE VSTACK_TYPE *JOIN(VSTACK_NAME, init)(VSTACK_TYPE *self)
+{
+    return JOIN(VSTACK_NAME, init_with_context)(self, NULL);
+}
+
+FUNCTION_LINKAGE VSTACK_TYPE *JOIN(VSTACK_NAME, init_with_context)(VSTACK_TYPE *self, void *ctx)
+{
+    assert(self != NULL);
+
+    self->count = 0;
+    self->capacity = VSTACK_INLINE_CAPACITY;
+    self->ctx = ctx;
+    self->values = VSTACK_INLINE_VALUES(self);
+
+    return self;
+}
+
+FUNCTION_LINKAGE void JOIN(VSTACK_NAME, deinit)(VSTACK_TYPE *self)
+{
+    assert(self != NULL);
+
+    if (VSTACK_IS_ALLOCATED(self)) {
+        DEALLOCATOR(self->ctx, self->values, (size_t)self->capacity * sizeof(VALUE_TYPE));
+    }
+    self->values = VSTACK_INLINE_VALUES(self);
+    self->capacity = VSTACK_INLINE_CAPACITY;
+    self->count = 0;
+}
+
+FUNCTION_LINKAGE VSTACK_TYPE *JOIN(VSTACK_NAME, create)(const SIZE_TYPE min_capacity)
+{
+    return JOIN(VSTACK_NAME, create_with_context)(min_capacity, NULL);
+}
+
+FUNCTION_LINKAGE VSTACK_TYPE *JOIN(VSTACK_NAME, create_with_context)(const SIZE_TYPE min_capacity, void *ctx)
+{
+    VSTACK_TYPE *self = (VSTACK_TYPE *)ALLOCATOR(ctx, sizeof(VSTACK_TYPE));
+
+    if (!self) {
+        return NULL;
+    }
+
+    VSTACK_INIT(self, ctx);
+
+    if (!VSTACK_RESERVE(self, min_capacity)) {
+        DEALLOCATOR(ctx, self, sizeof(VSTACK_TYPE));
+        return NULL;
+    }
+
+    return self;
+}
+
+FUNCTION_LINKAGE void JOIN(VSTACK_NAME, destroy)(VSTACK_TYPE *self)
+{
+    assert(self != NULL);
+
+    void *ctx = self->ctx;
+
+    VSTACK_DEINIT(self);
+    DEALLOCATOR(ctx, self, sizeof(VSTACK_TYPE));
+}
+
+FUNCTION_LINKAGE bool JOIN(VSTACK_NAME, reserve)(VSTACK_TYPE *self, const SIZE_TYPE min_capacity)
+{
+    assert(self != NULL);
+
+    if (min_capacity <= self->capacity) {
+        return true;
+    }
+
+    return VSTACK_MOVE(self, min_capacity);
+}
+
+FUNCTION_LINKAGE bool JOIN(VSTACK_NAME, shrink_to_fit)(VSTACK_TYPE *self)
+{
+    assert(self != NULL);
+
+    if (!VSTACK_IS_ALLOCATED(self) || self->count == self->capacity) {
+        return true;
+    }
+
+    return VSTACK_MOVE(self, self->count);
+}
+
+FUNCTION_LINKAGE bool JOIN(VSTACK_NAME, is_empty)(const VSTACK_TYPE *self)
+{
+    assert(self != NULL);
+
+    return self->count == 0;
+}
+
+FUNCTION_LINKAGE VALUE_TYPE JOIN(VSTACK_NAME, at)(const VSTACK_TYPE *self, const SIZE_TYPE index)
+{
+    assert(self != NULL);
+    assert(index < self->count);
+
+    return self->values[self->count - 1 - index];
+}
+
+FUNCTION_LINKAGE VALUE_TYPE JOIN(VSTACK_NAME, get_top)(const VSTACK_TYPE *self)
+{
+    assert(self != NULL);
+    assert(!VSTACK_IS_EMPTY(self));
+
+    return self->values[self->count - 1];
+}
+
+FUNCTION_LINKAGE VALUE_TYPE JOIN(VSTACK_NAME, get_bottom)(const VSTACK_TYPE *self)
+{
+    assert(self != NULL);
+    assert(!VSTACK_IS_EMPTY(self));
+
+    return self->values[0];
+}
+
+FUNCTION_LINKAGE bool JOIN(VSTACK_NAME, push)(VSTACK_TYPE *self, const VALUE_TYPE value)
+{
+    assert(self != NULL);
+
+    if (self->count == self->capacity) {
+        if (self->capacity == VSTACK_SIZE_MAX || !VSTACK_GROW(self, self->capacity + 1)) {
+            return false;
+        }
+    }
+
+    self->values[self->count++] = value;
+
+    return true;
+}
+
+FUNCTION_LINKAGE VALUE_TYPE JOIN(VSTACK_NAME, pop)(VSTACK_TYPE *self)
+{
+    assert(self != NULL);
+    assert(!VSTACK_IS_EMPTY(self));
+
+    return self->values[--self->count];
+}
+
+FUNCTION_LINKAGE bool JOIN(VSTACK_NAME, push_n)(VSTACK_TYPE *restrict self, const VALUE_TYPE *restrict src,
+                                                const SIZE_TYPE n)
+{
+    assert(self != NULL);
+    assert(src != NULL || n == 0);
+
+    if (n == 0) {
+        return true;
+    }
+    if (n > self->capacity - self->count) {
+        if (n > VSTACK_SIZE_MAX - self->count || !VSTACK_GROW(self, self->count + n)) {
+            return false;
+        }
+    }
+
+    memcpy(&self->values[self->count], src, (size_t)n * sizeof(VALUE_TYPE));
+    self->count += n;
+
+    return true;
+}
+
+FUNCTION_LINKAGE void JOIN(VSTACK_NAME, pop_n)(VSTACK_TYPE *restrict self, VALUE_TYPE *restrict dest,
+                                               const SIZE_TYPE n)
+{
+    assert(self != NULL);
+    assert(dest != NULL || n == 0);
+    assert(n <= self->count);
+
+    if (n == 0) {
+        return;
+    }
+
+    self->count -= n;
+    memcpy(dest, &self->values[self->count], (size_t)n * sizeof(VALUE_TYPE));
+}
+
+FUNCTION_LINKAGE VALUE_TYPE *JOIN(VSTACK_NAME, peek_n)(VSTACK_TYPE *self, const SIZE_TYPE n)
+{
+    assert(self != NULL);
+    assert(n <= self->count);
+
+    return &self->values[self->count - n];
+}
+
+FUNCTION_LINKAGE void JOIN(VSTACK_NAME, truncate)(VSTACK_TYPE *self, const SIZE_TYPE count)
+{
+    assert(self != NULL);
+    assert(count <= self->count);
+
+    self->count = count;
+}
+
+FUNCTION_LINKAGE void JOIN(VSTACK_NAME, clear)(VSTACK_TYPE *self)
+{
+    assert(self != NULL);
+
+    self->count = 0;
+}
+
+#endif
+
+// }}}
+
+// macro undefs: {{{
+
+#undef NAME
+#undef VALUE_TYPE
+#undef SIZE_TYPE
+#undef INLINE_CAPACITY
+#undef ALLOCATOR
+#undef DEALLOCATOR
+#undef FUNCTION_LINKAGE
+#undef FUNCTION_DEFINITIONS
+#undef TYPE_DEFINITIONS
+
+#undef VSTACK_NAME
+#undef VSTACK_TYPE
+#undef VSTACK_IS_EMPTY
+#undef VSTACK_INIT
+#undef VSTACK_DEINIT
+#undef VSTACK_RESERVE
+#undef VSTACK_SIZE_MAX
+#undef VSTACK_MOVE
+#undef VSTACK_GROW
+#undef VSTACK_INLINE_CAPACITY
+#undef VSTACK_INLINE_VALUES
+#undef VSTACK_IS_ALLOCATED
+
+// }}}
+
+#ifdef __cplusplus
+}
+#endif
+
+// vim: ft=c fdm=marker
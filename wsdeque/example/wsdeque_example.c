@@ -0,0 +1,81 @@
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#define NAME       int_wsdeque
+#define VALUE_TYPE int
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "wsdeque_template.h"
+
+#define THIEF_COUNT (2)
+#define JOB_COUNT   (1000)
+
+static struct int_wsdeque *d;
+static atomic_bool owner_done;
+
+static void *thief(void *arg)
+{
+    long *sum = arg;
+    for (;;) {
+        const bool done = atomic_load(&owner_done); // once set, the deque stays empty
+        int job;
+        if (int_wsdeque_steal(d, &job)) {
+            *sum += job; // the oldest job
+        }
+        else if (done) {
+            break;
+        }
+        else {
+            sched_yield(); // empty. let the owner push more jobs
+        }
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    d = int_wsdeque_create(4); // grows as needed
+    if (!d) {
+        assert(false);
+    }
+
+    pthread_t thieves[THIEF_COUNT];
+    long sums[THIEF_COUNT] = {0};
+    for (int i = 0; i < THIEF_COUNT; i++) {
+        pthread_create(&thieves[i], NULL, thief, &sums[i]);
+    }
+
+    /* the owner pushes two jobs, and handles the newest one itself */
+    long owner_sum = 0;
+    for (int i = 1; i <= JOB_COUNT; i += 2) {
+        int_wsdeque_push(d, i);
+        int_wsdeque_push(d, i + 1);
+
+        int job;
+        if (int_wsdeque_pop(d, &job)) {
+            owner_sum += job;
+        }
+    }
+    int job;
+    while (int_wsdeque_pop(d, &job)) {
+        owner_sum += job;
+    }
+    atomic_store(&owner_done, true);
+
+    long sum = owner_sum;
+    for (int i = 0; i < THIEF_COUNT; i++) {
+        pthread_join(thieves[i], NULL);
+        sum += sums[i];
+    }
+
+    /* every job is handled exactly once, by the owner or by one of the thieves */
+    assert(sum == (long)JOB_COUNT * (JOB_COUNT + 1) / 2);
+    printf("sum: %ld (owner: %ld)\n", sum, owner_sum);
+
+    int_wsdeque_destroy(d);
+}
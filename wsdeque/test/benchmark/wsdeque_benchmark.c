@@ -0,0 +1,266 @@
+// Fork-join benchmark: computes fib(n) by splitting it into tasks until
+// n <= CUTOFF, with 1 to 8 worker threads. Each worker pushes one half of a
+// split and continues with the other. Compares a work-stealing deque per
+// worker with a single fstack of tasks shared by all workers under a mutex,
+// and reports the speedup over the serial recursion.
+// Run with `make bench`.
+//
+// usage: ./a.out [n]
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+struct task {
+    struct task *parent;
+    _Atomic(uint64_t) sum; // of the finished children
+    atomic_int pending;    // number of unfinished children
+    int n;
+};
+
+typedef struct task *task_ptr;
+
+#define NAME       task_wsdeque
+#define VALUE_TYPE task_ptr
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "wsdeque_template.h"
+
+#define NAME       task_fstack
+#define VALUE_TYPE task_ptr
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "fstack_template.h"
+
+#define CUTOFF           (12)
+#define MAX_THREAD_COUNT (8)
+#define SHARED_CAPACITY  (1 << 16)
+
+/* spin for a while before giving up the core, such that oversubscribed cores still make progress */
+#define SPIN_LIMIT (1024)
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static inline void backoff(uint32_t *spins)
+{
+    if (++*spins == SPIN_LIMIT) {
+        *spins = 0;
+        sched_yield();
+    }
+}
+
+static uint64_t fib_serial(const int n)
+{
+    return n < 2 ? (uint64_t)n : fib_serial(n - 1) + fib_serial(n - 2);
+}
+
+// schedulers: {{{
+
+static bool use_wsdeque;
+static uint32_t thread_count;
+static struct task_wsdeque *deques[MAX_THREAD_COUNT];
+
+static pthread_mutex_t shared_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct task_fstack *shared_stack;
+
+static atomic_bool done;
+static uint64_t result;
+
+static inline uint32_t xorshift32(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static bool give(const uint32_t id, struct task *t)
+{
+    if (use_wsdeque) {
+        return task_wsdeque_push(deques[id], t);
+    }
+    pthread_mutex_lock(&shared_mutex);
+    const bool pushed = !task_fstack_is_full(shared_stack);
+    if (pushed) {
+        task_fstack_push(shared_stack, t);
+    }
+    pthread_mutex_unlock(&shared_mutex);
+    return pushed;
+}
+
+static bool take(const uint32_t id, uint32_t *rng, struct task **t)
+{
+    if (use_wsdeque) {
+        if (task_wsdeque_pop(deques[id], t)) {
+            return true;
+        }
+        const uint32_t victim = xorshift32(rng) % thread_count;
+        return victim != id && task_wsdeque_steal(deques[victim], t);
+    }
+    pthread_mutex_lock(&shared_mutex);
+    const bool popped = !task_fstack_is_empty(shared_stack);
+    if (popped) {
+        *t = task_fstack_pop(shared_stack);
+    }
+    pthread_mutex_unlock(&shared_mutex);
+    return popped;
+}
+
+// }}}
+
+static struct task *task_new(struct task *parent, const int n)
+{
+    struct task *t = malloc(sizeof(struct task));
+    if (!t) {
+        fprintf(stderr, "out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    t->parent = parent;
+    atomic_init(&t->sum, 0);
+    atomic_init(&t->pending, 0);
+    t->n = n;
+    return t;
+}
+
+/* hand the value to the parent. the last child to finish finishes the parent */
+static void complete(struct task *t, uint64_t value)
+{
+    for (;;) {
+        struct task *parent = t->parent;
+        free(t);
+
+        if (!parent) {
+            result = value;
+            atomic_store(&done, true);
+            return;
+        }
+        atomic_fetch_add(&parent->sum, value);
+        if (atomic_fetch_sub(&parent->pending, 1) != 1) {
+            return;
+        }
+        value = atomic_load(&parent->sum);
+        t = parent;
+    }
+}
+
+static void run(const uint32_t id, struct task *t)
+{
+    while (t->n > CUTOFF) {
+        struct task *left = task_new(t, t->n - 1);
+        struct task *right = task_new(t, t->n - 2);
+        atomic_store(&t->pending, 2);
+
+        if (!give(id, right)) {
+            run(id, right);
+        }
+        t = left;
+    }
+    complete(t, fib_serial(t->n));
+}
+
+static void *worker(void *arg)
+{
+    const uint32_t id = (uint32_t)(uintptr_t)arg;
+    uint32_t rng = id * 2654435761U + 1;
+    uint32_t spins = 0;
+
+    while (!atomic_load_explicit(&done, memory_order_relaxed)) {
+        struct task *t;
+        if (take(id, &rng, &t)) {
+            run(id, t);
+            spins = 0;
+        }
+        else {
+            backoff(&spins);
+        }
+    }
+    return NULL;
+}
+
+static double run_parallel(const int n, const uint32_t count, const bool with_wsdeque)
+{
+    use_wsdeque = with_wsdeque;
+    thread_count = count;
+    atomic_store(&done, false);
+
+    for (uint32_t i = 0; i < count; i++) {
+        deques[i] = task_wsdeque_create(64);
+        if (!deques[i]) {
+            fprintf(stderr, "out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    shared_stack = task_fstack_create(SHARED_CAPACITY);
+    if (!shared_stack) {
+        fprintf(stderr, "out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    const double start = now_s();
+
+    /* the root is given to worker 0 before any worker starts */
+    if (!give(0, task_new(NULL, n))) {
+        fprintf(stderr, "out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    pthread_t threads[MAX_THREAD_COUNT];
+    for (uint32_t i = 0; i < count; i++) {
+        pthread_create(&threads[i], NULL, worker, (void *)(uintptr_t)i);
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    const double elapsed = now_s() - start;
+
+    for (uint32_t i = 0; i < count; i++) {
+        task_wsdeque_destroy(deques[i]);
+    }
+    task_fstack_destroy(shared_stack);
+
+    return elapsed;
+}
+
+int main(int argc, char **argv)
+{
+    const int n = argc > 1 ? atoi(argv[1]) : 32;
+    if (n <= CUTOFF || n > 60) {
+        fprintf(stderr, "n must be in (%d, 60]\n", CUTOFF);
+        return EXIT_FAILURE;
+    }
+
+    double start = now_s();
+    const uint64_t expected = fib_serial(n);
+    const double serial_s = now_s() - start;
+
+    printf("fib(%d) = %llu, cutoff %d, serial: %.3f s\n", n, (unsigned long long)expected, CUTOFF, serial_s);
+    printf("%8s %25s %25s\n", "threads", "wsdeque s (speedup)", "locked fstack s (speedup)");
+
+    for (uint32_t count = 1; count <= MAX_THREAD_COUNT; count *= 2) {
+        const double ws_s = run_parallel(n, count, true);
+        const bool ws_ok = result == expected;
+        const double locked_s = run_parallel(n, count, false);
+        const bool locked_ok = result == expected;
+
+        if (!ws_ok || !locked_ok) {
+            fprintf(stderr, "wrong result with %u threads\n", count);
+            return EXIT_FAILURE;
+        }
+
+        printf("%8u %17.3f (%5.2fx) %17.3f (%5.2fx)\n", count, ws_s, serial_s / ws_s, locked_s, serial_s / locked_s);
+    }
+}
@@ -0,0 +1,281 @@
+/*
+    Test cases:
+    - Creation:
+      - Zero / overly large capacities are rejected
+      - Capacity is rounded up to a power of two
+      - Top and bottom are on separate cache lines
+    - Single thread:
+      - pop is LIFO, steal is FIFO, both fail exactly when empty
+      - Mixed pushes, pops and steals against a model
+      - Growth keeps the values and their order, also when the values wrap around the ring
+      - Wrap-around of the positions at the maximum of SIZE_TYPE
+    - Multiple threads (1 owner, 3 thieves), starting with a ring of 2:
+      - Every value is received exactly once, by the owner or by a thief
+      - Values stolen by a thief are received in increasing order
+*/
+
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define NAME       u32_wsdeque
+#define VALUE_TYPE uint32_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "wsdeque_template.h"
+
+#define NAME       u8_wsdeque
+#define VALUE_TYPE uint32_t
+#define SIZE_TYPE  uint8_t
+#define TYPE_DEFINITIONS
+#define FUNCTION_DEFINITIONS
+#define FUNCTION_LINKAGE static inline
+#include "wsdeque_template.h"
+
+#define THIEF_COUNT (3)
+#define VALUE_COUNT (400000)
+
+static void creation_test(void)
+{
+    assert(u32_wsdeque_create(0) == NULL);
+    assert(u8_wsdeque_create(UINT8_MAX / 2 + 2) == NULL);
+
+    struct u32_wsdeque *d = u32_wsdeque_create(5);
+    assert(d != NULL);
+    assert(atomic_load(&d->ring)->capacity == 8);
+    assert((uintptr_t)d % WSDEQUE_CACHE_LINE_SIZE == 0);
+    assert(u32_wsdeque_count(d) == 0);
+    u32_wsdeque_destroy(d);
+
+    assert(offsetof(struct u32_wsdeque, bottom) - offsetof(struct u32_wsdeque, top) >= WSDEQUE_CACHE_LINE_SIZE);
+}
+
+static void single_thread_test(void)
+{
+    struct u32_wsdeque *d = u32_wsdeque_create(4);
+    assert(d != NULL);
+
+    uint32_t value;
+    assert(!u32_wsdeque_pop(d, &value));
+    assert(!u32_wsdeque_steal(d, &value));
+
+    for (uint32_t i = 0; i < 4; i++) {
+        assert(u32_wsdeque_push(d, i));
+    }
+    assert(u32_wsdeque_count(d) == 4);
+    for (uint32_t i = 4; i-- > 0;) {
+        assert(u32_wsdeque_pop(d, &value) && value == i);
+    }
+    assert(!u32_wsdeque_pop(d, &value));
+
+    for (uint32_t i = 0; i < 4; i++) {
+        assert(u32_wsdeque_push(d, i));
+    }
+    for (uint32_t i = 0; i < 4; i++) {
+        assert(u32_wsdeque_steal(d, &value) && value == i);
+    }
+    assert(!u32_wsdeque_steal(d, &value));
+    assert(u32_wsdeque_count(d) == 0);
+
+    u32_wsdeque_destroy(d);
+}
+
+static void model_test(void)
+{
+    struct u32_wsdeque *d = u32_wsdeque_create(1);
+    assert(d != NULL);
+
+    /* the model is a plain array, with values in [begin, end) */
+    enum { MODEL_CAPACITY = 1 << 16 };
+    uint32_t *model = malloc(MODEL_CAPACITY * sizeof(uint32_t));
+    assert(model != NULL);
+    uint32_t begin = 0, end = 0, next = 0;
+
+    srand(47);
+    for (uint32_t i = 0; i < MODEL_CAPACITY; i++) {
+        const int op = rand() % 8;
+        uint32_t value;
+
+        if (op < 4) {
+            assert(u32_wsdeque_push(d, next));
+            model[end++] = next++;
+        }
+        else if (op < 6) {
+            if (begin == end) {
+                assert(!u32_wsdeque_pop(d, &value));
+            }
+            else {
+                assert(u32_wsdeque_pop(d, &value) && value == model[--end]);
+            }
+        }
+        else {
+            if (begin == end) {
+                assert(!u32_wsdeque_steal(d, &value));
+            }
+            else {
+                assert(u32_wsdeque_steal(d, &value) && value == model[begin++]);
+            }
+        }
+        assert(u32_wsdeque_count(d) == end - begin);
+    }
+
+    free(model);
+    u32_wsdeque_destroy(d);
+}
+
+static void growth_test(void)
+{
+    struct u32_wsdeque *d = u32_wsdeque_create(4);
+    assert(d != NULL);
+
+    /* move top and bottom into the middle of the ring, such that the values wrap around */
+    uint32_t value;
+    for (uint32_t i = 0; i < 3; i++) {
+        assert(u32_wsdeque_push(d, 0));
+        assert(u32_wsdeque_steal(d, &value));
+    }
+
+    for (uint32_t i = 0; i < 100; i++) {
+        assert(u32_wsdeque_push(d, i));
+    }
+    assert(atomic_load(&d->ring)->capacity == 128);
+    assert(atomic_load(&d->ring)->retired->capacity == 64);
+    assert(u32_wsdeque_count(d) == 100);
+
+    for (uint32_t i = 0; i < 50; i++) {
+        assert(u32_wsdeque_steal(d, &value) && value == i);
+    }
+    for (uint32_t i = 100; i-- > 50;) {
+        assert(u32_wsdeque_pop(d, &value) && value == i);
+    }
+    assert(!u32_wsdeque_pop(d, &value));
+
+    u32_wsdeque_destroy(d);
+}
+
+static void index_wrap_around_test(void)
+{
+    struct u8_wsdeque *d = u8_wsdeque_create(4);
+    assert(d != NULL);
+
+    /* an empty deque whose positions are about to wrap around */
+    atomic_store(&d->top, UINT8_MAX - 1);
+    atomic_store(&d->bottom, UINT8_MAX - 1);
+
+    uint32_t value;
+    for (uint32_t round = 0; round < 3; round++) {
+        for (uint32_t i = 0; i < 4; i++) {
+            assert(u8_wsdeque_push(d, i));
+        }
+        assert(u8_wsdeque_count(d) == 4);
+        assert(u8_wsdeque_steal(d, &value) && value == 0);
+        assert(u8_wsdeque_pop(d, &value) && value == 3);
+        assert(u8_wsdeque_pop(d, &value) && value == 2);
+        assert(u8_wsdeque_steal(d, &value) && value == 1);
+        assert(!u8_wsdeque_pop(d, &value));
+        assert(!u8_wsdeque_steal(d, &value));
+    }
+
+    /* growth across the wrap-around */
+    for (uint32_t i = 0; i < 20; i++) {
+        assert(u8_wsdeque_push(d, i));
+    }
+    assert(atomic_load(&d->ring)->capacity == 32);
+    for (uint32_t i = 0; i < 20; i++) {
+        assert(u8_wsdeque_steal(d, &value) && value == i);
+    }
+
+    u8_wsdeque_destroy(d);
+}
+
+static struct u32_wsdeque *shared_deque;
+static uint8_t *seen;
+static atomic_bool owner_done;
+
+static void *thief(void *arg)
+{
+    (void)arg;
+
+    bool has_last = false;
+    uint32_t last = 0;
+
+    for (;;) {
+        /* read before stealing. once set, the owner has emptied the deque */
+        const bool done = atomic_load(&owner_done);
+
+        uint32_t value;
+        if (u32_wsdeque_steal(shared_deque, &value)) {
+            assert(value < VALUE_COUNT);
+            assert(!has_last || last < value);
+            last = value;
+            has_last = true;
+
+            seen[value]++;
+        }
+        else if (done) {
+            break;
+        }
+        else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void multiple_threads_test(void)
+{
+    shared_deque = u32_wsdeque_create(2);
+    seen = calloc(VALUE_COUNT, sizeof(uint8_t));
+    assert(shared_deque != NULL && seen != NULL);
+    atomic_store(&owner_done, false);
+
+    pthread_t thieves[THIEF_COUNT];
+    for (uint32_t i = 0; i < THIEF_COUNT; i++) {
+        assert(pthread_create(&thieves[i], NULL, thief, NULL) == 0);
+    }
+
+    /* push in bursts of varying length, and pop half of each burst back */
+    uint32_t next = 0, value;
+    while (next < VALUE_COUNT) {
+        const uint32_t burst = next % 61 + 1;
+        for (uint32_t i = 0; i < burst && next < VALUE_COUNT; i++) {
+            assert(u32_wsdeque_push(shared_deque, next++));
+        }
+        for (uint32_t i = 0; i < burst / 2 && u32_wsdeque_pop(shared_deque, &value); i++) {
+            assert(value < next);
+            seen[value]++;
+        }
+    }
+    while (u32_wsdeque_pop(shared_deque, &value)) {
+        seen[value]++;
+    }
+    atomic_store(&owner_done, true);
+
+    for (uint32_t i = 0; i < THIEF_COUNT; i++) {
+        assert(pthread_join(thieves[i], NULL) == 0);
+    }
+
+    /* seen is written by the owner or one thief per value, and read after the joins */
+    for (uint32_t i = 0; i < VALUE_COUNT; i++) {
+        assert(seen[i] == 1);
+    }
+    assert(u32_wsdeque_count(shared_deque) == 0);
+
+    free(seen);
+    u32_wsdeque_destroy(shared_deque);
+}
+
+int main(void)
+{
+    creation_test();
+    single_thread_test();
+    model_test();
+    growth_test();
+    index_wrap_around_test();
+    multiple_threads_test();
+}
@@ -0,0 +1,553 @@
+/*  wsdeque_template.h
+ *
+ *  Copyright (C) 2025 abxh
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *  See the file LICENSE included with this distribution for more
+ *  information. */
+
+/**
+ * @file wsdeque_template.h
+ * @brief Growable lock-free work-stealing deque (Chase-Lev) based on ring
+ *        buffer
+ *
+ * The deque has a single owner and any number of thieves:
+ *      @li The owner pushes and pops values at the bottom, in LIFO order.
+ *      @li Thieves steal values from the top, in FIFO order.
+ *
+ * This is the building block of work-stealing schedulers: each worker runs
+ * the most recently spawned task from its own deque, which is the one most
+ * likely to be in cache, while idle workers take the oldest (and usually
+ * largest) task from the deques of others.
+ *
+ * The values live in a power-of-two ring, indexed by ever-increasing `top` and
+ * `bottom` positions masked by the capacity, as in `fqueue_template.h`. When
+ * the ring is full, the owner copies the values into a ring of twice the
+ * capacity and publishes it. Thieves may still read from the old ring, so it
+ * is kept around until the deque is destroyed. The total memory held is thus
+ * at most twice the largest ring.
+ *
+ * The owner and the thieves only contend when the deque holds a single value,
+ * in which case they race for it by a compare-and-swap on `top`. `top` and
+ * `bottom` are placed on separate cache lines.
+ *
+ * @note The values are read and written with atomic operations, since a
+ *       thief may read a value which the owner is overwriting at the same
+ *       time (the steal then fails). `VALUE_TYPE` should therefore be a type
+ *       which is lock-free as an atomic, such as a pointer to a task.
+ *
+ * Source(s) used:
+ *  @li D. Chase and Y. Lev. Dynamic Circular Work-Stealing Deque. SPAA 2005.
+ *  @li N. M. Lê, A. Pop, A. Cohen and F. Zappa Nardelli. Correct and Efficient
+ *      Work-Stealing for Weak Memory Models. PPoPP 2013.
+ */
+
+/**
+ * @example wsdeque_example.c
+ * Example of how `wsdeque_template.h` header file is used in practice.
+ */
+
+#ifdef __cplusplus
+#ifdef __GNUC__
+#define restrict __restrict__
+#else
+#define restrict
+#endif
+extern "C" {
+#endif
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// macro definitions: {{{
+
+/**
+ * @def PASTE(a,b)
+ * @brief Paste two tokens together.
+ */
+#ifndef PASTE
+#define PASTE(a, b) a##b
+#endif
+
+/**
+ * @def XPASTE(a,b)
+ * @brief First expand tokens, then paste them together.
+ */
+#ifndef XPASTE
+#define XPASTE(a, b) PASTE(a, b)
+#endif
+
+/**
+ * @def JOIN(a,b)
+ * @brief First expand tokens, then paste them together with a _ in between.
+ */
+#ifndef JOIN
+#define JOIN(a, b) XPASTE(a, XPASTE(_, b))
+#endif
+
+/**
+ * @brief Macro to check if a number is a power of two.
+ *
+ * @param[in] X             The number at hand.
+ *
+ * @return                  A boolean value indicating whether the number is a power of two.
+ */
+#ifndef IS_POW2
+#define IS_POW2(X) ((X) != 0 && ((X) & ((X) - 1)) == 0)
+#endif
+
+/**
+ * @def WSDEQUE_CACHE_LINE_SIZE
+ * @brief Alignment used to keep the owner and thief indices apart.
+ *        Equal to a typical cache line size.
+ */
+#ifndef WSDEQUE_CACHE_LINE_SIZE
+#define WSDEQUE_CACHE_LINE_SIZE (64)
+#endif
+
+/// @cond DO_NOT_DOCUMENT
+#ifndef WSDEQUE_ALIGNAS
+#ifdef __cplusplus
+#define WSDEQUE_ALIGNAS(x) alignas(x)
+#else
+#define WSDEQUE_ALIGNAS(x) _Alignas(x)
+#endif
+#endif
+/// @endcond
+
+/**
+ * @def NAME
+ * @brief Prefix to deque type and operations. This must be manually defined
+ *        before including this header file.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef NAME
+#define NAME wsdeque
+#error "Must define NAME."
+#else
+#define WSDEQUE_NAME NAME
+#endif
+
+/**
+ * @def VALUE_TYPE
+ * @brief Deque value type. This must be manually defined before including this
+ *        header file.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef VALUE_TYPE
+#define VALUE_TYPE int
+#define FUNCTION_DEFINITIONS
+#define TYPE_DEFINITIONS
+#error "Must define VALUE_TYPE."
+#endif
+
+/**
+ * @def SIZE_TYPE
+ * @brief Deque capacity and position type. Defaults to `size_t`.
+ *
+ * The positions only grow, and a thief which is preempted between reading
+ * `top` and the compare-and-swap on it may wrongly succeed if `top` has
+ * wrapped around all the way in the meantime. A 64-bit type rules this out in
+ * practice. Must be an unsigned integer type which is lock-free as an atomic.
+ *
+ * Is undefined after header is included.
+ */
+#ifndef SIZE_TYPE
+#define SIZE_TYPE size_t
+#endif
+
+/**
+ * @def FUNCTION_LINKAGE
+ * @brief Specify function linkage e.g. static inline
+ */
+#ifndef FUNCTION_LINKAGE
+#define FUNCTION_LINKAGE
+#endif
+
+/// @cond DO_NOT_DOCUMENT
+#define WSDEQUE_TYPE      struct WSDEQUE_NAME
+#define WSDEQUE_RING_TYPE struct JOIN(WSDEQUE_NAME, ring)
+#define WSDEQUE_SIZE_MAX  ((SIZE_TYPE)-1)
+#define WSDEQUE_ROUND_UP  JOIN(internal, JOIN(WSDEQUE_NAME, round_up_pow2))
+#define WSDEQUE_RING_NEW  JOIN(internal, JOIN(WSDEQUE_NAME, ring_new))
+#define WSDEQUE_RING_GROW JOIN(internal, JOIN(WSDEQUE_NAME, ring_grow))
+#define WSDEQUE_IS_BEHIND JOIN(internal, JOIN(WSDEQUE_NAME, is_behind))
+/// @endcond
+
+// }}}
+
+// type definitions: {{{
+
+/**
+ * @def TYPE_DEFINITIONS
+ * @brief Define the types
+ */
+#ifdef TYPE_DEFINITIONS
+
+/**
+ * @brief Generated ring struct type for a `VALUE_TYPE`.
+ */
+struct JOIN(WSDEQUE_NAME, ring) {
+    SIZE_TYPE capacity;           ///< Number of values allocated for. A power of 2.
+    WSDEQUE_RING_TYPE *retired;   ///< The smaller ring this one replaced, if any.
+    _Atomic(VALUE_TYPE) values[]; ///< Array of values.
+};
+
+/**
+ * @brief Generated deque struct type for a `VALUE_TYPE`.
+ */
+struct WSDEQUE_NAME {
+    WSDEQUE_ALIGNAS(WSDEQUE_CACHE_LINE_SIZE)
+    _Atomic(SIZE_TYPE) top; ///< Position of the next value to be stolen. Shared by the owner and the thieves.
+
+    WSDEQUE_ALIGNAS(WSDEQUE_CACHE_LINE_SIZE)
+    _Atomic(SIZE_TYPE) bottom; ///< Position of the next value to be pushed. Written by the owner only.
+
+    _Atomic(WSDEQUE_RING_TYPE *) ring; ///< The current ring. Replaced by the owner only.
+};
+
+#endif
+
+// }}}
+
+// function declarations: {{{
+
+/**
+ * @brief Create a deque struct with a given initial capacity.
+ *
+ * The deque struct is allocated with aligned_alloc() and the ring with
+ * malloc().
+ *
+ * @param[in] min_capacity      Number of values expected to be stored at first.
+ *
+ * @return                      A pointer to the deque.
+ * @retval NULL
+ *   @li                        If memory allocation fails.
+ *   @li                        If capacity is 0 or larger than the maximum of `SIZE_TYPE` / 2 + 1 or the
+ *                              equivalent size overflows.
+ */
+FUNCTION_LINKAGE WSDEQUE_TYPE *JOIN(WSDEQUE_NAME, create)(const SIZE_TYPE min_capacity);
+
+/**
+ * @brief Destroy a deque struct, together with its current and retired rings.
+ *
+ * @warning May not be called twice in a row on the same object, or while
+ *          other threads still use the deque.
+ *
+ * @param[in] self              The deque pointer.
+ */
+FUNCTION_LINKAGE void JOIN(WSDEQUE_NAME, destroy)(WSDEQUE_TYPE *self);
+
+/**
+ * @brief Return the number of values in the deque.
+ *
+ * @note A snapshot. The deque may have changed by the time the result is used.
+ *
+ * @param[in] self              The deque pointer.
+ *
+ * @return                      The number of values.
+ */
+FUNCTION_LINKAGE SIZE_TYPE JOIN(WSDEQUE_NAME, count)(WSDEQUE_TYPE *self);
+
+/**
+ * @brief Push a value at the bottom of the deque, growing the ring if it is
+ *        full.
+ *
+ * @warning May only be called by the owner.
+ *
+ * @param[in] self              The deque pointer.
+ * @param[in] value             The value to push.
+ *
+ * @return                      Whether the value was pushed.
+ * @retval false                If the ring was full, and a larger ring could not be allocated.
+ */
+FUNCTION_LINKAGE bool JOIN(WSDEQUE_NAME, push)(WSDEQUE_TYPE *self, const VALUE_TYPE value);
+
+/**
+ * @brief Pop the value at the bottom of the deque, if it is not empty.
+ *
+ * @warning May only be called by the owner.
+ *
+ * @param[in] self              The deque pointer.
+ * @param[out] value_ptr        Set to the bottom value, if any.
+ *
+ * @return                      Whether a value was popped.
+ */
+FUNCTION_LINKAGE bool JOIN(WSDEQUE_NAME, pop)(WSDEQUE_TYPE *restrict self, VALUE_TYPE *restrict value_ptr);
+
+/**
+ * @brief Steal the value at the top of the deque, if it is not empty.
+ *
+ * May be called by any thread.
+ *
+ * @note May also fail if another thief, or the owner, takes the top value at
+ *       the same time. The deque may thus still hold values after a failed
+ *       steal.
+ *
+ * @param[in] self              The deque pointer.
+ * @param[out] value_ptr        Set to the top value, if any.
+ *
+ * @return                      Whether a value was stolen.
+ */
+FUNCTION_LINKAGE bool JOIN(WSDEQUE_NAME, steal)(WSDEQUE_TYPE *restrict self, VALUE_TYPE *restrict value_ptr);
+
+// }}}
+
+// function definitions: {{{
+
+/**
+ * @def FUNCTION_DEFINITIONS
+ * @brief Define the functions
+ */
+#ifdef FUNCTION_DEFINITIONS
+
+#include "round_up_pow2_32.h" // round_up_pow2_32
+#include "round_up_pow2_64.h" // round_up_pow2_64
+
+/// @cond DO_NOT_DOCUMENT
+static inline SIZE_TYPE JOIN(internal, JOIN(WSDEQUE_NAME, round_up_pow2))(const SIZE_TYPE x)
+{
+    if (sizeof(SIZE_TYPE) <= sizeof(uint32_t)) {
+        return (SIZE_TYPE)round_up_pow2_32((uint32_t)x);
+    }
+    return (SIZE_TYPE)round_up_pow2_64((uint64_t)x);
+}
+
+/* whether position a is before position b, with the difference interpreted as signed */
+static inline bool JOIN(internal, JOIN(WSDEQUE_NAME, is_behind))(const SIZE_TYPE a, const SIZE_TYPE b)
+{
+    return (SIZE_TYPE)((SIZE_TYPE)(b - a) - 1) < WSDEQUE_SIZE_MAX / 2;
+}
+
+static inline WSDEQUE_RING_TYPE *JOIN(internal, JOIN(WSDEQUE_NAME, ring_new))(const SIZE_TYPE pow2_capacity)
+{
+    assert(IS_POW2(pow2_capacity));
+
+    if ((uintmax_t)0 + pow2_capacity
+        > (SIZE_MAX - offsetof(WSDEQUE_RING_TYPE, values)) / sizeof(((WSDEQUE_RING_TYPE *)0)->values[0])) {
+        return NULL;
+    }
+
+    WSDEQUE_RING_TYPE *ring = (WSDEQUE_RING_TYPE *)malloc(
+        offsetof(WSDEQUE_RING_TYPE, values) + (size_t)pow2_capacity * sizeof(((WSDEQUE_RING_TYPE *)0)->values[0]));
+
+    if (!ring) {
+        return NULL;
+    }
+
+    ring->capacity = pow2_capacity;
+    ring->retired = NULL;
+
+    return ring;
+}
+
+/* copy the values in [top, bottom) into a ring of twice the capacity, at the same positions */
+static inline WSDEQUE_RING_TYPE *JOIN(internal, JOIN(WSDEQUE_NAME, ring_grow))(WSDEQUE_RING_TYPE *ring,
+                                                                            const SIZE_TYPE top, const SIZE_TYPE bottom)
+{
+    if (ring->capacity > WSDEQUE_SIZE_MAX / 4 + 1) {
+        return NULL;
+    }
+
+    WSDEQUE_RING_TYPE *new_ring = WSDEQUE_RING_NEW((SIZE_TYPE)(ring->capacity * 2));
+
+    if (!new_ring) {
+        return NULL;
+    }
+
+    const SIZE_TYPE old_mask = ring->capacity - 1;
+    const SIZE_TYPE new_mask = new_ring->capacity - 1;
+
+    for (SIZE_TYPE pos = top; pos != bottom; pos++) {
+        const VALUE_TYPE value = atomic_load_explicit(&ring->values[pos & old_mask], memory_order_relaxed);
+        atomic_store_explicit(&new_ring->values[pos & new_mask], value, memory_order_relaxed);
+    }
+    new_ring->retired = ring;
+
+    return new_ring;
+}
+/// @endcond
+
+FUNCTION_LINKAGE WSDEQUE_TYPE *JOIN(WSDEQUE_NAME, create)(const SIZE_TYPE min_capacity)
+{
+    if (min_capacity == 0 || min_capacity > WSDEQUE_SIZE_MAX / 2 + 1) {
+        return NULL;
+    }
+
+    /* aligned_alloc requires the size to be a multiple of the alignment */
+    const size_t size = (sizeof(WSDEQUE_TYPE) + WSDEQUE_CACHE_LINE_SIZE - 1) & ~(size_t)(WSDEQUE_CACHE_LINE_SIZE - 1);
+
+    WSDEQUE_TYPE *self = (WSDEQUE_TYPE *)aligned_alloc(WSDEQUE_CACHE_LINE_SIZE, size);
+
+    if (!self) {
+        return NULL;
+    }
+
+    WSDEQUE_RING_TYPE *ring = WSDEQUE_RING_NEW(WSDEQUE_ROUND_UP(min_capacity));
+
+    if (!ring) {
+        free(self);
+        return NULL;
+    }
+
+    atomic_init(&self->top, 0);
+    atomic_init(&self->bottom, 0);
+    atomic_init(&self->ring, ring);
+
+    return self;
+}
+
+FUNCTION_LINKAGE void JOIN(WSDEQUE_NAME, destroy)(WSDEQUE_TYPE *self)
+{
+    assert(self != NULL);
+
+    WSDEQUE_RING_TYPE *ring = atomic_load_explicit(&self->ring, memory_order_relaxed);
+
+    while (ring) {
+        WSDEQUE_RING_TYPE *retired = ring->retired;
+        free(ring);
+        ring = retired;
+    }
+
+    free(self);
+}
+
+FUNCTION_LINKAGE SIZE_TYPE JOIN(WSDEQUE_NAME, count)(WSDEQUE_TYPE *self)
+{
+    assert(self != NULL);
+
+    /* top is read first, such that bottom is never seen behind it, except while a pop is under way */
+    const SIZE_TYPE top = atomic_load_explicit(&self->top, memory_order_acquire);
+    const SIZE_TYPE bottom = atomic_load_explicit(&self->bottom, memory_order_acquire);
+
+    return WSDEQUE_IS_BEHIND(top, bottom) ? (SIZE_TYPE)(bottom - top) : 0;
+}
+
+FUNCTION_LINKAGE bool JOIN(WSDEQUE_NAME, push)(WSDEQUE_TYPE *self, const VALUE_TYPE value)
+{
+    assert(self != NULL);
+
+    const SIZE_TYPE bottom = atomic_load_explicit(&self->bottom, memory_order_relaxed);
+    const SIZE_TYPE top = atomic_load_explicit(&self->top, memory_order_acquire);
+    WSDEQUE_RING_TYPE *ring = atomic_load_explicit(&self->ring, memory_order_relaxed);
+
+    if ((SIZE_TYPE)(bottom - top) >= ring->capacity) {
+        ring = WSDEQUE_RING_GROW(ring, top, bottom);
+        if (!ring) {
+            return false;
+        }
+        /* thieves which see the new ring also see the values copied into it */
+        atomic_store_explicit(&self->ring, ring, memory_order_release);
+    }
+
+    atomic_store_explicit(&ring->values[bottom & (ring->capacity - 1)], value, memory_order_relaxed);
+
+    /* thieves which see the new bottom also see the value */
+    atomic_store_explicit(&self->bottom, (SIZE_TYPE)(bottom + 1), memory_order_release);
+
+    return true;
+}
+
+FUNCTION_LINKAGE bool JOIN(WSDEQUE_NAME, pop)(WSDEQUE_TYPE *restrict self, VALUE_TYPE *restrict value_ptr)
+{
+    assert(self != NULL);
+    assert(value_ptr != NULL);
+
+    const SIZE_TYPE bottom = (SIZE_TYPE)(atomic_load_explicit(&self->bottom, memory_order_relaxed) - 1);
+    WSDEQUE_RING_TYPE *ring = atomic_load_explicit(&self->ring, memory_order_relaxed);
+
+    /* claim the bottom value before looking at top, such that a thief either sees the claim or is seen */
+    atomic_store_explicit(&self->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    SIZE_TYPE top = atomic_load_explicit(&self->top, memory_order_relaxed);
+
+    if (WSDEQUE_IS_BEHIND(bottom, top)) {
+        /* empty */
+        atomic_store_explicit(&self->bottom, (SIZE_TYPE)(bottom + 1), memory_order_relaxed);
+        return false;
+    }
+
+    const VALUE_TYPE value = atomic_load_explicit(&ring->values[bottom & (ring->capacity - 1)], memory_order_relaxed);
+
+    if (top != bottom) {
+        *value_ptr = value;
+        return true;
+    }
+
+    /* the last value. race the thieves for it */
+    const bool won = atomic_compare_exchange_strong_explicit(&self->top, &top, (SIZE_TYPE)(top + 1),
+                                                             memory_order_seq_cst, memory_order_relaxed);
+
+    atomic_store_explicit(&self->bottom, (SIZE_TYPE)(bottom + 1), memory_order_relaxed);
+
+    if (won) {
+        *value_ptr = value;
+    }
+
+    return won;
+}
+
+FUNCTION_LINKAGE bool JOIN(WSDEQUE_NAME, steal)(WSDEQUE_TYPE *restrict self, VALUE_TYPE *restrict value_ptr)
+{
+    assert(self != NULL);
+    assert(value_ptr != NULL);
+
+    SIZE_TYPE top = atomic_load_explicit(&self->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    const SIZE_TYPE bottom = atomic_load_explicit(&self->bottom, memory_order_acquire);
+
+    if (!WSDEQUE_IS_BEHIND(top, bottom)) {
+        return false;
+    }
+
+    WSDEQUE_RING_TYPE *ring = atomic_load_explicit(&self->ring, memory_order_acquire);
+    const VALUE_TYPE value = atomic_load_explicit(&ring->values[top & (ring->capacity - 1)], memory_order_relaxed);
+
+    if (!atomic_compare_exchange_strong_explicit(&self->top, &top, (SIZE_TYPE)(top + 1), memory_order_seq_cst,
+                                                 memory_order_relaxed)) {
+        return false;
+    }
+
+    *value_ptr = value;
+
+    return true;
+}
+
+#endif
+
+// }}}
+
+// macro undefs: {{{
+
+#undef NAME
+#undef VALUE_TYPE
+#undef SIZE_TYPE
+#undef FUNCTION_LINKAGE
+#undef FUNCTION_DEFINITIONS
+#undef TYPE_DEFINITIONS
+
+#undef WSDEQUE_NAME
+#undef WSDEQUE_TYPE
+#undef WSDEQUE_RING_TYPE
+#undef WSDEQUE_SIZE_MAX
+#undef WSDEQUE_ROUND_UP
+#undef WSDEQUE_RING_NEW
+#undef WSDEQUE_RING_GROW
+#undef WSDEQUE_IS_BEHIND
+
+// }}}
+
+#ifdef __cplusplus
+}
+#endif
+
+// vim: ft=c fdm=marker